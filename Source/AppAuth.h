@@ -16,21 +16,9 @@
         limitations under the License.
  */
 
-#import "OIDAuthState.h"
-#import "OIDAuthStateChangeDelegate.h"
-#import "OIDAuthStateErrorDelegate.h"
-#import "OIDAuthorizationRequest.h"
-#import "OIDAuthorizationResponse.h"
-#import "OIDAuthorizationService.h"
-#import "OIDError.h"
-#import "OIDErrorUtilities.h"
-#import "OIDGrantTypes.h"
-#import "OIDResponseTypes.h"
-#import "OIDScopes.h"
-#import "OIDServiceConfiguration.h"
-#import "OIDServiceDiscovery.h"
-#import "OIDTokenRequest.h"
-#import "OIDTokenResponse.h"
+#import "AppAuthCore.h"
+#import "OIDAuthState+IOS.h"
+#import "OIDAuthorizationService+IOS.h"
 
 /*! @mainpage AppAuth for iOS
 
@@ -55,4 +43,11 @@
     extensions (standard or otherwise) with the ability to handle additional params
     in all protocol requests and responses.
 
+    @section core AppAuthCore
+
+    Everything except presenting authorization requests in `SFSafariViewController`
+    is UI-independent, and is also built as the AppAuthCore library (`AppAuthCore.h`).
+    It depends only on Foundation, so it can be linked into command line tools,
+    daemons and test harnesses, and built on Linux with GNUstep (see `GNUmakefile`).
+
  */
@@ -0,0 +1,59 @@
+/*! @file AppAuthCore.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDAuthState.h"
+#import "OIDAuthStateChangeDelegate.h"
+#import "OIDAuthStateErrorDelegate.h"
+#import "OIDAuthStateObserver.h"
+#import "OIDAuthStateSharedStore.h"
+#import "OIDAuthStateSnapshot.h"
+#import "OIDAuthorizationRequest.h"
+#import "OIDAuthorizationRequestTemplate.h"
+#import "OIDAuthorizationResponse.h"
+#import "OIDAuthorizationService.h"
+#import "OIDCancellable.h"
+#import "OIDClientAuthentication.h"
+#import "OIDClock.h"
+#import "OIDClockSkewEstimator.h"
+#import "OIDConnectivityMonitor.h"
+#import "OIDDPoPKey.h"
+#import "OIDDPoPProofGenerator.h"
+#import "OIDEncryptedAuthStateStore.h"
+#import "OIDError.h"
+#import "OIDErrorUtilities.h"
+#import "OIDFileKeySource.h"
+#import "OIDGrantTypes.h"
+#import "OIDHTTPClient.h"
+#import "OIDJWSSigner.h"
+#import "OIDKeySource.h"
+#import "OIDLogging.h"
+#import "OIDLoopbackRedirectListener.h"
+#import "OIDNetworkReachabilityMonitor.h"
+#import "OIDRegistrationRequest.h"
+#import "OIDRegistrationResponse.h"
+#import "OIDRegistrationStore.h"
+#import "OIDRequestObjectBuilder.h"
+#import "OIDRequestPriority.h"
+#import "OIDResponseTypes.h"
+#import "OIDScopeSet.h"
+#import "OIDScopes.h"
+#import "OIDServiceConfiguration.h"
+#import "OIDServiceDiscovery.h"
+#import "OIDTokenRefreshRequestTemplate.h"
+#import "OIDTokenRequest.h"
+#import "OIDTokenResponse.h"
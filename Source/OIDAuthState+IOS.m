@@ -0,0 +1,72 @@
+/*! @file OIDAuthState+IOS.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDAuthState+IOS.h"
+
+#import "OIDAuthorizationRequest.h"
+#import "OIDAuthorizationResponse.h"
+#import "OIDAuthorizationService+IOS.h"
+#import "OIDTokenRequest.h"
+#import "OIDTokenResponse.h"
+
+@implementation OIDAuthState (IOS)
+
++ (id<OIDAuthorizationFlowSession>)authStateByPresentingAuthorizationRequest:
+    (OIDAuthorizationRequest *)authorizationRequest
+    presentingViewController:(UIViewController *)presentingViewController
+                    callback:(OIDAuthStateAuthorizationCallback)callback {
+  // presents the authorization request
+  id<OIDAuthorizationFlowSession> authFlowSession =
+      [OIDAuthorizationService presentAuthorizationRequest:authorizationRequest
+                                  presentingViewController:presentingViewController
+          callback:^(OIDAuthorizationResponse *_Nullable authorizationResponse,
+                     NSError *_Nullable error) {
+    // inspects response and processes further if needed (e.g. authorization code exchange)
+    if (authorizationResponse) {
+      if ([authorizationRequest.responseType isEqualToString:OIDResponseTypeCode]) {
+        // if the request is for the code flow (NB. not hybrid), assumes the code is intended for
+        // this client, and performs the authorization code exchange
+        OIDTokenRequest *tokenExchangeRequest = [authorizationResponse tokenExchangeRequest];
+        // the user has just finished authorizing, and is waiting for the exchange
+        [OIDAuthorizationService performTokenRequest:tokenExchangeRequest
+                                            priority:OIDRequestPriorityUserInitiated
+                                            deadline:nil
+                                            callback:^(OIDTokenResponse *_Nullable tokenResponse,
+                                                       NSError *_Nullable error) {
+          OIDAuthState *authState;
+          if (tokenResponse) {
+            authState = [[OIDAuthState alloc] initWithAuthorizationResponse:authorizationResponse
+                                                              tokenResponse:tokenResponse];
+          }
+          callback(authState, error);
+        }];
+      } else {
+        // implicit or hybrid flow (hybrid flow assumes code is not for this client)
+        OIDAuthState *authState =
+            [[OIDAuthState alloc] initWithAuthorizationResponse:authorizationResponse];
+        callback(authState, error);
+      }
+    } else {
+      callback(nil, error);
+    }
+  }];
+  return authFlowSession;
+}
+
+@end
+
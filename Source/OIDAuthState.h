@@ -15,16 +15,25 @@
         See the License for the specific language governing permissions and
         limitations under the License.
  */
-#import <UIKit/UIKit.h>
+#import <Foundation/Foundation.h>
+
+#import "OIDRequestPriority.h"
 
 @class OIDAuthorizationRequest;
 @class OIDAuthorizationResponse;
 @class OIDAuthState;
+@class OIDAuthStateSharedStore;
+@class OIDAuthStateSnapshot;
+@class OIDClientAuthentication;
+@class OIDDPoPProofGenerator;
+@class OIDScopeSet;
 @class OIDTokenResponse;
 @class OIDTokenRequest;
 @protocol OIDAuthorizationFlowSession;
 @protocol OIDAuthStateChangeDelegate;
 @protocol OIDAuthStateErrorDelegate;
+@protocol OIDAuthStateObserver;
+@protocol OIDConnectivityMonitor;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -38,6 +47,15 @@ typedef void (^OIDAuthStateAction)(NSString *_Nullable accessToken,
                                    NSString *_Nullable idToken,
                                    NSError *_Nullable error);
 
+/*! @typedef OIDAuthStateRequestAction
+    @brief Represents a block used to call an action with a request authorized by a fresh access
+        token.
+    @param authorizedRequest The authorized request, if a fresh access token was available.
+    @param error The error if an error occurred.
+ */
+typedef void (^OIDAuthStateRequestAction)(NSURLRequest *_Nullable authorizedRequest,
+                                          NSError *_Nullable error);
+
 /*! @typedef OIDAuthStateAuthorizationCallback
     @brief The method called when the @c
         OIDAuthState.authStateByPresentingAuthorizationRequest:presentingViewController:callback:
@@ -71,6 +89,14 @@ typedef void (^OIDAuthStateAuthorizationCallback)(OIDAuthState *_Nullable authSt
  */
 @property(nonatomic, readonly, nullable) NSString *scope;
 
+/*! @property scopeSet
+    @brief The scope of the current authorization grant, as an @c OIDScopeSet.
+    @discussion Use this to check whether the granted scope covers what an API requires, e.g.
+        @c [requiredScopes isSubsetOfScopeSet:authState.scopeSet]. The set is cached until the
+        scope changes.
+ */
+@property(nonatomic, readonly, nullable) OIDScopeSet *scopeSet;
+
 /*! @property lastAuthorizationResponse
     @brief The most recent authorization response used to update the authorization state. For the
         implicit flow, this will contain the latest access token.
@@ -105,10 +131,16 @@ typedef void (^OIDAuthStateAuthorizationCallback)(OIDAuthState *_Nullable authSt
  */
 @property(nonatomic, readonly) BOOL isAuthorized;
 
+/*! @property snapshot
+    @brief An immutable copy of the current tokens and status, which may be read on any thread.
+ */
+@property(nonatomic, readonly) OIDAuthStateSnapshot *snapshot;
+
 /*! @property stateChangeDelegate
     @brief The @c OIDAuthStateChangeDelegate delegate.
     @discussion Use the delegate to observe state changes (and update storage) as well as error
-        states.
+        states. The delegate is called synchronously by each update, so it should be quick; use
+        @c addObserver:queue: for work that can happen later.
  */
 @property(nonatomic, weak, nullable) id<OIDAuthStateChangeDelegate> stateChangeDelegate;
 
@@ -119,21 +151,90 @@ typedef void (^OIDAuthStateAuthorizationCallback)(OIDAuthState *_Nullable authSt
  */
 @property(nonatomic, weak, nullable) id<OIDAuthStateErrorDelegate> errorDelegate;
 
-/*! @fn authStateByPresentingAuthorizationRequest:presentingViewController:callback:
-    @brief Convenience method to create a @c OIDAuthState by presenting an authorization request
-        and performing the authorization code exchange in the case of code flow requests.
-    @param authorizationRequest The authorization request to present.
-    @param presentingViewController The view controller from which to present the
-        @c SFSafariViewController.
-    @param callback The method called when the request has completed or failed.
-    @return A @c OIDAuthorizationFlowSession instance which will terminate when it
-        receives a @c OIDAuthorizationFlowSession.cancel message, or after processing a
-        @c OIDAuthorizationFlowSession.resumeAuthorizationFlowWithURL: message.
- */
-+ (id<OIDAuthorizationFlowSession>)authStateByPresentingAuthorizationRequest:
-    (OIDAuthorizationRequest *)authorizationRequest
-    presentingViewController:(UIViewController *)presentingViewController
-                    callback:(OIDAuthStateAuthorizationCallback)callback;
+/*! @property sharedStore
+    @brief A store shared with other processes that use the same authorization, such as app
+        extensions.
+    @discussion When set, token refreshes performed by @c withFreshTokensPerformAction: hold the
+        store's cross-process refresh lock. Before refreshing, the stored state is checked, and if
+        another process has already obtained fresh tokens they are adopted without a token request.
+        Successful refreshes are written back to the store.
+ */
+@property(nonatomic, strong, nullable) OIDAuthStateSharedStore *sharedStore;
+
+/*! @property staleTokenGracePeriod
+    @brief How many seconds past its expiry the last access token may still be used when it can't
+        be refreshed because of a transient error, such as an authorization server outage.
+        Defaults to 0, which disables the grace period.
+    @discussion When a refresh performed by @c withFreshTokensPerformAction: fails with a transient
+        error and the access token expired less than this long ago, the actions are performed with
+        the last tokens and no error. The refresh is then retried in the background with
+        exponential backoff, and until it succeeds, further actions are performed immediately with
+        the last tokens while they remain within the grace period. After that, actions receive the
+        refresh error as usual.
+
+        Only use this with resource servers known to accept tokens for some time after their
+        expiry. The errors are reported to @c errorDelegate, so outages can be monitored.
+ */
+@property(nonatomic, assign) NSTimeInterval staleTokenGracePeriod;
+
+/*! @property staleTokenRetryInitialInterval
+    @brief Seconds before the first background refresh after stale tokens were used. Defaults
+        to 5. Each further retry waits twice as long, up to @c staleTokenRetryMaximumInterval.
+ */
+@property(nonatomic, assign) NSTimeInterval staleTokenRetryInitialInterval;
+
+/*! @property staleTokenRetryMaximumInterval
+    @brief The longest interval between background refreshes while stale tokens are in use.
+        Defaults to 60.
+ */
+@property(nonatomic, assign) NSTimeInterval staleTokenRetryMaximumInterval;
+
+/*! @property tokenRefreshLeadTime
+    @brief How many seconds before the access token expires @c withFreshTokensPerformAction:
+        refreshes it. Defaults to 60.
+    @discussion A longer lead time covers more clock skew and token endpoint latency, at the cost
+        of more frequent refreshes.
+ */
+@property(nonatomic, assign) NSTimeInterval tokenRefreshLeadTime;
+
+/*! @property connectivityMonitor
+    @brief Reports whether the network is reachable, so that token refreshes can wait for it.
+        Defaults to nil, in which case refreshes are always attempted immediately.
+    @discussion When set, and a refresh performed by @c withFreshTokensPerformAction: is needed
+        while the network is unreachable, the refresh is deferred instead of failing. Actions
+        wait until the network is reachable again, when a single refresh is made for all of them,
+        or until @c offlineActionTimeout elapses, when they are performed with an
+        @c OIDErrorCodeNetworkError error.
+
+        Use @c OIDNetworkReachabilityMonitor.sharedMonitor, or your own implementation.
+ */
+@property(nonatomic, strong, nullable) id<OIDConnectivityMonitor> connectivityMonitor;
+
+/*! @property offlineActionTimeout
+    @brief How many seconds an action may wait for the network to become reachable, when a
+        @c connectivityMonitor is set. Defaults to 60. If 0 or less, actions wait indefinitely.
+ */
+@property(nonatomic, assign) NSTimeInterval offlineActionTimeout;
+
+/*! @property proofGenerator
+    @brief Creates the DPoP proofs which bind this state's tokens to a key. Defaults to nil, in
+        which case no proofs are sent.
+    @discussion When set, token refreshes are made with a proof, and
+        @c withFreshTokensAuthorizeRequest:action: adds a proof to each request authorized with a
+        DPoP-bound access token. The code exchange which created the state should also have been
+        made with a proof from the same generator, using
+        @c OIDAuthorizationService.performTokenRequest:proofGenerator:priority:deadline:callback:.
+    @see https://www.rfc-editor.org/rfc/rfc9449
+ */
+@property(nonatomic, strong, nullable) OIDDPoPProofGenerator *proofGenerator;
+
+/*! @property clientAuthentication
+    @brief Authenticates token refreshes for confidential clients. Defaults to nil, in which case
+        refreshes carry only the client ID and the template's additional parameters.
+    @discussion The client's credentials aren't archived with the state, so set this again after
+        decoding one.
+ */
+@property(nonatomic, strong, nullable) OIDClientAuthentication *clientAuthentication;
 
 /*! @fn init
     @internal
@@ -204,12 +305,75 @@ typedef void (^OIDAuthStateAuthorizationCallback)(OIDAuthState *_Nullable authSt
  */
 - (void)withFreshTokensPerformAction:(OIDAuthStateAction)action;
 
+/*! @fn withFreshTokensPerformAction:priority:
+    @brief Calls the block with a valid access token, refreshing it first with the given priority
+        if needed.
+    @param action The block to execute with a fresh token. This block will be executed on the main
+        thread.
+    @param priority How urgently the action needs the tokens. Use
+        @c OIDRequestPriorityUserInitiated when the user is waiting for the action, so its refresh
+        doesn't queue behind background requests. If a refresh is already pending, it is made
+        with the highest priority of the actions waiting for it, if it hasn't started yet.
+ */
+- (void)withFreshTokensPerformAction:(OIDAuthStateAction)action
+                            priority:(OIDRequestPriority)priority;
+
+/*! @fn withFreshTokensAuthorizeRequest:action:
+    @brief Calls the block with a copy of a resource request authorized with a valid access token
+        (refreshing it first, if needed), or if a refresh was needed and failed, with the error
+        that caused it to fail.
+    @param request The request to a resource server.
+    @param action The block to execute with the authorized request. This block will be executed
+        on the main thread.
+    @discussion If the access token is DPoP-bound and a @c proofGenerator is set, the token is sent
+        with the @c DPoP scheme and a proof of possession for the request. Otherwise it's sent as
+        a bearer token. A resource server which responds with a @c DPoP-Nonce header should have
+        the response passed to @c OIDDPoPProofGenerator.recordNonceFromResponse:, so later proofs
+        include its nonce.
+ */
+- (void)withFreshTokensAuthorizeRequest:(NSURLRequest *)request
+                                 action:(OIDAuthStateRequestAction)action;
+
+/*! @fn addObserver:queue:
+    @brief Registers an observer, which is notified asynchronously of each change to the state.
+    @param observer The observer, which is held weakly. Adding an observer again replaces its
+        queue.
+    @param queue The queue the observer is called on, or nil for the main queue.
+    @discussion Bursts of changes made before the observer's queue runs the notification, such as
+        the updates of a single refresh, are coalesced into one call with the latest snapshot.
+ */
+- (void)addObserver:(id<OIDAuthStateObserver>)observer queue:(nullable dispatch_queue_t)queue;
+
+/*! @fn removeObserver:
+    @brief Unregisters an observer. Notifications already queued for it are dropped, unless they
+        have already started.
+    @param observer The observer to remove.
+ */
+- (void)removeObserver:(id<OIDAuthStateObserver>)observer;
+
 /*! @fn setNeedsTokenRefresh
     @brief Forces a token refresh the next time @c withFreshTokensPerformAction is called, even if
         the current tokens are considered valid.
  */
 - (void)setNeedsTokenRefresh;
 
+/*! @fn compact
+    @brief Reduces the memory held by the state, for apps which keep many states resident.
+    @discussion Replaces the configuration of the last authorization and token requests with one
+        which has the same endpoints, but no discovery document, and which is shared by reference
+        with every other compacted state using those endpoints. The secrets of requests which
+        were already made are dropped: the last token request's authorization code, code verifier
+        and refresh token, and the authorization request's code verifier once the code was
+        exchanged. Everything needed to refresh tokens, and the values of all the state's
+        properties, are retained.
+
+        After compaction, @c lastAuthorizationResponse and @c lastTokenResponse are equivalent
+        objects whose requests' @c configuration.discoveryDocument is nil, without those secrets.
+        Call this once the state has been created or unarchived, on the same thread as the state's
+        updates.
+ */
+- (void)compact;
+
 /*! @fn tokenRefreshRequest
     @brief Creates a token request suitable for refreshing an access token.
     @return A @c OIDTokenRequest suitable for using a refresh token to obtain a new access token.
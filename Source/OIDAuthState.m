@@ -20,12 +20,24 @@
 
 #import "OIDAuthStateChangeDelegate.h"
 #import "OIDAuthStateErrorDelegate.h"
+#import "OIDAuthStateObserver.h"
+#import "OIDAuthStateSharedStore.h"
+#import "OIDAuthStateSnapshot.h"
 #import "OIDAuthorizationRequest.h"
 #import "OIDAuthorizationResponse.h"
 #import "OIDAuthorizationService.h"
+#import "OIDClientAuthentication.h"
+#import "OIDClock.h"
+#import "OIDClockSkewEstimator.h"
+#import "OIDConnectivityMonitor.h"
+#import "OIDDPoPProofGenerator.h"
 #import "OIDDefines.h"
 #import "OIDError.h"
 #import "OIDErrorUtilities.h"
+#import "OIDLogging.h"
+#import "OIDScopeSet.h"
+#import "OIDServiceConfiguration.h"
+#import "OIDTokenRefreshRequestTemplate.h"
 #import "OIDTokenRequest.h"
 #import "OIDTokenResponse.h"
 
@@ -49,6 +61,32 @@ static NSString *const kLastAuthorizationResponseKey = @"lastAuthorizationRespon
  */
 static NSString *const kLastTokenResponseKey = @"lastTokenResponse";
 
+/*! @var kAccessTokenKey
+    @brief Key used to encode the access token in the hot header of the archive.
+ */
+static NSString *const kAccessTokenKey = @"accessToken";
+
+/*! @var kTokenTypeKey
+    @brief Key used to encode the access token's type in the hot header of the archive.
+ */
+static NSString *const kTokenTypeKey = @"tokenType";
+
+/*! @var kAccessTokenExpirationDateKey
+    @brief Key used to encode the access token's expiry in the hot header of the archive.
+ */
+static NSString *const kAccessTokenExpirationDateKey = @"accessTokenExpirationDate";
+
+/*! @var kIDTokenKey
+    @brief Key used to encode the ID token in the hot header of the archive.
+ */
+static NSString *const kIDTokenKey = @"idToken";
+
+/*! @var kColdPayloadKey
+    @brief Key used to encode the nested archive of the last authorization and token responses,
+        which is only decoded when they are first needed.
+ */
+static NSString *const kColdPayloadKey = @"coldPayload";
+
 /*! @var kLastOAuthErrorKey
     @brief Key used to encode the @c lastOAuthError property for @c NSSecureCoding.
  */
@@ -61,10 +99,31 @@ static NSString *const kAuthorizationErrorKey = @"authorizationError";
 static NSString *const kRefreshTokenRequestException =
     @"Attempted to create a token refresh request from a token response with no refresh token.";
 
-/*! @var kExpiryTimeTolerance
-    @brief Number of seconds the access token is refreshed before it actually expires.
+/*! @var kDefaultTokenRefreshLeadTime
+    @brief The default value of @c tokenRefreshLeadTime.
+ */
+static const NSTimeInterval kDefaultTokenRefreshLeadTime = 60;
+
+/*! @var kDefaultOfflineActionTimeout
+    @brief The default value of @c offlineActionTimeout.
+ */
+static const NSTimeInterval kDefaultOfflineActionTimeout = 60;
+
+/*! @var kOfflineActionTimeoutDescription
+    @brief The description of the error passed to actions which timed out waiting for the network.
+ */
+static NSString *const kOfflineActionTimeoutDescription =
+    @"The network was unreachable, so the tokens could not be refreshed.";
+
+/*! @var kDefaultStaleTokenRetryInitialInterval
+    @brief The default value of @c staleTokenRetryInitialInterval.
+ */
+static const NSTimeInterval kDefaultStaleTokenRetryInitialInterval = 5;
+
+/*! @var kDefaultStaleTokenRetryMaximumInterval
+    @brief The default value of @c staleTokenRetryMaximumInterval.
  */
-static const NSUInteger kExpiryTimeTolerance = 60;
+static const NSTimeInterval kDefaultStaleTokenRetryMaximumInterval = 60;
 
 @interface OIDAuthState ()
 
@@ -75,6 +134,11 @@ static const NSUInteger kExpiryTimeTolerance = 60;
  */
 @property(nonatomic, readonly, nullable) NSString *accessToken;
 
+/*! @property tokenType
+    @brief The type of the access token.
+ */
+@property(nonatomic, readonly, nullable) NSString *tokenType;
+
 /*! @property accessTokenExpirationDate
     @brief The approximate expiration date & time of the access token.
     @discussion Rather than using this property directly, you should call
@@ -89,6 +153,13 @@ static const NSUInteger kExpiryTimeTolerance = 60;
  */
 @property(nonatomic, readonly, nullable) NSString *idToken;
 
+/*! @fn initWithColdPayload:
+    @brief Creates an unarchived state whose responses are decoded from @c coldPayload when they
+        are first needed.
+    @param coldPayload The archived last authorization and token responses.
+ */
+- (instancetype)initWithColdPayload:(NSData *)coldPayload NS_DESIGNATED_INITIALIZER;
+
 /*! @fn didChangeState
     @brief Private method, called when the internal state changes.
  */
@@ -96,6 +167,92 @@ static const NSUInteger kExpiryTimeTolerance = 60;
 
 @end
 
+/*! @class OIDAuthStateObservation
+    @brief The registration of an @c OIDAuthStateObserver, which coalesces its notifications.
+ */
+@interface OIDAuthStateObservation : NSObject
+
+/*! @fn initWithObserver:queue:
+    @brief Designated initializer.
+    @param observer The observer, which is held weakly.
+    @param queue The queue the observer is called on.
+ */
+- (instancetype)initWithObserver:(id<OIDAuthStateObserver>)observer queue:(dispatch_queue_t)queue;
+
+/*! @fn postSnapshot:ofAuthState:
+    @brief Notifies the observer of the snapshot on its queue, unless a notification is already
+        queued, in which case that notification delivers this snapshot instead.
+ */
+- (void)postSnapshot:(OIDAuthStateSnapshot *)snapshot ofAuthState:(OIDAuthState *)authState;
+
+/*! @fn invalidate
+    @brief Drops any queued notification, and prevents further ones.
+ */
+- (void)invalidate;
+
+@end
+
+@implementation OIDAuthStateObservation {
+  /*! @var _observer
+      @brief The observer.
+   */
+  __weak id<OIDAuthStateObserver> _observer;
+
+  /*! @var _queue
+      @brief The queue the observer is called on.
+   */
+  dispatch_queue_t _queue;
+
+  /*! @var _pendingSnapshot
+      @brief The snapshot the queued notification will deliver, or nil if none is queued.
+          Synchronized on @c self.
+   */
+  OIDAuthStateSnapshot *_pendingSnapshot;
+
+  /*! @var _invalidated
+      @brief Whether the observer has been removed. Synchronized on @c self.
+   */
+  BOOL _invalidated;
+}
+
+- (instancetype)initWithObserver:(id<OIDAuthStateObserver>)observer queue:(dispatch_queue_t)queue {
+  self = [super init];
+  if (self) {
+    _observer = observer;
+    _queue = queue;
+  }
+  return self;
+}
+
+- (void)postSnapshot:(OIDAuthStateSnapshot *)snapshot ofAuthState:(OIDAuthState *)authState {
+  @synchronized(self) {
+    BOOL isQueued = _pendingSnapshot != nil;
+    _pendingSnapshot = snapshot;
+    if (isQueued || _invalidated) {
+      return;
+    }
+  }
+  dispatch_async(_queue, ^() {
+    OIDAuthStateSnapshot *latestSnapshot;
+    @synchronized(self) {
+      latestSnapshot = self->_pendingSnapshot;
+      self->_pendingSnapshot = nil;
+      if (self->_invalidated) {
+        return;
+      }
+    }
+    [self->_observer authState:authState didChangeToSnapshot:latestSnapshot];
+  });
+}
+
+- (void)invalidate {
+  @synchronized(self) {
+    _invalidated = YES;
+    _pendingSnapshot = nil;
+  }
+}
+
+@end
 
 @implementation OIDAuthState {
   /*! @var _pendingActions
@@ -112,47 +269,73 @@ static const NSUInteger kExpiryTimeTolerance = 60;
       @brief If YES, tokens will be refreshed on the next API call regardless of expiry.
    */
   BOOL _needsTokenRefresh;
-}
 
-#pragma mark - Convenience initializers
-
-+ (id<OIDAuthorizationFlowSession>)authStateByPresentingAuthorizationRequest:
-    (OIDAuthorizationRequest *)authorizationRequest
-    presentingViewController:(UIViewController *)presentingViewController
-                    callback:(OIDAuthStateAuthorizationCallback)callback {
-  // presents the authorization request
-  id<OIDAuthorizationFlowSession> authFlowSession =
-      [OIDAuthorizationService presentAuthorizationRequest:authorizationRequest
-                                  presentingViewController:presentingViewController
-          callback:^(OIDAuthorizationResponse *_Nullable authorizationResponse,
-                     NSError *_Nullable error) {
-    // inspects response and processes further if needed (e.g. authorization code exchange)
-    if (authorizationResponse) {
-      if ([authorizationRequest.responseType isEqualToString:OIDResponseTypeCode]) {
-        // if the request is for the code flow (NB. not hybrid), assumes the code is intended for
-        // this client, and performs the authorization code exchange
-        OIDTokenRequest *tokenExchangeRequest = [authorizationResponse tokenExchangeRequest];
-        [OIDAuthorizationService performTokenRequest:tokenExchangeRequest
-                                            callback:^(OIDTokenResponse *_Nullable tokenResponse,
-                                                       NSError *_Nullable error) {
-          OIDAuthState *authState;
-          if (tokenResponse) {
-            authState = [[OIDAuthState alloc] initWithAuthorizationResponse:authorizationResponse
-                                                              tokenResponse:tokenResponse];
-          }
-          callback(authState, error);
-        }];
-      } else {
-        // implicit or hybrid flow (hybrid flow assumes code is not for this client)
-        OIDAuthState *authState =
-            [[OIDAuthState alloc] initWithAuthorizationResponse:authorizationResponse];
-        callback(authState, error);
-      }
-    } else {
-      callback(nil, error);
-    }
-  }];
-  return authFlowSession;
+  /*! @var _staleTokenRetryInterval
+      @brief While stale tokens are in use, the interval before the next background refresh,
+          otherwise 0. Only changed on the main thread.
+   */
+  NSTimeInterval _staleTokenRetryInterval;
+
+  /*! @var _tokenRefreshDeferred
+      @brief If YES, the refresh for the pending actions is waiting for the network to become
+          reachable. Synchronized on @c _pendingActionsSyncObject.
+   */
+  BOOL _tokenRefreshDeferred;
+
+  /*! @var _observations
+      @brief The registered observers, held weakly, and their registrations. Synchronized on
+          itself.
+   */
+  NSMapTable<id<OIDAuthStateObserver>, OIDAuthStateObservation *> *_observations;
+
+  /*! @var _pendingRefreshPriority
+      @brief The priority of the refresh for the pending actions: the highest priority of any of
+          them when it starts. Synchronized on @c _pendingActionsSyncObject.
+   */
+  OIDRequestPriority _pendingRefreshPriority;
+
+  /*! @var _scopeSet
+      @brief The cached @c scopeSet, valid while @c _scope is the string it was created from.
+   */
+  OIDScopeSet *_scopeSet;
+
+  /*! @var _scopeSetSource
+      @brief The @c _scope string from which @c _scopeSet was created.
+   */
+  NSString *_scopeSetSource;
+
+  /*! @var _refreshRequestTemplate
+      @brief The cached refresh request template, valid while the last authorization response's
+          request is the one it was compiled from.
+   */
+  OIDTokenRefreshRequestTemplate *_refreshRequestTemplate;
+
+  /*! @var _coldPayload
+      @brief The archived last authorization and token responses, until they are first needed.
+          While set, the token values are read from the @c _archived ivars. Synchronized on
+          @c self.
+   */
+  NSData *_coldPayload;
+
+  /*! @var _archivedAccessToken
+      @brief The access token from the hot header of the archive.
+   */
+  NSString *_archivedAccessToken;
+
+  /*! @var _archivedTokenType
+      @brief The access token's type from the hot header of the archive.
+   */
+  NSString *_archivedTokenType;
+
+  /*! @var _archivedAccessTokenExpirationDate
+      @brief The access token's expiry from the hot header of the archive.
+   */
+  NSDate *_archivedAccessTokenExpirationDate;
+
+  /*! @var _archivedIDToken
+      @brief The ID token from the hot header of the archive.
+   */
+  NSString *_archivedIDToken;
 }
 
 #pragma mark - Initializers
@@ -180,7 +363,7 @@ static const NSUInteger kExpiryTimeTolerance = 60;
                                          tokenResponse:(nullable OIDTokenResponse *)tokenResponse {
   self = [super init];
   if (self) {
-    _pendingActionsSyncObject = [[NSObject alloc] init];
+    [self setUpSynchronization];
     [self updateWithAuthorizationResponse:authorizationResponse error:nil];
 
     if (tokenResponse) {
@@ -190,9 +373,34 @@ static const NSUInteger kExpiryTimeTolerance = 60;
   return self;
 }
 
+- (instancetype)initWithColdPayload:(NSData *)coldPayload {
+  self = [super init];
+  if (self) {
+    [self setUpSynchronization];
+    _coldPayload = coldPayload;
+  }
+  return self;
+}
+
+/*! @fn setUpSynchronization
+    @brief Creates the objects every initializer needs before the state can be used.
+ */
+- (void)setUpSynchronization {
+  _pendingActionsSyncObject = [[NSObject alloc] init];
+  _observations = [[NSMapTable alloc]
+      initWithKeyOptions:NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality
+            valueOptions:NSPointerFunctionsStrongMemory
+                capacity:0];
+  _offlineActionTimeout = kDefaultOfflineActionTimeout;
+  _tokenRefreshLeadTime = kDefaultTokenRefreshLeadTime;
+  _staleTokenRetryInitialInterval = kDefaultStaleTokenRetryInitialInterval;
+  _staleTokenRetryMaximumInterval = kDefaultStaleTokenRetryMaximumInterval;
+}
+
 #pragma mark - NSObject overrides
 
 - (NSString *)description {
+  [self decodeColdPayloadIfNeeded];
   return [NSString stringWithFormat:@"<%@: %p, isAuthorized: %@, refreshToken: \"%@\", "
                                      "scope: \"%@\", accessToken: \"%@\", "
                                      "accessTokenExpirationDate: %@, idToken: \"%@\", "
@@ -201,11 +409,11 @@ static const NSUInteger kExpiryTimeTolerance = 60;
                                     NSStringFromClass([self class]),
                                     self,
                                     (self.isAuthorized) ? @"YES" : @"NO",
-                                    _refreshToken,
+                                    OIDLogRedact(_refreshToken),
                                     _scope,
-                                    self.accessToken,
+                                    OIDLogRedact(self.accessToken),
                                     self.accessTokenExpirationDate,
-                                    self.idToken,
+                                    OIDLogRedact(self.idToken),
                                     _lastAuthorizationResponse,
                                     _lastTokenResponse,
                                     _authorizationError];
@@ -218,12 +426,26 @@ static const NSUInteger kExpiryTimeTolerance = 60;
 }
 
 - (instancetype)initWithCoder:(NSCoder *)aDecoder {
-  _lastAuthorizationResponse = [aDecoder decodeObjectOfClass:[OIDAuthorizationResponse class]
-                                                      forKey:kLastAuthorizationResponseKey];
-  _lastTokenResponse = [aDecoder decodeObjectOfClass:[OIDTokenResponse class]
-                                              forKey:kLastTokenResponseKey];
-  self = [self initWithAuthorizationResponse:_lastAuthorizationResponse
-                               tokenResponse:_lastTokenResponse];
+  NSData *coldPayload = [aDecoder decodeObjectOfClass:[NSData class] forKey:kColdPayloadKey];
+  if (coldPayload) {
+    self = [self initWithColdPayload:coldPayload];
+    if (self) {
+      _archivedAccessToken = [aDecoder decodeObjectOfClass:[NSString class]
+                                                    forKey:kAccessTokenKey];
+      _archivedTokenType = [aDecoder decodeObjectOfClass:[NSString class] forKey:kTokenTypeKey];
+      _archivedAccessTokenExpirationDate =
+          [aDecoder decodeObjectOfClass:[NSDate class] forKey:kAccessTokenExpirationDateKey];
+      _archivedIDToken = [aDecoder decodeObjectOfClass:[NSString class] forKey:kIDTokenKey];
+    }
+  } else {
+    // archived before the responses were separated into a cold payload
+    OIDAuthorizationResponse *authorizationResponse =
+        [aDecoder decodeObjectOfClass:[OIDAuthorizationResponse class]
+                               forKey:kLastAuthorizationResponseKey];
+    OIDTokenResponse *tokenResponse = [aDecoder decodeObjectOfClass:[OIDTokenResponse class]
+                                                             forKey:kLastTokenResponseKey];
+    self = [self initWithAuthorizationResponse:authorizationResponse tokenResponse:tokenResponse];
+  }
   if (self) {
     _authorizationError =
         [aDecoder decodeObjectOfClass:[NSError class] forKey:kAuthorizationErrorKey];
@@ -234,8 +456,18 @@ static const NSUInteger kExpiryTimeTolerance = 60;
 }
 
 - (void)encodeWithCoder:(NSCoder *)aCoder {
-  [aCoder encodeObject:_lastAuthorizationResponse forKey:kLastAuthorizationResponseKey];
-  [aCoder encodeObject:_lastTokenResponse forKey:kLastTokenResponseKey];
+  // the hot header holds everything needed to check whether the state is authorized and to use
+  // its tokens, so that restoring many states doesn't decode their request and response graphs
+  NSData *coldPayload;
+  @synchronized(self) {
+    coldPayload = _coldPayload ?: [self archivedColdPayload];
+  }
+  [aCoder encodeObject:coldPayload forKey:kColdPayloadKey];
+  [aCoder encodeObject:[self accessTokenIgnoringError] forKey:kAccessTokenKey];
+  [aCoder encodeObject:[self tokenTypeIgnoringError] forKey:kTokenTypeKey];
+  [aCoder encodeObject:[self accessTokenExpirationDateIgnoringError]
+                forKey:kAccessTokenExpirationDateKey];
+  [aCoder encodeObject:[self idTokenIgnoringError] forKey:kIDTokenKey];
   if (_authorizationError) {
     NSError *codingSafeAuthorizationError = [NSError errorWithDomain:_authorizationError.domain
                                                                 code:_authorizationError.code
@@ -246,38 +478,154 @@ static const NSUInteger kExpiryTimeTolerance = 60;
   [aCoder encodeObject:_refreshToken forKey:kRefreshTokenKey];
 }
 
+#pragma mark - Cold payload
+
+/*! @fn archivedColdPayload
+    @brief Archives the last authorization and token responses. Called while synchronized on
+        @c self, once the cold payload has been decoded.
+ */
+- (NSData *)archivedColdPayload {
+  NSMutableData *data = [NSMutableData data];
+  NSKeyedArchiver *archiver = [[NSKeyedArchiver alloc] initForWritingWithMutableData:data];
+  archiver.requiresSecureCoding = YES;
+  [archiver encodeObject:_lastAuthorizationResponse forKey:kLastAuthorizationResponseKey];
+  [archiver encodeObject:_lastTokenResponse forKey:kLastTokenResponseKey];
+  [archiver finishEncoding];
+  return data;
+}
+
+/*! @fn decodeColdPayloadIfNeeded
+    @brief Decodes the last authorization and token responses, if the state was unarchived and
+        they haven't been needed yet. Must be called before they are read or replaced.
+ */
+- (void)decodeColdPayloadIfNeeded {
+  @synchronized(self) {
+    if (!_coldPayload) {
+      return;
+    }
+    NSKeyedUnarchiver *unarchiver =
+        [[NSKeyedUnarchiver alloc] initForReadingWithData:_coldPayload];
+    unarchiver.requiresSecureCoding = YES;
+    _lastAuthorizationResponse =
+        [unarchiver decodeObjectOfClass:[OIDAuthorizationResponse class]
+                                 forKey:kLastAuthorizationResponseKey];
+    _lastTokenResponse = [unarchiver decodeObjectOfClass:[OIDTokenResponse class]
+                                                  forKey:kLastTokenResponseKey];
+    [unarchiver finishDecoding];
+    _coldPayload = nil;
+    _archivedAccessToken = nil;
+    _archivedTokenType = nil;
+    _archivedAccessTokenExpirationDate = nil;
+    _archivedIDToken = nil;
+  }
+}
+
+- (OIDAuthorizationResponse *)lastAuthorizationResponse {
+  [self decodeColdPayloadIfNeeded];
+  return _lastAuthorizationResponse;
+}
+
+- (nullable OIDTokenResponse *)lastTokenResponse {
+  [self decodeColdPayloadIfNeeded];
+  return _lastTokenResponse;
+}
+
 #pragma mark - Private convenience getters
 
+/*! @fn accessTokenIgnoringError
+    @brief The access token of the last response, even if there has since been an error.
+ */
+- (nullable NSString *)accessTokenIgnoringError {
+  @synchronized(self) {
+    if (_coldPayload) {
+      return _archivedAccessToken;
+    }
+  }
+  return _lastTokenResponse ? _lastTokenResponse.accessToken
+                            : _lastAuthorizationResponse.accessToken;
+}
+
+/*! @fn tokenTypeIgnoringError
+    @brief The access token type of the last response, even if there has since been an error.
+ */
+- (nullable NSString *)tokenTypeIgnoringError {
+  @synchronized(self) {
+    if (_coldPayload) {
+      return _archivedTokenType;
+    }
+  }
+  return _lastTokenResponse ? _lastTokenResponse.tokenType
+                            : _lastAuthorizationResponse.tokenType;
+}
+
+/*! @fn accessTokenExpirationDateIgnoringError
+    @brief The access token expiry of the last response, even if there has since been an error.
+ */
+- (nullable NSDate *)accessTokenExpirationDateIgnoringError {
+  @synchronized(self) {
+    if (_coldPayload) {
+      return _archivedAccessTokenExpirationDate;
+    }
+  }
+  return _lastTokenResponse ? _lastTokenResponse.accessTokenExpirationDate
+                            : _lastAuthorizationResponse.accessTokenExpirationDate;
+}
+
+/*! @fn idTokenIgnoringError
+    @brief The ID token of the last response, even if there has since been an error.
+ */
+- (nullable NSString *)idTokenIgnoringError {
+  @synchronized(self) {
+    if (_coldPayload) {
+      return _archivedIDToken;
+    }
+  }
+  return _lastTokenResponse ? _lastTokenResponse.idToken
+                            : _lastAuthorizationResponse.idToken;
+}
+
 - (NSString *)accessToken {
   if (_authorizationError) {
     return nil;
   }
-  return _lastTokenResponse ? _lastTokenResponse.accessToken
-                            : _lastAuthorizationResponse.accessToken;
+  return [self accessTokenIgnoringError];
 }
 
 - (NSString *)tokenType {
   if (_authorizationError) {
     return nil;
   }
-  return _lastTokenResponse ? _lastTokenResponse.tokenType
-                            : _lastAuthorizationResponse.tokenType;
+  return [self tokenTypeIgnoringError];
 }
 
 - (NSDate *)accessTokenExpirationDate {
   if (_authorizationError) {
     return nil;
   }
-  return _lastTokenResponse ? _lastTokenResponse.accessTokenExpirationDate
-                            : _lastAuthorizationResponse.accessTokenExpirationDate;
+  return [self accessTokenExpirationDateIgnoringError];
+}
+
+/*! @fn accessTokenTimeUntilExpiration
+    @brief The estimated number of seconds until the access token expires, or 0 if unknown.
+    @see OIDTokenResponse.accessTokenTimeUntilExpiration
+ */
+- (NSTimeInterval)accessTokenTimeUntilExpiration {
+  if (_authorizationError) {
+    return 0;
+  }
+  // the estimate depends on the clock offset recorded with the token response
+  [self decodeColdPayloadIfNeeded];
+  return _lastTokenResponse
+      ? [_lastTokenResponse accessTokenTimeUntilExpiration]
+      : [_lastAuthorizationResponse.accessTokenExpirationDate
+            timeIntervalSinceDate:[OIDClock sharedClock].now];
 }
 
 - (NSString *)idToken {
   if (_authorizationError) {
     return nil;
   }
-  return _lastTokenResponse ? _lastTokenResponse.idToken
-                            : _lastAuthorizationResponse.idToken;
+  return [self idTokenIgnoringError];
 }
 
 #pragma mark - Getters
@@ -286,6 +634,15 @@ static const NSUInteger kExpiryTimeTolerance = 60;
   return !self.authorizationError && (self.accessToken || self.idToken);
 }
 
+- (nullable OIDScopeSet *)scopeSet {
+  // the scope is replaced rather than mutated, so an identity check detects any change
+  if (_scopeSetSource != _scope) {
+    _scopeSet = _scope ? [OIDScopeSet scopeSetWithString:_scope] : nil;
+    _scopeSetSource = _scope;
+  }
+  return _scopeSet;
+}
+
 #pragma mark - Updating the state
 
 - (void)updateWithAuthorizationResponse:(nullable OIDAuthorizationResponse *)authorizationResponse
@@ -299,6 +656,7 @@ static const NSUInteger kExpiryTimeTolerance = 60;
     return;
   }
 
+  [self decodeColdPayloadIfNeeded];
   _lastAuthorizationResponse = authorizationResponse;
 
   // clears the last token response and refresh token as these now relate to an old authorization
@@ -321,10 +679,10 @@ static const NSUInteger kExpiryTimeTolerance = 60;
     // Calling updateWithTokenResponse while in an error state probably means the developer obtained
     // a new token and did the exchange without also calling updateWithAuthorizationResponse.
     // Attempts to handle gracefully, but warns the developer that this is unexpected.
-    NSLog(@"OIDAuthState:updateWithTokenResponse should not be called in an error state [%@] call"
-         "updateWithAuthorizationResponse with the result of the fresh authorization response"
-         "first",
-         _authorizationError);
+    OIDLogWarning(@"OIDAuthState:updateWithTokenResponse should not be called in an error state "
+                   "[%@] call updateWithAuthorizationResponse with the result of the fresh "
+                   "authorization response first",
+                  _authorizationError);
 
     _authorizationError = nil;
   }
@@ -338,6 +696,7 @@ static const NSUInteger kExpiryTimeTolerance = 60;
     return;
   }
 
+  [self decodeColdPayloadIfNeeded];
   _lastTokenResponse = tokenResponse;
 
   // updates the scope and refresh token if they are present on the TokenResponse.
@@ -376,22 +735,140 @@ static const NSUInteger kExpiryTimeTolerance = 60;
   if (!_refreshToken) {
     [OIDErrorUtilities raiseException:kRefreshTokenRequestException];
   }
-  return [[OIDTokenRequest alloc]
-      initWithConfiguration:_lastAuthorizationResponse.request.configuration
-                  grantType:OIDGrantTypeRefreshToken
-          authorizationCode:nil
-                redirectURL:_lastAuthorizationResponse.request.redirectURL
-                   clientID:_lastAuthorizationResponse.request.clientID
-                      scope:_lastAuthorizationResponse.request.scope
-               refreshToken:_refreshToken
-               codeVerifier:nil
-       additionalParameters:additionalParameters];
+  return [[self refreshRequestTemplate] tokenRequestWithRefreshToken:_refreshToken
+                                                 additionalParameters:additionalParameters];
+}
+
+/*! @fn refreshRequestTemplate
+    @brief Returns the refresh request template for the last authorization, compiling it if the
+        authorization has changed since it was last used.
+ */
+- (OIDTokenRefreshRequestTemplate *)refreshRequestTemplate {
+  [self decodeColdPayloadIfNeeded];
+  OIDAuthorizationRequest *authorizationRequest = _lastAuthorizationResponse.request;
+  OIDTokenRefreshRequestTemplate *requestTemplate = _refreshRequestTemplate;
+  // the authorization response is replaced rather than mutated, so an identity check detects any
+  // change of configuration or scope
+  if (requestTemplate.authorizationRequest != authorizationRequest) {
+    requestTemplate =
+        [[OIDTokenRefreshRequestTemplate alloc] initWithAuthorizationRequest:authorizationRequest];
+    _refreshRequestTemplate = requestTemplate;
+  }
+  return requestTemplate;
+}
+
+#pragma mark - Compaction
+
+/*! @fn compactConfiguration:
+    @brief Returns a configuration with the same endpoints as @c configuration but no discovery
+        document, which is shared with every other compacted state using those endpoints.
+ */
++ (nullable OIDServiceConfiguration *)compactConfiguration:
+    (nullable OIDServiceConfiguration *)configuration {
+  if (!configuration) {
+    return nil;
+  }
+  if (configuration.discoveryDocument) {
+    configuration = [[OIDServiceConfiguration alloc]
+        initWithAuthorizationEndpoint:configuration.authorizationEndpoint
+                        tokenEndpoint:configuration.tokenEndpoint
+                 registrationEndpoint:configuration.registrationEndpoint];
+  }
+  return [OIDServiceConfiguration internedConfiguration:configuration];
+}
+
+- (void)compact {
+  [self decodeColdPayloadIfNeeded];
+  OIDAuthorizationRequest *authorizationRequest = _lastAuthorizationResponse.request;
+  OIDServiceConfiguration *configuration =
+      [[self class] compactConfiguration:authorizationRequest.configuration];
+  // once the code was exchanged, its verifier is a secret nothing needs any more
+  NSString *codeVerifier = _lastTokenResponse ? nil : authorizationRequest.codeVerifier;
+  if (authorizationRequest.configuration != configuration
+      || authorizationRequest.codeVerifier != codeVerifier) {
+    authorizationRequest =
+        [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
+                                                      clientId:authorizationRequest.clientID
+                                                         scope:authorizationRequest.scope
+                                                   redirectURL:authorizationRequest.redirectURL
+                                                  responseType:authorizationRequest.responseType
+                                                         state:authorizationRequest.state
+                                                  codeVerifier:codeVerifier
+                                          additionalParameters:
+                                              authorizationRequest.additionalParameters];
+    _lastAuthorizationResponse =
+        [_lastAuthorizationResponse responseByReplacingRequest:authorizationRequest];
+  }
+
+  OIDTokenRequest *tokenRequest = _lastTokenResponse.request;
+  if (tokenRequest
+      && (tokenRequest.configuration != configuration || tokenRequest.authorizationCode
+          || tokenRequest.refreshToken || tokenRequest.codeVerifier)) {
+    // the token request was made with the authorization's configuration, or an equivalent copy
+    OIDServiceConfiguration *tokenConfiguration =
+        [tokenRequest.configuration.tokenEndpoint isEqual:configuration.tokenEndpoint]
+            ? configuration
+            : [[self class] compactConfiguration:tokenRequest.configuration];
+    // the request was already made, so its grant is only kept as a record, without its secrets
+    tokenRequest = [[OIDTokenRequest alloc] initWithConfiguration:tokenConfiguration
+                                                        grantType:tokenRequest.grantType
+                                                authorizationCode:nil
+                                                      redirectURL:tokenRequest.redirectURL
+                                                         clientID:tokenRequest.clientID
+                                                            scope:tokenRequest.scope
+                                                     refreshToken:nil
+                                                     codeVerifier:nil
+                                             additionalParameters:
+                                                 tokenRequest.additionalParameters];
+    _lastTokenResponse = [_lastTokenResponse responseByReplacingRequest:tokenRequest];
+  }
 }
 
 #pragma mark - Stateful Actions
 
 - (void)didChangeState {
   [_stateChangeDelegate didChangeState:self];
+
+  NSArray<OIDAuthStateObservation *> *observations;
+  @synchronized(_observations) {
+    observations = _observations.objectEnumerator.allObjects;
+  }
+  if (!observations.count) {
+    return;
+  }
+  OIDAuthStateSnapshot *snapshot = self.snapshot;
+  for (OIDAuthStateObservation *observation in observations) {
+    [observation postSnapshot:snapshot ofAuthState:self];
+  }
+}
+
+#pragma mark - Observers
+
+- (OIDAuthStateSnapshot *)snapshot {
+  return [[OIDAuthStateSnapshot alloc] initWithAccessToken:self.accessToken
+                                                 tokenType:self.tokenType
+                                 accessTokenExpirationDate:self.accessTokenExpirationDate
+                                                   idToken:self.idToken
+                                              refreshToken:_refreshToken
+                                                     scope:_scope
+                                        authorizationError:_authorizationError];
+}
+
+- (void)addObserver:(id<OIDAuthStateObserver>)observer queue:(nullable dispatch_queue_t)queue {
+  OIDAuthStateObservation *observation =
+      [[OIDAuthStateObservation alloc] initWithObserver:observer
+                                                  queue:queue ?: dispatch_get_main_queue()];
+  @synchronized(_observations) {
+    [[_observations objectForKey:observer] invalidate];
+    [_observations setObject:observation forKey:observer];
+  }
+}
+
+- (void)removeObserver:(id<OIDAuthStateObserver>)observer {
+  @synchronized(_observations) {
+    [[_observations objectForKey:observer] invalidate];
+    [_observations removeObjectForKey:observer];
+  }
 }
 
 - (void)setNeedsTokenRefresh {
@@ -399,12 +876,19 @@ static const NSUInteger kExpiryTimeTolerance = 60;
 }
 
 - (void)withFreshTokensPerformAction:(OIDAuthStateAction)action {
+  [self withFreshTokensPerformAction:action priority:OIDRequestPriorityDefault];
+}
+
+- (void)withFreshTokensPerformAction:(OIDAuthStateAction)action
+                            priority:(OIDRequestPriority)priority {
   if (!_refreshToken) {
     [OIDErrorUtilities raiseException:kRefreshTokenRequestException];
   }
 
-  if ([self.accessTokenExpirationDate timeIntervalSinceNow] > kExpiryTimeTolerance
-      && !_needsTokenRefresh) {
+  BOOL isFresh = [self accessTokenTimeUntilExpiration] > _tokenRefreshLeadTime;
+  // while stale tokens are in use, refreshes are retried in the background instead
+  BOOL isUsingStaleTokens = _staleTokenRetryInterval > 0 && [self isWithinStaleTokenGracePeriod];
+  if ((isFresh || isUsingStaleTokens) && !_needsTokenRefresh) {
     // access token is valid within tolerance levels, perform action
     dispatch_async(dispatch_get_main_queue(), ^() {
       action(self.accessToken, self.idToken, nil);
@@ -412,50 +896,324 @@ static const NSUInteger kExpiryTimeTolerance = 60;
   } else {
     // else, first refresh the token, then perform action
     _needsTokenRefresh = NO;
-    NSAssert(_pendingActionsSyncObject, @"_pendingActionsSyncObject cannot be nil");
-    @synchronized(_pendingActionsSyncObject) {
-      // if a token is already in the process of being refreshed, adds to pending actions
-      if (_pendingActions) {
-        [_pendingActions addObject:action];
+    [self refreshTokensAndPerformAction:action priority:priority];
+  }
+}
+
+- (void)withFreshTokensAuthorizeRequest:(NSURLRequest *)request
+                                 action:(OIDAuthStateRequestAction)action {
+  [self withFreshTokensPerformAction:^(NSString *_Nullable accessToken,
+                                       NSString *_Nullable idToken,
+                                       NSError *_Nullable error) {
+    if (!accessToken) {
+      action(nil, error);
+      return;
+    }
+    OIDDPoPProofGenerator *proofGenerator = self.proofGenerator;
+    NSString *tokenType = self.tokenType;
+    BOOL isDPoPBound = tokenType && [tokenType caseInsensitiveCompare:@"DPoP"] == NSOrderedSame;
+    if (proofGenerator && isDPoPBound) {
+      NSError *proofError;
+      NSURLRequest *authorizedRequest = [proofGenerator requestBySigningRequest:request
+                                                                    accessToken:accessToken
+                                                                          error:&proofError];
+      action(authorizedRequest, proofError);
+      return;
+    }
+    NSMutableURLRequest *authorizedRequest = [request mutableCopy];
+    [authorizedRequest setValue:[@"Bearer " stringByAppendingString:accessToken]
+             forHTTPHeaderField:@"Authorization"];
+    action(authorizedRequest, nil);
+  }];
+}
+
+/*! @fn refreshTokensAndPerformAction:priority:
+    @brief Refreshes the tokens, then performs the action, unless a refresh is already in progress
+        in which case the action is performed when it completes.
+    @param action The action to perform with the refreshed tokens.
+    @param priority How urgently the action needs the tokens. A deferred refresh is made with the
+        highest priority of the actions waiting for it.
+    @discussion If the @c connectivityMonitor reports the network is unreachable, the refresh is
+        deferred until it is reachable, and actions which wait longer than
+        @c offlineActionTimeout are performed with an error.
+ */
+- (void)refreshTokensAndPerformAction:(OIDAuthStateAction)action
+                             priority:(OIDRequestPriority)priority {
+  // the identical block is needed to find the action again if it times out
+  action = [action copy];
+  id<OIDConnectivityMonitor> connectivityMonitor = _connectivityMonitor;
+  BOOL isDeferred;
+  NSAssert(_pendingActionsSyncObject, @"_pendingActionsSyncObject cannot be nil");
+  @synchronized(_pendingActionsSyncObject) {
+    // if a token is already in the process of being refreshed, adds to pending actions
+    if (_pendingActions) {
+      [_pendingActions addObject:action];
+      _pendingRefreshPriority = MAX(_pendingRefreshPriority, priority);
+      isDeferred = _tokenRefreshDeferred;
+      if (isDeferred) {
+        [self scheduleOfflineTimeoutForAction:action];
+      }
+      return;
+    }
+
+    // creates a list of pending actions, starting with this one
+    _pendingActions = [NSMutableArray arrayWithObject:action];
+    _pendingRefreshPriority = priority;
+    isDeferred = connectivityMonitor && !connectivityMonitor.reachable;
+    _tokenRefreshDeferred = isDeferred;
+  }
+
+  if (isDeferred) {
+    OIDLogInfo(@"Deferring token refresh until the network is reachable.");
+    [self scheduleOfflineTimeoutForAction:action];
+    __weak OIDAuthState *weakSelf = self;
+    [connectivityMonitor performWhenReachable:^() {
+      [weakSelf performDeferredTokenRefresh];
+    }];
+    return;
+  }
+  [self performTokenRefresh];
+}
+
+/*! @fn performTokenRefresh
+    @brief Makes the token refresh request for the pending actions.
+ */
+- (void)performTokenRefresh {
+  OIDAuthStateSharedStore *sharedStore = _sharedStore;
+  if (sharedStore) {
+    [self refreshTokensWithSharedStore:sharedStore];
+    return;
+  }
+  OIDTokenRequest *tokenRefreshRequest = [self tokenRefreshRequest];
+  OIDLogInfo(@"Refreshing tokens at %@.", tokenRefreshRequest.configuration.tokenEndpoint);
+  [OIDAuthorizationService performTokenRequest:tokenRefreshRequest
+                          clientAuthentication:_clientAuthentication
+                                proofGenerator:_proofGenerator
+                                      priority:[self pendingRefreshPriority]
+                                      deadline:nil
+                                      callback:^(OIDTokenResponse *_Nullable response,
+                                                 NSError *_Nullable error) {
+    dispatch_async(dispatch_get_main_queue(), ^() {
+      [self didCompleteTokenRefreshWithResponse:response error:error];
+    });
+  }];
+}
+
+/*! @fn pendingRefreshPriority
+    @brief The priority to make the refresh for the pending actions with.
+ */
+- (OIDRequestPriority)pendingRefreshPriority {
+  @synchronized(_pendingActionsSyncObject) {
+    return _pendingRefreshPriority;
+  }
+}
+
+#pragma mark - Offline Actions
+
+/*! @fn performDeferredTokenRefresh
+    @brief Called once the network is reachable again, to make a single refresh for every action
+        which is still waiting.
+ */
+- (void)performDeferredTokenRefresh {
+  @synchronized(_pendingActionsSyncObject) {
+    _tokenRefreshDeferred = NO;
+    if (!_pendingActions.count) {
+      // every waiting action timed out
+      _pendingActions = nil;
+      return;
+    }
+  }
+  [self performTokenRefresh];
+}
+
+/*! @fn scheduleOfflineTimeoutForAction:
+    @brief Performs the action with an error if it is still waiting for the network after
+        @c offlineActionTimeout.
+    @param action The pending action, which must be the identical block in @c _pendingActions.
+ */
+- (void)scheduleOfflineTimeoutForAction:(OIDAuthStateAction)action {
+  if (_offlineActionTimeout <= 0) {
+    return;
+  }
+  __weak OIDAuthState *weakSelf = self;
+  [[OIDClock sharedClock] performAfterDelay:_offlineActionTimeout block:^() {
+    OIDAuthState *strongSelf = weakSelf;
+    if (!strongSelf) {
+      return;
+    }
+    @synchronized(strongSelf->_pendingActionsSyncObject) {
+      NSUInteger index = [strongSelf->_pendingActions indexOfObjectIdenticalTo:action];
+      // once the deferred refresh has started, the action waits for it instead
+      if (!strongSelf->_tokenRefreshDeferred || index == NSNotFound) {
         return;
       }
+      [strongSelf->_pendingActions removeObjectAtIndex:index];
+    }
+    NSError *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeNetworkError
+                                      underlyingError:nil
+                                          description:kOfflineActionTimeoutDescription];
+    action(strongSelf.accessToken, strongSelf.idToken, error);
+  }];
+}
+
+/*! @fn didCompleteTokenRefreshWithResponse:error:
+    @brief Updates the state with the result of a token refresh, and performs the pending actions.
+    @param response The token response, if the refresh succeeded.
+    @param error The error, if the refresh failed.
+    @discussion Called on the main thread. If both @c response and @c error are nil, the state was
+        already updated and only the pending actions are performed.
+ */
+- (void)didCompleteTokenRefreshWithResponse:(nullable OIDTokenResponse *)response
+                                      error:(nullable NSError *)error {
+  // update OIDAuthState based on response
+  if (response) {
+    _staleTokenRetryInterval = 0;
+    NSString *idToken = response.idToken;
+    if (idToken && ![idToken isEqualToString:[self idTokenIgnoringError]]) {
+      // only a newly issued ID token's issue time is a sample of the server's clock
+      OIDClockSkewEstimator *estimator = [OIDClockSkewEstimator sharedEstimator];
+      NSURL *issuer =
+          [OIDClockSkewEstimator issuerForConfiguration:response.request.configuration];
+      [estimator recordIssuedAtOfIDToken:idToken forIssuer:issuer];
+    }
+    [self updateWithTokenResponse:response error:nil];
+  } else if (error) {
+    if (error.domain == OIDOAuthTokenErrorDomain) {
+      _staleTokenRetryInterval = 0;
+      [self updateWithAuthorizationError:error];
+    } else {
+      if ([_errorDelegate respondsToSelector:
+          @selector(authState:didEncounterTransientError:)]) {
+        [_errorDelegate authState:self didEncounterTransientError:error];
+      }
+      if ([self isWithinStaleTokenGracePeriod]) {
+        // the pending actions get the last tokens, as if the refresh had not been needed
+        OIDLogWarning(@"Using stale tokens after a failed refresh: %@", error);
+        [self scheduleStaleTokenRetry];
+        if ([_errorDelegate respondsToSelector:
+            @selector(authState:didUseStaleTokensAfterTransientError:)]) {
+          [_errorDelegate authState:self didUseStaleTokensAfterTransientError:error];
+        }
+        error = nil;
+      } else {
+        _staleTokenRetryInterval = 0;
+      }
+    }
+  }
 
-      // creates a list of pending actions, starting with this one
-      _pendingActions = [NSMutableArray arrayWithObject:action];
+  // nil the pending queue and process everything that was queued up
+  NSArray *actionsToProcess;
+  @synchronized(_pendingActionsSyncObject) {
+    actionsToProcess = _pendingActions;
+    _pendingActions = nil;
+  }
+  for (OIDAuthStateAction actionToProcess in actionsToProcess) {
+    actionToProcess(self.accessToken, self.idToken, error);
+  }
+}
+
+#pragma mark - Stale Token Grace Period
+
+/*! @fn isWithinStaleTokenGracePeriod
+    @brief Whether the access token expired no longer than @c staleTokenGracePeriod ago, and may
+        be used if it can't be refreshed.
+ */
+- (BOOL)isWithinStaleTokenGracePeriod {
+  return _staleTokenGracePeriod > 0
+      && self.accessToken
+      && [self accessTokenTimeUntilExpiration] > -_staleTokenGracePeriod;
+}
+
+/*! @fn scheduleStaleTokenRetry
+    @brief Schedules a background refresh, backing off exponentially while refreshes keep failing.
+    @discussion Called on the main thread.
+ */
+- (void)scheduleStaleTokenRetry {
+  _staleTokenRetryInterval = _staleTokenRetryInterval > 0
+      ? MIN(_staleTokenRetryInterval * 2, _staleTokenRetryMaximumInterval)
+      : _staleTokenRetryInitialInterval;
+  __weak OIDAuthState *weakSelf = self;
+  [[OIDClock sharedClock] performAfterDelay:_staleTokenRetryInterval block:^() {
+    OIDAuthState *strongSelf = weakSelf;
+    if (strongSelf && strongSelf->_staleTokenRetryInterval > 0) {
+      // actions are being performed with the stale tokens, so nobody waits for this
+      [strongSelf refreshTokensAndPerformAction:^(NSString *_Nullable accessToken,
+                                                  NSString *_Nullable idToken,
+                                                  NSError *_Nullable error) {}
+                                       priority:OIDRequestPriorityBackground];
     }
+  }];
+}
+
+#pragma mark - Shared Store
 
-    // refresh the tokens
-    OIDTokenRequest *tokenRefreshRequest = [self tokenRefreshRequest];
-    [OIDAuthorizationService performTokenRequest:tokenRefreshRequest
-                                        callback:^(OIDTokenResponse *_Nullable response,
-                                                   NSError *_Nullable error) {
-      dispatch_async(dispatch_get_main_queue(), ^() {
-        // update OIDAuthState based on response
-        if (response) {
-          [self updateWithTokenResponse:response error:nil];
-        } else {
-          if (error.domain == OIDOAuthTokenErrorDomain) {
-            [self updateWithAuthorizationError:error];
-          } else {
-            if ([_errorDelegate respondsToSelector:
-                @selector(authState:didEncounterTransientError:)]) {
-              [_errorDelegate authState:self didEncounterTransientError:error];
-            }
+/*! @fn refreshTokensWithSharedStore:
+    @brief Refreshes the tokens while holding the shared store's cross-process refresh lock,
+        adopting the stored tokens instead if another process already refreshed them.
+    @param sharedStore The store to coordinate the refresh with.
+ */
+- (void)refreshTokensWithSharedStore:(OIDAuthStateSharedStore *)sharedStore {
+  // acquiring the lock can block for as long as another process's refresh takes
+  dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^() {
+    BOOL locked = [sharedStore lockForRefresh];
+    OIDAuthState *storedState = locked ? [sharedStore readAuthState] : nil;
+    dispatch_async(dispatch_get_main_queue(), ^() {
+      if ([self adoptTokensFromSharedAuthState:storedState]) {
+        [sharedStore unlockForRefresh];
+        [self didCompleteTokenRefreshWithResponse:nil error:nil];
+        return;
+      }
+
+      OIDTokenRequest *tokenRefreshRequest = [self tokenRefreshRequest];
+      OIDLogInfo(@"Refreshing tokens at %@.", tokenRefreshRequest.configuration.tokenEndpoint);
+      [OIDAuthorizationService performTokenRequest:tokenRefreshRequest
+                              clientAuthentication:self.clientAuthentication
+                                    proofGenerator:self.proofGenerator
+                                          priority:[self pendingRefreshPriority]
+                                          deadline:nil
+                                          callback:^(OIDTokenResponse *_Nullable response,
+                                                     NSError *_Nullable error) {
+        [self didCompleteTokenRefreshWithResponse:response error:error];
+        // an authorization error is written too, so other processes stop using the grant
+        if (locked) {
+          if (response || error.domain == OIDOAuthTokenErrorDomain) {
+            [sharedStore writeAuthState:self error:NULL];
           }
+          [sharedStore unlockForRefresh];
         }
+      }];
+    });
+  });
+}
 
-        // nil the pending queue and process everything that was queued up
-        NSArray *actionsToProcess;
-        @synchronized(_pendingActionsSyncObject) {
-          actionsToProcess = _pendingActions;
-          _pendingActions = nil;
-        }
-        for (OIDAuthStateAction actionToProcess in actionsToProcess) {
-          actionToProcess(self.accessToken, self.idToken, error);
-        }
-      });
-    }];
+/*! @fn adoptTokensFromSharedAuthState:
+    @brief Takes the tokens from a state written by another process, if they are newer.
+    @param storedState The state read from the shared store.
+    @return YES if the stored state had a fresh access token which was adopted, and no refresh is
+        needed. If only the refresh token was rotated, it is adopted but NO is returned.
+ */
+- (BOOL)adoptTokensFromSharedAuthState:(nullable OIDAuthState *)storedState {
+  if (!storedState || storedState.authorizationError) {
+    return NO;
   }
+  BOOL refreshTokenRotated = storedState.refreshToken
+      && !OIDIsEqualIncludingNil(storedState.refreshToken, _refreshToken);
+  // the stored access token must differ from ours, otherwise a refresh forced with
+  // setNeedsTokenRefresh (for example after the token was rejected) would never happen
+  BOOL hasFreshAccessToken = storedState.accessToken
+      && !OIDIsEqualIncludingNil(storedState.accessToken, self.accessToken)
+      && [storedState accessTokenTimeUntilExpiration] > _tokenRefreshLeadTime;
+  if (!refreshTokenRotated && !hasFreshAccessToken) {
+    return NO;
+  }
+
+  [self decodeColdPayloadIfNeeded];
+  _lastTokenResponse = storedState.lastTokenResponse;
+  _refreshToken = storedState.refreshToken;
+  _scope = storedState.scope;
+  _authorizationError = nil;
+  [self didChangeState];
+  return hasFreshAccessToken;
 }
 
 #pragma mark -
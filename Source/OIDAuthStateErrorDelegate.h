@@ -57,6 +57,16 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)authState:(OIDAuthState *)state didEncounterTransientError:(NSError *)error;
 
+/*! @brief Called when a token refresh failed with a transient error, and the last tokens were
+        used instead, as allowed by @c OIDAuthState.staleTokenGracePeriod.
+    @param state The @c OIDAuthState which used stale tokens.
+    @param error The transient error, which was also passed to
+        @c authState:didEncounterTransientError:.
+    @discussion The refresh is retried in the background until it succeeds or the grace period
+        ends, and this method is called again each time a retry fails within the grace period.
+ */
+- (void)authState:(OIDAuthState *)state didUseStaleTokensAfterTransientError:(NSError *)error;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,45 @@
+/*! @file OIDAuthStateObserver.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OIDAuthState;
+@class OIDAuthStateSnapshot;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @protocol OIDAuthStateObserver
+    @brief An observer of the changes to an @c OIDAuthState, registered with
+        @c OIDAuthState.addObserver:queue:.
+    @discussion Unlike @c OIDAuthStateChangeDelegate, any number of observers can be registered,
+        and they are notified asynchronously, so a slow observer never delays a token refresh.
+ */
+@protocol OIDAuthStateObserver <NSObject>
+
+/*! @fn authState:didChangeToSnapshot:
+    @brief Called on the observer's queue after the state changes.
+    @param authState The state that changed.
+    @param snapshot The state as of its latest change. When the state changes several times
+        before the observer's queue gets to the notification, the observer is called once, with
+        the snapshot of the last change.
+ */
+- (void)authState:(OIDAuthState *)authState didChangeToSnapshot:(OIDAuthStateSnapshot *)snapshot;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,99 @@
+/*! @file OIDAuthStateSharedStore.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OIDAuthState;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDAuthStateSharedStore
+    @brief A file-backed store for an archived @c OIDAuthState which is shared between processes,
+        such as an app and its extensions.
+    @discussion Token refreshes performed by an @c OIDAuthState that has a @c sharedStore are
+        serialized across every process using a store for the same file. The process holding the
+        refresh lock re-reads the stored state before refreshing; if another process already
+        refreshed, its tokens are adopted instead of making another token request. This avoids
+        duplicate token endpoint traffic, and @c invalid_grant errors when the authorization server
+        rotates refresh tokens.
+
+        The lock is an advisory @c flock(2) on a sibling ".lock" file, so it is released by the
+        kernel if the process holding it exits, and works on any POSIX platform. The file must be
+        in a location all participating processes can access, such as an app group container.
+ */
+@interface OIDAuthStateSharedStore : NSObject
+
+/*! @property fileURL
+    @brief The location of the archived @c OIDAuthState.
+ */
+@property(nonatomic, readonly) NSURL *fileURL;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use @c initWithFileURL:.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn initWithFileURL:
+    @brief Designated initializer.
+    @param fileURL The file URL of the archived @c OIDAuthState. The refresh lock is created next
+        to it, with a ".lock" suffix.
+ */
+- (nullable instancetype)initWithFileURL:(NSURL *)fileURL NS_DESIGNATED_INITIALIZER;
+
+/*! @fn readAuthState
+    @brief Reads the most recently written @c OIDAuthState.
+    @return The stored auth state, or nil if nothing was stored or the archive could not be read.
+    @discussion Writes replace the file atomically, so reads never observe a partial archive and
+        don't need to hold the refresh lock.
+ */
+- (nullable OIDAuthState *)readAuthState;
+
+/*! @fn writeAuthState:error:
+    @brief Archives the given @c OIDAuthState to the store, atomically replacing any previous one.
+    @param authState The auth state to store.
+    @param error If the state could not be written, the underlying file system error.
+    @return YES if the state was written.
+    @discussion Call this when the state is first created, and from
+        @c OIDAuthStateChangeDelegate.didChangeState: if you change it outside a refresh. States
+        refreshed through a store are written back to it automatically.
+ */
+- (BOOL)writeAuthState:(OIDAuthState *)authState error:(NSError **_Nullable)error;
+
+/*! @fn lockForRefresh
+    @brief Acquires the cross-process refresh lock, blocking until it is available.
+    @return YES if the lock was acquired, NO if the lock file could not be opened.
+    @discussion Must not be called on the main thread. Balance each successful call with
+        @c unlockForRefresh, which may be called from any thread.
+ */
+- (BOOL)lockForRefresh;
+
+/*! @fn tryLockForRefresh
+    @brief Acquires the cross-process refresh lock if it is immediately available.
+    @return YES if the lock was acquired.
+ */
+- (BOOL)tryLockForRefresh;
+
+/*! @fn unlockForRefresh
+    @brief Releases the refresh lock acquired by @c lockForRefresh or @c tryLockForRefresh.
+ */
+- (void)unlockForRefresh;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,140 @@
+/*! @file OIDAuthStateSharedStore.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDAuthStateSharedStore.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#import "OIDAuthState.h"
+#import "OIDDefines.h"
+
+/*! @var kLockFileSuffix
+    @brief Suffix appended to the store's file path to create the refresh lock file.
+ */
+static NSString *const kLockFileSuffix = @".lock";
+
+@implementation OIDAuthStateSharedStore {
+  /*! @var _lockFileDescriptor
+      @brief The open lock file, or -1 if it hasn't been opened yet.
+   */
+  int _lockFileDescriptor;
+
+  /*! @var _localLock
+      @brief Serializes refreshes within this process. @c flock(2) locks are held per open file
+          description, so a second lock request on the same descriptor would succeed immediately.
+          A semaphore is used rather than an @c NSLock as refreshes release the lock from a
+          different thread than the one that acquired it.
+   */
+  dispatch_semaphore_t _localLock;
+}
+
+- (nullable instancetype)init OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithFileURL:));
+
+- (nullable instancetype)initWithFileURL:(NSURL *)fileURL {
+  self = [super init];
+  if (self) {
+    _fileURL = [fileURL copy];
+    _lockFileDescriptor = -1;
+    _localLock = dispatch_semaphore_create(1);
+  }
+  return self;
+}
+
+- (void)dealloc {
+  if (_lockFileDescriptor >= 0) {
+    close(_lockFileDescriptor);
+  }
+}
+
+#pragma mark - Reading and writing
+
+- (nullable OIDAuthState *)readAuthState {
+  NSData *data = [NSData dataWithContentsOfURL:_fileURL];
+  if (!data) {
+    return nil;
+  }
+  id authState = nil;
+  @try {
+    authState = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  } @catch (NSException *exception) {
+    // a corrupt archive is treated the same as a missing one
+    return nil;
+  }
+  if (![authState isKindOfClass:[OIDAuthState class]]) {
+    return nil;
+  }
+  return authState;
+}
+
+- (BOOL)writeAuthState:(OIDAuthState *)authState error:(NSError **_Nullable)error {
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:authState];
+  return [data writeToURL:_fileURL options:NSDataWritingAtomic error:error];
+}
+
+#pragma mark - Refresh lock
+
+/*! @fn openLockFileIfNeeded
+    @brief Opens the lock file, creating it if needed.
+    @return YES if the lock file is open.
+ */
+- (BOOL)openLockFileIfNeeded {
+  if (_lockFileDescriptor >= 0) {
+    return YES;
+  }
+  NSString *lockPath = [_fileURL.path stringByAppendingString:kLockFileSuffix];
+  _lockFileDescriptor = open(lockPath.fileSystemRepresentation, O_RDWR | O_CREAT, 0600);
+  return _lockFileDescriptor >= 0;
+}
+
+- (BOOL)lockForRefresh {
+  dispatch_semaphore_wait(_localLock, DISPATCH_TIME_FOREVER);
+  if (![self openLockFileIfNeeded]) {
+    dispatch_semaphore_signal(_localLock);
+    return NO;
+  }
+  int result;
+  do {
+    result = flock(_lockFileDescriptor, LOCK_EX);
+  } while (result != 0 && errno == EINTR);
+  if (result != 0) {
+    dispatch_semaphore_signal(_localLock);
+    return NO;
+  }
+  return YES;
+}
+
+- (BOOL)tryLockForRefresh {
+  if (dispatch_semaphore_wait(_localLock, DISPATCH_TIME_NOW) != 0) {
+    return NO;
+  }
+  if (![self openLockFileIfNeeded] || flock(_lockFileDescriptor, LOCK_EX | LOCK_NB) != 0) {
+    dispatch_semaphore_signal(_localLock);
+    return NO;
+  }
+  return YES;
+}
+
+- (void)unlockForRefresh {
+  flock(_lockFileDescriptor, LOCK_UN);
+  dispatch_semaphore_signal(_localLock);
+}
+
+@end
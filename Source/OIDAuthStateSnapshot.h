@@ -0,0 +1,97 @@
+/*! @file OIDAuthStateSnapshot.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDAuthStateSnapshot
+    @brief An immutable copy of the tokens and status of an @c OIDAuthState at one point in time,
+        which may be read on any thread.
+    @see OIDAuthStateObserver
+ */
+@interface OIDAuthStateSnapshot : NSObject <NSCopying>
+
+/*! @property accessToken
+    @brief The access token, or nil if there isn't one or the state is invalid.
+ */
+@property(nonatomic, readonly, nullable) NSString *accessToken;
+
+/*! @property tokenType
+    @brief The type of the access token.
+ */
+@property(nonatomic, readonly, nullable) NSString *tokenType;
+
+/*! @property accessTokenExpirationDate
+    @brief The approximate expiration date & time of the access token.
+ */
+@property(nonatomic, readonly, nullable) NSDate *accessTokenExpirationDate;
+
+/*! @property idToken
+    @brief The ID token, or nil if there isn't one or the state is invalid.
+ */
+@property(nonatomic, readonly, nullable) NSString *idToken;
+
+/*! @property refreshToken
+    @brief The most recent refresh token received from the server.
+ */
+@property(nonatomic, readonly, nullable) NSString *refreshToken;
+
+/*! @property scope
+    @brief The scope of the current authorization grant.
+ */
+@property(nonatomic, readonly, nullable) NSString *scope;
+
+/*! @property authorizationError
+    @brief The authorization error that invalidated the state, if any.
+ */
+@property(nonatomic, readonly, nullable) NSError *authorizationError;
+
+/*! @property isAuthorized
+    @brief Whether the state was not known to be invalid, as per @c OIDAuthState.isAuthorized.
+ */
+@property(nonatomic, readonly) BOOL isAuthorized;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use the designated initializer.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn initWithAccessToken:tokenType:accessTokenExpirationDate:idToken:refreshToken:scope:authorizationError:
+    @brief Designated initializer.
+    @param accessToken The access token.
+    @param tokenType The type of the access token.
+    @param accessTokenExpirationDate The expiration date of the access token.
+    @param idToken The ID token.
+    @param refreshToken The refresh token.
+    @param scope The granted scope.
+    @param authorizationError The authorization error that invalidated the state, if any.
+ */
+- (instancetype)initWithAccessToken:(nullable NSString *)accessToken
+                          tokenType:(nullable NSString *)tokenType
+          accessTokenExpirationDate:(nullable NSDate *)accessTokenExpirationDate
+                            idToken:(nullable NSString *)idToken
+                       refreshToken:(nullable NSString *)refreshToken
+                              scope:(nullable NSString *)scope
+                 authorizationError:(nullable NSError *)authorizationError
+    NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,94 @@
+/*! @file OIDAuthStateSnapshot.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDAuthStateSnapshot.h"
+
+#import "OIDDefines.h"
+#import "OIDLogging.h"
+
+@implementation OIDAuthStateSnapshot
+
+@synthesize accessToken = _accessToken;
+@synthesize tokenType = _tokenType;
+@synthesize accessTokenExpirationDate = _accessTokenExpirationDate;
+@synthesize idToken = _idToken;
+@synthesize refreshToken = _refreshToken;
+@synthesize scope = _scope;
+@synthesize authorizationError = _authorizationError;
+
+- (nullable instancetype)init
+    OID_UNAVAILABLE_USE_INITIALIZER(
+        @selector(initWithAccessToken:
+                            tokenType:
+            accessTokenExpirationDate:
+                              idToken:
+                         refreshToken:
+                                scope:
+                   authorizationError:)
+    );
+
+- (instancetype)initWithAccessToken:(nullable NSString *)accessToken
+                          tokenType:(nullable NSString *)tokenType
+          accessTokenExpirationDate:(nullable NSDate *)accessTokenExpirationDate
+                            idToken:(nullable NSString *)idToken
+                       refreshToken:(nullable NSString *)refreshToken
+                              scope:(nullable NSString *)scope
+                 authorizationError:(nullable NSError *)authorizationError {
+  self = [super init];
+  if (self) {
+    _accessToken = [accessToken copy];
+    _tokenType = [tokenType copy];
+    _accessTokenExpirationDate = [accessTokenExpirationDate copy];
+    _idToken = [idToken copy];
+    _refreshToken = [refreshToken copy];
+    _scope = [scope copy];
+    _authorizationError = authorizationError;
+  }
+  return self;
+}
+
+- (BOOL)isAuthorized {
+  return !_authorizationError && (_accessToken || _idToken);
+}
+
+#pragma mark - NSObject overrides
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, isAuthorized: %@, accessToken: \"%@\", "
+                                     "accessTokenExpirationDate: %@, idToken: \"%@\", "
+                                     "refreshToken: \"%@\", scope: \"%@\", "
+                                     "authorizationError: %@>",
+                                    NSStringFromClass([self class]),
+                                    self,
+                                    self.isAuthorized ? @"YES" : @"NO",
+                                    OIDLogRedact(_accessToken),
+                                    _accessTokenExpirationDate,
+                                    OIDLogRedact(_idToken),
+                                    OIDLogRedact(_refreshToken),
+                                    _scope,
+                                    _authorizationError];
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(nullable NSZone *)zone {
+  // immutable
+  return self;
+}
+
+@end
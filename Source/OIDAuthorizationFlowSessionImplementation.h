@@ -0,0 +1,79 @@
+/*! @file OIDAuthorizationFlowSessionImplementation.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "OIDAuthorizationService.h"
+
+@class OIDAuthorizationRequest;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDAuthorizationFlowSessionImplementation
+    @internal
+    @brief The UI-independent part of an authorization flow session: matches the redirect URL
+        against the request, validates the response and invokes the pending callback.
+    @discussion Presenting the request to the user is left to subclasses, such as the
+        @c SFSafariViewController session in OIDAuthorizationService+IOS.m, which override
+        @c dismissUserAgentWithCompletion: to dismiss whatever they presented.
+ */
+@interface OIDAuthorizationFlowSessionImplementation : NSObject <OIDAuthorizationFlowSession>
+
+/*! @property request
+    @brief The authorization request this session is waiting for a response to.
+ */
+@property(nonatomic, readonly) OIDAuthorizationRequest *request;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use @c initWithRequest:.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn initWithRequest:
+    @brief Designated initializer.
+    @param request The authorization request.
+ */
+- (nullable instancetype)initWithRequest:(OIDAuthorizationRequest *)request
+    NS_DESIGNATED_INITIALIZER;
+
+/*! @fn startWithCallback:
+    @brief Starts waiting for the authorization response.
+    @param callback The method called when the flow has completed, failed or been cancelled.
+    @discussion Subclasses present the request's @c authorizationRequestURL after calling super.
+ */
+- (void)startWithCallback:(OIDAuthorizationCallback)callback;
+
+/*! @fn dismissUserAgentWithCompletion:
+    @brief Dismisses the user agent that was presenting the request, if any.
+    @param completion Called once the user agent was dismissed.
+    @discussion The base implementation has no user agent, and calls @c completion immediately.
+ */
+- (void)dismissUserAgentWithCompletion:(void (^)(void))completion;
+
+/*! @fn didFinishWithResponse:error:
+    @brief Invokes the pending callback and performs cleanup.
+    @param response The authorization response, if any to return to the callback.
+    @param error The error, if any, to return to the callback.
+ */
+- (void)didFinishWithResponse:(nullable OIDAuthorizationResponse *)response
+                        error:(nullable NSError *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -139,7 +139,10 @@ NS_ASSUME_NONNULL_BEGIN
     @param redirectURL The client's redirect URI.
     @param responseType The expected response type.
     @param additionalParameters The client's additional authorization parameters.
+    @return The request, or nil if a scope is invalid.
     @remarks This convenience initializer generates a state parameter automatically.
+    @discussion Scopes are validated as by the initializer taking an error. An invalid scope fails
+        an assertion in debug builds, and is logged in release builds.
  */
 - (nullable instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
                 clientId:(NSString *)clientID
@@ -148,6 +151,26 @@ NS_ASSUME_NONNULL_BEGIN
             responseType:(NSString *)responseType
     additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters;
 
+/*! @fn initWithConfiguration:clientId:scopes:redirectURL:responseType:additionalParameters:error:
+    @brief Creates an authorization request, validating the scopes.
+    @param configuration The service's configuration.
+    @param clientID The client identifier.
+    @param scopes An array of scopes to combine into a single scope string per the OAuth2 spec.
+    @param redirectURL The client's redirect URI.
+    @param responseType The expected response type.
+    @param additionalParameters The client's additional authorization parameters.
+    @param error If a scope is invalid, an error with the code @c OIDErrorCodeInvalidScope.
+    @return The request, or nil if a scope is invalid.
+    @remarks This convenience initializer generates a state parameter automatically.
+ */
+- (nullable instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
+                clientId:(NSString *)clientID
+                  scopes:(nullable NSArray<NSString *> *)scopes
+             redirectURL:(NSURL *)redirectURL
+            responseType:(NSString *)responseType
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters
+                   error:(NSError **_Nullable)error;
+
 /*! @fn initWithConfiguration:clientId:scope:redirectURL:responseType:state:codeVerifier:additionalParameters:
     @brief Designated initializer.
     @param configuration The service's configuration.
@@ -19,6 +19,7 @@
 #import "OIDAuthorizationRequest.h"
 
 #import "OIDDefines.h"
+#import "OIDLogging.h"
 #import "OIDScopeUtilities.h"
 #import "OIDServiceConfiguration.h"
 #import "OIDTokenUtilities.h"
@@ -131,9 +132,38 @@ static NSUInteger const kCodeVerifierBytes = 32;
              redirectURL:(NSURL *)redirectURL
             responseType:(NSString *)responseType
     additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters {
+  NSError *error;
+  self = [self initWithConfiguration:configuration
+                            clientId:clientID
+                              scopes:scopes
+                         redirectURL:redirectURL
+                        responseType:responseType
+                additionalParameters:additionalParameters
+                               error:&error];
+  if (error) {
+    NSAssert(NO, @"%@", error.localizedFailureReason);
+    OIDLogWarning(@"Not creating authorization request: %@", error.localizedFailureReason);
+  }
+  return self;
+}
+
+- (nullable instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
+                clientId:(NSString *)clientID
+                  scopes:(nullable NSArray<NSString *> *)scopes
+             redirectURL:(NSURL *)redirectURL
+            responseType:(NSString *)responseType
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters
+                   error:(NSError **_Nullable)error {
+  NSString *scope;
+  if (scopes) {
+    scope = [OIDScopeUtilities scopesWithArray:scopes error:error];
+    if (!scope) {
+      return nil;
+    }
+  }
   return [self initWithConfiguration:configuration
                             clientId:clientID
-                               scope:[OIDScopeUtilities scopesWithArray:scopes]
+                               scope:scope
                          redirectURL:redirectURL
                         responseType:responseType
                                state:[[self class] generateState]
@@ -200,10 +230,19 @@ static NSUInteger const kCodeVerifierBytes = 32;
 #pragma mark - NSObject overrides
 
 - (NSString *)description {
-  return [NSString stringWithFormat:@"<%@: %p, request: %@>",
+  return [NSString stringWithFormat:@"<%@: %p, URL: %@, responseType: %@, clientID: %@, scope: "
+                                     "\"%@\", redirectURL: %@, state: \"%@\", codeVerifier: %@, "
+                                     "additionalParameters: %@>",
                                     NSStringFromClass([self class]),
                                     self,
-                                    self.authorizationRequestURL];
+                                    _configuration.authorizationEndpoint,
+                                    _responseType,
+                                    _clientID,
+                                    _scope,
+                                    _redirectURL,
+                                    _state,
+                                    OIDLogRedact(_codeVerifier),
+                                    OIDLogRedactParameters(_additionalParameters)];
 }
 
 #pragma mark - CodeVerifier/state Generation Methods
@@ -0,0 +1,164 @@
+/*! @file OIDAuthorizationRequestTemplate.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OIDAuthorizationRequest;
+@class OIDRequestObjectBuilder;
+@class OIDServiceConfiguration;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDAuthorizationRequestTemplate
+    @brief A reusable, precompiled authorization request for a particular client configuration.
+    @discussion The parameters which are the same for every login (the response type, client ID,
+        redirect URI, scope and any additional parameters) are encoded into the authorization
+        endpoint URL once, when the template is created. Requests created from the template build
+        their @c authorizationRequestURL by appending only the per-flow @c state and PKCE
+        parameters to that prefix.
+
+        With a @c requestObjectBuilder, the parameters are instead sent in a signed request
+        object. The template then prepares the constant claims once, and each request signs them
+        along with its @c state and PKCE parameters when it's created. Its URL is a prefix with
+        only @c response_type, @c client_id and @c scope, followed by the request object. If
+        signing fails no request is created, so the parameters are never sent unsigned instead.
+
+        Templates are immutable and can be shared between threads. Requests created from a
+        template are otherwise ordinary @c OIDAuthorizationRequest objects, and are archived as
+        such.
+ */
+@interface OIDAuthorizationRequestTemplate : NSObject
+
+/*! @property configuration
+    @brief The service's configuration.
+ */
+@property(nonatomic, readonly) OIDServiceConfiguration *configuration;
+
+/*! @property responseType
+    @brief The expected response type.
+ */
+@property(nonatomic, readonly) NSString *responseType;
+
+/*! @property clientID
+    @brief The client identifier.
+ */
+@property(nonatomic, readonly) NSString *clientID;
+
+/*! @property scope
+    @brief The space-delimited scope string requested.
+ */
+@property(nonatomic, readonly, nullable) NSString *scope;
+
+/*! @property redirectURL
+    @brief The client's redirect URI.
+ */
+@property(nonatomic, readonly) NSURL *redirectURL;
+
+/*! @property additionalParameters
+    @brief The client's additional authorization parameters, sent with every request.
+ */
+@property(nonatomic, readonly, nullable) NSDictionary<NSString *, NSString *> *additionalParameters;
+
+/*! @property requestObjectBuilder
+    @brief Signs the request objects of requests created from the template, or nil to send the
+        parameters in the URL.
+ */
+@property(nonatomic, readonly, nullable) OIDRequestObjectBuilder *requestObjectBuilder;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use the designated initializer.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn initWithConfiguration:clientId:scope:redirectURL:responseType:additionalParameters:
+    @brief Creates a template which sends the parameters in the URL.
+    @param configuration The service's configuration.
+    @param clientID The client identifier.
+    @param scope A space-delimited scope string per the OAuth2 spec.
+    @param redirectURL The client's redirect URI.
+    @param responseType The expected response type.
+    @param additionalParameters The client's additional authorization parameters.
+ */
+- (instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
+                clientId:(NSString *)clientID
+                   scope:(nullable NSString *)scope
+             redirectURL:(NSURL *)redirectURL
+            responseType:(NSString *)responseType
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters;
+
+/*! @fn initWithConfiguration:clientId:scope:redirectURL:responseType:additionalParameters:requestObjectBuilder:
+    @brief Designated initializer.
+    @param configuration The service's configuration.
+    @param clientID The client identifier.
+    @param scope A space-delimited scope string per the OAuth2 spec.
+    @param redirectURL The client's redirect URI.
+    @param responseType The expected response type.
+    @param additionalParameters The client's additional authorization parameters.
+    @param requestObjectBuilder Signs the parameters as a request object, or nil to send them in
+        the URL.
+ */
+- (instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
+                clientId:(NSString *)clientID
+                   scope:(nullable NSString *)scope
+             redirectURL:(NSURL *)redirectURL
+            responseType:(NSString *)responseType
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters
+    requestObjectBuilder:(nullable OIDRequestObjectBuilder *)requestObjectBuilder
+    NS_DESIGNATED_INITIALIZER;
+
+/*! @fn authorizationRequest
+    @brief Creates an authorization request with a newly generated state and PKCE code verifier.
+    @return The request, or nil if its request object could not be signed. Use
+        @c authorizationRequestWithError: to learn why.
+ */
+- (nullable OIDAuthorizationRequest *)authorizationRequest;
+
+/*! @fn authorizationRequestWithError:
+    @brief Creates an authorization request with a newly generated state and PKCE code verifier.
+    @param error If the request's request object could not be signed, the reason.
+    @return The request, or nil if its request object could not be signed.
+ */
+- (nullable OIDAuthorizationRequest *)authorizationRequestWithError:(NSError **_Nullable)error;
+
+/*! @fn authorizationRequestWithState:codeVerifier:
+    @brief Creates an authorization request with the given per-flow parameters.
+    @param state An opaque value used to maintain state between the request and callback.
+    @param codeVerifier The PKCE code verifier, or nil to not use PKCE.
+    @return The request, or nil if its request object could not be signed. Use
+        @c authorizationRequestWithState:codeVerifier:error: to learn why.
+ */
+- (nullable OIDAuthorizationRequest *)
+    authorizationRequestWithState:(nullable NSString *)state
+                     codeVerifier:(nullable NSString *)codeVerifier;
+
+/*! @fn authorizationRequestWithState:codeVerifier:error:
+    @brief Creates an authorization request with the given per-flow parameters.
+    @param state An opaque value used to maintain state between the request and callback.
+    @param codeVerifier The PKCE code verifier, or nil to not use PKCE.
+    @param error If the request's request object could not be signed, the reason.
+    @return The request, or nil if its request object could not be signed.
+ */
+- (nullable OIDAuthorizationRequest *)
+    authorizationRequestWithState:(nullable NSString *)state
+                     codeVerifier:(nullable NSString *)codeVerifier
+                            error:(NSError **_Nullable)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
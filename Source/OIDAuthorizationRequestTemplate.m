@@ -0,0 +1,373 @@
+/*! @file OIDAuthorizationRequestTemplate.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDAuthorizationRequestTemplate.h"
+
+#import "OIDAuthorizationRequest.h"
+#import "OIDDefines.h"
+#import "OIDRequestObjectBuilder.h"
+#import "OIDServiceConfiguration.h"
+#import "OIDURLQueryComponent.h"
+
+/*! @var kResponseTypeParameter
+    @brief The response type request parameter.
+ */
+static NSString *const kResponseTypeParameter = @"response_type";
+
+/*! @var kClientIDParameter
+    @brief The client ID request parameter.
+ */
+static NSString *const kClientIDParameter = @"client_id";
+
+/*! @var kRedirectURLParameter
+    @brief The redirect URI request parameter.
+ */
+static NSString *const kRedirectURLParameter = @"redirect_uri";
+
+/*! @var kScopeParameter
+    @brief The scope request parameter.
+ */
+static NSString *const kScopeParameter = @"scope";
+
+/*! @var kStateParameter
+    @brief The state request parameter.
+ */
+static NSString *const kStateParameter = @"state";
+
+/*! @var kCodeChallengeParameter
+    @brief The PKCE code challenge request parameter.
+ */
+static NSString *const kCodeChallengeParameter = @"code_challenge";
+
+/*! @var kCodeChallengeMethodParameter
+    @brief The PKCE code challenge method request parameter.
+ */
+static NSString *const kCodeChallengeMethodParameter = @"code_challenge_method";
+
+/*! @var kRequestParameter
+    @brief The request object request parameter.
+ */
+static NSString *const kRequestParameter = @"request";
+
+/*! @class OIDTemplatedAuthorizationRequest
+    @brief An authorization request whose URL is built by appending to a template's URL prefix.
+ */
+@interface OIDTemplatedAuthorizationRequest : OIDAuthorizationRequest
+
+/*! @fn initWithTemplate:state:codeVerifier:
+    @brief Creates an authorization request from a template, without its request object.
+ */
+- (instancetype)initWithTemplate:(OIDAuthorizationRequestTemplate *)requestTemplate
+                           state:(nullable NSString *)state
+                    codeVerifier:(nullable NSString *)codeVerifier NS_DESIGNATED_INITIALIZER;
+
+/*! @fn requestWithTemplate:state:codeVerifier:error:
+    @brief Creates an authorization request from a template, signing its request object if the
+        template has a request object builder.
+    @return The request, or nil if the request object could not be signed.
+ */
++ (nullable instancetype)requestWithTemplate:(OIDAuthorizationRequestTemplate *)requestTemplate
+                                       state:(nullable NSString *)state
+                                codeVerifier:(nullable NSString *)codeVerifier
+                                       error:(NSError **_Nullable)error;
+
+@end
+
+@interface OIDAuthorizationRequestTemplate ()
+
+/*! @fn URLForRequest:
+    @brief Builds the authorization URL of a request created from the template, or returns nil if
+        the template has no URL prefix.
+ */
+- (nullable NSURL *)URLForRequest:(OIDAuthorizationRequest *)request;
+
+/*! @fn requestObjectForRequest:error:
+    @brief Signs the request object of a request created from the template.
+    @param error If signing failed, the reason.
+    @return The request object, or nil if signing failed.
+ */
+- (nullable NSString *)requestObjectForRequest:(OIDAuthorizationRequest *)request
+                                         error:(NSError **_Nullable)error;
+
+/*! @fn URLForRequestObject:
+    @brief Builds the authorization URL which sends a request object.
+ */
+- (NSURL *)URLForRequestObject:(NSString *)requestObject;
+
+@end
+
+@implementation OIDAuthorizationRequestTemplate {
+  /*! @var _URLPrefix
+      @brief The authorization endpoint URL with the constant parameters in its query, or nil if
+          the endpoint has a fragment, which prevents parameters from being appended.
+   */
+  NSString *_URLPrefix;
+
+  /*! @var _requestObjectClaims
+      @brief The constant parameters, as request object claims. Nil without a
+          @c requestObjectBuilder.
+   */
+  NSDictionary<NSString *, NSString *> *_requestObjectClaims;
+
+  /*! @var _requestObjectURLPrefix
+      @brief The authorization endpoint URL with the parameters required outside the request
+          object, ending with the @c request parameter's name, or nil without a
+          @c requestObjectBuilder or if the endpoint has a fragment.
+   */
+  NSString *_requestObjectURLPrefix;
+}
+
+- (nullable instancetype)init
+    OID_UNAVAILABLE_USE_INITIALIZER(
+        @selector(initWithConfiguration:
+                               clientId:
+                                  scope:
+                            redirectURL:
+                           responseType:
+                   additionalParameters:
+                   requestObjectBuilder:)
+    );
+
+- (instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
+                clientId:(NSString *)clientID
+                   scope:(nullable NSString *)scope
+             redirectURL:(NSURL *)redirectURL
+            responseType:(NSString *)responseType
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters {
+  return [self initWithConfiguration:configuration
+                            clientId:clientID
+                               scope:scope
+                         redirectURL:redirectURL
+                        responseType:responseType
+                additionalParameters:additionalParameters
+                requestObjectBuilder:nil];
+}
+
+- (instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
+                clientId:(NSString *)clientID
+                   scope:(nullable NSString *)scope
+             redirectURL:(NSURL *)redirectURL
+            responseType:(NSString *)responseType
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters
+    requestObjectBuilder:(nullable OIDRequestObjectBuilder *)requestObjectBuilder {
+  self = [super init];
+  if (self) {
+    _configuration = [configuration copy];
+    _clientID = [clientID copy];
+    _scope = [scope copy];
+    _redirectURL = [redirectURL copy];
+    _responseType = [responseType copy];
+    _additionalParameters =
+        [[NSDictionary alloc] initWithDictionary:additionalParameters copyItems:YES];
+
+    // the same parameters as -[OIDAuthorizationRequest authorizationRequestURL], less the
+    // per-flow ones
+    OIDURLQueryComponent *query = [[OIDURLQueryComponent alloc] init];
+    [query addParameter:kResponseTypeParameter value:_responseType];
+    [query addParameter:kClientIDParameter value:_clientID];
+    [query addParameters:_additionalParameters];
+    if (_redirectURL) {
+      [query addParameter:kRedirectURLParameter value:_redirectURL.absoluteString];
+    }
+    if (_scope) {
+      [query addParameter:kScopeParameter value:_scope];
+    }
+    NSURL *URL = [query URLByReplacingQueryInURL:_configuration.authorizationEndpoint];
+    if (URL && !URL.fragment) {
+      _URLPrefix = URL.absoluteString;
+    }
+
+    _requestObjectBuilder = requestObjectBuilder;
+    if (requestObjectBuilder) {
+      NSMutableDictionary<NSString *, NSString *> *claims =
+          [NSMutableDictionary dictionaryWithDictionary:_additionalParameters ?: @{}];
+      claims[kResponseTypeParameter] = _responseType;
+      claims[kClientIDParameter] = _clientID;
+      claims[kRedirectURLParameter] = _redirectURL.absoluteString;
+      claims[kScopeParameter] = _scope;
+      _requestObjectClaims = claims;
+      OIDURLQueryComponent *outerQuery = [[OIDURLQueryComponent alloc] init];
+      [outerQuery addParameter:kResponseTypeParameter value:_responseType];
+      [outerQuery addParameter:kClientIDParameter value:_clientID];
+      if (_scope) {
+        [outerQuery addParameter:kScopeParameter value:_scope];
+      }
+      NSURL *outerURL =
+          [outerQuery URLByReplacingQueryInURL:_configuration.authorizationEndpoint];
+      if (outerURL && !outerURL.fragment) {
+        _requestObjectURLPrefix =
+            [NSString stringWithFormat:@"%@&%@=", outerURL.absoluteString, kRequestParameter];
+      }
+    }
+  }
+  return self;
+}
+
+- (nullable OIDAuthorizationRequest *)authorizationRequest {
+  return [self authorizationRequestWithError:NULL];
+}
+
+- (nullable OIDAuthorizationRequest *)authorizationRequestWithError:(NSError **_Nullable)error {
+  return [self authorizationRequestWithState:[OIDAuthorizationRequest generateState]
+                                codeVerifier:[OIDAuthorizationRequest generateCodeVerifier]
+                                       error:error];
+}
+
+- (nullable OIDAuthorizationRequest *)
+    authorizationRequestWithState:(nullable NSString *)state
+                     codeVerifier:(nullable NSString *)codeVerifier {
+  return [self authorizationRequestWithState:state codeVerifier:codeVerifier error:NULL];
+}
+
+- (nullable OIDAuthorizationRequest *)
+    authorizationRequestWithState:(nullable NSString *)state
+                     codeVerifier:(nullable NSString *)codeVerifier
+                            error:(NSError **_Nullable)error {
+  return [OIDTemplatedAuthorizationRequest requestWithTemplate:self
+                                                         state:state
+                                                  codeVerifier:codeVerifier
+                                                         error:error];
+}
+
+- (nullable NSURL *)URLForRequest:(OIDAuthorizationRequest *)request {
+  if (!_URLPrefix) {
+    return nil;
+  }
+  OIDURLQueryComponent *query = [[OIDURLQueryComponent alloc] init];
+  if (request.state) {
+    [query addParameter:kStateParameter value:request.state];
+  }
+  if (request.codeVerifier) {
+    [query addParameter:kCodeChallengeParameter value:request.codeChallenge];
+    [query addParameter:kCodeChallengeMethodParameter value:request.codeChallengeMethod];
+  }
+  NSString *flowParameters = [query URLEncodedParameters];
+  if (!flowParameters.length) {
+    return [NSURL URLWithString:_URLPrefix];
+  }
+  return [NSURL URLWithString:[NSString stringWithFormat:@"%@&%@", _URLPrefix, flowParameters]];
+}
+
+- (nullable NSString *)requestObjectForRequest:(OIDAuthorizationRequest *)request
+                                         error:(NSError **_Nullable)error {
+  NSMutableDictionary<NSString *, NSString *> *claims = [_requestObjectClaims mutableCopy];
+  claims[kStateParameter] = request.state;
+  if (request.codeVerifier) {
+    claims[kCodeChallengeParameter] = request.codeChallenge;
+    claims[kCodeChallengeMethodParameter] = request.codeChallengeMethod;
+  }
+  return [_requestObjectBuilder requestObjectWithClaims:claims error:error];
+}
+
+- (NSURL *)URLForRequestObject:(NSString *)requestObject {
+  if (_requestObjectURLPrefix) {
+    // the compact serialization is already URL-safe
+    return [NSURL URLWithString:[_requestObjectURLPrefix stringByAppendingString:requestObject]];
+  }
+  // the endpoint has a fragment, so the query is rebuilt each time
+  OIDURLQueryComponent *query = [[OIDURLQueryComponent alloc] init];
+  [query addParameter:kResponseTypeParameter value:_responseType];
+  [query addParameter:kClientIDParameter value:_clientID];
+  if (_scope) {
+    [query addParameter:kScopeParameter value:_scope];
+  }
+  [query addParameter:kRequestParameter value:requestObject];
+  return [query URLByReplacingQueryInURL:_configuration.authorizationEndpoint];
+}
+
+#pragma mark - NSObject overrides
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, URL prefix: %@>",
+                                    NSStringFromClass([self class]),
+                                    self,
+                                    _URLPrefix];
+}
+
+@end
+
+@implementation OIDTemplatedAuthorizationRequest {
+  /*! @var _requestTemplate
+      @brief The template the request was created from.
+   */
+  OIDAuthorizationRequestTemplate *_requestTemplate;
+
+  /*! @var _requestObject
+      @brief The request's signed request object, or nil if it's sent without one.
+   */
+  NSString *_requestObject;
+}
+
+- (nullable instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
+                clientId:(NSString *)clientID
+                   scope:(nullable NSString *)scope
+             redirectURL:(NSURL *)redirectURL
+            responseType:(NSString *)responseType
+                   state:(nullable NSString *)state
+            codeVerifier:(nullable NSString *)codeVerifier
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters
+    OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithTemplate:state:codeVerifier:));
+
+- (instancetype)initWithTemplate:(OIDAuthorizationRequestTemplate *)requestTemplate
+                           state:(nullable NSString *)state
+                    codeVerifier:(nullable NSString *)codeVerifier {
+  self = [super initWithConfiguration:requestTemplate.configuration
+                             clientId:requestTemplate.clientID
+                                scope:requestTemplate.scope
+                          redirectURL:requestTemplate.redirectURL
+                         responseType:requestTemplate.responseType
+                                state:state
+                         codeVerifier:codeVerifier
+                 additionalParameters:requestTemplate.additionalParameters];
+  if (self) {
+    _requestTemplate = requestTemplate;
+  }
+  return self;
+}
+
++ (nullable instancetype)requestWithTemplate:(OIDAuthorizationRequestTemplate *)requestTemplate
+                                       state:(nullable NSString *)state
+                                codeVerifier:(nullable NSString *)codeVerifier
+                                       error:(NSError **_Nullable)error {
+  OIDTemplatedAuthorizationRequest *request =
+      [[self alloc] initWithTemplate:requestTemplate state:state codeVerifier:codeVerifier];
+  if (requestTemplate.requestObjectBuilder) {
+    // signed once, so the URL is the same each time it's built
+    request->_requestObject = [requestTemplate requestObjectForRequest:request error:error];
+    if (!request->_requestObject) {
+      return nil;
+    }
+  }
+  return request;
+}
+
+- (NSURL *)authorizationRequestURL {
+  if (_requestObject) {
+    return [_requestTemplate URLForRequestObject:_requestObject];
+  }
+  return [_requestTemplate URLForRequest:self] ?: [super authorizationRequestURL];
+}
+
+#pragma mark - NSSecureCoding
+
+- (Class)classForCoder {
+  // the template isn't archived, so the request is decoded as an ordinary one
+  return [OIDAuthorizationRequest class];
+}
+
+@end
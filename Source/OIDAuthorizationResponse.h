@@ -137,6 +137,15 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable OIDTokenRequest *)tokenExchangeRequestWithAdditionalParameters:
     (nullable NSDictionary<NSString *, NSString *> *)additionalParameters;
 
+/*! @fn responseByReplacingRequest:
+    @brief Returns a response with the same values as this one, but serviced by an equivalent
+        request.
+    @param request The request to substitute, typically one which shares its configuration with
+        other objects.
+    @see OIDAuthState.compact
+ */
+- (instancetype)responseByReplacingRequest:(OIDAuthorizationRequest *)request;
+
 @end
 
 NS_ASSUME_NONNULL_END
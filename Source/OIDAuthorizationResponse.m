@@ -19,9 +19,11 @@
 #import "OIDAuthorizationResponse.h"
 
 #import "OIDAuthorizationRequest.h"
+#import "OIDClock.h"
 #import "OIDDefines.h"
 #import "OIDError.h"
 #import "OIDFieldMapping.h"
+#import "OIDLogging.h"
 #import "OIDTokenRequest.h"
 
 /*! @var kAuthorizationCodeKey
@@ -106,7 +108,8 @@ static NSString *const kTokenExchangeRequestException =
             return value;
           }
           NSNumber *valueAsNumber = (NSNumber *)value;
-          return [NSDate dateWithTimeIntervalSinceNow:[valueAsNumber longLongValue]];
+          return [[OIDClock sharedClock].now
+              dateByAddingTimeInterval:[valueAsNumber longLongValue]];
         }];
     fieldMap[kTokenTypeKey] =
         [[OIDFieldMapping alloc] initWithName:@"_tokenType" type:[NSString class]];
@@ -137,6 +140,16 @@ static NSString *const kTokenExchangeRequestException =
   return self;
 }
 
+- (instancetype)responseByReplacingRequest:(OIDAuthorizationRequest *)request {
+  OIDAuthorizationResponse *response =
+      [[[self class] alloc] initWithRequest:request parameters:@{ }];
+  [OIDFieldMapping copyFieldsWithMap:[[self class] fieldMap]
+                        fromInstance:self
+                          toInstance:response];
+  response->_additionalParameters = _additionalParameters;
+  return response;
+}
+
 #pragma mark - NSCopying
 
 - (instancetype)copyWithZone:(nullable NSZone *)zone {
@@ -180,14 +193,14 @@ static NSString *const kTokenExchangeRequestException =
                                      "request: %@>",
                                     NSStringFromClass([self class]),
                                     self,
-                                    _authorizationCode,
+                                    OIDLogRedact(_authorizationCode),
                                     _state,
-                                    _accessToken,
+                                    OIDLogRedact(_accessToken),
                                     _accessTokenExpirationDate,
                                     _tokenType,
-                                    _idToken,
+                                    OIDLogRedact(_idToken),
                                     _scope,
-                                    _additionalParameters,
+                                    OIDLogRedactParameters(_additionalParameters),
                                     _request];
 }
 
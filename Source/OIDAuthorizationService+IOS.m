@@ -0,0 +1,92 @@
+/*! @file OIDAuthorizationService+IOS.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDAuthorizationService+IOS.h"
+
+#import <SafariServices/SafariServices.h>
+
+#import "OIDAuthorizationFlowSessionImplementation.h"
+#import "OIDAuthorizationRequest.h"
+#import "OIDErrorUtilities.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDSafariAuthorizationFlowSession
+    @brief An authorization flow session which presents the request in an
+        @c SFSafariViewController.
+ */
+@interface OIDSafariAuthorizationFlowSession : OIDAuthorizationFlowSessionImplementation
+    <SFSafariViewControllerDelegate>
+
+- (void)presentSafariViewControllerWithViewController:(UIViewController *)parentViewController
+    callback:(OIDAuthorizationCallback)authorizationFlowCallback;
+
+@end
+
+@implementation OIDSafariAuthorizationFlowSession {
+  __weak SFSafariViewController *_safari;
+}
+
+- (void)presentSafariViewControllerWithViewController:(UIViewController *)parentViewController
+    callback:(OIDAuthorizationCallback)authorizationFlowCallback {
+  [self startWithCallback:authorizationFlowCallback];
+  NSURL *URL = [self.request authorizationRequestURL];
+  SFSafariViewController *safari = [[SFSafariViewController alloc] initWithURL:URL
+                                                       entersReaderIfAvailable:NO];
+  safari.delegate = self;
+  _safari = safari;
+  [parentViewController presentViewController:safari animated:YES completion:nil];
+}
+
+- (void)dismissUserAgentWithCompletion:(void (^)(void))completion {
+  SFSafariViewController *safari = _safari;
+  _safari = nil;
+  [safari dismissViewControllerAnimated:YES completion:completion];
+}
+
+- (void)safariViewControllerDidFinish:(SFSafariViewController *)controller {
+  NSError *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeProgramCanceledAuthorizationFlow
+                                    underlyingError:nil
+                                        description:nil];
+  [self didFinishWithResponse:nil error:error];
+}
+
+- (void)didFinishWithResponse:(nullable OIDAuthorizationResponse *)response
+                        error:(nullable NSError *)error {
+  _safari = nil;
+  [super didFinishWithResponse:response error:error];
+}
+
+@end
+
+@implementation OIDAuthorizationService (IOS)
+
++ (id<OIDAuthorizationFlowSession>)
+    presentAuthorizationRequest:(OIDAuthorizationRequest *)request
+       presentingViewController:(UIViewController *)presentingViewController
+                       callback:(OIDAuthorizationCallback)callback {
+  OIDSafariAuthorizationFlowSession *flow =
+      [[OIDSafariAuthorizationFlowSession alloc] initWithRequest:request];
+  [flow presentSafariViewControllerWithViewController:presentingViewController
+                                             callback:callback];
+  return flow;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -16,11 +16,18 @@
         limitations under the License.
  */
 
-#import <UIKit/UIKit.h>
+#import <Foundation/Foundation.h>
+
+#import "OIDCancellable.h"
+#import "OIDRequestPriority.h"
 
 @class OIDAuthorization;
 @class OIDAuthorizationRequest;
 @class OIDAuthorizationResponse;
+@class OIDClientAuthentication;
+@class OIDDPoPProofGenerator;
+@class OIDRegistrationRequest;
+@class OIDRegistrationResponse;
 @class OIDServiceConfiguration;
 @class OIDTokenRequest;
 @class OIDTokenResponse;
@@ -55,6 +62,14 @@ typedef void (^OIDAuthorizationCallback)(OIDAuthorizationResponse *_Nullable aut
 typedef void (^OIDTokenCallback)(OIDTokenResponse *_Nullable tokenResponse,
                                  NSError *_Nullable error);
 
+/*! @typedef OIDRegistrationCallback
+    @brief Represents the type of block used as a callback for dynamic client registration.
+    @param registrationResponse The registration response, if available.
+    @param error The error if an error occurred.
+ */
+typedef void (^OIDRegistrationCallback)(OIDRegistrationResponse *_Nullable registrationResponse,
+                                        NSError *_Nullable error);
+
 /*! @typedef OIDTokenEndpointParameters
     @brief Represents the type of dictionary used to specify additional querystring parameters
         when making authorization or token endpoint requests.
@@ -62,8 +77,10 @@ typedef void (^OIDTokenCallback)(OIDTokenResponse *_Nullable tokenResponse,
 typedef NSDictionary<NSString *, NSString *> *_Nullable OIDTokenEndpointParameters;
 
 /*! @class OIDAuthorizationService
-    @brief Performs various OAuth and OpenID Connect related RPCs via @c SFSafariViewController or
-        @c NSURLSession.
+    @brief Performs various OAuth and OpenID Connect related RPCs via @c OIDHTTPClient.
+    @discussion Presenting an authorization request in @c SFSafariViewController is provided by
+        the @c OIDAuthorizationService(IOS) category in OIDAuthorizationService+IOS.h, which is
+        not part of the UI-independent AppAuthCore library.
  */
 @interface OIDAuthorizationService : NSObject
 
@@ -88,11 +105,24 @@ typedef NSDictionary<NSString *, NSString *> *_Nullable OIDTokenEndpointParamete
     @param issuerURL The service provider's OpenID Connect issuer.
     @param completion A block which will be invoked when the authorization service configuration has
         been created, or when an error has occurred.
+    @return A handle which cancels the request.
     @see https://openid.net/specs/openid-connect-discovery-1_0.html
  */
-+ (void)discoverServiceConfigurationForIssuer:(NSURL *)issuerURL
-                                   completion:(OIDDiscoveryCallback)completion;
++ (id<OIDCancellable>)discoverServiceConfigurationForIssuer:(NSURL *)issuerURL
+                                                 completion:(OIDDiscoveryCallback)completion;
 
+/*! @fn discoverServiceConfigurationForIssuer:deadline:completion:
+    @brief Creates an authorization service configuration from an OpenID Connect compliant issuer
+        URL, failing with @c OIDErrorCodeDeadlineExceeded if discovery doesn't complete in time.
+    @param issuerURL The service provider's OpenID Connect issuer.
+    @param deadline The time by which discovery must complete, or nil for no deadline.
+    @param completion A block which will be invoked when the authorization service configuration has
+        been created, or when an error has occurred.
+    @return A handle which cancels the request.
+ */
++ (id<OIDCancellable>)discoverServiceConfigurationForIssuer:(NSURL *)issuerURL
+                                                   deadline:(nullable NSDate *)deadline
+                                                 completion:(OIDDiscoveryCallback)completion;
 
 /*! @fn discoverServiceConfigurationForDiscoveryURL:completion:
     @brief Convenience method for creating an authorization service configuration from an OpenID
@@ -100,32 +130,113 @@ typedef NSDictionary<NSString *, NSString *> *_Nullable OIDTokenEndpointParamete
     @param discoveryURL The URL of the service provider's OpenID Connect discovery document.
     @param completion A block which will be invoked when the authorization service configuration has
         been created, or when an error has occurred.
+    @return A handle which cancels the request.
     @see https://openid.net/specs/openid-connect-discovery-1_0.html
  */
-+ (void)discoverServiceConfigurationForDiscoveryURL:(NSURL *)discoveryURL
-                                         completion:(OIDDiscoveryCallback)completion;
++ (id<OIDCancellable>)discoverServiceConfigurationForDiscoveryURL:(NSURL *)discoveryURL
+    completion:(OIDDiscoveryCallback)completion;
 
-/*! @fn presentAuthorizationRequest:presentingViewController:callback:
-    @brief Perform an authorization flow using @c SFSafariViewController.
-    @param request The authorization request.
-    @param presentingViewController The view controller from which to present the
-        @c SFSafariViewController.
-    @param callback The method called when the request has completed or failed.
-    @return A @c OIDAuthorizationFlowSession instance which will terminate when it
-        receives a @c OIDAuthorizationFlowSession.cancel message, or after processing a
-        @c OIDAuthorizationFlowSession.resumeAuthorizationFlowWithURL: message.
+/*! @fn discoverServiceConfigurationForDiscoveryURL:deadline:completion:
+    @brief Creates an authorization service configuration from an OpenID Connect discovery
+        document, failing with @c OIDErrorCodeDeadlineExceeded if it can't be fetched in time.
+    @param discoveryURL The URL of the service provider's OpenID Connect discovery document.
+    @param deadline The time by which discovery must complete, or nil for no deadline.
+    @param completion A block which will be invoked when the authorization service configuration has
+        been created, or when an error has occurred.
+    @return A handle which cancels the request.
  */
-+ (id<OIDAuthorizationFlowSession>)
-    presentAuthorizationRequest:(OIDAuthorizationRequest *)request
-       presentingViewController:(UIViewController *)presentingViewController
-                       callback:(OIDAuthorizationCallback)callback;
++ (id<OIDCancellable>)discoverServiceConfigurationForDiscoveryURL:(NSURL *)discoveryURL
+    deadline:(nullable NSDate *)deadline
+    completion:(OIDDiscoveryCallback)completion;
 
 /*! @fn performTokenRequest:callback:
     @brief Performs a token request.
     @param request The token request.
     @param callback The method called when the request has completed or failed.
+    @return A handle which cancels the request.
+ */
++ (id<OIDCancellable>)performTokenRequest:(OIDTokenRequest *)request
+                                 callback:(OIDTokenCallback)callback;
+
+/*! @fn performTokenRequest:deadline:callback:
+    @brief Performs a token request, failing with @c OIDErrorCodeDeadlineExceeded if it doesn't
+        complete in time.
+    @param request The token request.
+    @param deadline The time by which the request must complete, or nil for no deadline.
+    @param callback The method called when the request has completed or failed.
+    @return A handle which cancels the request.
+    @discussion To give a chain of calls a single deadline, such as discovery followed by a code
+        exchange, pass the same date to each of them. Each request's timeout is then whatever is
+        left of the deadline when it starts.
+ */
++ (id<OIDCancellable>)performTokenRequest:(OIDTokenRequest *)request
+                                 deadline:(nullable NSDate *)deadline
+                                 callback:(OIDTokenCallback)callback;
+
+/*! @fn performTokenRequest:priority:deadline:callback:
+    @brief Performs a token request with the given priority.
+    @param request The token request.
+    @param priority How urgently the tokens are needed. Use @c OIDRequestPriorityUserInitiated
+        when the user is waiting, such as for an authorization code exchange, and
+        @c OIDRequestPriorityBackground for refreshes nobody is waiting for.
+    @param deadline The time by which the request must complete, or nil for no deadline.
+    @param callback The method called when the request has completed or failed. Like every
+        callback of this class, it's called on the main queue whatever the priority.
+    @return A handle which cancels the request.
+ */
++ (id<OIDCancellable>)performTokenRequest:(OIDTokenRequest *)request
+                                 priority:(OIDRequestPriority)priority
+                                 deadline:(nullable NSDate *)deadline
+                                 callback:(OIDTokenCallback)callback;
+
+/*! @fn performTokenRequest:proofGenerator:priority:deadline:callback:
+    @brief Performs a token request with a DPoP proof, so that the tokens issued are bound to the
+        proof generator's key.
+    @param request The token request.
+    @param proofGenerator Signs the request's proof, or nil to make the request without one.
+    @param priority How urgently the tokens are needed.
+    @param deadline The time by which the request must complete, or nil for no deadline.
+    @param callback The method called when the request has completed or failed.
+    @return A handle which cancels the request.
+    @discussion The token endpoint's @c DPoP-Nonce is recorded by the proof generator. If the
+        request is rejected with a @c use_dpop_nonce error and a new nonce, it is retried once
+        with a proof containing that nonce.
+    @see https://www.rfc-editor.org/rfc/rfc9449#section-8
+ */
++ (id<OIDCancellable>)performTokenRequest:(OIDTokenRequest *)request
+                           proofGenerator:(nullable OIDDPoPProofGenerator *)proofGenerator
+                                 priority:(OIDRequestPriority)priority
+                                 deadline:(nullable NSDate *)deadline
+                                 callback:(OIDTokenCallback)callback;
+
+/*! @fn performTokenRequest:clientAuthentication:proofGenerator:priority:deadline:callback:
+    @brief Performs a token request as an authenticated confidential client.
+    @param request The token request.
+    @param clientAuthentication Adds the client's credentials to the request, or nil for public
+        clients and clients passing credentials in the request's @c additionalParameters.
+    @param proofGenerator Signs the request's DPoP proof, or nil to make the request without one.
+    @param priority How urgently the tokens are needed.
+    @param deadline The time by which the request must complete, or nil for no deadline.
+    @param callback The method called when the request has completed or failed.
+    @return A handle which cancels the request.
+ */
++ (id<OIDCancellable>)performTokenRequest:(OIDTokenRequest *)request
+                     clientAuthentication:(nullable OIDClientAuthentication *)clientAuthentication
+                           proofGenerator:(nullable OIDDPoPProofGenerator *)proofGenerator
+                                 priority:(OIDRequestPriority)priority
+                                 deadline:(nullable NSDate *)deadline
+                                 callback:(OIDTokenCallback)callback;
+
+/*! @fn performRegistrationRequest:completion:
+    @brief Performs a dynamic client registration request.
+    @param request The registration request.
+    @param completion The method called when the request has completed or failed.
+    @discussion To avoid registering again on every launch, consider @c OIDRegistrationStore,
+        which persists the response and reuses it.
+    @see https://tools.ietf.org/html/rfc7591#section-3
  */
-+ (void)performTokenRequest:(OIDTokenRequest *)request callback:(OIDTokenCallback)callback;
++ (void)performRegistrationRequest:(OIDRegistrationRequest *)request
+                        completion:(OIDRegistrationCallback)completion;
 
 @end
 
@@ -143,9 +254,11 @@ typedef NSDictionary<NSString *, NSString *> *_Nullable OIDTokenEndpointParamete
 - (void)cancel;
 
 /*! @brief Clients should call this method with the result of the authorization code flow if it
-        becomes available. Causes the @c SFSafariViewController created by the
-        @c OIDAuthorizationService.getAuthorizationCodeWithRequest:callback: method to be dismissed,
-        the pending request's completion block is invoked, and this method returns.
+        becomes available. Causes the user agent presenting the request (e.g. the
+        @c SFSafariViewController created by
+        @c OIDAuthorizationService.presentAuthorizationRequest:presentingViewController:callback:)
+        to be dismissed, the pending request's completion block is invoked, and this method
+        returns.
     @param URL The redirect URL invoked by the authorization server.
     @remarks Has no effect if called more than once, or after a @c cancel message was received.
     @return YES if the passed URL matches the expected redirect URL and was consumed, NO otherwise.
@@ -18,12 +18,19 @@
 
 #import "OIDAuthorizationService.h"
 
-#import <SafariServices/SafariServices.h>
-
+#import "OIDAuthorizationFlowSessionImplementation.h"
 #import "OIDAuthorizationRequest.h"
 #import "OIDAuthorizationResponse.h"
+#import "OIDClientAuthentication.h"
+#import "OIDClockSkewEstimator.h"
+#import "OIDDPoPProofGenerator.h"
 #import "OIDDefines.h"
 #import "OIDErrorUtilities.h"
+#import "OIDGrantTypes.h"
+#import "OIDHTTPClient.h"
+#import "OIDLogging.h"
+#import "OIDRegistrationRequest.h"
+#import "OIDRegistrationResponse.h"
 #import "OIDServiceConfiguration.h"
 #import "OIDServiceDiscovery.h"
 #import "OIDTokenRequest.h"
@@ -36,27 +43,44 @@
  */
 static NSString *const kOpenIDConfigurationWellKnownPath = @".well-known/openid-configuration";
 
-NS_ASSUME_NONNULL_BEGIN
-
-@interface OIDAuthorizationFlowSessionImplementation : NSObject <OIDAuthorizationFlowSession,
-                                                                 SFSafariViewControllerDelegate>
-
-- (instancetype)init NS_UNAVAILABLE;
+/*! @var kUseDPoPNonceError
+    @brief The token error returned when a DPoP proof lacks the server's current nonce.
+    @see https://www.rfc-editor.org/rfc/rfc9449#section-8
+ */
+static NSString *const kUseDPoPNonceError = @"use_dpop_nonce";
 
-- (nullable instancetype)initWithRequest:(OIDAuthorizationRequest *)request
-    NS_DESIGNATED_INITIALIZER;
+/*! @var kInvalidClientError
+    @brief The token error returned when client authentication failed.
+    @see https://tools.ietf.org/html/rfc6749#section-5.2
+ */
+static NSString *const kInvalidClientError = @"invalid_client";
 
-- (void)presentSafariViewControllerWithViewController:(UIViewController *)parentViewController
-    callback:(OIDAuthorizationCallback)authorizationFlowCallback;
+NS_ASSUME_NONNULL_BEGIN
 
-@end
+/*! @fn OIDTransportError
+    @brief Returns the error to report for a request which failed in @c OIDHTTPClient.
+    @discussion Errors raised by the client when it aborts a response, such as
+        @c OIDErrorCodeResponseTooLarge, are reported as they are. Others are network errors.
+ */
+static NSError *OIDTransportError(NSError *_Nullable error) {
+  if ([error.domain isEqualToString:OIDGeneralErrorDomain]) {
+    return error;
+  }
+  return [OIDErrorUtilities errorWithCode:OIDErrorCodeNetworkError
+                          underlyingError:error
+                              description:nil];
+}
 
 @implementation OIDAuthorizationFlowSessionImplementation {
-  __weak SFSafariViewController *_safari;
   OIDAuthorizationRequest *_request;
   OIDAuthorizationCallback _pendingauthorizationFlowCallback;
 }
 
+@synthesize request = _request;
+
+- (nullable instancetype)init
+    OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithRequest:));
+
 - (nullable instancetype)initWithRequest:(OIDAuthorizationRequest *)request {
   self = [super init];
   if (self) {
@@ -65,21 +89,16 @@ NS_ASSUME_NONNULL_BEGIN
   return self;
 }
 
-- (void)presentSafariViewControllerWithViewController:(UIViewController *)parentViewController
-    callback:(OIDAuthorizationCallback)authorizationFlowCallback {
-  NSURL *URL = [_request authorizationRequestURL];
-  SFSafariViewController *safari = [[SFSafariViewController alloc] initWithURL:URL
-                                                       entersReaderIfAvailable:NO];
-  safari.delegate = self;
-  _safari = safari;
-  _pendingauthorizationFlowCallback = authorizationFlowCallback;
-  [parentViewController presentViewController:safari animated:YES completion:nil];
+- (void)startWithCallback:(OIDAuthorizationCallback)callback {
+  _pendingauthorizationFlowCallback = callback;
+}
+
+- (void)dismissUserAgentWithCompletion:(void (^)(void))completion {
+  completion();
 }
 
 - (void)cancel {
-  SFSafariViewController *safari = _safari;
-  _safari = nil;
-  [safari dismissViewControllerAnimated:YES completion:^{
+  [self dismissUserAgentWithCompletion:^{
     NSError *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeUserCanceledAuthorizationFlow
                                       underlyingError:nil
                                           description:nil];
@@ -143,31 +162,16 @@ NS_ASSUME_NONNULL_BEGIN
                             userInfo:userInfo];
   }
 
-  SFSafariViewController *safari = _safari;
-  _safari = nil;
-  [safari dismissViewControllerAnimated:YES completion:^{
+  [self dismissUserAgentWithCompletion:^{
     [self didFinishWithResponse:response error:error];
   }];
 
   return YES;
 }
 
-- (void)safariViewControllerDidFinish:(SFSafariViewController *)controller {
-  NSError *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeProgramCanceledAuthorizationFlow
-                                    underlyingError:nil
-                                        description:nil];
-  [self didFinishWithResponse:nil error:error];
-}
-
-/*! @fn didFinishWithResponse:error:
-    @brief Invokes the pending callback and performs cleanup.
-    @param response The authorization response, if any to return to the callback.
-    @param error The error, if any, to return to the callback.
- */
 - (void)didFinishWithResponse:(nullable OIDAuthorizationResponse *)response
                         error:(nullable NSError *)error {
   OIDAuthorizationCallback callback = _pendingauthorizationFlowCallback;
-  _safari = nil;
   _pendingauthorizationFlowCallback = nil;
 
   if (callback) {
@@ -177,37 +181,111 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/*! @class OIDTokenRequestHandle
+    @brief The @c OIDCancellable returned for token requests, which cancels the request in
+        progress, including a retry made with a new DPoP nonce.
+ */
+@interface OIDTokenRequestHandle : NSObject <OIDCancellable>
+
+/*! @fn addRequest:
+    @brief Adds an HTTP request made for the token request, which is cancelled immediately if the
+        token request already has been.
+ */
+- (void)addRequest:(id<OIDCancellable>)request;
+
+@end
+
+@implementation OIDTokenRequestHandle {
+  /*! @var _requests
+      @brief The HTTP requests made so far. Synchronized on @c self.
+   */
+  NSMutableArray<id<OIDCancellable>> *_requests;
+
+  /*! @var _cancelled
+      @brief Whether @c cancel has been called. Synchronized on @c self.
+   */
+  BOOL _cancelled;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _requests = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (void)addRequest:(id<OIDCancellable>)request {
+  BOOL cancelled;
+  @synchronized(self) {
+    [_requests addObject:request];
+    cancelled = _cancelled;
+  }
+  if (cancelled) {
+    [request cancel];
+  }
+}
+
+- (void)cancel {
+  NSArray<id<OIDCancellable>> *requests;
+  @synchronized(self) {
+    _cancelled = YES;
+    requests = [_requests copy];
+  }
+  // cancelling a completed request has no effect
+  [requests makeObjectsPerformSelector:@selector(cancel)];
+}
+
+@end
+
 @implementation OIDAuthorizationService
 
-+ (void)discoverServiceConfigurationForIssuer:(NSURL *)issuerURL
-                                   completion:(OIDDiscoveryCallback)completion {
++ (id<OIDCancellable>)discoverServiceConfigurationForIssuer:(NSURL *)issuerURL
+                                                 completion:(OIDDiscoveryCallback)completion {
+  return [[self class] discoverServiceConfigurationForIssuer:issuerURL
+                                                    deadline:nil
+                                                  completion:completion];
+}
+
++ (id<OIDCancellable>)discoverServiceConfigurationForIssuer:(NSURL *)issuerURL
+                                                   deadline:(nullable NSDate *)deadline
+                                                 completion:(OIDDiscoveryCallback)completion {
   NSURL *fullDiscoveryURL =
       [issuerURL URLByAppendingPathComponent:kOpenIDConfigurationWellKnownPath];
 
   return [[self class] discoverServiceConfigurationForDiscoveryURL:fullDiscoveryURL
+                                                          deadline:deadline
                                                         completion:completion];
 }
 
++ (id<OIDCancellable>)discoverServiceConfigurationForDiscoveryURL:(NSURL *)discoveryURL
+    completion:(OIDDiscoveryCallback)completion {
+  return [[self class] discoverServiceConfigurationForDiscoveryURL:discoveryURL
+                                                          deadline:nil
+                                                        completion:completion];
+}
 
-+ (void)discoverServiceConfigurationForDiscoveryURL:(NSURL *)discoveryURL
++ (id<OIDCancellable>)discoverServiceConfigurationForDiscoveryURL:(NSURL *)discoveryURL
+    deadline:(nullable NSDate *)deadline
     completion:(OIDDiscoveryCallback)completion {
 
-  NSURLSession *session = [NSURLSession sharedSession];
-  NSURLSessionDataTask *task =
-      [session dataTaskWithURL:discoveryURL
-             completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+  NSURLRequest *URLRequest = [NSURLRequest requestWithURL:discoveryURL];
+  return [[OIDHTTPClient sharedClient] performRequest:URLRequest
+                                         endpointType:OIDHTTPEndpointTypeDiscovery
+                                             deadline:deadline
+                                           completion:^(NSData *_Nullable data,
+                                                        NSHTTPURLResponse *_Nullable response,
+                                                        NSError *_Nullable error) {
     // If we got any sort of error, just report it.
     if (error || !data) {
-      error = [OIDErrorUtilities errorWithCode:OIDErrorCodeNetworkError
-                               underlyingError:error
-                                   description:nil];
+      error = OIDTransportError(error);
       dispatch_async(dispatch_get_main_queue(), ^{
         completion(nil, error);
       });
       return;
     }
 
-    NSHTTPURLResponse *urlResponse = (NSHTTPURLResponse *)response;
+    NSHTTPURLResponse *urlResponse = response;
 
     // Check for non-200 status codes.
     // https://openid.net/specs/openid-connect-discovery-1_0.html#ProviderConfigurationResponse
@@ -243,59 +321,167 @@ NS_ASSUME_NONNULL_BEGIN
       completion(configuration, nil);
     });
   }];
-  [task resume];
 }
 
-#pragma mark - Authorization Endpoint
-
-+ (id<OIDAuthorizationFlowSession>)
-    presentAuthorizationRequest:(OIDAuthorizationRequest *)request
-       presentingViewController:(UIViewController *)presentingViewController
-                       callback:(OIDAuthorizationCallback)callback {
-  OIDAuthorizationFlowSessionImplementation *flow =
-      [[OIDAuthorizationFlowSessionImplementation alloc] initWithRequest:request];
-  [flow presentSafariViewControllerWithViewController:presentingViewController
-                                             callback:callback];
-  return flow;
+#pragma mark - Token Endpoint
+
++ (id<OIDCancellable>)performTokenRequest:(OIDTokenRequest *)request
+                                 callback:(OIDTokenCallback)callback {
+  return [[self class] performTokenRequest:request deadline:nil callback:callback];
 }
 
-#pragma mark - Token Endpoint
++ (id<OIDCancellable>)performTokenRequest:(OIDTokenRequest *)request
+                                 deadline:(nullable NSDate *)deadline
+                                 callback:(OIDTokenCallback)callback {
+  return [[self class] performTokenRequest:request
+                                  priority:OIDRequestPriorityDefault
+                                  deadline:deadline
+                                  callback:callback];
+}
 
-+ (void)performTokenRequest:(OIDTokenRequest *)request callback:(OIDTokenCallback)callback {
++ (id<OIDCancellable>)performTokenRequest:(OIDTokenRequest *)request
+                                 priority:(OIDRequestPriority)priority
+                                 deadline:(nullable NSDate *)deadline
+                                 callback:(OIDTokenCallback)callback {
+  return [[self class] performTokenRequest:request
+                            proofGenerator:nil
+                                  priority:priority
+                                  deadline:deadline
+                                  callback:callback];
+}
+
++ (id<OIDCancellable>)performTokenRequest:(OIDTokenRequest *)request
+                           proofGenerator:(nullable OIDDPoPProofGenerator *)proofGenerator
+                                 priority:(OIDRequestPriority)priority
+                                 deadline:(nullable NSDate *)deadline
+                                 callback:(OIDTokenCallback)callback {
+  return [[self class] performTokenRequest:request
+                      clientAuthentication:nil
+                            proofGenerator:proofGenerator
+                                  priority:priority
+                                  deadline:deadline
+                                  callback:callback];
+}
+
++ (id<OIDCancellable>)performTokenRequest:(OIDTokenRequest *)request
+                     clientAuthentication:(nullable OIDClientAuthentication *)clientAuthentication
+                           proofGenerator:(nullable OIDDPoPProofGenerator *)proofGenerator
+                                 priority:(OIDRequestPriority)priority
+                                 deadline:(nullable NSDate *)deadline
+                                 callback:(OIDTokenCallback)callback {
+  OIDTokenRequestHandle *handle = [[OIDTokenRequestHandle alloc] init];
+  [[self class] performTokenRequest:request
+               clientAuthentication:clientAuthentication
+                     proofGenerator:proofGenerator
+                           priority:priority
+                           deadline:deadline
+                       isNonceRetry:NO
+                             handle:handle
+                           callback:callback];
+  return handle;
+}
+
+/*! @fn performTokenRequest:clientAuthentication:proofGenerator:priority:deadline:isNonceRetry:handle:callback:
+    @brief Performs a token request, or its retry with a new DPoP nonce.
+    @param isNonceRetry Whether this is the retry, which isn't retried again.
+    @param handle The handle returned for the token request, which the HTTP request is added to.
+ */
++ (void)performTokenRequest:(OIDTokenRequest *)request
+       clientAuthentication:(nullable OIDClientAuthentication *)clientAuthentication
+             proofGenerator:(nullable OIDDPoPProofGenerator *)proofGenerator
+                   priority:(OIDRequestPriority)priority
+                   deadline:(nullable NSDate *)deadline
+               isNonceRetry:(BOOL)isNonceRetry
+                     handle:(OIDTokenRequestHandle *)handle
+                   callback:(OIDTokenCallback)callback {
+  OIDLogDebug(@"Performing token request: %@", request);
   NSURLRequest *URLRequest = [request URLRequest];
-  NSURLSession *session = [NSURLSession sharedSession];
-  [[session dataTaskWithRequest:URLRequest
-              completionHandler:^(NSData *_Nullable data,
-                                  NSURLResponse *_Nullable response,
-                                  NSError *_Nullable error) {
+  if (clientAuthentication) {
+    NSError *authenticationError;
+    URLRequest = [clientAuthentication requestByAuthenticatingRequest:URLRequest
+                                                                error:&authenticationError];
+    if (!URLRequest) {
+      dispatch_async(dispatch_get_main_queue(), ^{
+        callback(nil, authenticationError);
+      });
+      return;
+    }
+  }
+  if (proofGenerator) {
+    NSError *proofError;
+    URLRequest = [proofGenerator requestBySigningRequest:URLRequest
+                                             accessToken:nil
+                                                   error:&proofError];
+    if (!URLRequest) {
+      dispatch_async(dispatch_get_main_queue(), ^{
+        callback(nil, proofError);
+      });
+      return;
+    }
+  }
+  id<OIDCancellable> HTTPRequest =
+      [[OIDHTTPClient sharedClient] performRequest:URLRequest
+                                      endpointType:OIDHTTPEndpointTypeToken
+                                          priority:priority
+                                          deadline:deadline
+                                        completion:^(NSData *_Nullable data,
+                                                     NSHTTPURLResponse *_Nullable response,
+                                                     NSError *_Nullable error) {
     if (error) {
       // A network error or server error occurred.
-      NSError *returnedError =
-          [OIDErrorUtilities errorWithCode:OIDErrorCodeNetworkError
-                           underlyingError:error
-                               description:nil];
+      OIDLogInfo(@"Token request to %@ failed: %@", URLRequest.URL, error);
+      NSError *returnedError = OIDTransportError(error);
       dispatch_async(dispatch_get_main_queue(), ^{
         callback(nil, returnedError);
       });
       return;
     }
 
-    NSHTTPURLResponse *HTTPURLResponse = (NSHTTPURLResponse *)response;
+    NSHTTPURLResponse *HTTPURLResponse = response;
+    BOOL receivedNewNonce = [proofGenerator recordNonceFromResponse:HTTPURLResponse];
+    NSURL *issuer = [OIDClockSkewEstimator issuerForConfiguration:request.configuration];
+    OIDClockSkewEstimator *clockSkewEstimator = [OIDClockSkewEstimator sharedEstimator];
+    [clockSkewEstimator recordDateHeaderOfResponse:HTTPURLResponse forIssuer:issuer];
 
     if (HTTPURLResponse.statusCode != 200) {
       // A server error occurred.
+      OIDLogInfo(@"Token request to %@ failed with HTTP status %ld.",
+                 URLRequest.URL,
+                 (long)HTTPURLResponse.statusCode);
       NSError *serverError =
           [OIDErrorUtilities HTTPErrorWithHTTPResponse:HTTPURLResponse data:data];
+      if (HTTPURLResponse.statusCode == 401) {
+        // client authentication failed, possibly because the server saw the assertion's jti
+        [clientAuthentication discardCachedAssertion];
+      }
 
       // HTTP 400 may indicate an RFC6749 Section 5.2 error response, checks for that
       if (HTTPURLResponse.statusCode == 400) {
         NSError *jsonDeserializationError;
         NSDictionary<NSString *, NSObject<NSCopying> *> *json =
             [NSJSONSerialization JSONObjectWithData:data options:0 error:&jsonDeserializationError];
+        if ([json isKindOfClass:[NSDictionary class]]
+            && [json[OIDOAuthErrorFieldError] isEqual:kInvalidClientError]) {
+          [clientAuthentication discardCachedAssertion];
+        }
 
         // if the HTTP 400 response parses as JSON and has an 'error' key, it's an OAuth error
         // these errors are special as they indicate a problem with the authorization grant
         if (json[OIDOAuthErrorFieldError]) {
+          if (receivedNewNonce && !isNonceRetry
+              && [json[OIDOAuthErrorFieldError] isEqual:kUseDPoPNonceError]) {
+            OIDLogDebug(@"Retrying the token request to %@ with a new DPoP nonce.",
+                        URLRequest.URL);
+            [self performTokenRequest:request
+                 clientAuthentication:clientAuthentication
+                       proofGenerator:proofGenerator
+                             priority:priority
+                             deadline:deadline
+                         isNonceRetry:YES
+                               handle:handle
+                             callback:callback];
+            return;
+          }
           NSError *oauthError =
             [OIDErrorUtilities OAuthErrorWithDomain:OIDOAuthTokenErrorDomain
                                       OAuthResponse:json
@@ -333,6 +519,15 @@ NS_ASSUME_NONNULL_BEGIN
       return;
     }
 
+    // an ID token from a code exchange was issued just now, so its issue time is another sample
+    // of the server's clock; a refresh response may repeat an old one, which OIDAuthState checks
+    NSString *idToken =
+        [json isKindOfClass:[NSDictionary class]] ? (NSString *)json[@"id_token"] : nil;
+    BOOL isRefresh = [request.grantType isEqualToString:OIDGrantTypeRefreshToken];
+    if (!isRefresh && [idToken isKindOfClass:[NSString class]]) {
+      [clockSkewEstimator recordIssuedAtOfIDToken:idToken forIssuer:issuer];
+    }
+
     OIDTokenResponse *tokenResponse =
         [[OIDTokenResponse alloc] initWithRequest:request parameters:json];
     if (!tokenResponse) {
@@ -351,7 +546,121 @@ NS_ASSUME_NONNULL_BEGIN
     dispatch_async(dispatch_get_main_queue(), ^{
       callback(tokenResponse, nil);
     });
-  }] resume];
+  }];
+  [handle addRequest:HTTPRequest];
+}
+
+#pragma mark - Dynamic Client Registration
+
++ (void)performRegistrationRequest:(OIDRegistrationRequest *)request
+                        completion:(OIDRegistrationCallback)completion {
+  OIDLogDebug(@"Performing registration request: %@", request);
+  NSURLRequest *URLRequest = [request URLRequest];
+  if (!URLRequest.URL || !URLRequest.HTTPBody) {
+    NSError *returnedError =
+        [OIDErrorUtilities errorWithCode:OIDErrorCodeInvalidDiscoveryDocument
+                         underlyingError:nil
+                             description:@"The registration request has no registration "
+                                          "endpoint, or its metadata couldn't be serialized."];
+    dispatch_async(dispatch_get_main_queue(), ^{
+      completion(nil, returnedError);
+    });
+    return;
+  }
+
+  [[OIDHTTPClient sharedClient] performRequest:URLRequest
+                                  endpointType:OIDHTTPEndpointTypeRegistration
+                                    completion:^(NSData *_Nullable data,
+                                                 NSHTTPURLResponse *_Nullable response,
+                                                 NSError *_Nullable error) {
+    if (error) {
+      // A network error or server error occurred.
+      OIDLogInfo(@"Registration request to %@ failed: %@", URLRequest.URL, error);
+      NSError *returnedError = OIDTransportError(error);
+      dispatch_async(dispatch_get_main_queue(), ^{
+        completion(nil, returnedError);
+      });
+      return;
+    }
+
+    NSHTTPURLResponse *HTTPURLResponse = response;
+
+    // RFC7591 specifies 201, but some servers respond with 200
+    if (HTTPURLResponse.statusCode != 201 && HTTPURLResponse.statusCode != 200) {
+      // A server error occurred.
+      OIDLogInfo(@"Registration request to %@ failed with HTTP status %ld.",
+                 URLRequest.URL,
+                 (long)HTTPURLResponse.statusCode);
+      NSError *serverError =
+          [OIDErrorUtilities HTTPErrorWithHTTPResponse:HTTPURLResponse data:data];
+
+      // HTTP 400 may indicate an RFC7591 Section 3.2.2 error response, checks for that
+      if (HTTPURLResponse.statusCode == 400) {
+        NSError *jsonDeserializationError;
+        NSDictionary<NSString *, NSObject<NSCopying> *> *json =
+            [NSJSONSerialization JSONObjectWithData:data options:0 error:&jsonDeserializationError];
+
+        // if the HTTP 400 response parses as JSON and has an 'error' key, it's an OAuth error
+        if ([json isKindOfClass:[NSDictionary class]] && json[OIDOAuthErrorFieldError]) {
+          NSError *oauthError =
+            [OIDErrorUtilities OAuthErrorWithDomain:OIDOAuthRegistrationErrorDomain
+                                      OAuthResponse:json
+                                    underlyingError:serverError];
+          dispatch_async(dispatch_get_main_queue(), ^{
+            completion(nil, oauthError);
+          });
+          return;
+        }
+      }
+
+      // not an OAuth error, just a generic server error
+      NSError *returnedError =
+          [OIDErrorUtilities errorWithCode:OIDErrorCodeServerError
+                           underlyingError:serverError
+                               description:nil];
+      dispatch_async(dispatch_get_main_queue(), ^{
+        completion(nil, returnedError);
+      });
+      return;
+    }
+
+    NSError *jsonDeserializationError;
+    NSDictionary<NSString *, NSObject<NSCopying> *> *json =
+        [NSJSONSerialization JSONObjectWithData:data options:0 error:&jsonDeserializationError];
+    if (jsonDeserializationError) {
+      // A problem occurred deserializing the response/JSON.
+      NSError *returnedError =
+          [OIDErrorUtilities errorWithCode:OIDErrorCodeJSONDeserializationError
+                           underlyingError:jsonDeserializationError
+                               description:nil];
+      dispatch_async(dispatch_get_main_queue(), ^{
+        completion(nil, returnedError);
+      });
+      return;
+    }
+
+    OIDRegistrationResponse *registrationResponse =
+        [json isKindOfClass:[NSDictionary class]]
+            ? [[OIDRegistrationResponse alloc] initWithRequest:request parameters:json]
+            : nil;
+    if (!registrationResponse) {
+      // A problem occurred constructing the registration response from the JSON.
+      NSError *returnedError =
+          [OIDErrorUtilities errorWithCode:OIDErrorCodeRegistrationResponseConstructionError
+                           underlyingError:nil
+                               description:@"The registration response has no client_id."];
+      dispatch_async(dispatch_get_main_queue(), ^{
+        completion(nil, returnedError);
+      });
+      return;
+    }
+
+    // Success
+    OIDLogInfo(@"Registered client %@ at %@.", registrationResponse.clientID, URLRequest.URL);
+    dispatch_async(dispatch_get_main_queue(), ^{
+      completion(registrationResponse, nil);
+    });
+  }];
 }
 
 @end
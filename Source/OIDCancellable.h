@@ -0,0 +1,39 @@
+/*! @file OIDCancellable.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @protocol OIDCancellable
+    @brief A handle to a request in progress, returned by the methods of
+        @c OIDAuthorizationService which make network requests.
+ */
+@protocol OIDCancellable <NSObject>
+
+/*! @fn cancel
+    @brief Cancels the request, if it hasn't completed yet.
+    @discussion The underlying network task is cancelled immediately, freeing its connection for
+        other requests. The request's callback is still called, with an
+        @c OIDErrorCodeRequestCanceled error. Cancelling a completed request has no effect.
+ */
+- (void)cancel;
+
+@end
+
+NS_ASSUME_NONNULL_END
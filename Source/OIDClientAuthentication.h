@@ -0,0 +1,157 @@
+/*! @file OIDClientAuthentication.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OIDServiceConfiguration;
+@protocol OIDJWSSigner;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @var OIDClientAuthenticationMethodClientSecretBasic
+    @brief The client ID and secret are sent with the HTTP Basic authentication scheme.
+    @see https://tools.ietf.org/html/rfc6749#section-2.3.1
+ */
+extern NSString *const OIDClientAuthenticationMethodClientSecretBasic;
+
+/*! @var OIDClientAuthenticationMethodClientSecretPost
+    @brief The client secret is sent in the request body.
+    @see https://tools.ietf.org/html/rfc6749#section-2.3.1
+ */
+extern NSString *const OIDClientAuthenticationMethodClientSecretPost;
+
+/*! @var OIDClientAuthenticationMethodClientSecretJWT
+    @brief The client sends a JWT assertion signed with HMAC-SHA256, keyed by the client secret.
+    @see http://openid.net/specs/openid-connect-core-1_0.html#ClientAuthentication
+ */
+extern NSString *const OIDClientAuthenticationMethodClientSecretJWT;
+
+/*! @var OIDClientAuthenticationMethodPrivateKeyJWT
+    @brief The client sends a JWT assertion signed with a private key registered for it.
+    @see http://openid.net/specs/openid-connect-core-1_0.html#ClientAuthentication
+ */
+extern NSString *const OIDClientAuthenticationMethodPrivateKeyJWT;
+
+/*! @class OIDClientAuthentication
+    @brief Authenticates a confidential client's requests to the token endpoint.
+    @discussion The per-client work is done once: the @c Authorization header for
+        @c client_secret_basic is built when the object is created, and the JOSE header of client
+        assertions is encoded on first use.
+
+        Each request gets a newly signed client assertion with a unique @c jti by default, as
+        servers may reject a @c jti they've already seen. For servers known to accept them, set
+        @c assertionReuseInterval so that clients making many token requests don't sign each
+        one. A cached assertion is discarded when the token endpoint rejects the client.
+
+        An instance may be used from any thread.
+    @see https://www.rfc-editor.org/rfc/rfc7523#section-2.2
+ */
+@interface OIDClientAuthentication : NSObject
+
+/*! @property method
+    @brief The authentication method, such as @c OIDClientAuthenticationMethodClientSecretBasic.
+ */
+@property(nonatomic, readonly) NSString *method;
+
+/*! @property clientID
+    @brief The client identifier.
+ */
+@property(nonatomic, readonly) NSString *clientID;
+
+/*! @property assertionLifetime
+    @brief How long client assertions are valid for, which sets their @c exp claim. Defaults to
+        two minutes.
+ */
+@property(atomic, assign) NSTimeInterval assertionLifetime;
+
+/*! @property assertionReuseInterval
+    @brief How long a signed client assertion is reused for before a new one is signed. Defaults
+        to 0, which signs a new assertion for every request. Assertions are never reused for more
+        than half their lifetime, so a reused assertion doesn't expire in transit.
+ */
+@property(atomic, assign) NSTimeInterval assertionReuseInterval;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use one of the factory methods.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn clientSecretBasicAuthenticationWithClientID:clientSecret:
+    @brief Creates an instance which uses @c client_secret_basic.
+ */
++ (instancetype)clientSecretBasicAuthenticationWithClientID:(NSString *)clientID
+                                               clientSecret:(NSString *)clientSecret;
+
+/*! @fn clientSecretPostAuthenticationWithClientID:clientSecret:
+    @brief Creates an instance which uses @c client_secret_post.
+ */
++ (instancetype)clientSecretPostAuthenticationWithClientID:(NSString *)clientID
+                                              clientSecret:(NSString *)clientSecret;
+
+/*! @fn clientSecretJWTAuthenticationWithClientID:clientSecret:
+    @brief Creates an instance which uses @c client_secret_jwt, with @c HS256 assertions.
+ */
++ (instancetype)clientSecretJWTAuthenticationWithClientID:(NSString *)clientID
+                                             clientSecret:(NSString *)clientSecret;
+
+/*! @fn privateKeyJWTAuthenticationWithClientID:signer:
+    @brief Creates an instance which uses @c private_key_jwt.
+    @param signer The client's private key.
+ */
++ (instancetype)privateKeyJWTAuthenticationWithClientID:(NSString *)clientID
+                                                 signer:(id<OIDJWSSigner>)signer;
+
+/*! @fn authenticationWithConfiguration:clientID:clientSecret:signer:
+    @brief Chooses the strongest method the token endpoint supports, given the client's
+        credentials.
+    @param configuration The authorization server's configuration. If it has no discovery document
+        or the document doesn't list the supported methods, @c client_secret_basic is assumed.
+    @param clientSecret The client secret, if any.
+    @param signer The client's private key, if any.
+    @return The authentication, or nil if the server supports no method the credentials allow.
+    @discussion Methods are preferred in the order @c private_key_jwt, @c client_secret_jwt,
+        @c client_secret_basic, @c client_secret_post. The JWT methods are only chosen if the
+        server lists their signing algorithm in @c token_endpoint_auth_signing_alg_values_supported,
+        or doesn't list any.
+ */
++ (nullable instancetype)authenticationWithConfiguration:(OIDServiceConfiguration *)configuration
+                                                clientID:(NSString *)clientID
+                                            clientSecret:(nullable NSString *)clientSecret
+                                                  signer:(nullable id<OIDJWSSigner>)signer;
+
+/*! @fn requestByAuthenticatingRequest:error:
+    @brief Returns a copy of a token endpoint request with the client's credentials added.
+    @param request A POST request with a form-encoded body.
+    @param error If a client assertion could not be signed, the reason.
+    @discussion The request's URL is the audience of client assertions. Their @c iat and @c exp
+        claims are the server's time, from @c OIDClockSkewEstimator.serverDateForIssuer:.
+ */
+- (nullable NSURLRequest *)requestByAuthenticatingRequest:(NSURLRequest *)request
+                                                    error:(NSError **_Nullable)error;
+
+/*! @fn discardCachedAssertion
+    @brief Makes the next request sign a new client assertion.
+    @discussion Called by @c OIDAuthorizationService when the token endpoint responds with
+        @c invalid_client, since the assertion may have been rejected for its reused @c jti.
+ */
+- (void)discardCachedAssertion;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,391 @@
+/*! @file OIDClientAuthentication.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDClientAuthentication.h"
+
+#import "OIDClock.h"
+#import "OIDClockSkewEstimator.h"
+#import "OIDDefines.h"
+#import "OIDErrorUtilities.h"
+#import "OIDJWSSigner.h"
+#import "OIDServiceConfiguration.h"
+#import "OIDServiceDiscovery.h"
+#import "OIDTokenUtilities.h"
+
+NSString *const OIDClientAuthenticationMethodClientSecretBasic = @"client_secret_basic";
+
+NSString *const OIDClientAuthenticationMethodClientSecretPost = @"client_secret_post";
+
+NSString *const OIDClientAuthenticationMethodClientSecretJWT = @"client_secret_jwt";
+
+NSString *const OIDClientAuthenticationMethodPrivateKeyJWT = @"private_key_jwt";
+
+/*! @var kClientSecretKey
+    @brief Form parameter for the client secret with @c client_secret_post.
+ */
+static NSString *const kClientSecretKey = @"client_secret";
+
+/*! @var kClientAssertionTypeKey
+    @brief Form parameter for the type of a client assertion.
+ */
+static NSString *const kClientAssertionTypeKey = @"client_assertion_type";
+
+/*! @var kClientAssertionKey
+    @brief Form parameter for a client assertion.
+ */
+static NSString *const kClientAssertionKey = @"client_assertion";
+
+/*! @var kJWTBearerAssertionType
+    @brief The @c client_assertion_type of JWT client assertions.
+    @see https://www.rfc-editor.org/rfc/rfc7523#section-2.2
+ */
+static NSString *const kJWTBearerAssertionType =
+    @"urn:ietf:params:oauth:client-assertion-type:jwt-bearer";
+
+/*! @var kHMACAlgorithm
+    @brief The JWS algorithm of @c client_secret_jwt assertions.
+ */
+static NSString *const kHMACAlgorithm = @"HS256";
+
+/*! @var kAuthorizationHeaderKey
+    @brief The HTTP header the @c client_secret_basic credentials are sent in.
+ */
+static NSString *const kAuthorizationHeaderKey = @"Authorization";
+
+/*! @var kJTISize
+    @brief The number of random bytes in the @c jti claim of each assertion.
+ */
+static NSUInteger const kJTISize = 16;
+
+/*! @var kDefaultAssertionLifetime
+    @brief The default value of @c assertionLifetime.
+ */
+static NSTimeInterval const kDefaultAssertionLifetime = 120;
+
+/*! @var kDefaultAssertionReuseInterval
+    @brief The default value of @c assertionReuseInterval.
+ */
+static NSTimeInterval const kDefaultAssertionReuseInterval = 0;
+
+/*! @fn OIDFormEncode
+    @brief Percent-encodes everything but unreserved characters, which is safe both in form bodies
+        and in the credentials of the Basic scheme.
+    @see https://tools.ietf.org/html/rfc6749#section-2.3.1
+ */
+static NSString *OIDFormEncode(NSString *string) {
+  static NSCharacterSet *unreservedCharacters;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    NSMutableCharacterSet *characters = [NSMutableCharacterSet alphanumericCharacterSet];
+    [characters addCharactersInString:@"-._~"];
+    unreservedCharacters = [characters copy];
+  });
+  return [string stringByAddingPercentEncodingWithAllowedCharacters:unreservedCharacters];
+}
+
+/*! @class OIDClientSecretSigner
+    @brief Signs @c client_secret_jwt assertions with HMAC-SHA256, keyed by the client secret.
+ */
+@interface OIDClientSecretSigner : NSObject <OIDJWSSigner>
+
+/*! @fn initWithClientSecret:
+    @brief Designated initializer.
+ */
+- (instancetype)initWithClientSecret:(NSString *)clientSecret;
+
+@end
+
+@implementation OIDClientSecretSigner {
+  /*! @var _key
+      @brief The UTF-8 bytes of the client secret.
+   */
+  NSData *_key;
+}
+
+- (instancetype)initWithClientSecret:(NSString *)clientSecret {
+  self = [super init];
+  if (self) {
+    _key = [clientSecret dataUsingEncoding:NSUTF8StringEncoding];
+  }
+  return self;
+}
+
+- (NSString *)algorithm {
+  return kHMACAlgorithm;
+}
+
+- (nullable NSData *)signatureForSigningInput:(NSData *)signingInput
+                                        error:(NSError **_Nullable)error {
+  return [OIDTokenUtilities HMACSHA256WithKey:_key data:signingInput];
+}
+
+@end
+
+@interface OIDClientAuthentication ()
+
+/*! @fn initWithMethod:clientID:clientSecret:signer:
+    @brief Designated initializer.
+    @param clientSecret The secret, for the @c client_secret_basic and @c client_secret_post
+        methods.
+    @param signer The assertion signer, for the JWT methods.
+ */
+- (instancetype)initWithMethod:(NSString *)method
+                      clientID:(NSString *)clientID
+                  clientSecret:(nullable NSString *)clientSecret
+                        signer:(nullable id<OIDJWSSigner>)signer NS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation OIDClientAuthentication {
+  /*! @var _basicAuthorization
+      @brief The @c Authorization header value, for @c client_secret_basic.
+   */
+  NSString *_basicAuthorization;
+
+  /*! @var _postParameters
+      @brief The encoded form parameters appended to the body, for @c client_secret_post.
+   */
+  NSString *_postParameters;
+
+  /*! @var _signer
+      @brief Signs client assertions, for the JWT methods.
+   */
+  id<OIDJWSSigner> _signer;
+
+  /*! @var _assertionHeaderPrefix
+      @brief The encoded JOSE header of client assertions. Synchronized on @c self.
+   */
+  NSString *_assertionHeaderPrefix;
+
+  /*! @var _assertion
+      @brief The most recently signed client assertion. Synchronized on @c self.
+   */
+  NSString *_assertion;
+
+  /*! @var _assertionAudience
+      @brief The audience @c _assertion was signed for. Synchronized on @c self.
+   */
+  NSString *_assertionAudience;
+
+  /*! @var _assertionIssuedAt
+      @brief When @c _assertion was signed. Synchronized on @c self.
+   */
+  NSDate *_assertionIssuedAt;
+
+  /*! @var _issuer
+      @brief The URL the authorization server's clock offset is estimated for, or nil to use the
+          audience of each assertion.
+   */
+  NSURL *_issuer;
+}
+
+- (nullable instancetype)init
+    OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithMethod:clientID:clientSecret:signer:));
+
+- (instancetype)initWithMethod:(NSString *)method
+                      clientID:(NSString *)clientID
+                  clientSecret:(nullable NSString *)clientSecret
+                        signer:(nullable id<OIDJWSSigner>)signer {
+  self = [super init];
+  if (self) {
+    _method = [method copy];
+    _clientID = [clientID copy];
+    _signer = signer;
+    _assertionLifetime = kDefaultAssertionLifetime;
+    _assertionReuseInterval = kDefaultAssertionReuseInterval;
+    if ([method isEqualToString:OIDClientAuthenticationMethodClientSecretBasic]) {
+      NSString *credentials = [NSString stringWithFormat:@"%@:%@",
+                                                         OIDFormEncode(clientID),
+                                                         OIDFormEncode(clientSecret)];
+      NSData *credentialsData = [credentials dataUsingEncoding:NSUTF8StringEncoding];
+      _basicAuthorization = [NSString stringWithFormat:@"Basic %@",
+          [credentialsData base64EncodedStringWithOptions:0]];
+    } else if ([method isEqualToString:OIDClientAuthenticationMethodClientSecretPost]) {
+      _postParameters =
+          [NSString stringWithFormat:@"%@=%@", kClientSecretKey, OIDFormEncode(clientSecret)];
+    }
+  }
+  return self;
+}
+
++ (instancetype)clientSecretBasicAuthenticationWithClientID:(NSString *)clientID
+                                               clientSecret:(NSString *)clientSecret {
+  return [[self alloc] initWithMethod:OIDClientAuthenticationMethodClientSecretBasic
+                             clientID:clientID
+                         clientSecret:clientSecret
+                               signer:nil];
+}
+
++ (instancetype)clientSecretPostAuthenticationWithClientID:(NSString *)clientID
+                                              clientSecret:(NSString *)clientSecret {
+  return [[self alloc] initWithMethod:OIDClientAuthenticationMethodClientSecretPost
+                             clientID:clientID
+                         clientSecret:clientSecret
+                               signer:nil];
+}
+
++ (instancetype)clientSecretJWTAuthenticationWithClientID:(NSString *)clientID
+                                             clientSecret:(NSString *)clientSecret {
+  OIDClientSecretSigner *signer = [[OIDClientSecretSigner alloc] initWithClientSecret:clientSecret];
+  return [[self alloc] initWithMethod:OIDClientAuthenticationMethodClientSecretJWT
+                             clientID:clientID
+                         clientSecret:nil
+                               signer:signer];
+}
+
++ (instancetype)privateKeyJWTAuthenticationWithClientID:(NSString *)clientID
+                                                 signer:(id<OIDJWSSigner>)signer {
+  return [[self alloc] initWithMethod:OIDClientAuthenticationMethodPrivateKeyJWT
+                             clientID:clientID
+                         clientSecret:nil
+                               signer:signer];
+}
+
++ (nullable instancetype)authenticationWithConfiguration:(OIDServiceConfiguration *)configuration
+                                                clientID:(NSString *)clientID
+                                            clientSecret:(nullable NSString *)clientSecret
+                                                  signer:(nullable id<OIDJWSSigner>)signer {
+  OIDServiceDiscovery *discovery = configuration.discoveryDocument;
+  NSArray<NSString *> *methods = discovery.tokenEndpointAuthMethodsSupported
+      ?: @[ OIDClientAuthenticationMethodClientSecretBasic ];
+  NSArray<NSString *> *algorithms = discovery.tokenEndpointAuthSigningAlgorithmValuesSupported;
+
+  OIDClientAuthentication *authentication;
+  if (signer && [methods containsObject:OIDClientAuthenticationMethodPrivateKeyJWT]
+      && (!algorithms || [algorithms containsObject:signer.algorithm])) {
+    authentication = [self privateKeyJWTAuthenticationWithClientID:clientID signer:signer];
+  } else if (clientSecret && [methods containsObject:OIDClientAuthenticationMethodClientSecretJWT]
+             && (!algorithms || [algorithms containsObject:kHMACAlgorithm])) {
+    authentication =
+        [self clientSecretJWTAuthenticationWithClientID:clientID clientSecret:clientSecret];
+  }
+  if (authentication) {
+    // the server's clock offset is recorded under the same URL
+    authentication->_issuer = [OIDClockSkewEstimator issuerForConfiguration:configuration];
+    return authentication;
+  }
+  if (!clientSecret) {
+    return nil;
+  }
+  if ([methods containsObject:OIDClientAuthenticationMethodClientSecretBasic]) {
+    return [self clientSecretBasicAuthenticationWithClientID:clientID clientSecret:clientSecret];
+  }
+  if ([methods containsObject:OIDClientAuthenticationMethodClientSecretPost]) {
+    return [self clientSecretPostAuthenticationWithClientID:clientID clientSecret:clientSecret];
+  }
+  return nil;
+}
+
+- (nullable NSURLRequest *)requestByAuthenticatingRequest:(NSURLRequest *)request
+                                                    error:(NSError **_Nullable)error {
+  NSMutableURLRequest *authenticatedRequest = [request mutableCopy];
+  if (_basicAuthorization) {
+    [authenticatedRequest setValue:_basicAuthorization forHTTPHeaderField:kAuthorizationHeaderKey];
+    return authenticatedRequest;
+  }
+
+  NSString *parameters = _postParameters;
+  if (_signer) {
+    NSString *assertion = [self assertionForAudience:request.URL.absoluteString error:error];
+    if (!assertion) {
+      return nil;
+    }
+    parameters = [NSString stringWithFormat:@"%@=%@&%@=%@",
+                                            kClientAssertionTypeKey,
+                                            OIDFormEncode(kJWTBearerAssertionType),
+                                            kClientAssertionKey,
+                                            assertion];
+  }
+  NSMutableData *body = [request.HTTPBody mutableCopy] ?: [NSMutableData data];
+  if (body.length) {
+    [body appendBytes:"&" length:1];
+  }
+  [body appendData:[parameters dataUsingEncoding:NSUTF8StringEncoding]];
+  authenticatedRequest.HTTPBody = body;
+  return authenticatedRequest;
+}
+
+- (void)discardCachedAssertion {
+  @synchronized(self) {
+    _assertion = nil;
+    _assertionAudience = nil;
+    _assertionIssuedAt = nil;
+  }
+}
+
+/*! @fn assertionForAudience:error:
+    @brief Returns the cached client assertion if it was signed for the audience within the reuse
+        interval, otherwise signs a new one.
+    @discussion Assertions are compact JWS strings, which are already form-safe.
+ */
+- (nullable NSString *)assertionForAudience:(NSString *)audience error:(NSError **_Nullable)error {
+  @synchronized(self) {
+    NSDate *now = [OIDClock sharedClock].now;
+    NSTimeInterval lifetime = self.assertionLifetime;
+    NSTimeInterval reuseInterval = MIN(self.assertionReuseInterval, lifetime / 2);
+    if (_assertion && [_assertionAudience isEqualToString:audience]
+        && [now timeIntervalSinceDate:_assertionIssuedAt] < reuseInterval) {
+      return _assertion;
+    }
+
+    if (!_assertionHeaderPrefix) {
+      NSMutableDictionary<NSString *, id> *header =
+          [@{ @"alg" : _signer.algorithm, @"typ" : @"JWT" } mutableCopy];
+      if ([_signer respondsToSelector:@selector(keyID)]) {
+        header[@"kid"] = _signer.keyID;
+      }
+      _assertionHeaderPrefix = [OIDTokenUtilities JWSHeaderPrefixWithHeader:header];
+    }
+    NSString *jti = [OIDTokenUtilities randomURLSafeStringWithSize:kJTISize];
+    // the server validates these claims against its own clock
+    NSURL *issuer = _issuer ?: [NSURL URLWithString:audience];
+    NSDate *serverNow =
+        issuer ? [[OIDClockSkewEstimator sharedEstimator] serverDateForIssuer:issuer] : now;
+    long long issuedAt = (long long)serverNow.timeIntervalSince1970;
+    NSString *assertion;
+    NSError *signingError;
+    if (_assertionHeaderPrefix && jti) {
+      NSDictionary<NSString *, id> *claims = @{
+        @"iss" : _clientID,
+        @"sub" : _clientID,
+        @"aud" : audience,
+        @"jti" : jti,
+        @"iat" : @(issuedAt),
+        @"exp" : @(issuedAt + (long long)lifetime),
+      };
+      assertion = [OIDTokenUtilities JWSWithHeaderPrefix:_assertionHeaderPrefix
+                                                  claims:claims
+                                                  signer:_signer
+                                                   error:&signingError];
+    }
+    if (!assertion) {
+      if (error) {
+        *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeClientAuthenticationError
+                                  underlyingError:signingError
+                                      description:@"Failed to sign a client assertion."];
+      }
+      return nil;
+    }
+    _assertion = assertion;
+    _assertionAudience = [audience copy];
+    _assertionIssuedAt = now;
+    return assertion;
+  }
+}
+
+@end
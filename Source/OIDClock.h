@@ -0,0 +1,62 @@
+/*! @file OIDClock.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDClock
+    @brief The source of time for token expiry and the timers of @c OIDAuthState.
+    @discussion The shared clock reads the system clocks and schedules work on the main queue.
+        Replace it with a subclass to run the library against virtual time, for example to
+        simulate days of token refreshes in a test.
+ */
+@interface OIDClock : NSObject
+
+/*! @fn sharedClock
+    @brief The clock the library uses.
+ */
++ (OIDClock *)sharedClock;
+
+/*! @fn setSharedClock:
+    @brief Replaces the clock the library uses.
+    @param clock The new shared clock.
+ */
++ (void)setSharedClock:(OIDClock *)clock;
+
+/*! @property now
+    @brief The current wall clock time.
+ */
+@property(nonatomic, readonly) NSDate *now;
+
+/*! @fn monotonicTimeInterval
+    @brief The current time, in seconds, on a clock which is unaffected by changes to the
+        device's date and time.
+    @discussion The clock does not advance while the device is asleep, so intervals measured with
+        it are a lower bound. The epoch is unspecified.
+ */
+- (NSTimeInterval)monotonicTimeInterval;
+
+/*! @fn performAfterDelay:block:
+    @brief Performs a block on the main queue once the given number of seconds has passed.
+ */
+- (void)performAfterDelay:(NSTimeInterval)delay block:(dispatch_block_t)block;
+
+@end
+
+NS_ASSUME_NONNULL_END
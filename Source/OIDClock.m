@@ -0,0 +1,57 @@
+/*! @file OIDClock.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDClock.h"
+
+/*! @var gSharedClock
+    @brief The clock returned by @c sharedClock. Synchronized on the class.
+ */
+static OIDClock *gSharedClock;
+
+@implementation OIDClock
+
++ (OIDClock *)sharedClock {
+  @synchronized(self) {
+    if (!gSharedClock) {
+      gSharedClock = [[OIDClock alloc] init];
+    }
+    return gSharedClock;
+  }
+}
+
++ (void)setSharedClock:(OIDClock *)clock {
+  @synchronized(self) {
+    gSharedClock = clock;
+  }
+}
+
+- (NSDate *)now {
+  return [NSDate date];
+}
+
+- (NSTimeInterval)monotonicTimeInterval {
+  return [NSProcessInfo processInfo].systemUptime;
+}
+
+- (void)performAfterDelay:(NSTimeInterval)delay block:(dispatch_block_t)block {
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                 dispatch_get_main_queue(),
+                 block);
+}
+
+@end
@@ -0,0 +1,122 @@
+/*! @file OIDClockSkewEstimator.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OIDServiceConfiguration;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDClockSkewEstimator
+    @brief Estimates the offset between the device's clock and the clock of each authorization
+        server, so that absolute times can be compared across the two.
+    @discussion Samples come from the HTTP @c Date header of token endpoint responses and the
+        @c iat claim of freshly issued ID tokens, both of which are the server's idea of "now".
+        Both have one second resolution and include network latency, so samples are smoothed
+        with an exponentially weighted moving average. A sample far from the estimate is discarded
+        as an outlier, unless several in a row are, as happens when the device's clock is changed,
+        in which case the estimate restarts from the latest sample.
+
+        Authorization servers are identified by the origin (scheme, host and port) of any of
+        their endpoint URLs. The library uses @c issuerForConfiguration:.
+ */
+@interface OIDClockSkewEstimator : NSObject
+
+/*! @fn sharedEstimator
+    @brief The estimator which token requests and responses use.
+ */
++ (OIDClockSkewEstimator *)sharedEstimator;
+
+/*! @fn issuerForConfiguration:
+    @brief The URL identifying a configuration's authorization server: its discovered issuer,
+        or its token endpoint if it wasn't discovered.
+ */
++ (NSURL *)issuerForConfiguration:(OIDServiceConfiguration *)configuration;
+
+/*! @fn monotonicTimeInterval
+    @brief The current time, in seconds, on a clock which is unaffected by changes to the
+        device's date and time.
+    @discussion The clock does not advance while the device is asleep, so intervals measured with
+        it are a lower bound. The epoch is unspecified.
+    @see OIDClock.monotonicTimeInterval
+ */
++ (NSTimeInterval)monotonicTimeInterval;
+
+/*! @fn dateWithHTTPDate:
+    @brief Parses an HTTP date in the preferred IMF-fixdate format, for example
+        "Sun, 06 Nov 1994 08:49:37 GMT".
+    @param HTTPDate The value of a @c Date header.
+    @return The date, or nil if @c HTTPDate isn't an IMF-fixdate.
+    @see https://tools.ietf.org/html/rfc7231#section-7.1.1.1
+ */
++ (nullable NSDate *)dateWithHTTPDate:(NSString *)HTTPDate;
+
+/*! @fn recordServerDate:localDate:forIssuer:
+    @brief Adds a sample of the server's clock.
+    @param serverDate The time according to the server.
+    @param localDate The time according to this device at the same moment.
+    @param issuer Any endpoint URL of the authorization server.
+ */
+- (void)recordServerDate:(NSDate *)serverDate
+               localDate:(NSDate *)localDate
+               forIssuer:(NSURL *)issuer;
+
+/*! @fn recordDateHeaderOfResponse:forIssuer:
+    @brief Adds a sample from the @c Date header of a response which was just received, if it
+        has one.
+    @param response The HTTP response.
+    @param issuer Any endpoint URL of the authorization server.
+ */
+- (void)recordDateHeaderOfResponse:(NSHTTPURLResponse *)response forIssuer:(NSURL *)issuer;
+
+/*! @fn recordIssuedAtOfIDToken:forIssuer:
+    @brief Adds a sample from the @c iat claim of an ID token which was just issued, if it can be
+        read.
+    @discussion Only pass ID tokens the response newly issued. A refresh response may repeat the
+        ID token first issued with the grant, whose @c iat is long past.
+    @param idToken The ID token, as a JWT. Its signature is not checked; a token with a forged
+        @c iat can only make the estimate less accurate.
+    @param issuer Any endpoint URL of the authorization server.
+ */
+- (void)recordIssuedAtOfIDToken:(NSString *)idToken forIssuer:(NSURL *)issuer;
+
+/*! @fn hasClockOffsetForIssuer:
+    @brief Whether any samples have been recorded for the authorization server.
+    @param issuer Any endpoint URL of the authorization server.
+ */
+- (BOOL)hasClockOffsetForIssuer:(NSURL *)issuer;
+
+/*! @fn clockOffsetForIssuer:
+    @brief The estimated number of seconds the authorization server's clock is ahead of this
+        device's, or 0 if no samples have been recorded.
+    @param issuer Any endpoint URL of the authorization server.
+ */
+- (NSTimeInterval)clockOffsetForIssuer:(NSURL *)issuer;
+
+/*! @fn serverDateForIssuer:
+    @brief The current time according to the authorization server: the shared @c OIDClock's
+        time plus the estimated clock offset.
+    @discussion Use this for the @c iat, @c nbf and @c exp claims of JWTs the server validates,
+        so they are accepted even if the device's clock is wrong.
+    @param issuer Any endpoint URL of the authorization server.
+ */
+- (NSDate *)serverDateForIssuer:(NSURL *)issuer;
+
+@end
+
+NS_ASSUME_NONNULL_END
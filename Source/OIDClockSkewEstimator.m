@@ -0,0 +1,217 @@
+/*! @file OIDClockSkewEstimator.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDClockSkewEstimator.h"
+
+#import "OIDClock.h"
+#import "OIDServiceConfiguration.h"
+#import "OIDServiceDiscovery.h"
+#import "OIDTokenUtilities.h"
+
+/*! @var kDateHeaderField
+    @brief The HTTP header containing the date and time the response was generated.
+ */
+static NSString *const kDateHeaderField = @"Date";
+
+/*! @var kIssuedAtClaim
+    @brief The ID token claim containing the time it was issued, in seconds since 1970.
+ */
+static NSString *const kIssuedAtClaim = @"iat";
+
+/*! @var kSampleWeight
+    @brief The weight of each new sample in the moving average of the clock offset.
+ */
+static const double kSampleWeight = 0.25;
+
+/*! @var kTruncatedSecondCorrection
+    @brief Added to server times with whole second resolution, which were truncated on average by
+        half a second.
+ */
+static const NSTimeInterval kTruncatedSecondCorrection = 0.5;
+
+/*! @var kMaximumSampleDeviation
+    @brief Samples further than this many seconds from the estimate are discarded as outliers.
+ */
+static const NSTimeInterval kMaximumSampleDeviation = 300;
+
+/*! @var kMaximumConsecutiveOutliers
+    @brief The number of outliers in a row which are discarded before the estimate restarts from
+        the next one.
+ */
+static const NSUInteger kMaximumConsecutiveOutliers = 3;
+
+@implementation OIDClockSkewEstimator {
+  /*! @var _offsets
+      @brief The estimated clock offset of each authorization server, keyed by origin.
+          Synchronized on @c self.
+   */
+  NSMutableDictionary<NSString *, NSNumber *> *_offsets;
+
+  /*! @var _outlierCounts
+      @brief The number of outliers in a row discarded for each authorization server, keyed by
+          origin. Synchronized on @c self.
+   */
+  NSMutableDictionary<NSString *, NSNumber *> *_outlierCounts;
+}
+
++ (OIDClockSkewEstimator *)sharedEstimator {
+  static OIDClockSkewEstimator *sharedEstimator;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    sharedEstimator = [[OIDClockSkewEstimator alloc] init];
+  });
+  return sharedEstimator;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _offsets = [NSMutableDictionary dictionary];
+    _outlierCounts = [NSMutableDictionary dictionary];
+  }
+  return self;
+}
+
++ (NSURL *)issuerForConfiguration:(OIDServiceConfiguration *)configuration {
+  return configuration.discoveryDocument.issuer ?: configuration.tokenEndpoint;
+}
+
+#pragma mark - Clocks
+
++ (NSTimeInterval)monotonicTimeInterval {
+  return [[OIDClock sharedClock] monotonicTimeInterval];
+}
+
+/*! @fn HTTPDateFormatter
+    @brief A date formatter for IMF-fixdate, which is always in English and GMT.
+ */
++ (NSDateFormatter *)HTTPDateFormatter {
+  static NSDateFormatter *formatter;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    formatter = [[NSDateFormatter alloc] init];
+    formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+    formatter.timeZone = [NSTimeZone timeZoneForSecondsFromGMT:0];
+    formatter.dateFormat = @"EEE',' dd MMM yyyy HH':'mm':'ss 'GMT'";
+  });
+  return formatter;
+}
+
++ (nullable NSDate *)dateWithHTTPDate:(NSString *)HTTPDate {
+  return [[self HTTPDateFormatter] dateFromString:HTTPDate];
+}
+
+#pragma mark - Samples
+
+/*! @fn keyForIssuer:
+    @brief Returns the origin of an authorization server endpoint URL.
+ */
++ (NSString *)keyForIssuer:(NSURL *)issuer {
+  NSString *scheme = issuer.scheme.lowercaseString;
+  NSNumber *port = issuer.port;
+  if (!port) {
+    port = [scheme isEqualToString:@"http"] ? @80 : @443;
+  }
+  return [NSString stringWithFormat:@"%@://%@:%@", scheme, issuer.host.lowercaseString, port];
+}
+
+- (void)recordServerDate:(NSDate *)serverDate
+               localDate:(NSDate *)localDate
+               forIssuer:(NSURL *)issuer {
+  NSTimeInterval sample = [serverDate timeIntervalSinceDate:localDate];
+  NSString *key = [[self class] keyForIssuer:issuer];
+  @synchronized(self) {
+    NSNumber *offset = _offsets[key];
+    if (!offset) {
+      _offsets[key] = @(sample);
+      return;
+    }
+    if (fabs(sample - offset.doubleValue) > kMaximumSampleDeviation) {
+      NSUInteger outlierCount = _outlierCounts[key].unsignedIntegerValue + 1;
+      if (outlierCount <= kMaximumConsecutiveOutliers) {
+        _outlierCounts[key] = @(outlierCount);
+        return;
+      }
+      // the outliers persist, so the device's clock was most likely changed
+      [_outlierCounts removeObjectForKey:key];
+      _offsets[key] = @(sample);
+      return;
+    }
+    [_outlierCounts removeObjectForKey:key];
+    _offsets[key] = @(offset.doubleValue + kSampleWeight * (sample - offset.doubleValue));
+  }
+}
+
+- (void)recordDateHeaderOfResponse:(NSHTTPURLResponse *)response forIssuer:(NSURL *)issuer {
+  NSString *HTTPDate = response.allHeaderFields[kDateHeaderField];
+  if (![HTTPDate isKindOfClass:[NSString class]]) {
+    return;
+  }
+  NSDate *serverDate = [[self class] dateWithHTTPDate:HTTPDate];
+  if (!serverDate) {
+    return;
+  }
+  [self recordServerDate:[serverDate dateByAddingTimeInterval:kTruncatedSecondCorrection]
+               localDate:[OIDClock sharedClock].now
+               forIssuer:issuer];
+}
+
+- (void)recordIssuedAtOfIDToken:(NSString *)idToken forIssuer:(NSURL *)issuer {
+  NSArray<NSString *> *segments = [idToken componentsSeparatedByString:@"."];
+  if (segments.count < 2) {
+    return;
+  }
+  NSData *payloadData = [OIDTokenUtilities decodeBase64urlNoPadding:segments[1]];
+  if (!payloadData) {
+    return;
+  }
+  id payload = [NSJSONSerialization JSONObjectWithData:payloadData options:0 error:NULL];
+  if (![payload isKindOfClass:[NSDictionary class]]) {
+    return;
+  }
+  NSNumber *issuedAt = ((NSDictionary *)payload)[kIssuedAtClaim];
+  if (![issuedAt isKindOfClass:[NSNumber class]]) {
+    return;
+  }
+  NSTimeInterval serverTime = issuedAt.doubleValue + kTruncatedSecondCorrection;
+  [self recordServerDate:[NSDate dateWithTimeIntervalSince1970:serverTime]
+               localDate:[OIDClock sharedClock].now
+               forIssuer:issuer];
+}
+
+#pragma mark - Estimates
+
+- (BOOL)hasClockOffsetForIssuer:(NSURL *)issuer {
+  NSString *key = [[self class] keyForIssuer:issuer];
+  @synchronized(self) {
+    return _offsets[key] != nil;
+  }
+}
+
+- (NSTimeInterval)clockOffsetForIssuer:(NSURL *)issuer {
+  NSString *key = [[self class] keyForIssuer:issuer];
+  @synchronized(self) {
+    return _offsets[key].doubleValue;
+  }
+}
+
+- (NSDate *)serverDateForIssuer:(NSURL *)issuer {
+  return [[OIDClock sharedClock].now dateByAddingTimeInterval:[self clockOffsetForIssuer:issuer]];
+}
+
+@end
@@ -0,0 +1,46 @@
+/*! @file OIDConnectivityMonitor.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @protocol OIDConnectivityMonitor
+    @brief Reports whether the network is reachable, so that work which needs it can wait.
+    @discussion @c OIDNetworkReachabilityMonitor is the default implementation. Other
+        implementations can be used to share an app's existing reachability logic, or to simulate
+        connectivity changes in tests.
+    @see OIDAuthState.connectivityMonitor
+ */
+@protocol OIDConnectivityMonitor <NSObject>
+
+/*! @property reachable
+    @brief Whether the network is currently reachable. May be called on any thread.
+ */
+@property(nonatomic, readonly, getter=isReachable) BOOL reachable;
+
+/*! @fn performWhenReachable:
+    @brief Calls the block on the main queue once the network is reachable, or as soon as possible
+        if it already is.
+    @param block The block to call. Each block is called at most once.
+ */
+- (void)performWhenReachable:(dispatch_block_t)block;
+
+@end
+
+NS_ASSUME_NONNULL_END
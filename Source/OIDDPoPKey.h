@@ -0,0 +1,42 @@
+/*! @file OIDDPoPKey.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "OIDJWSSigner.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @protocol OIDDPoPKey
+    @brief An asymmetric key which DPoP proofs are signed with, such as a P-256 key in the Secure
+        Enclave or the keychain.
+    @discussion The key's public half and algorithm are read once by @c OIDDPoPProofGenerator, so
+        they must not change. Only @c signatureForSigningInput:error: is called for each proof.
+    @see https://www.rfc-editor.org/rfc/rfc9449
+ */
+@protocol OIDDPoPKey <OIDJWSSigner>
+
+/*! @property publicJWK
+    @brief The public key as a JSON Web Key, with only its public members.
+    @see https://www.rfc-editor.org/rfc/rfc7517
+ */
+@property(nonatomic, readonly) NSDictionary<NSString *, NSString *> *publicJWK;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,115 @@
+/*! @file OIDDPoPProofGenerator.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "OIDDPoPKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @var OIDDPoPHeaderField
+    @brief The request header field DPoP proofs are sent in.
+ */
+extern NSString *const OIDDPoPHeaderField;
+
+/*! @var OIDDPoPNonceHeaderField
+    @brief The response header field servers send DPoP nonces in.
+ */
+extern NSString *const OIDDPoPNonceHeaderField;
+
+/*! @class OIDDPoPProofGenerator
+    @brief Creates DPoP proofs, which bind tokens to a key held by the client.
+    @discussion The parts of a proof which depend only on the key are computed once, when the
+        generator is created: the JWK thumbprint, and the encoded JOSE header with the public key
+        which starts every proof. Each proof then only encodes its claims and signs them.
+
+        Servers may require proofs to contain a nonce they issued. Nonces received in
+        @c DPoP-Nonce response headers are recorded per endpoint, and included in later proofs for
+        that endpoint. @c OIDAuthorizationService records the token endpoint's nonces itself, and
+        retries a token request once if it was rejected for lacking the current nonce.
+
+        A generator may be used from any thread.
+    @see https://www.rfc-editor.org/rfc/rfc9449
+ */
+@interface OIDDPoPProofGenerator : NSObject
+
+/*! @property key
+    @brief The key proofs are signed with.
+ */
+@property(nonatomic, readonly) id<OIDDPoPKey> key;
+
+/*! @property thumbprint
+    @brief The base64url-encoded SHA-256 JWK thumbprint of the key, which is the value of the
+        @c dpop_jkt authorization request parameter.
+    @see https://www.rfc-editor.org/rfc/rfc7638
+    @see https://www.rfc-editor.org/rfc/rfc9449#section-10
+ */
+@property(nonatomic, readonly) NSString *thumbprint;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use @c initWithKey:.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn initWithKey:
+    @brief Designated initializer.
+    @param key The key to sign proofs with.
+    @return The generator, or nil if the key's public JWK lacks the members its key type requires.
+ */
+- (nullable instancetype)initWithKey:(id<OIDDPoPKey>)key NS_DESIGNATED_INITIALIZER;
+
+/*! @fn proofForHTTPMethod:URL:accessToken:error:
+    @brief Creates a proof for a single request.
+    @param HTTPMethod The request's method.
+    @param URL The request's URL. Its query and fragment aren't part of the proof.
+    @param accessToken The access token sent with the request to a resource server, which the
+        proof is bound to, or nil for requests to the token endpoint.
+    @param error If the key could not sign the proof, the reason.
+    @return The compact serialization of the proof.
+    @discussion The @c iat claim is the server's time, from
+        @c OIDClockSkewEstimator.serverDateForIssuer: for the request's URL.
+ */
+- (nullable NSString *)proofForHTTPMethod:(NSString *)HTTPMethod
+                                      URL:(NSURL *)URL
+                              accessToken:(nullable NSString *)accessToken
+                                    error:(NSError **_Nullable)error;
+
+/*! @fn requestBySigningRequest:accessToken:error:
+    @brief Returns a copy of a request with a proof in its @c DPoP header, and if an access token
+        is given, that token in its @c Authorization header with the @c DPoP scheme.
+    @param request The request to sign.
+    @param accessToken The DPoP-bound access token to send, or nil for token requests.
+    @param error If the key could not sign the proof, the reason.
+ */
+- (nullable NSURLRequest *)requestBySigningRequest:(NSURLRequest *)request
+                                       accessToken:(nullable NSString *)accessToken
+                                             error:(NSError **_Nullable)error;
+
+/*! @fn recordNonceFromResponse:
+    @brief Records the nonce in a response's @c DPoP-Nonce header, if any, for the endpoint the
+        response came from.
+    @param response A response from the authorization server or a resource server.
+    @return YES if the response had a nonce which differs from the one recorded before, meaning a
+        request rejected with a @c use_dpop_nonce error can be retried with it.
+ */
+- (BOOL)recordNonceFromResponse:(NSHTTPURLResponse *)response;
+
+@end
+
+NS_ASSUME_NONNULL_END
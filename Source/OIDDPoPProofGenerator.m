@@ -0,0 +1,228 @@
+/*! @file OIDDPoPProofGenerator.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDDPoPProofGenerator.h"
+
+#import "OIDClockSkewEstimator.h"
+#import "OIDDefines.h"
+#import "OIDErrorUtilities.h"
+#import "OIDTokenUtilities.h"
+
+NSString *const OIDDPoPHeaderField = @"DPoP";
+
+NSString *const OIDDPoPNonceHeaderField = @"DPoP-Nonce";
+
+/*! @var kProofType
+    @brief The @c typ header parameter of DPoP proofs.
+ */
+static NSString *const kProofType = @"dpop+jwt";
+
+/*! @var kAuthorizationScheme
+    @brief The HTTP authorization scheme for DPoP-bound access tokens.
+ */
+static NSString *const kAuthorizationScheme = @"DPoP";
+
+/*! @var kJTISize
+    @brief The number of random bytes in the @c jti claim of each proof.
+ */
+static NSUInteger const kJTISize = 16;
+
+/*! @fn OIDThumbprintMembersOfKeyType
+    @brief Returns the JWK members a thumbprint is computed over, in lexicographic order, or nil
+        for an unknown key type.
+    @see https://www.rfc-editor.org/rfc/rfc7638#section-3.2
+ */
+static NSArray<NSString *> *_Nullable OIDThumbprintMembersOfKeyType(NSString *keyType) {
+  if ([keyType isEqualToString:@"EC"]) {
+    return @[ @"crv", @"kty", @"x", @"y" ];
+  }
+  if ([keyType isEqualToString:@"RSA"]) {
+    return @[ @"e", @"kty", @"n" ];
+  }
+  if ([keyType isEqualToString:@"OKP"]) {
+    return @[ @"crv", @"kty", @"x" ];
+  }
+  return nil;
+}
+
+@implementation OIDDPoPProofGenerator {
+  /*! @var _headerPrefix
+      @brief The base64url-encoded JOSE header followed by a period, which starts every proof.
+   */
+  NSString *_headerPrefix;
+
+  /*! @var _nonces
+      @brief The latest nonce received from each endpoint, keyed by its @c htu value.
+          Synchronized on @c self.
+   */
+  NSMutableDictionary<NSString *, NSString *> *_nonces;
+
+  /*! @var _lastAccessToken
+      @brief The access token whose hash is @c _lastAccessTokenHash. Synchronized on @c self.
+   */
+  NSString *_lastAccessToken;
+
+  /*! @var _lastAccessTokenHash
+      @brief The @c ath claim for @c _lastAccessToken, as requests with the same token are
+          typically signed many times. Synchronized on @c self.
+   */
+  NSString *_lastAccessTokenHash;
+}
+
+- (nullable instancetype)init OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithKey:));
+
+- (nullable instancetype)initWithKey:(id<OIDDPoPKey>)key {
+  self = [super init];
+  if (self) {
+    _key = key;
+    NSDictionary<NSString *, NSString *> *publicJWK = [key.publicJWK copy];
+    _thumbprint = [[self class] thumbprintOfJWK:publicJWK];
+    if (!_thumbprint) {
+      return nil;
+    }
+    NSDictionary *header = @{ @"typ" : kProofType, @"alg" : key.algorithm, @"jwk" : publicJWK };
+    _headerPrefix = [OIDTokenUtilities JWSHeaderPrefixWithHeader:header];
+    if (!_headerPrefix) {
+      return nil;
+    }
+    _nonces = [NSMutableDictionary dictionary];
+  }
+  return self;
+}
+
+/*! @fn thumbprintOfJWK:
+    @brief Computes the SHA-256 thumbprint of a JWK, over the JSON object with just its required
+        members, in lexicographic order and without whitespace.
+    @return The base64url-encoded thumbprint, or nil if a required member is missing.
+ */
++ (nullable NSString *)thumbprintOfJWK:(NSDictionary<NSString *, NSString *> *)JWK {
+  NSArray<NSString *> *members = OIDThumbprintMembersOfKeyType(JWK[@"kty"]);
+  if (!members) {
+    return nil;
+  }
+  NSMutableString *canonicalJSON = [NSMutableString stringWithString:@"{"];
+  for (NSString *member in members) {
+    NSString *value = JWK[member];
+    if (![value isKindOfClass:[NSString class]]) {
+      return nil;
+    }
+    // serializes the value alone for its escaping, then drops the enclosing brackets
+    NSData *valueData = [NSJSONSerialization dataWithJSONObject:@[ value ] options:0 error:NULL];
+    NSString *arrayJSON = [[NSString alloc] initWithData:valueData
+                                                encoding:NSUTF8StringEncoding];
+    NSString *valueJSON = [arrayJSON substringWithRange:NSMakeRange(1, arrayJSON.length - 2)];
+    [canonicalJSON appendFormat:@"%@\"%@\":%@", canonicalJSON.length > 1 ? @"," : @"", member,
+                                valueJSON];
+  }
+  [canonicalJSON appendString:@"}"];
+  return [OIDTokenUtilities encodeBase64urlNoPadding:[OIDTokenUtilities sha265:canonicalJSON]];
+}
+
+/*! @fn targetURIOfURL:
+    @brief Returns the @c htu claim for a URL, which omits its query and fragment.
+ */
++ (NSString *)targetURIOfURL:(NSURL *)URL {
+  NSURLComponents *components = [NSURLComponents componentsWithURL:URL resolvingAgainstBaseURL:YES];
+  components.query = nil;
+  components.fragment = nil;
+  return components.URL.absoluteString ?: URL.absoluteString;
+}
+
+#pragma mark - Proofs
+
+- (nullable NSString *)proofForHTTPMethod:(NSString *)HTTPMethod
+                                      URL:(NSURL *)URL
+                              accessToken:(nullable NSString *)accessToken
+                                    error:(NSError **_Nullable)error {
+  NSString *targetURI = [[self class] targetURIOfURL:URL];
+  NSMutableDictionary<NSString *, id> *claims = [NSMutableDictionary dictionaryWithCapacity:6];
+  claims[@"jti"] = [OIDTokenUtilities randomURLSafeStringWithSize:kJTISize];
+  claims[@"htm"] = HTTPMethod;
+  claims[@"htu"] = targetURI;
+  // the server validates the proof's age against its own clock
+  NSDate *now = [[OIDClockSkewEstimator sharedEstimator] serverDateForIssuer:URL];
+  claims[@"iat"] = @((long long)now.timeIntervalSince1970);
+  @synchronized(self) {
+    claims[@"nonce"] = _nonces[targetURI];
+    if (accessToken) {
+      if (![_lastAccessToken isEqualToString:accessToken]) {
+        _lastAccessToken = [accessToken copy];
+        _lastAccessTokenHash =
+            [OIDTokenUtilities encodeBase64urlNoPadding:[OIDTokenUtilities sha265:accessToken]];
+      }
+      claims[@"ath"] = _lastAccessTokenHash;
+    }
+  }
+
+  NSError *signingError;
+  NSString *proof;
+  if (claims[@"jti"]) {
+    proof = [OIDTokenUtilities JWSWithHeaderPrefix:_headerPrefix
+                                            claims:claims
+                                            signer:_key
+                                             error:&signingError];
+  }
+  if (!proof) {
+    if (error) {
+      *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeDPoPProofError
+                                underlyingError:signingError
+                                    description:@"Failed to sign a DPoP proof."];
+    }
+    return nil;
+  }
+  return proof;
+}
+
+- (nullable NSURLRequest *)requestBySigningRequest:(NSURLRequest *)request
+                                       accessToken:(nullable NSString *)accessToken
+                                             error:(NSError **_Nullable)error {
+  NSString *proof = [self proofForHTTPMethod:request.HTTPMethod ?: @"GET"
+                                         URL:request.URL
+                                 accessToken:accessToken
+                                       error:error];
+  if (!proof) {
+    return nil;
+  }
+  NSMutableURLRequest *signedRequest = [request mutableCopy];
+  [signedRequest setValue:proof forHTTPHeaderField:OIDDPoPHeaderField];
+  if (accessToken) {
+    NSString *authorization =
+        [NSString stringWithFormat:@"%@ %@", kAuthorizationScheme, accessToken];
+    [signedRequest setValue:authorization forHTTPHeaderField:@"Authorization"];
+  }
+  return signedRequest;
+}
+
+#pragma mark - Nonces
+
+- (BOOL)recordNonceFromResponse:(NSHTTPURLResponse *)response {
+  NSString *nonce = response.allHeaderFields[OIDDPoPNonceHeaderField];
+  if (!nonce.length || !response.URL) {
+    return NO;
+  }
+  NSString *targetURI = [[self class] targetURIOfURL:response.URL];
+  @synchronized(self) {
+    if ([_nonces[targetURI] isEqualToString:nonce]) {
+      return NO;
+    }
+    _nonces[targetURI] = [nonce copy];
+    return YES;
+  }
+}
+
+@end
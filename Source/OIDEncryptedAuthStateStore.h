@@ -0,0 +1,100 @@
+/*! @file OIDEncryptedAuthStateStore.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OIDAuthState;
+@protocol OIDKeySource;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDEncryptedAuthStateStore
+    @brief Persists auth states in a directory, each encrypted and authenticated with a key from
+        an @c OIDKeySource.
+    @discussion Each auth state is a separate record, stored in its own file under an identifier
+        chosen by the app, so saving one state from @c OIDAuthStateChangeDelegate.didChangeState:
+        encrypts and writes only that record. A save is skipped entirely if the state archives to
+        the same bytes as the record last saved or loaded by this store.
+
+        The data key is fetched from the key source the first time it's needed and cached for the
+        lifetime of the store. Records are encrypted with AES-256 in CTR mode under a random nonce
+        generated for every save, and authenticated with HMAC-SHA256 over the ciphertext and the
+        record's identifier (encrypt-then-MAC), so records that were modified, swapped between
+        identifiers, or encrypted under another key are rejected rather than decoded. The
+        primitives are CommonCrypto's on Apple platforms and OpenSSL's elsewhere.
+ */
+@interface OIDEncryptedAuthStateStore : NSObject
+
+/*! @property directoryURL
+    @brief The directory containing the records, which is created on the first save.
+ */
+@property(nonatomic, readonly) NSURL *directoryURL;
+
+/*! @property keySource
+    @brief The source of the data key.
+ */
+@property(nonatomic, readonly) id<OIDKeySource> keySource;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use @c initWithDirectoryURL:keySource:.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn initWithDirectoryURL:keySource:
+    @brief Designated initializer.
+    @param directoryURL The file URL of the directory to store records in.
+    @param keySource The source of the key records are encrypted with.
+ */
+- (nullable instancetype)initWithDirectoryURL:(NSURL *)directoryURL
+                                    keySource:(id<OIDKeySource>)keySource
+    NS_DESIGNATED_INITIALIZER;
+
+/*! @fn saveAuthState:forIdentifier:error:
+    @brief Encrypts and stores an auth state, replacing any record with the same identifier.
+    @param authState The auth state to store.
+    @param identifier Identifies the record, for example the account the state belongs to.
+    @param error If the state could not be stored, the key source or file system error.
+    @return YES if the state was stored, or was unchanged since it was last saved or loaded.
+ */
+- (BOOL)saveAuthState:(OIDAuthState *)authState
+        forIdentifier:(NSString *)identifier
+                error:(NSError **_Nullable)error;
+
+/*! @fn authStateForIdentifier:error:
+    @brief Reads, authenticates and decrypts a stored auth state.
+    @param identifier The identifier the state was saved with.
+    @param error If the record could not be read, the reason. An error with the code
+        @c OIDErrorCodeStoredRecordInvalid indicates the record failed authentication.
+    @return The stored auth state, or nil if there is no record with the identifier or an error
+        occurred.
+ */
+- (nullable OIDAuthState *)authStateForIdentifier:(NSString *)identifier
+                                            error:(NSError **_Nullable)error;
+
+/*! @fn removeAuthStateForIdentifier:error:
+    @brief Deletes a stored auth state.
+    @param identifier The identifier the state was saved with.
+    @param error If the record could not be removed, the underlying file system error.
+    @return YES if the record was removed, or nothing was stored.
+ */
+- (BOOL)removeAuthStateForIdentifier:(NSString *)identifier error:(NSError **_Nullable)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
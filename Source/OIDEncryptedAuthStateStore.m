@@ -0,0 +1,435 @@
+/*! @file OIDEncryptedAuthStateStore.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDEncryptedAuthStateStore.h"
+
+#import "OIDAuthState.h"
+#import "OIDDefines.h"
+#import "OIDErrorUtilities.h"
+#import "OIDKeySource.h"
+#import "OIDTokenUtilities.h"
+
+#if __has_include(<CommonCrypto/CommonCryptor.h>)
+#import <CommonCrypto/CommonCryptor.h>
+#import <CommonCrypto/CommonHMAC.h>
+#define OID_HAS_COMMON_CRYPTO 1
+#else
+// GNUstep on Linux, for the AppAuthCore library; see GNUmakefile
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#endif
+
+/*! @var kEncryptionKeyLength
+    @brief The length of the AES-256 key, which is the first part of the data key.
+ */
+static NSUInteger const kEncryptionKeyLength = 32;
+
+/*! @var kAuthenticationKeyLength
+    @brief The length of the HMAC-SHA256 key, which is the second part of the data key.
+ */
+static NSUInteger const kAuthenticationKeyLength = 32;
+
+/*! @var kNonceLength
+    @brief The length of the random initial counter block of each record.
+ */
+static NSUInteger const kNonceLength = 16;
+
+/*! @var kTagLength
+    @brief The length of the HMAC-SHA256 tag at the end of each record.
+ */
+static NSUInteger const kTagLength = 32;
+
+/*! @var kRecordFormatVersion
+    @brief The first byte of each record, identifying its format: the version byte, the nonce, the
+        ciphertext, then the tag.
+ */
+static uint8_t const kRecordFormatVersion = 1;
+
+/*! @var kRecordHeaderLength
+    @brief The length of the version byte and 16 byte nonce at the start of each record.
+ */
+static NSUInteger const kRecordHeaderLength = 17;
+
+/*! @var kRecordPathExtension
+    @brief The path extension of record files.
+ */
+static NSString *const kRecordPathExtension = @"authstate";
+
+/*! @var kDigestKeyLabel
+    @brief The HKDF info label of the key for plaintext digests, which keeps them apart from the
+        record tags computed with the authentication key.
+ */
+static NSString *const kDigestKeyLabel = @"org.openid.appauth.authstate.digest";
+
+/*! @fn OIDApplyAES256CTR
+    @brief Encrypts or decrypts bytes with AES-256 in CTR mode, which are the same operation.
+    @param key The 32 byte encryption key.
+    @param nonce The 16 byte initial counter block.
+    @param output A buffer of at least @c length bytes.
+    @return Whether the operation succeeded.
+ */
+static BOOL OIDApplyAES256CTR(const uint8_t *key,
+                              const uint8_t *nonce,
+                              const uint8_t *input,
+                              size_t length,
+                              uint8_t *output) {
+#if OID_HAS_COMMON_CRYPTO
+  CCCryptorRef cryptor = NULL;
+  CCCryptorStatus status = CCCryptorCreateWithMode(kCCEncrypt, kCCModeCTR, kCCAlgorithmAES,
+                                                   ccNoPadding, nonce, key, kEncryptionKeyLength,
+                                                   NULL, 0, 0, kCCModeOptionCTR_BE, &cryptor);
+  if (status != kCCSuccess) {
+    return NO;
+  }
+  size_t moved = 0;
+  status = CCCryptorUpdate(cryptor, input, length, output, length, &moved);
+  CCCryptorRelease(cryptor);
+  return status == kCCSuccess && moved == length;
+#else
+  EVP_CIPHER_CTX *context = EVP_CIPHER_CTX_new();
+  if (!context) {
+    return NO;
+  }
+  int moved = 0;
+  int finalMoved = 0;
+  BOOL success = EVP_EncryptInit_ex(context, EVP_aes_256_ctr(), NULL, key, nonce) == 1
+      && EVP_EncryptUpdate(context, output, &moved, input, (int)length) == 1
+      && EVP_EncryptFinal_ex(context, output + moved, &finalMoved) == 1
+      && (size_t)(moved + finalMoved) == length;
+  EVP_CIPHER_CTX_free(context);
+  return success;
+#endif
+}
+
+/*! @fn OIDHMACSHA256
+    @brief Computes the HMAC-SHA256 of bytes.
+    @param key The 32 byte authentication key.
+    @param tag A buffer of @c kTagLength bytes for the result.
+ */
+static void OIDHMACSHA256(const uint8_t *key, const void *bytes, size_t length, uint8_t *tag) {
+#if OID_HAS_COMMON_CRYPTO
+  CCHmac(kCCHmacAlgSHA256, key, kAuthenticationKeyLength, bytes, length, tag);
+#else
+  unsigned int tagLength = (unsigned int)kTagLength;
+  HMAC(EVP_sha256(), key, (int)kAuthenticationKeyLength, bytes, length, tag, &tagLength);
+#endif
+}
+
+/*! @fn OIDHKDFExpandSHA256
+    @brief Derives a @c kTagLength byte key from the authentication key with HKDF-Expand.
+    @param key The 32 byte authentication key, already uniformly random, so HKDF-Extract is
+        skipped.
+    @param label The info label identifying what the derived key is for.
+    @param derivedKey A buffer of @c kTagLength bytes for the result.
+    @see https://tools.ietf.org/html/rfc5869#section-2.3
+ */
+static void OIDHKDFExpandSHA256(const uint8_t *key, NSString *label, uint8_t *derivedKey) {
+  // a single block, T(1) = HMAC(key, info | 0x01), covers the derived key's length
+  NSMutableData *info = [[label dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+  uint8_t counter = 1;
+  [info appendBytes:&counter length:sizeof(counter)];
+  OIDHMACSHA256(key, info.bytes, info.length, derivedKey);
+}
+
+/*! @fn OIDConstantTimeEqual
+    @brief Compares two buffers in time which doesn't depend on where they differ, so comparing
+        tags doesn't reveal how much of a forged tag is correct.
+ */
+static BOOL OIDConstantTimeEqual(const uint8_t *a, const uint8_t *b, size_t length) {
+  uint8_t difference = 0;
+  for (size_t i = 0; i < length; i++) {
+    difference |= a[i] ^ b[i];
+  }
+  return difference == 0;
+}
+
+@implementation OIDEncryptedAuthStateStore {
+  /*! @var _dataKey
+      @brief The data key, once fetched from the key source. Synchronized on @c self.
+   */
+  NSData *_dataKey;
+
+  /*! @var _digestKey
+      @brief The key for plaintext digests, derived from the data key when it's fetched. Never
+          used to authenticate records.
+   */
+  NSData *_digestKey;
+
+  /*! @var _recordDigests
+      @brief Keyed digests of the plaintext of the records last saved or loaded, by identifier.
+          Synchronized on @c self.
+   */
+  NSMutableDictionary<NSString *, NSData *> *_recordDigests;
+}
+
+- (nullable instancetype)init
+    OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithDirectoryURL:keySource:));
+
+- (nullable instancetype)initWithDirectoryURL:(NSURL *)directoryURL
+                                    keySource:(id<OIDKeySource>)keySource {
+  self = [super init];
+  if (self) {
+    _directoryURL = [directoryURL copy];
+    _keySource = keySource;
+    _recordDigests = [NSMutableDictionary dictionary];
+  }
+  return self;
+}
+
+#pragma mark - Keys and records
+
+/*! @fn dataKeyWithError:
+    @brief Returns the data key, fetching it from the key source the first time.
+ */
+- (nullable NSData *)dataKeyWithError:(NSError **_Nullable)error {
+  @synchronized(self) {
+    if (_dataKey) {
+      return _dataKey;
+    }
+    NSUInteger length = kEncryptionKeyLength + kAuthenticationKeyLength;
+    NSError *keyError;
+    NSData *key = [_keySource dataKeyWithLength:length error:&keyError];
+    if (key.length != length) {
+      if (error) {
+        BOOL isKeyError = [keyError.domain isEqual:OIDGeneralErrorDomain]
+            && keyError.code == OIDErrorCodeKeyUnavailable;
+        *error = isKeyError ? keyError
+                            : [OIDErrorUtilities errorWithCode:OIDErrorCodeKeyUnavailable
+                                               underlyingError:keyError
+                                                   description:nil];
+      }
+      return nil;
+    }
+    _dataKey = [key copy];
+    uint8_t digestKey[kTagLength];
+    OIDHKDFExpandSHA256((const uint8_t *)_dataKey.bytes + kEncryptionKeyLength,
+                        kDigestKeyLabel,
+                        digestKey);
+    _digestKey = [NSData dataWithBytes:digestKey length:kTagLength];
+    return _dataKey;
+  }
+}
+
+/*! @fn recordURLForIdentifier:
+    @brief Returns the location of a record, named with the base64url encoding of its identifier
+        so any identifier is a valid file name.
+ */
+- (NSURL *)recordURLForIdentifier:(NSString *)identifier {
+  NSData *identifierData = [identifier dataUsingEncoding:NSUTF8StringEncoding];
+  NSString *fileName = [[OIDTokenUtilities encodeBase64urlNoPadding:identifierData]
+      stringByAppendingPathExtension:kRecordPathExtension];
+  return [_directoryURL URLByAppendingPathComponent:fileName];
+}
+
+/*! @fn tagForRecord:identifier:key:tag:
+    @brief Computes the tag of a record's version byte, nonce and ciphertext, bound to its
+        identifier.
+    @param record A buffer with the record's authenticated bytes, which is extended with the
+        identifier and its length in place to avoid copying the ciphertext, and truncated again.
+ */
++ (void)tagForRecord:(NSMutableData *)record
+          identifier:(NSString *)identifier
+                 key:(NSData *)key
+                 tag:(uint8_t *)tag {
+  NSUInteger authenticatedLength = record.length;
+  NSData *identifierData = [identifier dataUsingEncoding:NSUTF8StringEncoding];
+  unsigned long long identifierLength = NSSwapHostLongLongToBig(identifierData.length);
+  [record appendData:identifierData];
+  [record appendBytes:&identifierLength length:sizeof(identifierLength)];
+  OIDHMACSHA256((const uint8_t *)key.bytes + kEncryptionKeyLength,
+                record.bytes,
+                record.length,
+                tag);
+  record.length = authenticatedLength;
+}
+
+/*! @fn sealPlaintext:identifier:key:
+    @brief Encrypts and authenticates a record under a fresh nonce.
+    @return The record, or nil if random nonce generation or encryption failed.
+ */
++ (nullable NSData *)sealPlaintext:(NSData *)plaintext
+                        identifier:(NSString *)identifier
+                               key:(NSData *)key {
+  NSData *nonce = [OIDTokenUtilities randomDataWithSize:kNonceLength];
+  if (!nonce) {
+    return nil;
+  }
+  NSMutableData *record = [NSMutableData dataWithLength:kRecordHeaderLength + plaintext.length];
+  uint8_t *bytes = record.mutableBytes;
+  bytes[0] = kRecordFormatVersion;
+  memcpy(bytes + 1, nonce.bytes, kNonceLength);
+  if (!OIDApplyAES256CTR(key.bytes, nonce.bytes, plaintext.bytes, plaintext.length,
+                         bytes + kRecordHeaderLength)) {
+    return nil;
+  }
+  uint8_t tag[kTagLength];
+  [self tagForRecord:record identifier:identifier key:key tag:tag];
+  [record appendBytes:tag length:kTagLength];
+  return record;
+}
+
+/*! @fn openRecord:identifier:key:
+    @brief Authenticates and decrypts a record.
+    @return The plaintext, or nil if the record failed authentication.
+ */
++ (nullable NSData *)openRecord:(NSData *)record
+                     identifier:(NSString *)identifier
+                            key:(NSData *)key {
+  const uint8_t *bytes = record.bytes;
+  if (record.length < kRecordHeaderLength + kTagLength || bytes[0] != kRecordFormatVersion) {
+    return nil;
+  }
+  NSUInteger authenticatedLength = record.length - kTagLength;
+  NSMutableData *authenticated = [NSMutableData dataWithBytes:bytes length:authenticatedLength];
+  uint8_t tag[kTagLength];
+  [self tagForRecord:authenticated identifier:identifier key:key tag:tag];
+  if (!OIDConstantTimeEqual(tag, bytes + authenticatedLength, kTagLength)) {
+    return nil;
+  }
+  NSUInteger ciphertextLength = authenticatedLength - kRecordHeaderLength;
+  NSMutableData *plaintext = [NSMutableData dataWithLength:ciphertextLength];
+  if (!OIDApplyAES256CTR(key.bytes, bytes + 1, bytes + kRecordHeaderLength, ciphertextLength,
+                         plaintext.mutableBytes)) {
+    return nil;
+  }
+  return plaintext;
+}
+
+/*! @fn digestOfPlaintext:
+    @brief Returns a keyed digest of a record's plaintext, used to detect unchanged states without
+        keeping their tokens in memory.
+    @discussion Only called once @c dataKeyWithError: has returned the data key, and so derived
+        the digest key.
+ */
+- (NSData *)digestOfPlaintext:(NSData *)plaintext {
+  uint8_t digest[kTagLength];
+  OIDHMACSHA256(_digestKey.bytes,
+                plaintext.bytes,
+                plaintext.length,
+                digest);
+  return [NSData dataWithBytes:digest length:kTagLength];
+}
+
+#pragma mark - Saving and loading
+
+- (BOOL)saveAuthState:(OIDAuthState *)authState
+        forIdentifier:(NSString *)identifier
+                error:(NSError **_Nullable)error {
+  NSData *key = [self dataKeyWithError:error];
+  if (!key) {
+    return NO;
+  }
+  NSData *plaintext = [NSKeyedArchiver archivedDataWithRootObject:authState];
+  NSData *digest = [self digestOfPlaintext:plaintext];
+  @synchronized(self) {
+    if ([_recordDigests[identifier] isEqualToData:digest]) {
+      return YES;
+    }
+  }
+
+  NSData *record = [[self class] sealPlaintext:plaintext identifier:identifier key:key];
+  if (!record) {
+    if (error) {
+      *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeKeyUnavailable
+                                underlyingError:nil
+                                    description:@"Failed to encrypt the auth state."];
+    }
+    return NO;
+  }
+
+  NSFileManager *fileManager = [NSFileManager defaultManager];
+  NSDictionary<NSString *, id> *attributes = @{ NSFilePosixPermissions : @0700 };
+  if (![fileManager createDirectoryAtURL:_directoryURL
+             withIntermediateDirectories:YES
+                              attributes:attributes
+                                   error:error]) {
+    return NO;
+  }
+  // writes and digest updates are serialized so the digest always describes the file's contents
+  @synchronized(self) {
+    if (![record writeToURL:[self recordURLForIdentifier:identifier]
+                    options:NSDataWritingAtomic
+                      error:error]) {
+      [_recordDigests removeObjectForKey:identifier];
+      return NO;
+    }
+    _recordDigests[identifier] = digest;
+  }
+  return YES;
+}
+
+- (nullable OIDAuthState *)authStateForIdentifier:(NSString *)identifier
+                                            error:(NSError **_Nullable)error {
+  NSError *readError;
+  NSData *record = [NSData dataWithContentsOfURL:[self recordURLForIdentifier:identifier]
+                                         options:0
+                                           error:&readError];
+  if (!record) {
+    BOOL isMissing = [readError.domain isEqual:NSCocoaErrorDomain]
+        && readError.code == NSFileReadNoSuchFileError;
+    if (error) {
+      *error = isMissing ? nil : readError;
+    }
+    return nil;
+  }
+  NSData *key = [self dataKeyWithError:error];
+  if (!key) {
+    return nil;
+  }
+
+  NSData *plaintext = [[self class] openRecord:record identifier:identifier key:key];
+  id authState = nil;
+  if (plaintext) {
+    @try {
+      authState = [NSKeyedUnarchiver unarchiveObjectWithData:plaintext];
+    } @catch (NSException *exception) {
+      // an authentic record that can't be decoded is treated as invalid
+    }
+  }
+  if (![authState isKindOfClass:[OIDAuthState class]]) {
+    if (error) {
+      *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeStoredRecordInvalid
+                                underlyingError:nil
+                                    description:nil];
+    }
+    return nil;
+  }
+  @synchronized(self) {
+    _recordDigests[identifier] = [self digestOfPlaintext:plaintext];
+  }
+  return authState;
+}
+
+- (BOOL)removeAuthStateForIdentifier:(NSString *)identifier error:(NSError **_Nullable)error {
+  NSError *removeError;
+  @synchronized(self) {
+    [_recordDigests removeObjectForKey:identifier];
+    if (![[NSFileManager defaultManager] removeItemAtURL:[self recordURLForIdentifier:identifier]
+                                                   error:&removeError]
+        && !([removeError.domain isEqual:NSCocoaErrorDomain]
+             && removeError.code == NSFileNoSuchFileError)) {
+      if (error) {
+        *error = removeError;
+      }
+      return NO;
+    }
+  }
+  return YES;
+}
+
+@end
@@ -51,6 +51,17 @@ extern NSString *const OIDOAuthAuthorizationErrorDomain;
  */
 extern NSString *const OIDOAuthTokenErrorDomain;
 
+/*! @var OIDOAuthRegistrationErrorDomain
+    @brief The error domain for OAuth specific errors on the dynamic client registration
+        endpoint.
+    @discussion This error domain is used when the server responds with HTTP 400 and an OAuth
+        error, as defined RFC7591 Section 3.2.2. The entire OAuth error response dictionary is
+        available in the @c NSError.userInfo dictionary using the @c OIDOAuthErrorResponseErrorKey
+        key. The @c NSError.code will be one of the @c OIDErrorCodeOAuthRegistration enum values.
+    @see https://tools.ietf.org/html/rfc7591#section-3.2.2
+ */
+extern NSString *const OIDOAuthRegistrationErrorDomain;
+
 /*! @var OIDResourceServerAuthorizationErrorDomain
     @brief The error domain for authorization errors encountered out of band on the resource server.
  */
@@ -66,6 +77,34 @@ extern NSString *const OIDHTTPErrorDomain;
  */
 extern NSString *const OIDOAuthErrorResponseErrorKey;
 
+/*! @var OIDErrorRetryabilityKey
+    @brief An error key for an @c NSNumber containing the @c OIDErrorRetryability of the error.
+    @discussion Set on every error created by @c OIDErrorUtilities. Use
+        @c OIDErrorUtilities.retryabilityOfError: to also classify errors from other sources.
+ */
+extern NSString *const OIDErrorRetryabilityKey;
+
+/*! @var OIDHTTPErrorResponseBodyKey
+    @brief An error key for an @c NSData containing the start of the body of an HTTP error
+        response.
+    @discussion At most @c OIDHTTPErrorResponseBodyCaptureLimit bytes are kept, so that large error
+        pages don't stay in memory for as long as the error does. The localized description of
+        errors in the @c OIDHTTPErrorDomain is decoded from this data when it's first requested.
+ */
+extern NSString *const OIDHTTPErrorResponseBodyKey;
+
+/*! @var OIDHTTPErrorResponseBodyCaptureLimit
+    @brief The maximum number of bytes of an HTTP error response body kept in the error.
+ */
+extern NSUInteger const OIDHTTPErrorResponseBodyCaptureLimit;
+
+/*! @var OIDHTTPErrorRetryAfterKey
+    @brief An error key for an @c NSNumber containing the number of seconds the server asked the
+        client to wait before retrying, from the response's Retry-After header.
+    @see https://tools.ietf.org/html/rfc7231#section-7.1.3
+ */
+extern NSString *const OIDHTTPErrorRetryAfterKey;
+
 /*! @var kOAuthErrorResponseErrorField
     @brief The key of the 'error' response field in a RFC6749 Section 5.2 response.
     @remark error
@@ -125,6 +164,101 @@ typedef NS_ENUM(NSInteger, OIDErrorCode) {
       @brief Indicates a problem occurred constructing the token response from the JSON.
    */
   OIDErrorCodeTokenResponseConstructionError = -8,
+
+  /*! @var OIDErrorCodeRedirectListenerError
+      @brief Indicates the loopback redirect listener could not be started. The underlying error
+          is in the @c NSPOSIXErrorDomain.
+   */
+  OIDErrorCodeRedirectListenerError = -9,
+
+  /*! @var OIDErrorCodeInvalidScope
+      @brief Indicates a scope was empty or contained characters not allowed by RFC6749
+          Section 3.3.
+   */
+  OIDErrorCodeInvalidScope = -10,
+
+  /*! @var OIDErrorCodeRegistrationResponseConstructionError
+      @brief Indicates a problem occurred constructing the registration response from the JSON.
+   */
+  OIDErrorCodeRegistrationResponseConstructionError = -11,
+
+  /*! @var OIDErrorCodeResponseTooLarge
+      @brief Indicates a response body was larger than the maximum allowed for its endpoint, and
+          the request was aborted.
+      @see OIDHTTPClient
+   */
+  OIDErrorCodeResponseTooLarge = -12,
+
+  /*! @var OIDErrorCodeUnexpectedContentType
+      @brief Indicates a successful response was not JSON, for example a captive portal's login
+          page, and the request was aborted.
+      @see OIDHTTPClient
+   */
+  OIDErrorCodeUnexpectedContentType = -13,
+
+  /*! @var OIDErrorCodeRequestCanceled
+      @brief Indicates a request was cancelled through its @c OIDCancellable handle.
+   */
+  OIDErrorCodeRequestCanceled = -14,
+
+  /*! @var OIDErrorCodeDeadlineExceeded
+      @brief Indicates a request didn't complete before the deadline it was given, and was
+          cancelled.
+   */
+  OIDErrorCodeDeadlineExceeded = -15,
+
+  /*! @var OIDErrorCodeKeyUnavailable
+      @brief Indicates a key source could not provide the key used to encrypt stored auth
+          states. The underlying error, if any, is the key source's.
+      @see OIDKeySource
+   */
+  OIDErrorCodeKeyUnavailable = -16,
+
+  /*! @var OIDErrorCodeStoredRecordInvalid
+      @brief Indicates an encrypted auth state record failed authentication, because it was
+          corrupted, tampered with, moved to another identifier, or encrypted with another key.
+      @see OIDEncryptedAuthStateStore
+   */
+  OIDErrorCodeStoredRecordInvalid = -17,
+
+  /*! @var OIDErrorCodeDPoPProofError
+      @brief Indicates a DPoP proof could not be created. The underlying error, if any, is the
+          key's signing error.
+      @see OIDDPoPProofGenerator
+   */
+  OIDErrorCodeDPoPProofError = -18,
+
+  /*! @var OIDErrorCodeClientAuthenticationError
+      @brief Indicates a client assertion could not be created. The underlying error, if any, is
+          the signer's error.
+      @see OIDClientAuthentication
+   */
+  OIDErrorCodeClientAuthenticationError = -19,
+
+  /*! @var OIDErrorCodeRequestObjectError
+      @brief Indicates a request object could not be created. The underlying error, if any, is
+          the signer's error.
+      @see OIDRequestObjectBuilder
+   */
+  OIDErrorCodeRequestObjectError = -20,
+};
+
+/*! @enum OIDErrorRetryability
+    @brief Whether retrying the operation which failed with an error could succeed.
+    @see OIDErrorRetryabilityKey
+ */
+typedef NS_ENUM(NSInteger, OIDErrorRetryability) {
+  /*! @var OIDErrorRetryabilityNone
+      @brief Retrying the same request won't succeed. For example, the request was rejected by the
+          server, the grant is invalid, or the user canceled.
+   */
+  OIDErrorRetryabilityNone = 0,
+
+  /*! @var OIDErrorRetryabilityTransient
+      @brief The request may succeed if retried later. For example, the network was unreachable,
+          the server had an internal error, or it asked the client to slow down.
+   */
+  OIDErrorRetryabilityTransient = 1,
 };
 
 /*! @enum OIDErrorCodeOAuth
@@ -201,6 +335,18 @@ typedef NS_ENUM(NSInteger, OIDErrorCodeOAuth) {
    */
   OIDErrorCodeOAuthUnsupportedGrantType = -11,
 
+  /*! @var OIDErrorCodeOAuthInvalidRedirectURI
+      @remarks invalid_redirect_uri
+      @see https://tools.ietf.org/html/rfc7591#section-3.2.2
+   */
+  OIDErrorCodeOAuthInvalidRedirectURI = -12,
+
+  /*! @var OIDErrorCodeOAuthInvalidClientMetadata
+      @remarks invalid_client_metadata
+      @see https://tools.ietf.org/html/rfc7591#section-3.2.2
+   */
+  OIDErrorCodeOAuthInvalidClientMetadata = -13,
+
   /*! @var OIDErrorCodeOAuthClientError
       @brief An authorization error occurring on the client rather than the server. For example,
         due to a state mismatch or misconfiguration. Should be treated as an unrecoverable
@@ -343,6 +489,44 @@ typedef NS_ENUM(NSInteger, OIDErrorCodeOAuthToken) {
   OIDErrorCodeOAuthTokenOther = OIDErrorCodeOAuthOther,
 };
 
+/*! @enum OIDErrorCodeOAuthRegistration
+    @brief The error codes for the @c OIDOAuthRegistrationErrorDomain error domain
+    @see https://tools.ietf.org/html/rfc7591#section-3.2.2
+ */
+typedef NS_ENUM(NSInteger, OIDErrorCodeOAuthRegistration) {
+  /*! @var OIDErrorCodeOAuthRegistrationInvalidRequest
+      @remarks invalid_request
+      @see https://tools.ietf.org/html/rfc6749#section-5.2
+   */
+  OIDErrorCodeOAuthRegistrationInvalidRequest = OIDErrorCodeOAuthInvalidRequest,
+
+  /*! @var OIDErrorCodeOAuthRegistrationInvalidRedirectURI
+      @remarks invalid_redirect_uri
+      @see https://tools.ietf.org/html/rfc7591#section-3.2.2
+   */
+  OIDErrorCodeOAuthRegistrationInvalidRedirectURI = OIDErrorCodeOAuthInvalidRedirectURI,
+
+  /*! @var OIDErrorCodeOAuthRegistrationInvalidClientMetadata
+      @remarks invalid_client_metadata
+      @see https://tools.ietf.org/html/rfc7591#section-3.2.2
+   */
+  OIDErrorCodeOAuthRegistrationInvalidClientMetadata = OIDErrorCodeOAuthInvalidClientMetadata,
+
+  /*! @var OIDErrorCodeOAuthRegistrationClientError
+      @brief An unrecoverable registration error occurring on the client rather than the server.
+   */
+  OIDErrorCodeOAuthRegistrationClientError = OIDErrorCodeOAuthClientError,
+
+  /*! @var OIDErrorCodeOAuthRegistrationOther
+      @brief A registration endpoint OAuth error not known to this library
+      @discussion this indicates an OAuth error as per RFC7591, but the error code was not in our
+          list. It could be a custom error code, or one from an OAuth extension. See the "error" key
+          of the @c NSError:userInfo property. We assume such errors are not transient.
+      @see https://tools.ietf.org/html/rfc7591#section-3.2.2
+   */
+  OIDErrorCodeOAuthRegistrationOther = OIDErrorCodeOAuthOther,
+};
+
 
 /*! @var OIDOAuthExceptionInvalidAuthorizationFlow
     @brief The exception text for the exception which occurs when a
@@ -22,6 +22,8 @@ NSString *const OIDGeneralErrorDomain = @"org.openid.appauth.general";
 
 NSString *const OIDOAuthTokenErrorDomain = @"org.openid.appauth.oauth_token";
 
+NSString *const OIDOAuthRegistrationErrorDomain = @"org.openid.appauth.oauth_registration";
+
 NSString *const OIDOAuthAuthorizationErrorDomain = @"org.openid.appauth.oauth_authorization";
 
 NSString *const OIDResourceServerAuthorizationErrorDomain = @"org.openid.appauth.resourceserver";
@@ -33,6 +35,14 @@ NSString *const OIDOAuthExceptionInvalidAuthorizationFlow = @"An OAuth redirect
 
 NSString *const OIDOAuthErrorResponseErrorKey = @"OIDOAuthErrorResponseErrorKey";
 
+NSString *const OIDErrorRetryabilityKey = @"OIDErrorRetryabilityKey";
+
+NSString *const OIDHTTPErrorResponseBodyKey = @"OIDHTTPErrorResponseBodyKey";
+
+NSUInteger const OIDHTTPErrorResponseBodyCaptureLimit = 4096;
+
+NSString *const OIDHTTPErrorRetryAfterKey = @"OIDHTTPErrorRetryAfterKey";
+
 NSString *const OIDOAuthErrorFieldError = @"error";
 
 NSString *const OIDOAuthErrorFieldErrorDescription = @"error_description";
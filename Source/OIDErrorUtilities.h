@@ -42,8 +42,8 @@ NS_ASSUME_NONNULL_BEGIN
 /*! @fn OAuthErrorWithDomain:OAuthResponse:underlyingError:
     @brief Creates a standard @c NSError from an @c OIDErrorCode and custom user info. Automatically
         populates the localized error description.
-    @param OAuthErrorDomain The OAuth error domain. Must be @c OIDOAuthAuthorizationErrorDomain or
-        @c OIDOAuthTokenErrorDomain.
+    @param OAuthErrorDomain The OAuth error domain. Must be @c OIDOAuthAuthorizationErrorDomain,
+        @c OIDOAuthTokenErrorDomain or @c OIDOAuthRegistrationErrorDomain.
     @param errorResponse The dictionary from an OAuth error response (as per RFC6749 Section 5.2).
     @param underlyingError The underlying error which occurred, if applicable.
     @return An @c NSError representing the OAuth error.
@@ -76,6 +76,10 @@ NS_ASSUME_NONNULL_BEGIN
     @param data The response data associated with the response which should be converted to an
         @c NSString assuming a UTF-8 encoding, if available.
     @return An @c NSError representing the error.
+    @discussion Only the first @c OIDHTTPErrorResponseBodyCaptureLimit bytes of @c data are kept,
+        under @c OIDHTTPErrorResponseBodyKey, and they are decoded when the localized description
+        is first requested. The response's Retry-After header, if any, is available under
+        @c OIDHTTPErrorRetryAfterKey.
  */
 + (nullable NSError *)HTTPErrorWithHTTPResponse:(NSHTTPURLResponse *)HTTPURLResponse
                                            data:(nullable NSData *)data;
@@ -106,13 +110,23 @@ NS_ASSUME_NONNULL_BEGIN
     @brief Returns true if the given error domain is an OAuth error domain.
     @param errorDomain The error domain to test.
     @discussion An OAuth error domain is used for errors returned per RFC6749 sections 4.1.2.1 and
-        5.2. Other errors, such as network errors can also occur but they will not have an OAuth
-        error domain.
+        5.2, and RFC7591 section 3.2.2. Other errors, such as network errors can also occur but
+        they will not have an OAuth error domain.
     @see https://tools.ietf.org/html/rfc6749#section-4.1.2.1
     @see https://tools.ietf.org/html/rfc6749#section-5.2
+    @see https://tools.ietf.org/html/rfc7591#section-3.2.2
  */
 + (BOOL)isOAuthErrorDomain:(NSString*)errorDomain;
 
+/*! @fn retryabilityOfError:
+    @brief Returns whether retrying the operation which failed with the given error could succeed.
+    @param error The error to classify.
+    @discussion Returns the @c OIDErrorRetryabilityKey value of errors created by this class.
+        Errors in the @c NSURLErrorDomain and @c NSPOSIXErrorDomain caused by connectivity are
+        transient, as are HTTP 408, 429 and 5xx responses. Other errors are assumed not to be.
+ */
++ (OIDErrorRetryability)retryabilityOfError:(NSError *)error;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -18,8 +18,104 @@
 
 #import "OIDErrorUtilities.h"
 
+#include <errno.h>
+
+/*! @var kRetryAfterHeaderField
+    @brief The HTTP header with which a server tells the client how long to wait before retrying.
+    @see https://tools.ietf.org/html/rfc7231#section-7.1.3
+ */
+static NSString *const kRetryAfterHeaderField = @"Retry-After";
+
+/*! @fn OIDRetryabilityOfErrorCode
+    @brief Returns whether an error with the given @c OIDGeneralErrorDomain code is transient.
+    @param code The error code.
+    @param underlyingError The underlying error, which determines the retryability of errors that
+        wrap it.
+ */
+static OIDErrorRetryability OIDRetryabilityOfErrorCode(OIDErrorCode code,
+                                                       NSError *_Nullable underlyingError) {
+  switch (code) {
+    case OIDErrorCodeNetworkError:
+    case OIDErrorCodeServerError:
+      // errors without an underlying error, such as offline timeouts, are transient
+      return underlyingError ? [OIDErrorUtilities retryabilityOfError:underlyingError]
+                             : OIDErrorRetryabilityTransient;
+    case OIDErrorCodeJSONDeserializationError:
+    case OIDErrorCodeUnexpectedContentType:
+      // typically an HTML page from a proxy or load balancer in front of a failing server
+      return OIDErrorRetryabilityTransient;
+    case OIDErrorCodeDeadlineExceeded:
+      // a slow server, which may well answer in time with a new deadline
+      return OIDErrorRetryabilityTransient;
+    case OIDErrorCodeInvalidDiscoveryDocument:
+    case OIDErrorCodeUserCanceledAuthorizationFlow:
+    case OIDErrorCodeProgramCanceledAuthorizationFlow:
+    case OIDErrorCodeTokenResponseConstructionError:
+    case OIDErrorCodeRedirectListenerError:
+    case OIDErrorCodeInvalidScope:
+    case OIDErrorCodeRegistrationResponseConstructionError:
+    case OIDErrorCodeResponseTooLarge:
+    case OIDErrorCodeRequestCanceled:
+    case OIDErrorCodeKeyUnavailable:
+    case OIDErrorCodeStoredRecordInvalid:
+    case OIDErrorCodeDPoPProofError:
+    case OIDErrorCodeClientAuthenticationError:
+    case OIDErrorCodeRequestObjectError:
+      return OIDErrorRetryabilityNone;
+  }
+  return OIDErrorRetryabilityNone;
+}
+
+/*! @fn OIDRetryabilityOfHTTPStatusCode
+    @brief Returns whether an HTTP error response with the given status code is transient.
+    @param statusCode The HTTP status code.
+ */
+static OIDErrorRetryability OIDRetryabilityOfHTTPStatusCode(NSInteger statusCode) {
+  // 408 Request Timeout, 429 Too Many Requests, and server errors other than 501 Not Implemented
+  if (statusCode == 408 || statusCode == 429 || (statusCode >= 500 && statusCode != 501)) {
+    return OIDErrorRetryabilityTransient;
+  }
+  return OIDErrorRetryabilityNone;
+}
+
+/*! @fn OIDDecodeResponseBody
+    @brief Decodes captured response body data as UTF-8.
+    @param data The captured data, which may end partway through a multi-byte character.
+    @return The decoded string, or nil if the data isn't UTF-8.
+ */
+static NSString *_Nullable OIDDecodeResponseBody(NSData *data) {
+  // drop up to three trailing bytes, in case truncation split a character
+  for (NSUInteger trim = 0; trim < 4 && trim < data.length; trim++) {
+    NSString *body = [[NSString alloc] initWithBytes:data.bytes
+                                              length:data.length - trim
+                                            encoding:NSUTF8StringEncoding];
+    if (body) {
+      return body;
+    }
+  }
+  return nil;
+}
+
 @implementation OIDErrorUtilities
 
++ (void)initialize {
+  if (self != [OIDErrorUtilities class]) {
+    return;
+  }
+  // HTTP error descriptions are decoded from the captured body on demand, as most errors are
+  // handled by code and never displayed or logged
+  if ([NSError respondsToSelector:@selector(setUserInfoValueProviderForDomain:provider:)]) {
+    [NSError setUserInfoValueProviderForDomain:OIDHTTPErrorDomain
+                                      provider:^id _Nullable(NSError *error, NSString *key) {
+      NSData *body = error.userInfo[OIDHTTPErrorResponseBodyKey];
+      if (![key isEqualToString:NSLocalizedDescriptionKey] || !body) {
+        return nil;
+      }
+      return OIDDecodeResponseBody(body);
+    }];
+  }
+}
+
 + (nullable NSError *)errorWithCode:(OIDErrorCode)code
                     underlyingError:(NSError *)underlyingError
                         description:(NSString *)description {
@@ -30,6 +126,7 @@
   if (description) {
     userInfo[NSLocalizedFailureReasonErrorKey] = description;
   }
+  userInfo[OIDErrorRetryabilityKey] = @(OIDRetryabilityOfErrorCode(code, underlyingError));
   // TODO: Populate localized description based on code.
   NSError *error = [NSError errorWithDomain:OIDGeneralErrorDomain
                                        code:code
@@ -39,7 +136,8 @@
 
 + (BOOL)isOAuthErrorDomain:(NSString *)errorDomain {
   return errorDomain == OIDOAuthAuthorizationErrorDomain
-      || errorDomain == OIDOAuthTokenErrorDomain;
+      || errorDomain == OIDOAuthTokenErrorDomain
+      || errorDomain == OIDOAuthRegistrationErrorDomain;
 }
 
 + (nullable NSError *)resourceServerAuthorizationErrorWithCode:(NSInteger)code
@@ -51,6 +149,8 @@
   if (underlyingError) {
     userInfo[NSUnderlyingErrorKey] = underlyingError;
   }
+  // the resource server rejected the tokens, so a retry would need new ones
+  userInfo[OIDErrorRetryabilityKey] = @(OIDErrorRetryabilityNone);
   NSError *error = [NSError errorWithDomain:OIDResourceServerAuthorizationErrorDomain
                                        code:code
                                    userInfo:userInfo];
@@ -100,6 +200,10 @@
 
   // looks up the error code based on the "error" response param
   OIDErrorCodeOAuth code = [[self class] OAuthErrorCodeFromString:oauthErrorCodeString];
+  BOOL transient = code == OIDErrorCodeOAuthServerError
+      || code == OIDErrorCodeOAuthTemporarilyUnavailable;
+  userInfo[OIDErrorRetryabilityKey] =
+      @(transient ? OIDErrorRetryabilityTransient : OIDErrorRetryabilityNone);
 
   NSError *error = [NSError errorWithDomain:oAuthErrorDomain
                                        code:code
@@ -110,13 +214,29 @@
 + (nullable NSError *)HTTPErrorWithHTTPResponse:(NSHTTPURLResponse *)HTTPURLResponse
                                            data:(nullable NSData *)data {
   NSMutableDictionary *userInfo = [NSMutableDictionary dictionary];
-  if (data) {
-    NSString *serverResponse =
-        [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
-    if (serverResponse) {
-      userInfo[NSLocalizedDescriptionKey] = serverResponse;
+  if (data.length) {
+    // copies only the captured prefix, so the error doesn't keep the whole response alive
+    NSData *capturedBody =
+        [NSData dataWithBytes:data.bytes
+                       length:MIN(data.length, OIDHTTPErrorResponseBodyCaptureLimit)];
+    userInfo[OIDHTTPErrorResponseBodyKey] = capturedBody;
+    if (![NSError respondsToSelector:@selector(setUserInfoValueProviderForDomain:provider:)]) {
+      NSString *serverResponse = OIDDecodeResponseBody(capturedBody);
+      if (serverResponse) {
+        userInfo[NSLocalizedDescriptionKey] = serverResponse;
+      }
     }
   }
+  userInfo[OIDErrorRetryabilityKey] =
+      @(OIDRetryabilityOfHTTPStatusCode(HTTPURLResponse.statusCode));
+  // only the delta-seconds form is used; clients fall back to their own backoff for HTTP dates
+  NSString *retryAfter = HTTPURLResponse.allHeaderFields[kRetryAfterHeaderField];
+  NSInteger retryAfterSeconds = 0;
+  if ([retryAfter isKindOfClass:[NSString class]]
+      && [[NSScanner scannerWithString:retryAfter] scanInteger:&retryAfterSeconds]
+      && retryAfterSeconds >= 0) {
+    userInfo[OIDHTTPErrorRetryAfterKey] = @(retryAfterSeconds);
+  }
   NSError *serverError =
       [NSError errorWithDomain:OIDHTTPErrorDomain
                           code:HTTPURLResponse.statusCode
@@ -125,19 +245,25 @@
 }
 
 + (OIDErrorCodeOAuth)OAuthErrorCodeFromString:(NSString *)errorCode {
-  NSDictionary *errorCodes = @{
-      @"invalid_request": @(OIDErrorCodeOAuthInvalidRequest),
-      @"unauthorized_client": @(OIDErrorCodeOAuthUnauthorizedClient),
-      @"access_denied": @(OIDErrorCodeOAuthAccessDenied),
-      @"unsupported_response_type": @(OIDErrorCodeOAuthUnsupportedResponseType),
-      @"invalid_scope": @(OIDErrorCodeOAuthInvalidScope),
-      @"server_error": @(OIDErrorCodeOAuthServerError),
-      @"temporarily_unavailable": @(OIDErrorCodeOAuthTemporarilyUnavailable),
-      @"invalid_client": @(OIDErrorCodeOAuthInvalidClient),
-      @"invalid_grant": @(OIDErrorCodeOAuthInvalidGrant),
-      @"unsupported_grant_type": @(OIDErrorCodeOAuthUnsupportedGrantType),
-      };
-  NSNumber *code = errorCodes[errorCode];
+  static NSDictionary<NSString *, NSNumber *> *errorCodes;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    errorCodes = @{
+        @"invalid_request": @(OIDErrorCodeOAuthInvalidRequest),
+        @"unauthorized_client": @(OIDErrorCodeOAuthUnauthorizedClient),
+        @"access_denied": @(OIDErrorCodeOAuthAccessDenied),
+        @"unsupported_response_type": @(OIDErrorCodeOAuthUnsupportedResponseType),
+        @"invalid_scope": @(OIDErrorCodeOAuthInvalidScope),
+        @"server_error": @(OIDErrorCodeOAuthServerError),
+        @"temporarily_unavailable": @(OIDErrorCodeOAuthTemporarilyUnavailable),
+        @"invalid_client": @(OIDErrorCodeOAuthInvalidClient),
+        @"invalid_grant": @(OIDErrorCodeOAuthInvalidGrant),
+        @"unsupported_grant_type": @(OIDErrorCodeOAuthUnsupportedGrantType),
+        @"invalid_redirect_uri": @(OIDErrorCodeOAuthInvalidRedirectURI),
+        @"invalid_client_metadata": @(OIDErrorCodeOAuthInvalidClientMetadata),
+        };
+  });
+  NSNumber *code = [errorCode isKindOfClass:[NSString class]] ? errorCodes[errorCode] : nil;
   if (code) {
     return [code integerValue];
   } else {
@@ -145,6 +271,37 @@
   }
 }
 
++ (OIDErrorRetryability)retryabilityOfError:(NSError *)error {
+  NSNumber *retryability = error.userInfo[OIDErrorRetryabilityKey];
+  if ([retryability isKindOfClass:[NSNumber class]]) {
+    return retryability.integerValue;
+  }
+  if ([error.domain isEqualToString:NSURLErrorDomain]) {
+    switch (error.code) {
+      case NSURLErrorTimedOut:
+      case NSURLErrorCannotFindHost:
+      case NSURLErrorCannotConnectToHost:
+      case NSURLErrorNetworkConnectionLost:
+      case NSURLErrorDNSLookupFailed:
+      case NSURLErrorNotConnectedToInternet:
+        return OIDErrorRetryabilityTransient;
+      default:
+        // cancellation, malformed requests and certificate errors don't resolve themselves
+        return OIDErrorRetryabilityNone;
+    }
+  }
+  if ([error.domain isEqualToString:NSPOSIXErrorDomain]) {
+    return error.code == ETIMEDOUT || error.code == ECONNRESET || error.code == ENETDOWN
+        || error.code == ENETUNREACH || error.code == EHOSTUNREACH
+        ? OIDErrorRetryabilityTransient
+        : OIDErrorRetryabilityNone;
+  }
+  if ([error.domain isEqualToString:OIDHTTPErrorDomain]) {
+    return OIDRetryabilityOfHTTPStatusCode(error.code);
+  }
+  return OIDErrorRetryabilityNone;
+}
+
 + (void)raiseException:(NSString *)name {
   [[self class] raiseException:name message:name];
 }
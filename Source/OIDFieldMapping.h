@@ -113,6 +113,17 @@ typedef _Nullable id(^OIDFieldMappingConversionFunction)(NSObject *_Nullable val
                     map:(NSDictionary<NSString *, OIDFieldMapping *> *)map
                instance:(id)instance;
 
+/*! @fn copyFieldsWithMap:fromInstance:toInstance:
+    @brief Copies the values of the instance variables defined in a field mapping from one
+        instance to another.
+    @param map A mapping of keys to instance variables.
+    @param source The instance whose variables should be read.
+    @param destination The instance whose variables should be assigned.
+ */
++ (void)copyFieldsWithMap:(NSDictionary<NSString *, OIDFieldMapping *> *)map
+             fromInstance:(id)source
+               toInstance:(id)destination;
+
 /*! @fn JSONTypes
     @brief Returns an @c NSSet of classes suitable for deserializing JSON content in an
         @c NSSecureCoding context.
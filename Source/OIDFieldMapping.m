@@ -91,6 +91,14 @@
   }
 }
 
++ (void)copyFieldsWithMap:(NSDictionary<NSString *, OIDFieldMapping *> *)map
+             fromInstance:(id)source
+               toInstance:(id)destination {
+  for (OIDFieldMapping *mapping in map.objectEnumerator) {
+    [destination setValue:[source valueForKey:mapping.name] forKey:mapping.name];
+  }
+}
+
 + (NSSet *)JSONTypes {
   return [NSSet setWithArray:@[
     [NSDictionary class],
@@ -0,0 +1,53 @@
+/*! @file OIDFileKeySource.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "OIDKeySource.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDFileKeySource
+    @brief A key source which keeps the key in a file readable only by its owner.
+    @discussion The key file is created with mode 0600 on first use. If several processes create
+        it at once, one of them wins and the others read its key. The key file offers no more
+        protection than the file system does, so it should be kept apart from the records it
+        protects, for example outside directories which are backed up or synced.
+ */
+@interface OIDFileKeySource : NSObject <OIDKeySource>
+
+/*! @property fileURL
+    @brief The location of the key file.
+ */
+@property(nonatomic, readonly) NSURL *fileURL;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use @c initWithFileURL:.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn initWithFileURL:
+    @brief Designated initializer.
+    @param fileURL The file URL of the key, which needn't exist yet.
+ */
+- (nullable instancetype)initWithFileURL:(NSURL *)fileURL NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
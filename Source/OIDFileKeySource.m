@@ -0,0 +1,144 @@
+/*! @file OIDFileKeySource.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDFileKeySource.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#import "OIDDefines.h"
+#import "OIDErrorUtilities.h"
+#import "OIDTokenUtilities.h"
+
+@implementation OIDFileKeySource
+
+- (nullable instancetype)init OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithFileURL:));
+
+- (nullable instancetype)initWithFileURL:(NSURL *)fileURL {
+  self = [super init];
+  if (self) {
+    _fileURL = [fileURL copy];
+  }
+  return self;
+}
+
+- (nullable NSData *)dataKeyWithLength:(NSUInteger)length error:(NSError **_Nullable)error {
+  @synchronized(self) {
+    NSError *readError;
+    NSData *key = [NSData dataWithContentsOfURL:_fileURL options:0 error:&readError];
+    if (!key && [readError.domain isEqual:NSCocoaErrorDomain]
+        && readError.code == NSFileReadNoSuchFileError) {
+      key = [self createKeyWithLength:length error:error];
+      if (!key) {
+        return nil;
+      }
+      readError = nil;
+    }
+    if (!key) {
+      if (error) {
+        *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeKeyUnavailable
+                                  underlyingError:readError
+                                      description:nil];
+      }
+      return nil;
+    }
+    if (key.length != length) {
+      if (error) {
+        NSString *description =
+            [NSString stringWithFormat:@"The key file has %lu bytes, but %lu were requested.",
+                                       (unsigned long)key.length,
+                                       (unsigned long)length];
+        *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeKeyUnavailable
+                                  underlyingError:nil
+                                      description:description];
+      }
+      return nil;
+    }
+    return key;
+  }
+}
+
+/*! @fn createKeyWithLength:error:
+    @brief Generates a key and stores it in the key file, unless another process stored one first.
+    @return The key in the key file.
+    @discussion The key is written to a temporary file which is then hard linked into place, so
+        readers never see a partially written key, and the first process to create the key file
+        wins.
+ */
+- (nullable NSData *)createKeyWithLength:(NSUInteger)length error:(NSError **_Nullable)error {
+  NSData *key = [OIDTokenUtilities randomDataWithSize:length];
+  if (!key) {
+    if (error) {
+      *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeKeyUnavailable
+                                underlyingError:nil
+                                    description:@"Failed to generate a random key."];
+    }
+    return nil;
+  }
+
+  NSString *temporaryPath =
+      [_fileURL.path stringByAppendingFormat:@".%@", [NSUUID UUID].UUIDString];
+  const char *temporaryFile = temporaryPath.fileSystemRepresentation;
+  int errorNumber = 0;
+  int fileDescriptor = open(temporaryFile, O_WRONLY | O_CREAT | O_EXCL, 0600);
+  if (fileDescriptor < 0) {
+    errorNumber = errno;
+  } else {
+    size_t written = 0;
+    while (written < key.length) {
+      ssize_t result = write(fileDescriptor, (const uint8_t *)key.bytes + written,
+                             key.length - written);
+      if (result < 0 && errno != EINTR) {
+        errorNumber = errno;
+        break;
+      }
+      written += result > 0 ? (size_t)result : 0;
+    }
+    if (errorNumber == 0 && fsync(fileDescriptor) != 0) {
+      errorNumber = errno;
+    }
+    close(fileDescriptor);
+    if (errorNumber == 0 && link(temporaryFile, _fileURL.path.fileSystemRepresentation) != 0) {
+      errorNumber = errno;
+    }
+    unlink(temporaryFile);
+  }
+
+  if (errorNumber == EEXIST) {
+    // another process created the key first
+    NSData *existingKey = [NSData dataWithContentsOfURL:_fileURL];
+    if (existingKey) {
+      return existingKey;
+    }
+  }
+  if (errorNumber != 0) {
+    if (error) {
+      NSError *POSIXError = [NSError errorWithDomain:NSPOSIXErrorDomain
+                                                code:errorNumber
+                                            userInfo:nil];
+      *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeKeyUnavailable
+                                underlyingError:POSIXError
+                                    description:nil];
+    }
+    return nil;
+  }
+  return key;
+}
+
+@end
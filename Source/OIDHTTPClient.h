@@ -0,0 +1,177 @@
+/*! @file OIDHTTPClient.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "OIDCancellable.h"
+#import "OIDRequestPriority.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @typedef OIDHTTPCompletion
+    @brief The type of block called when an @c OIDHTTPClient request completes.
+    @param data The response body, which is truncated for error responses that aren't JSON.
+    @param response The HTTP response, if one was received.
+    @param error The error, if the request failed or was aborted.
+ */
+typedef void (^OIDHTTPCompletion)(NSData *_Nullable data,
+                                  NSHTTPURLResponse *_Nullable response,
+                                  NSError *_Nullable error);
+
+/*! @enum OIDHTTPEndpointType
+    @brief The kinds of endpoint @c OIDHTTPClient fetches from, which have separate maximum
+        response body sizes.
+ */
+typedef NS_ENUM(NSInteger, OIDHTTPEndpointType) {
+  /*! @var OIDHTTPEndpointTypeDiscovery
+      @brief An OpenID Connect discovery document.
+   */
+  OIDHTTPEndpointTypeDiscovery,
+
+  /*! @var OIDHTTPEndpointTypeToken
+      @brief The token endpoint.
+   */
+  OIDHTTPEndpointTypeToken,
+
+  /*! @var OIDHTTPEndpointTypeRegistration
+      @brief The dynamic client registration endpoint.
+   */
+  OIDHTTPEndpointTypeRegistration,
+};
+
+/*! @class OIDHTTPClient
+    @brief Performs the HTTP requests of @c OIDAuthorizationService, reading responses
+        incrementally so that misbehaving endpoints can't push arbitrarily large bodies into
+        memory.
+    @discussion Each request is aborted with @c OIDErrorCodeResponseTooLarge as soon as its
+        declared Content-Length, or the number of bytes received so far, exceeds the maximum body
+        size for its endpoint type.
+
+        Successful responses must be JSON objects. A response whose Content-Type isn't
+        @c application/json or an @c application type with a "+json" suffix, such as an HTML or
+        plain text page, is aborted with @c OIDErrorCodeUnexpectedContentType before its body is
+        read. A response whose body doesn't start with '{' is aborted with
+        @c OIDErrorCodeJSONDeserializationError as soon as the first non-whitespace byte arrives.
+        Error responses are only read up to @c OIDHTTPErrorResponseBodyCaptureLimit bytes,
+        whatever their type, which is all the resulting error keeps.
+
+        At most @c maximumConcurrentRequests requests run at once. Others wait, and are started
+        in order of their @c OIDRequestPriority, so queued background work never delays a more
+        urgent request. User-initiated requests never wait. Each request's priority also sets the
+        priority of its @c NSURLSessionTask. Its completion runs on a global queue of
+        corresponding priority, which is where @c OIDAuthorizationService parses responses before
+        calling its own callbacks on the main queue.
+ */
+@interface OIDHTTPClient : NSObject
+
+/*! @fn sharedClient
+    @brief The client used by @c OIDAuthorizationService.
+ */
++ (OIDHTTPClient *)sharedClient;
+
+/*! @fn setSharedClient:
+    @brief Replaces the client used by @c OIDAuthorizationService, for example to use a custom
+        session configuration or to stub the network in tests.
+    @param client The new shared client.
+ */
++ (void)setSharedClient:(OIDHTTPClient *)client;
+
+/*! @fn init
+    @brief Creates a client with the default session configuration.
+ */
+- (instancetype)init;
+
+/*! @fn initWithSessionConfiguration:
+    @brief Designated initializer.
+    @param configuration The configuration of the client's @c NSURLSession.
+    @discussion The session retains the client until @c invalidateAndCancel is called.
+ */
+- (instancetype)initWithSessionConfiguration:(NSURLSessionConfiguration *)configuration
+    NS_DESIGNATED_INITIALIZER;
+
+/*! @fn maximumBodySizeForEndpointType:
+    @brief The maximum number of bytes read from a response from the given type of endpoint.
+    @discussion Defaults to 1 MiB for discovery documents, and 256 KiB for the token and
+        registration endpoints.
+ */
+- (NSUInteger)maximumBodySizeForEndpointType:(OIDHTTPEndpointType)endpointType;
+
+/*! @fn setMaximumBodySize:forEndpointType:
+    @brief Sets the maximum number of bytes read from a response from the given type of endpoint.
+    @param maximumBodySize The maximum body size, in bytes.
+    @param endpointType The endpoint type the limit applies to.
+ */
+- (void)setMaximumBodySize:(NSUInteger)maximumBodySize
+           forEndpointType:(OIDHTTPEndpointType)endpointType;
+
+/*! @property maximumConcurrentRequests
+    @brief The number of requests run at once, not counting user-initiated ones. Defaults to 4.
+ */
+@property(nonatomic) NSUInteger maximumConcurrentRequests;
+
+/*! @fn performRequest:endpointType:completion:
+    @brief Performs an HTTP request, enforcing the limits for the endpoint type.
+    @param request The request.
+    @param endpointType The type of endpoint the request is sent to.
+    @param completion Called on a global queue when the request completes or is aborted.
+    @return A handle which cancels the request.
+ */
+- (id<OIDCancellable>)performRequest:(NSURLRequest *)request
+                        endpointType:(OIDHTTPEndpointType)endpointType
+                          completion:(OIDHTTPCompletion)completion;
+
+/*! @fn performRequest:endpointType:deadline:completion:
+    @brief Performs an HTTP request which must complete before the given deadline.
+    @param request The request. Its timeout is shortened to the time left before the deadline.
+    @param endpointType The type of endpoint the request is sent to.
+    @param deadline The time by which the request must complete, or nil for no deadline. A request
+        still in progress at the deadline is cancelled, and one whose deadline has already passed
+        isn't started. Either way it fails with @c OIDErrorCodeDeadlineExceeded.
+    @param completion Called on a global queue when the request completes or is aborted.
+    @return A handle which cancels the request.
+ */
+- (id<OIDCancellable>)performRequest:(NSURLRequest *)request
+                        endpointType:(OIDHTTPEndpointType)endpointType
+                            deadline:(nullable NSDate *)deadline
+                          completion:(OIDHTTPCompletion)completion;
+
+/*! @fn performRequest:endpointType:priority:deadline:completion:
+    @brief Performs an HTTP request with the given priority.
+    @param request The request.
+    @param endpointType The type of endpoint the request is sent to.
+    @param priority How urgently the response is needed.
+    @param deadline The time by which the request must complete, or nil for no deadline.
+    @param completion Called on a global queue of the given priority when the request completes or
+        is aborted.
+    @return A handle which cancels the request.
+ */
+- (id<OIDCancellable>)performRequest:(NSURLRequest *)request
+                        endpointType:(OIDHTTPEndpointType)endpointType
+                            priority:(OIDRequestPriority)priority
+                            deadline:(nullable NSDate *)deadline
+                          completion:(OIDHTTPCompletion)completion;
+
+/*! @fn invalidateAndCancel
+    @brief Cancels the requests in progress and invalidates the client's session, which releases
+        the client. The client can't be used afterwards.
+ */
+- (void)invalidateAndCancel;
+
+@end
+
+NS_ASSUME_NONNULL_END
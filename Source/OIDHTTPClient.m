@@ -0,0 +1,609 @@
+/*! @file OIDHTTPClient.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDHTTPClient.h"
+
+#import "OIDError.h"
+#import "OIDErrorUtilities.h"
+#import "OIDLogging.h"
+
+/*! @var kDefaultMaximumDiscoveryBodySize
+    @brief The default maximum size of a discovery document.
+ */
+static NSUInteger const kDefaultMaximumDiscoveryBodySize = 1024 * 1024;
+
+/*! @var kDefaultMaximumEndpointBodySize
+    @brief The default maximum size of a token or registration endpoint response.
+ */
+static NSUInteger const kDefaultMaximumEndpointBodySize = 256 * 1024;
+
+/*! @var kDefaultMaximumConcurrentRequests
+    @brief The default number of requests run at once, which matches the per-host connection
+        limit of the default session configuration on iOS.
+ */
+static NSUInteger const kDefaultMaximumConcurrentRequests = 4;
+
+/*! @var gSharedClient
+    @brief The client returned by @c sharedClient. Synchronized on the @c OIDHTTPClient class.
+ */
+static OIDHTTPClient *gSharedClient;
+
+/*! @fn OIDIsJSONCompatibleMIMEType
+    @brief Returns whether a response with the given MIME type may contain JSON.
+    @discussion Only @c application/json and the @c application types with a "+json" suffix
+        are, besides responses without a type, whose body is still checked to start like a JSON
+        object.
+ */
+static BOOL OIDIsJSONCompatibleMIMEType(NSString *_Nullable MIMEType) {
+  if (!MIMEType) {
+    return YES;
+  }
+  NSString *type = MIMEType.lowercaseString;
+  return [type isEqualToString:@"application/json"]
+      || ([type hasPrefix:@"application/"] && [type hasSuffix:@"+json"]);
+}
+
+/*! @fn OIDTaskPriorityForRequestPriority
+    @brief Returns the @c NSURLSessionTask priority for a request priority.
+ */
+static float OIDTaskPriorityForRequestPriority(OIDRequestPriority priority) {
+  switch (priority) {
+    case OIDRequestPriorityBackground:
+      return NSURLSessionTaskPriorityLow;
+    case OIDRequestPriorityDefault:
+      return NSURLSessionTaskPriorityDefault;
+    case OIDRequestPriorityUserInitiated:
+      return NSURLSessionTaskPriorityHigh;
+  }
+  return NSURLSessionTaskPriorityDefault;
+}
+
+/*! @fn OIDCompletionQueueForRequestPriority
+    @brief Returns the queue a request's completion is called on, and its response parsed on.
+    @discussion On Apple platforms, the global queue priorities map to the QoS classes utility,
+        default and user-initiated.
+ */
+static dispatch_queue_t OIDCompletionQueueForRequestPriority(OIDRequestPriority priority) {
+  long queuePriority = DISPATCH_QUEUE_PRIORITY_DEFAULT;
+  if (priority == OIDRequestPriorityBackground) {
+    queuePriority = DISPATCH_QUEUE_PRIORITY_LOW;
+  } else if (priority == OIDRequestPriorityUserInitiated) {
+    queuePriority = DISPATCH_QUEUE_PRIORITY_HIGH;
+  }
+  return dispatch_get_global_queue(queuePriority, 0);
+}
+
+/*! @class OIDHTTPTransfer
+    @brief The state of a request in progress.
+ */
+@interface OIDHTTPTransfer : NSObject {
+ @public
+  /*! @var completion
+      @brief The block to call when the transfer finishes.
+   */
+  OIDHTTPCompletion completion;
+
+  /*! @var task
+      @brief The transfer's task.
+   */
+  NSURLSessionDataTask *task;
+
+  /*! @var priority
+      @brief The priority of the request.
+   */
+  OIDRequestPriority priority;
+
+  /*! @var started
+      @brief Whether the task has been resumed, rather than waiting for a free slot.
+   */
+  BOOL started;
+
+  /*! @var maximumBodySize
+      @brief The endpoint's maximum body size.
+   */
+  NSUInteger maximumBodySize;
+
+  /*! @var limit
+      @brief The number of bytes to read, once the response's headers have been received.
+   */
+  NSUInteger limit;
+
+  /*! @var truncates
+      @brief Whether the body is truncated to @c limit, rather than the request aborted.
+   */
+  BOOL truncates;
+
+  /*! @var expectsJSONObject
+      @brief Whether the body must be a JSON object, whose start is checked when it arrives.
+   */
+  BOOL expectsJSONObject;
+
+  /*! @var response
+      @brief The response, once received.
+   */
+  NSHTTPURLResponse *response;
+
+  /*! @var data
+      @brief The body received so far.
+   */
+  NSMutableData *data;
+}
+@end
+
+@implementation OIDHTTPTransfer
+@end
+
+@interface OIDHTTPClient () <NSURLSessionDataDelegate>
+
+/*! @fn abortTask:code:description:
+    @brief Cancels the task and finishes it with an error.
+ */
+- (void)abortTask:(NSURLSessionTask *)task
+             code:(OIDErrorCode)code
+      description:(NSString *)description;
+
+@end
+
+/*! @class OIDHTTPRequestHandle
+    @brief The @c OIDCancellable returned for each request.
+ */
+@interface OIDHTTPRequestHandle : NSObject <OIDCancellable>
+
+/*! @fn initWithClient:task:
+    @brief Designated initializer.
+    @param client The client performing the request.
+    @param task The request's task, or nil if the request has already finished.
+ */
+- (instancetype)initWithClient:(nullable OIDHTTPClient *)client
+                          task:(nullable NSURLSessionTask *)task;
+
+@end
+
+@implementation OIDHTTPRequestHandle {
+  __weak OIDHTTPClient *_client;
+  NSURLSessionTask *_task;
+}
+
+- (instancetype)initWithClient:(nullable OIDHTTPClient *)client
+                          task:(nullable NSURLSessionTask *)task {
+  self = [super init];
+  if (self) {
+    _client = client;
+    _task = task;
+  }
+  return self;
+}
+
+- (void)cancel {
+  if (_task) {
+    [_client abortTask:_task
+                  code:OIDErrorCodeRequestCanceled
+           description:@"The request was cancelled."];
+  }
+}
+
+@end
+
+@implementation OIDHTTPClient {
+  /*! @var _session
+      @brief The session, whose delegate is this client.
+   */
+  NSURLSession *_session;
+
+  /*! @var _transfers
+      @brief The requests in progress or waiting to start, by task identifier. Also used as the
+          lock for every other instance variable.
+   */
+  NSMutableDictionary<NSNumber *, OIDHTTPTransfer *> *_transfers;
+
+  /*! @var _waitingTransfers
+      @brief The requests waiting for a free slot, most urgent first, and in the order they were
+          made within each priority.
+   */
+  NSMutableArray<OIDHTTPTransfer *> *_waitingTransfers;
+
+  /*! @var _runningCount
+      @brief The number of requests which have been started and haven't finished.
+   */
+  NSUInteger _runningCount;
+
+  /*! @var _maximumConcurrentRequests
+      @brief The backing variable of @c maximumConcurrentRequests.
+   */
+  NSUInteger _maximumConcurrentRequests;
+
+  /*! @var _maximumBodySizes
+      @brief The maximum body size of each endpoint type, indexed by @c OIDHTTPEndpointType.
+   */
+  NSUInteger _maximumBodySizes[OIDHTTPEndpointTypeRegistration + 1];
+}
+
++ (OIDHTTPClient *)sharedClient {
+  @synchronized(self) {
+    if (!gSharedClient) {
+      gSharedClient = [[OIDHTTPClient alloc] init];
+    }
+    return gSharedClient;
+  }
+}
+
++ (void)setSharedClient:(OIDHTTPClient *)client {
+  @synchronized(self) {
+    gSharedClient = client;
+  }
+}
+
+- (instancetype)init {
+  return [self initWithSessionConfiguration:
+                   [NSURLSessionConfiguration defaultSessionConfiguration]];
+}
+
+- (instancetype)initWithSessionConfiguration:(NSURLSessionConfiguration *)configuration {
+  self = [super init];
+  if (self) {
+    _transfers = [NSMutableDictionary dictionary];
+    _waitingTransfers = [NSMutableArray array];
+    _maximumConcurrentRequests = kDefaultMaximumConcurrentRequests;
+    _maximumBodySizes[OIDHTTPEndpointTypeDiscovery] = kDefaultMaximumDiscoveryBodySize;
+    _maximumBodySizes[OIDHTTPEndpointTypeToken] = kDefaultMaximumEndpointBodySize;
+    _maximumBodySizes[OIDHTTPEndpointTypeRegistration] = kDefaultMaximumEndpointBodySize;
+    // a serial queue, so each transfer's delegate messages are handled in order
+    NSOperationQueue *delegateQueue = [[NSOperationQueue alloc] init];
+    delegateQueue.maxConcurrentOperationCount = 1;
+    _session = [NSURLSession sessionWithConfiguration:configuration
+                                             delegate:self
+                                        delegateQueue:delegateQueue];
+  }
+  return self;
+}
+
+- (NSUInteger)maximumBodySizeForEndpointType:(OIDHTTPEndpointType)endpointType {
+  @synchronized(_transfers) {
+    return _maximumBodySizes[endpointType];
+  }
+}
+
+- (void)setMaximumBodySize:(NSUInteger)maximumBodySize
+           forEndpointType:(OIDHTTPEndpointType)endpointType {
+  @synchronized(_transfers) {
+    _maximumBodySizes[endpointType] = maximumBodySize;
+  }
+}
+
+- (NSUInteger)maximumConcurrentRequests {
+  @synchronized(_transfers) {
+    return _maximumConcurrentRequests;
+  }
+}
+
+- (void)setMaximumConcurrentRequests:(NSUInteger)maximumConcurrentRequests {
+  @synchronized(_transfers) {
+    _maximumConcurrentRequests = maximumConcurrentRequests;
+  }
+  [self startWaitingTasks];
+}
+
+- (id<OIDCancellable>)performRequest:(NSURLRequest *)request
+                        endpointType:(OIDHTTPEndpointType)endpointType
+                          completion:(OIDHTTPCompletion)completion {
+  return [self performRequest:request
+                 endpointType:endpointType
+                     deadline:nil
+                   completion:completion];
+}
+
+- (id<OIDCancellable>)performRequest:(NSURLRequest *)request
+                        endpointType:(OIDHTTPEndpointType)endpointType
+                            deadline:(nullable NSDate *)deadline
+                          completion:(OIDHTTPCompletion)completion {
+  return [self performRequest:request
+                 endpointType:endpointType
+                     priority:OIDRequestPriorityDefault
+                     deadline:deadline
+                   completion:completion];
+}
+
+- (id<OIDCancellable>)performRequest:(NSURLRequest *)request
+                        endpointType:(OIDHTTPEndpointType)endpointType
+                            priority:(OIDRequestPriority)priority
+                            deadline:(nullable NSDate *)deadline
+                          completion:(OIDHTTPCompletion)completion {
+  OIDHTTPTransfer *transfer = [[OIDHTTPTransfer alloc] init];
+  transfer->completion = [completion copy];
+  transfer->priority = priority;
+  transfer->maximumBodySize = [self maximumBodySizeForEndpointType:endpointType];
+
+  NSTimeInterval remaining = deadline ? deadline.timeIntervalSinceNow : 0;
+  if (deadline && remaining <= 0) {
+    OIDLogInfo(@"Not starting the request to %@, whose deadline has passed.", request.URL);
+    NSError *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeDeadlineExceeded
+                                      underlyingError:nil
+                                          description:@"The deadline passed before the request "
+                                                       "started."];
+    [self deliverTransfer:transfer data:nil error:error];
+    return [[OIDHTTPRequestHandle alloc] initWithClient:nil task:nil];
+  }
+  if (deadline && remaining < request.timeoutInterval) {
+    // the session's own timeout also fails the request once the deadline passes, in case the
+    // request is stalled rather than slow
+    NSMutableURLRequest *boundedRequest = [request mutableCopy];
+    boundedRequest.timeoutInterval = remaining;
+    request = boundedRequest;
+  }
+
+  NSURLSessionDataTask *task = [_session dataTaskWithRequest:request];
+  task.priority = OIDTaskPriorityForRequestPriority(priority);
+  transfer->task = task;
+  NSArray<NSURLSessionTask *> *tasksToStart;
+  @synchronized(_transfers) {
+    _transfers[@(task.taskIdentifier)] = transfer;
+    if (priority == OIDRequestPriorityUserInitiated) {
+      // the user is waiting, so this doesn't queue behind anything
+      transfer->started = YES;
+      _runningCount++;
+      tasksToStart = @[ task ];
+    } else {
+      NSUInteger index = 0;
+      while (index < _waitingTransfers.count && _waitingTransfers[index]->priority >= priority) {
+        index++;
+      }
+      [_waitingTransfers insertObject:transfer atIndex:index];
+      tasksToStart = [self dequeueWaitingTasks];
+    }
+  }
+  [tasksToStart makeObjectsPerformSelector:@selector(resume)];
+
+  if (deadline) {
+    // the timeout above is reset whenever data arrives, so the deadline is also enforced directly
+    __weak OIDHTTPClient *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(remaining * NSEC_PER_SEC)),
+                   dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0),
+                   ^{
+      [weakSelf abortTask:task
+                     code:OIDErrorCodeDeadlineExceeded
+              description:@"The request didn't complete before its deadline."];
+    });
+  }
+  return [[OIDHTTPRequestHandle alloc] initWithClient:self task:task];
+}
+
+- (void)invalidateAndCancel {
+  [_session invalidateAndCancel];
+}
+
+#pragma mark - Transfers
+
+/*! @fn transferForTask:
+    @brief Returns the state of the given task, or nil if it has already finished.
+ */
+- (nullable OIDHTTPTransfer *)transferForTask:(NSURLSessionTask *)task {
+  @synchronized(_transfers) {
+    return _transfers[@(task.taskIdentifier)];
+  }
+}
+
+/*! @fn dequeueWaitingTasks
+    @brief Marks as many waiting requests as there are free slots as started, most urgent first.
+        Must be called while synchronized on @c _transfers.
+    @return The tasks to resume, once no longer synchronized.
+ */
+- (NSArray<NSURLSessionTask *> *)dequeueWaitingTasks {
+  NSMutableArray<NSURLSessionTask *> *tasks = [NSMutableArray array];
+  while (_waitingTransfers.count && _runningCount < _maximumConcurrentRequests) {
+    OIDHTTPTransfer *transfer = _waitingTransfers.firstObject;
+    [_waitingTransfers removeObjectAtIndex:0];
+    transfer->started = YES;
+    _runningCount++;
+    [tasks addObject:transfer->task];
+  }
+  return tasks;
+}
+
+/*! @fn startWaitingTasks
+    @brief Starts as many waiting requests as there are free slots.
+ */
+- (void)startWaitingTasks {
+  NSArray<NSURLSessionTask *> *tasksToStart;
+  @synchronized(_transfers) {
+    tasksToStart = [self dequeueWaitingTasks];
+  }
+  [tasksToStart makeObjectsPerformSelector:@selector(resume)];
+}
+
+/*! @fn removeTransferForTask:
+    @brief Removes the task's state, freeing its slot if it was running. The caller must call
+        @c startWaitingTasks afterwards.
+    @return The task's state, or nil if it has already finished.
+ */
+- (nullable OIDHTTPTransfer *)removeTransferForTask:(NSURLSessionTask *)task {
+  @synchronized(_transfers) {
+    OIDHTTPTransfer *transfer = _transfers[@(task.taskIdentifier)];
+    if (!transfer) {
+      return nil;
+    }
+    [_transfers removeObjectForKey:@(task.taskIdentifier)];
+    if (transfer->started) {
+      _runningCount--;
+    } else {
+      [_waitingTransfers removeObjectIdenticalTo:transfer];
+    }
+    return transfer;
+  }
+}
+
+/*! @fn deliverTransfer:data:error:
+    @brief Calls the transfer's completion on the queue for its priority.
+ */
+- (void)deliverTransfer:(OIDHTTPTransfer *)transfer
+                   data:(nullable NSData *)data
+                  error:(nullable NSError *)error {
+  dispatch_async(OIDCompletionQueueForRequestPriority(transfer->priority), ^{
+    transfer->completion(data, transfer->response, error);
+  });
+}
+
+/*! @fn finishTask:data:error:
+    @brief Removes the task's state and calls its completion. Does nothing if the task has already
+        finished.
+    @param task The task.
+    @param data The body to report.
+    @param error The error to report.
+ */
+- (void)finishTask:(NSURLSessionTask *)task
+              data:(nullable NSData *)data
+             error:(nullable NSError *)error {
+  OIDHTTPTransfer *transfer = [self removeTransferForTask:task];
+  if (transfer) {
+    [self startWaitingTasks];
+    [self deliverTransfer:transfer data:data error:error];
+  }
+}
+
+/*! @fn abortTask:code:description:
+    @brief Cancels the task and finishes it with an error. Does nothing if the task has already
+        finished. May be called on any thread.
+    @discussion The task is cancelled before this method returns, which frees its connection for
+        the next waiting request.
+ */
+- (void)abortTask:(NSURLSessionTask *)task
+             code:(OIDErrorCode)code
+      description:(NSString *)description {
+  OIDHTTPTransfer *transfer = [self removeTransferForTask:task];
+  if (!transfer) {
+    return;
+  }
+  OIDLogInfo(@"Aborted the request to %@: %@", task.originalRequest.URL, description);
+  [task cancel];
+  [self startWaitingTasks];
+  NSError *error = [OIDErrorUtilities errorWithCode:code
+                                    underlyingError:nil
+                                        description:description];
+  [self deliverTransfer:transfer data:nil error:error];
+}
+
+#pragma mark - NSURLSessionDataDelegate
+
+- (void)URLSession:(NSURLSession *)session
+              dataTask:(NSURLSessionDataTask *)dataTask
+    didReceiveResponse:(NSURLResponse *)response
+     completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler {
+  OIDHTTPTransfer *transfer = [self transferForTask:dataTask];
+  if (!transfer) {
+    completionHandler(NSURLSessionResponseCancel);
+    return;
+  }
+  NSHTTPURLResponse *HTTPResponse =
+      [response isKindOfClass:[NSHTTPURLResponse class]] ? (NSHTTPURLResponse *)response : nil;
+  transfer->response = HTTPResponse;
+  BOOL successful = HTTPResponse.statusCode >= 200 && HTTPResponse.statusCode < 300;
+  BOOL JSONCompatible = OIDIsJSONCompatibleMIMEType(response.MIMEType);
+
+  if (successful && !JSONCompatible) {
+    completionHandler(NSURLSessionResponseCancel);
+    [self abortTask:dataTask
+               code:OIDErrorCodeUnexpectedContentType
+        description:[NSString stringWithFormat:@"Unexpected content type %@.", response.MIMEType]];
+    return;
+  }
+
+  // error bodies are only used for the error, so aren't worth failing the request over
+  transfer->truncates = !successful;
+  transfer->expectsJSONObject = successful;
+  // an OAuth error object is far smaller than the capture limit
+  transfer->limit = successful
+      ? transfer->maximumBodySize
+      : MIN(transfer->maximumBodySize, OIDHTTPErrorResponseBodyCaptureLimit);
+
+  long long expectedLength = response.expectedContentLength;
+  if (!transfer->truncates && expectedLength > (long long)transfer->limit) {
+    completionHandler(NSURLSessionResponseCancel);
+    [self abortTask:dataTask
+               code:OIDErrorCodeResponseTooLarge
+        description:[NSString stringWithFormat:@"Content-Length %lld exceeds the limit of %lu.",
+                                               expectedLength,
+                                               (unsigned long)transfer->limit]];
+    return;
+  }
+  NSUInteger capacity =
+      expectedLength > 0 ? (NSUInteger)MIN(expectedLength, (long long)transfer->limit) : 0;
+  transfer->data = [NSMutableData dataWithCapacity:capacity];
+  completionHandler(NSURLSessionResponseAllow);
+}
+
+- (void)URLSession:(NSURLSession *)session
+          dataTask:(NSURLSessionDataTask *)dataTask
+    didReceiveData:(NSData *)data {
+  OIDHTTPTransfer *transfer = [self transferForTask:dataTask];
+  if (!transfer) {
+    return;
+  }
+
+  if (transfer->expectsJSONObject) {
+    // checks the first significant byte as soon as it arrives, so an HTML page served with a JSON
+    // content type is rejected without reading the rest of it
+    __block BOOL rejected = NO;
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+      const char *characters = bytes;
+      for (NSUInteger i = 0; i < byteRange.length; i++) {
+        char character = characters[i];
+        if (character == ' ' || character == '\t' || character == '\r' || character == '\n') {
+          continue;
+        }
+        rejected = character != '{';
+        transfer->expectsJSONObject = NO;
+        *stop = YES;
+        return;
+      }
+    }];
+    if (rejected) {
+      [self abortTask:dataTask
+                 code:OIDErrorCodeJSONDeserializationError
+          description:@"The response is not a JSON object."];
+      return;
+    }
+  }
+
+  NSUInteger remaining = transfer->limit - transfer->data.length;
+  if (data.length > remaining) {
+    if (!transfer->truncates) {
+      [self abortTask:dataTask
+                 code:OIDErrorCodeResponseTooLarge
+          description:[NSString stringWithFormat:@"The response exceeds the limit of %lu bytes.",
+                                                 (unsigned long)transfer->limit]];
+      return;
+    }
+    [transfer->data appendData:[data subdataWithRange:NSMakeRange(0, remaining)]];
+    [dataTask cancel];
+    [self finishTask:dataTask data:transfer->data error:nil];
+    return;
+  }
+  [transfer->data appendData:data];
+}
+
+- (void)URLSession:(NSURLSession *)session
+                    task:(NSURLSessionTask *)task
+    didCompleteWithError:(nullable NSError *)error {
+  OIDHTTPTransfer *transfer = [self transferForTask:task];
+  if (!transfer) {
+    // already finished when it was aborted or truncated
+    return;
+  }
+  [self finishTask:task data:error ? nil : (transfer->data ?: [NSData data]) error:error];
+}
+
+@end
@@ -0,0 +1,58 @@
+/*! @file OIDJWSSigner.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @protocol OIDJWSSigner
+    @brief A key which signs JSON Web Signatures, such as client assertions, request objects and
+        DPoP proofs.
+    @discussion Asymmetric keys are typically kept in the Secure Enclave or the keychain, so
+        implementations of this protocol are supplied by the app.
+    @see https://www.rfc-editor.org/rfc/rfc7515
+ */
+@protocol OIDJWSSigner <NSObject>
+
+/*! @property algorithm
+    @brief The JWS algorithm the key signs with, such as "ES256".
+    @see https://www.rfc-editor.org/rfc/rfc7518#section-3.1
+ */
+@property(nonatomic, readonly) NSString *algorithm;
+
+/*! @fn signatureForSigningInput:error:
+    @brief Signs a JWS signing input.
+    @param signingInput The ASCII bytes of the encoded header and claims, separated by a period.
+    @param error If the key could not sign, the reason.
+    @return The signature in its JWS form, for example the concatenated R and S values for ES256
+        rather than a DER sequence.
+ */
+- (nullable NSData *)signatureForSigningInput:(NSData *)signingInput
+                                        error:(NSError **_Nullable)error;
+
+@optional
+
+/*! @property keyID
+    @brief The identifier of the key, which is sent in the @c kid header parameter so the server
+        can find the key among those registered for the client.
+ */
+@property(nonatomic, readonly, nullable) NSString *keyID;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,45 @@
+/*! @file OIDKeySource.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @protocol OIDKeySource
+    @brief Provides the secret key material an @c OIDEncryptedAuthStateStore encrypts its records
+        with, from wherever the platform keeps secrets.
+    @discussion @c OIDFileKeySource keeps the key in a file, for platforms without a keychain such
+        as Linux. On Apple platforms, apps can implement this protocol to keep the key in the
+        keychain, or derive it from a key in the Secure Enclave.
+
+        Fetching a key may be slow, for example a keychain query, so stores only ask for it once.
+ */
+@protocol OIDKeySource <NSObject>
+
+/*! @fn dataKeyWithLength:error:
+    @brief Returns the key, creating it with random bytes the first time it's requested.
+    @param length The number of bytes of key material required.
+    @param error If the key could not be created or read, the reason.
+    @return The key material, which must be the same for every call with the same length, or nil
+        if it's unavailable.
+ */
+- (nullable NSData *)dataKeyWithLength:(NSUInteger)length error:(NSError **_Nullable)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
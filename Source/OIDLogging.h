@@ -0,0 +1,154 @@
+/*! @file OIDLogging.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @enum OIDLogLevel
+    @brief The severity of a log message. Messages are written if their level is less than or
+        equal to @c OIDLogging.level.
+ */
+typedef NS_ENUM(NSInteger, OIDLogLevel) {
+  /*! @var OIDLogLevelOff
+      @brief Used as @c OIDLogging.level to disable logging.
+   */
+  OIDLogLevelOff = 0,
+
+  /*! @var OIDLogLevelError
+      @brief Failures which the library can't recover from.
+   */
+  OIDLogLevelError = 1,
+
+  /*! @var OIDLogLevelWarning
+      @brief Unexpected use of the library, or conditions which may lead to errors.
+   */
+  OIDLogLevelWarning = 2,
+
+  /*! @var OIDLogLevelInfo
+      @brief Significant events, such as token refreshes.
+   */
+  OIDLogLevelInfo = 3,
+
+  /*! @var OIDLogLevelDebug
+      @brief Detailed tracing of requests and responses.
+   */
+  OIDLogLevelDebug = 4,
+};
+
+/*! @typedef OIDLogSink
+    @brief Receives formatted log messages.
+    @param level The level of the message.
+    @param message The message, with secrets redacted unless @c OIDLogging.redactsSecrets is NO.
+ */
+typedef void (^OIDLogSink)(OIDLogLevel level, NSString *message);
+
+/*! @var gOIDLogLevel
+    @internal
+    @brief The current log level, read directly by @c OIDLog so that disabled messages cost a
+        single comparison. Use @c OIDLogging.setLevel: to change it.
+ */
+extern OIDLogLevel gOIDLogLevel;
+
+/*! @fn OIDLog
+    @brief Logs a message at the given level. The format and arguments are only evaluated if the
+        level is enabled.
+    @param level An @c OIDLogLevel.
+    @param format A format string, followed by its arguments. Wrap secrets with @c OIDLogRedact.
+ */
+#define OIDLog(level, format, ...) \
+  do { \
+    if ((level) <= gOIDLogLevel) { \
+      OIDLogWrite((level), (format), ##__VA_ARGS__); \
+    } \
+  } while (0)
+
+#define OIDLogError(format, ...) OIDLog(OIDLogLevelError, (format), ##__VA_ARGS__)
+#define OIDLogWarning(format, ...) OIDLog(OIDLogLevelWarning, (format), ##__VA_ARGS__)
+#define OIDLogInfo(format, ...) OIDLog(OIDLogLevelInfo, (format), ##__VA_ARGS__)
+#define OIDLogDebug(format, ...) OIDLog(OIDLogLevelDebug, (format), ##__VA_ARGS__)
+
+/*! @fn OIDLogWrite
+    @internal
+    @brief Formats a message and passes it to the sink, regardless of the level. Use @c OIDLog.
+ */
+void OIDLogWrite(OIDLogLevel level, NSString *format, ...) NS_FORMAT_FUNCTION(2, 3);
+
+/*! @fn OIDLogRedact
+    @brief Returns a placeholder for a secret, such as a token or authorization code, unless
+        @c OIDLogging.redactsSecrets is NO, in which case the secret itself is returned.
+    @param secret The secret, or nil.
+    @return nil if @c secret is nil.
+ */
+NSString *_Nullable OIDLogRedact(NSString *_Nullable secret);
+
+/*! @fn OIDLogRedactParameters
+    @brief Returns the parameters with each value replaced by a placeholder, unless
+        @c OIDLogging.redactsSecrets is NO, in which case the parameters are returned unchanged.
+    @param parameters Request or response parameters, which may include secrets.
+ */
+NSDictionary *_Nullable OIDLogRedactParameters(NSDictionary *_Nullable parameters);
+
+/*! @class OIDLogging
+    @brief Configures logging by the library, and the @c description of objects which contain
+        secrets.
+ */
+@interface OIDLogging : NSObject
+
+/*! @fn init
+    @internal
+    @brief Unavailable. This class should not be initialized.
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @fn level
+    @brief The most detailed level of message which is logged. Defaults to
+        @c OIDLogLevelWarning.
+ */
++ (OIDLogLevel)level;
+
+/*! @fn setLevel:
+    @brief Sets the most detailed level of message which is logged.
+    @param level The new level, or @c OIDLogLevelOff.
+ */
++ (void)setLevel:(OIDLogLevel)level;
+
+/*! @fn setSink:
+    @brief Sets the destination of log messages, for example to forward them to an app's own
+        logging system.
+    @param sink The sink, which may be called on any thread, or nil to restore the default, which
+        uses @c NSLog.
+ */
++ (void)setSink:(nullable OIDLogSink)sink;
+
+/*! @fn redactsSecrets
+    @brief Whether tokens, codes and other secrets are replaced with placeholders in log messages
+        and descriptions. Defaults to YES.
+ */
++ (BOOL)redactsSecrets;
+
+/*! @fn setRedactsSecrets:
+    @brief Sets whether secrets are redacted. Only disable redaction while debugging, as logs can
+        end up in crash reports and support requests.
+    @param redactsSecrets NO to include secrets in log messages and descriptions.
+ */
++ (void)setRedactsSecrets:(BOOL)redactsSecrets;
+
+@end
+
+NS_ASSUME_NONNULL_END
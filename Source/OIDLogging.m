@@ -0,0 +1,103 @@
+/*! @file OIDLogging.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDLogging.h"
+
+/*! @var kRedactedPlaceholder
+    @brief Replaces secrets in log messages and descriptions.
+ */
+static NSString *const kRedactedPlaceholder = @"[redacted]";
+
+/*! @var kLogPrefix
+    @brief Prefixes messages written by the default sink.
+ */
+static NSString *const kLogPrefix = @"AppAuth";
+
+OIDLogLevel gOIDLogLevel = OIDLogLevelWarning;
+
+/*! @var gSink
+    @brief The custom sink, if any. Synchronized on the @c OIDLogging class.
+ */
+static OIDLogSink gSink;
+
+/*! @var gRedactsSecrets
+    @brief Whether secrets are redacted.
+ */
+static BOOL gRedactsSecrets = YES;
+
+void OIDLogWrite(OIDLogLevel level, NSString *format, ...) {
+  va_list arguments;
+  va_start(arguments, format);
+  NSString *message = [[NSString alloc] initWithFormat:format arguments:arguments];
+  va_end(arguments);
+
+  OIDLogSink sink;
+  @synchronized([OIDLogging class]) {
+    sink = gSink;
+  }
+  if (sink) {
+    sink(level, message);
+  } else {
+    NSLog(@"[%@] %@", kLogPrefix, message);
+  }
+}
+
+NSString *_Nullable OIDLogRedact(NSString *_Nullable secret) {
+  if (!secret || !gRedactsSecrets) {
+    return secret;
+  }
+  return kRedactedPlaceholder;
+}
+
+NSDictionary *_Nullable OIDLogRedactParameters(NSDictionary *_Nullable parameters) {
+  if (!parameters || !gRedactsSecrets) {
+    return parameters;
+  }
+  NSMutableDictionary *redactedParameters =
+      [NSMutableDictionary dictionaryWithCapacity:parameters.count];
+  for (id key in parameters) {
+    redactedParameters[key] = kRedactedPlaceholder;
+  }
+  return redactedParameters;
+}
+
+@implementation OIDLogging
+
++ (OIDLogLevel)level {
+  return gOIDLogLevel;
+}
+
++ (void)setLevel:(OIDLogLevel)level {
+  gOIDLogLevel = level;
+}
+
++ (void)setSink:(nullable OIDLogSink)sink {
+  @synchronized(self) {
+    gSink = [sink copy];
+  }
+}
+
++ (BOOL)redactsSecrets {
+  return gRedactsSecrets;
+}
+
++ (void)setRedactsSecrets:(BOOL)redactsSecrets {
+  gRedactsSecrets = redactsSecrets;
+}
+
+@end
@@ -0,0 +1,100 @@
+/*! @file OIDLoopbackRedirectListener.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "OIDAuthorizationService.h"
+
+@class OIDAuthorizationRequest;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDLoopbackRedirectListener
+    @brief Receives authorization responses sent to a loopback IP redirect URI, for apps which
+        can't register a custom URI scheme, such as command line tools and automated tests.
+    @discussion The listener accepts HTTP connections on 127.0.0.1, on a port assigned by the
+        operating system. Create authorization requests with its @c redirectURL, start a flow
+        session for each with @c authorizationFlowSessionWithRequest:callback: and open the
+        request's @c authorizationRequestURL in a browser. When the browser is redirected back,
+        the listener responds to it straight away, and resumes the session whose request @c state
+        matches the response.
+
+        Any number of flows can be in progress on one listener. Connections are handled with
+        dispatch sources on a single private serial queue; no threads are created per connection.
+        Unless @c stopsWhenIdle is set to NO, the listener closes its socket once the last flow
+        session has completed, and reopens it on the same port when another session starts. If
+        the port was taken in the meantime, that session fails with
+        @c OIDErrorCodeRedirectListenerError.
+    @see https://tools.ietf.org/html/rfc8252#section-7.3
+ */
+@interface OIDLoopbackRedirectListener : NSObject
+
+/*! @property redirectURL
+    @brief The loopback redirect URI to use in authorization requests, e.g.
+        http://127.0.0.1:49152/. Nil until the listener was started.
+ */
+@property(nonatomic, readonly, nullable) NSURL *redirectURL;
+
+/*! @property listening
+    @brief Whether the listener is currently accepting connections.
+ */
+@property(nonatomic, readonly, getter=isListening) BOOL listening;
+
+/*! @property stopsWhenIdle
+    @brief Whether the listener stops after the last of its flow sessions has completed, until the
+        next one starts. Defaults to YES. Should be set before the listener is started.
+ */
+@property(nonatomic, assign) BOOL stopsWhenIdle;
+
+/*! @property responseHTML
+    @brief The HTML page sent to the browser after it delivered an authorization response. Defaults
+        to a short page asking the user to return to the app. Should be set before the listener is
+        started.
+ */
+@property(nonatomic, copy) NSString *responseHTML;
+
+/*! @fn startWithError:
+    @brief Binds to an ephemeral port on 127.0.0.1 and begins accepting connections.
+    @param error If the listener could not be started, an error with the code
+        @c OIDErrorCodeRedirectListenerError.
+    @return YES if the listener is listening.
+ */
+- (BOOL)startWithError:(NSError **_Nullable)error;
+
+/*! @fn stop
+    @brief Closes the listening socket and any open connections. Flow sessions that are still in
+        progress are not cancelled, but can no longer be resumed by this listener.
+ */
+- (void)stop;
+
+/*! @fn authorizationFlowSessionWithRequest:callback:
+    @brief Starts an authorization flow session which is resumed when the listener receives the
+        authorization response for the given request.
+    @param request The authorization request. Its @c redirectURL must be this listener's
+        @c redirectURL, and it must have a @c state, which is used to route the response.
+    @param callback The method called on the main queue when the flow has completed or failed.
+    @return The flow session, which may also be cancelled or resumed directly.
+    @discussion The caller is responsible for opening the request's @c authorizationRequestURL.
+ */
+- (id<OIDAuthorizationFlowSession>)
+    authorizationFlowSessionWithRequest:(OIDAuthorizationRequest *)request
+                               callback:(OIDAuthorizationCallback)callback;
+
+@end
+
+NS_ASSUME_NONNULL_END
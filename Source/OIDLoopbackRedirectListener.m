@@ -0,0 +1,574 @@
+/*! @file OIDLoopbackRedirectListener.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDLoopbackRedirectListener.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#import "OIDAuthorizationFlowSessionImplementation.h"
+#import "OIDAuthorizationRequest.h"
+#import "OIDErrorUtilities.h"
+#import "OIDURLQueryComponent.h"
+
+/*! @var kStateParameter
+    @brief The authorization response parameter used to route a response to its flow session.
+ */
+static NSString *const kStateParameter = @"state";
+
+/*! @var kMaxRequestLineBytes
+    @brief Connections which send more than this without completing the request line are closed.
+ */
+static NSUInteger const kMaxRequestLineBytes = 8192;
+
+/*! @var kReadBufferBytes
+    @brief The number of bytes read from a connection at a time.
+ */
+static size_t const kReadBufferBytes = 1024;
+
+/*! @var kConnectionTimeoutSeconds
+    @brief Time after which a connection is closed regardless of its state. Browsers open
+        speculative connections which may never send a request.
+ */
+static int64_t const kConnectionTimeoutSeconds = 30;
+
+/*! @var kSendFlags
+    @brief Flags for @c send(2). Where available, @c MSG_NOSIGNAL stops a browser which closed the
+        connection early from raising @c SIGPIPE; elsewhere @c SO_NOSIGPIPE is set on the socket.
+ */
+#ifdef MSG_NOSIGNAL
+static int const kSendFlags = MSG_NOSIGNAL;
+#else
+static int const kSendFlags = 0;
+#endif
+
+/*! @var kDefaultResponseHTML
+    @brief The default value of @c OIDLoopbackRedirectListener.responseHTML.
+ */
+static NSString *const kDefaultResponseHTML =
+    @"<!DOCTYPE html><html><head><meta charset=\"utf-8\"><title>Authorization complete</title>"
+     "</head><body><p>Authorization complete. You can close this window and return to the app."
+     "</p></body></html>";
+
+/*! @var kNotFoundResponseHTML
+    @brief The page sent for requests which don't belong to any flow session.
+ */
+static NSString *const kNotFoundResponseHTML =
+    @"<!DOCTYPE html><html><head><meta charset=\"utf-8\"><title>Not found</title></head>"
+     "<body><p>This request does not belong to an authorization in progress.</p></body></html>";
+
+/*! @fn OIDSetNonBlocking
+    @brief Puts a socket into non-blocking mode.
+    @return YES if the socket is non-blocking.
+ */
+static BOOL OIDSetNonBlocking(int socket) {
+  int flags = fcntl(socket, F_GETFL, 0);
+  return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/*! @fn OIDRedirectListenerError
+    @brief Returns an @c OIDErrorCodeRedirectListenerError error for a failed socket call.
+    @param errorNumber The @c errno of the failed call.
+ */
+static NSError *OIDRedirectListenerError(int errorNumber) {
+  NSError *POSIXError = [NSError errorWithDomain:NSPOSIXErrorDomain code:errorNumber userInfo:nil];
+  return [OIDErrorUtilities errorWithCode:OIDErrorCodeRedirectListenerError
+                          underlyingError:POSIXError
+                              description:nil];
+}
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface OIDLoopbackRedirectListener ()
+
+/*! @fn flowSessionDidFinish:
+    @brief Removes a completed flow session from the listener's routing table.
+ */
+- (void)flowSessionDidFinish:(OIDAuthorizationFlowSessionImplementation *)session;
+
+@end
+
+/*! @class OIDLoopbackAuthorizationFlowSession
+    @brief A flow session resumed by an @c OIDLoopbackRedirectListener.
+ */
+@interface OIDLoopbackAuthorizationFlowSession : OIDAuthorizationFlowSessionImplementation
+
+/*! @property listener
+    @brief The listener routing responses to this session. Retained until the session finishes,
+        so a listener stays alive while it has sessions in progress.
+ */
+@property(nonatomic, strong, nullable) OIDLoopbackRedirectListener *listener;
+
+/*! @property finished
+    @brief Whether the session has invoked its callback. Only accessed on the main queue.
+ */
+@property(nonatomic, readonly) BOOL finished;
+
+@end
+
+@implementation OIDLoopbackAuthorizationFlowSession
+
+- (void)didFinishWithResponse:(nullable OIDAuthorizationResponse *)response
+                        error:(nullable NSError *)error {
+  _finished = YES;
+  OIDLoopbackRedirectListener *listener = _listener;
+  _listener = nil;
+  [listener flowSessionDidFinish:self];
+  [super didFinishWithResponse:response error:error];
+}
+
+@end
+
+/*! @class OIDLoopbackRedirectConnection
+    @brief An accepted connection and the request bytes read from it so far.
+ */
+@interface OIDLoopbackRedirectConnection : NSObject
+
+/*! @property socket
+    @brief The connection's socket, closed when @c readSource is cancelled.
+ */
+@property(nonatomic, readonly) int socket;
+
+/*! @property readSource
+    @brief The dispatch source delivering read events for @c socket.
+ */
+@property(nonatomic, strong, nullable) dispatch_source_t readSource;
+
+/*! @property buffer
+    @brief The bytes received before the end of the request line.
+ */
+@property(nonatomic, readonly) NSMutableData *buffer;
+
+/*! @property responded
+    @brief Whether a response was sent. Further bytes from the client are discarded until it closes
+        the connection, as closing with unread data would reset the connection before the browser
+        has read the response.
+ */
+@property(nonatomic, assign) BOOL responded;
+
+- (instancetype)initWithSocket:(int)socket;
+
+@end
+
+@implementation OIDLoopbackRedirectConnection
+
+- (instancetype)initWithSocket:(int)socket {
+  self = [super init];
+  if (self) {
+    _socket = socket;
+    _buffer = [NSMutableData data];
+  }
+  return self;
+}
+
+@end
+
+@implementation OIDLoopbackRedirectListener {
+  /*! @var _queue
+      @brief Serial queue on which all sockets are serviced, and the state below is accessed.
+   */
+  dispatch_queue_t _queue;
+
+  /*! @var _listenSource
+      @brief Dispatch source for the listening socket, nil when not listening.
+   */
+  dispatch_source_t _listenSource;
+
+  /*! @var _connections
+      @brief Accepted connections which have not been closed yet.
+   */
+  NSMutableSet<OIDLoopbackRedirectConnection *> *_connections;
+
+  /*! @var _sessionsByState
+      @brief Flow sessions in progress, keyed by the @c state of their request.
+   */
+  NSMutableDictionary<NSString *, OIDLoopbackAuthorizationFlowSession *> *_sessionsByState;
+
+  /*! @var _redirectURL
+      @brief Backing variable for @c redirectURL.
+   */
+  NSURL *_redirectURL;
+
+  /*! @var _stoppedWhenIdle
+      @brief Whether the listening socket was closed because the last flow session completed, in
+          which case the next session reopens it on the same port.
+   */
+  BOOL _stoppedWhenIdle;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _queue = dispatch_queue_create("org.openid.appauth.loopback", DISPATCH_QUEUE_SERIAL);
+    _connections = [NSMutableSet set];
+    _sessionsByState = [NSMutableDictionary dictionary];
+    _stopsWhenIdle = YES;
+    _responseHTML = kDefaultResponseHTML;
+  }
+  return self;
+}
+
+- (void)dealloc {
+  // no other references remain, so the state can be accessed from any thread
+  [self closeListeningSocket];
+  [self closeAllConnections];
+}
+
+#pragma mark - Properties
+
+- (nullable NSURL *)redirectURL {
+  __block NSURL *redirectURL;
+  dispatch_sync(_queue, ^{
+    redirectURL = _redirectURL;
+  });
+  return redirectURL;
+}
+
+- (BOOL)isListening {
+  __block BOOL listening;
+  dispatch_sync(_queue, ^{
+    listening = _listenSource != nil;
+  });
+  return listening;
+}
+
+#pragma mark - Starting and stopping
+
+- (BOOL)startWithError:(NSError **_Nullable)error {
+  __block int errorNumber = 0;
+  dispatch_sync(_queue, ^{
+    if (_listenSource) {
+      return;
+    }
+    // port 0 lets the operating system assign a free ephemeral port
+    errorNumber = [self openListeningSocketOnPort:0];
+    _stoppedWhenIdle = NO;
+  });
+
+  if (errorNumber != 0) {
+    if (error) {
+      *error = OIDRedirectListenerError(errorNumber);
+    }
+    return NO;
+  }
+  return YES;
+}
+
+/*! @fn openListeningSocketOnPort:
+    @brief Binds to a port on 127.0.0.1 and begins accepting connections.
+    @param port The port, in network byte order.
+    @return 0 if the listener is listening, otherwise the @c errno of the call which failed.
+ */
+- (int)openListeningSocketOnPort:(in_port_t)port {
+  int listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+  if (listenSocket < 0) {
+    return errno;
+  }
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = port;
+  socklen_t addressLength = sizeof(address);
+  // connections closed before an idle stop may still hold the port in TIME_WAIT
+  int reuseAddress = 1;
+  if (setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(reuseAddress)) != 0
+      || bind(listenSocket, (struct sockaddr *)&address, sizeof(address)) != 0
+      || listen(listenSocket, SOMAXCONN) != 0
+      || getsockname(listenSocket, (struct sockaddr *)&address, &addressLength) != 0
+      || !OIDSetNonBlocking(listenSocket)) {
+    int errorNumber = errno;
+    close(listenSocket);
+    return errorNumber;
+  }
+
+  NSString *redirectURLString =
+      [NSString stringWithFormat:@"http://127.0.0.1:%u/", (unsigned int)ntohs(address.sin_port)];
+  _redirectURL = [NSURL URLWithString:redirectURLString];
+
+  dispatch_source_t source =
+      dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, listenSocket, 0, _queue);
+  __weak OIDLoopbackRedirectListener *weakSelf = self;
+  dispatch_source_set_event_handler(source, ^{
+    [weakSelf acceptConnectionsOnSocket:listenSocket];
+  });
+  dispatch_source_set_cancel_handler(source, ^{
+    close(listenSocket);
+  });
+  _listenSource = source;
+  dispatch_resume(source);
+  return 0;
+}
+
+- (void)stop {
+  dispatch_sync(_queue, ^{
+    _stoppedWhenIdle = NO;
+    [self closeListeningSocket];
+    [self closeAllConnections];
+    for (OIDLoopbackAuthorizationFlowSession *session in _sessionsByState.allValues) {
+      session.listener = nil;
+    }
+    [_sessionsByState removeAllObjects];
+  });
+}
+
+/*! @fn closeListeningSocket
+    @brief Stops accepting connections. Connections already accepted are unaffected.
+ */
+- (void)closeListeningSocket {
+  if (_listenSource) {
+    dispatch_source_cancel(_listenSource);
+    _listenSource = nil;
+  }
+}
+
+/*! @fn closeAllConnections
+    @brief Closes every accepted connection.
+ */
+- (void)closeAllConnections {
+  for (OIDLoopbackRedirectConnection *connection in _connections) {
+    dispatch_source_cancel(connection.readSource);
+  }
+  [_connections removeAllObjects];
+}
+
+#pragma mark - Flow sessions
+
+- (id<OIDAuthorizationFlowSession>)
+    authorizationFlowSessionWithRequest:(OIDAuthorizationRequest *)request
+                               callback:(OIDAuthorizationCallback)callback {
+  NSString *state = request.state;
+  if (!state) {
+    [NSException raise:NSInvalidArgumentException
+                format:@"Requests resumed by a loopback listener must have a state."];
+  }
+  OIDLoopbackAuthorizationFlowSession *session =
+      [[OIDLoopbackAuthorizationFlowSession alloc] initWithRequest:request];
+  session.listener = self;
+  [session startWithCallback:callback];
+  __block int errorNumber = 0;
+  dispatch_sync(_queue, ^{
+    // requests already carry the redirect URL, so the socket must come back on the same port
+    if (_stoppedWhenIdle && !_listenSource) {
+      errorNumber = [self openListeningSocketOnPort:htons(_redirectURL.port.unsignedShortValue)];
+      _stoppedWhenIdle = errorNumber != 0;
+    }
+    if (errorNumber == 0) {
+      _sessionsByState[state] = session;
+    }
+  });
+  if (errorNumber != 0) {
+    NSError *error = OIDRedirectListenerError(errorNumber);
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [session didFinishWithResponse:nil error:error];
+    });
+  }
+  return session;
+}
+
+- (void)flowSessionDidFinish:(OIDAuthorizationFlowSessionImplementation *)session {
+  NSString *state = session.request.state;
+  dispatch_async(_queue, ^{
+    if (_sessionsByState[state] == session) {
+      [_sessionsByState removeObjectForKey:state];
+    }
+    // connections still being answered are left to close on their own
+    if (_stopsWhenIdle && _sessionsByState.count == 0 && _listenSource) {
+      [self closeListeningSocket];
+      _stoppedWhenIdle = YES;
+    }
+  });
+}
+
+#pragma mark - Connections
+
+/*! @fn acceptConnectionsOnSocket:
+    @brief Accepts all pending connections on the listening socket.
+ */
+- (void)acceptConnectionsOnSocket:(int)listenSocket {
+  while (YES) {
+    int connectionSocket = accept(listenSocket, NULL, NULL);
+    if (connectionSocket < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // EAGAIN: no more pending connections
+      return;
+    }
+    if (!OIDSetNonBlocking(connectionSocket)) {
+      close(connectionSocket);
+      continue;
+    }
+#ifdef SO_NOSIGPIPE
+    int noSigPipe = 1;
+    setsockopt(connectionSocket, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+    [self openConnectionWithSocket:connectionSocket];
+  }
+}
+
+/*! @fn openConnectionWithSocket:
+    @brief Starts reading the request from an accepted connection.
+ */
+- (void)openConnectionWithSocket:(int)connectionSocket {
+  OIDLoopbackRedirectConnection *connection =
+      [[OIDLoopbackRedirectConnection alloc] initWithSocket:connectionSocket];
+  dispatch_source_t source =
+      dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, connectionSocket, 0, _queue);
+  __weak OIDLoopbackRedirectListener *weakSelf = self;
+  __weak OIDLoopbackRedirectConnection *weakConnection = connection;
+  dispatch_source_set_event_handler(source, ^{
+    [weakSelf readFromConnection:weakConnection];
+  });
+  dispatch_source_set_cancel_handler(source, ^{
+    close(connectionSocket);
+  });
+  connection.readSource = source;
+  [_connections addObject:connection];
+  dispatch_resume(source);
+
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, kConnectionTimeoutSeconds * NSEC_PER_SEC),
+                 _queue, ^{
+    [weakSelf closeConnection:weakConnection];
+  });
+}
+
+/*! @fn closeConnection:
+    @brief Closes a connection, if it is still open.
+ */
+- (void)closeConnection:(nullable OIDLoopbackRedirectConnection *)connection {
+  if (!connection || ![_connections containsObject:connection]) {
+    return;
+  }
+  dispatch_source_cancel(connection.readSource);
+  [_connections removeObject:connection];
+}
+
+/*! @fn readFromConnection:
+    @brief Reads available bytes, and handles the request once its request line is complete.
+ */
+- (void)readFromConnection:(nullable OIDLoopbackRedirectConnection *)connection {
+  if (!connection) {
+    return;
+  }
+  uint8_t bytes[kReadBufferBytes];
+  ssize_t count = read(connection.socket, bytes, sizeof(bytes));
+  if (count < 0 && (errno == EAGAIN || errno == EINTR)) {
+    return;
+  }
+  if (count <= 0) {
+    [self closeConnection:connection];
+    return;
+  }
+  if (connection.responded) {
+    return;
+  }
+
+  NSMutableData *buffer = connection.buffer;
+  NSUInteger searchStart = buffer.length > 0 ? buffer.length - 1 : 0;
+  [buffer appendBytes:bytes length:(NSUInteger)count];
+  NSRange lineEnd = [buffer rangeOfData:[NSData dataWithBytes:"\r\n" length:2]
+                                options:0
+                                  range:NSMakeRange(searchStart, buffer.length - searchStart)];
+  if (lineEnd.location == NSNotFound) {
+    if (buffer.length > kMaxRequestLineBytes) {
+      [self closeConnection:connection];
+    }
+    return;
+  }
+
+  // only the request line is needed, so the response is sent without waiting for the headers
+  NSString *requestLine = [[NSString alloc] initWithBytes:buffer.bytes
+                                                   length:lineEnd.location
+                                                 encoding:NSUTF8StringEncoding];
+  [self handleRequestLine:requestLine onConnection:connection];
+}
+
+/*! @fn handleRequestLine:onConnection:
+    @brief Responds to a request, and resumes the flow session it belongs to, if any.
+    @param requestLine The HTTP request line, e.g. "GET /?code=...&state=... HTTP/1.1".
+ */
+- (void)handleRequestLine:(nullable NSString *)requestLine
+             onConnection:(OIDLoopbackRedirectConnection *)connection {
+  NSArray<NSString *> *parts = [requestLine componentsSeparatedByString:@" "];
+  NSURL *URL;
+  OIDLoopbackAuthorizationFlowSession *session;
+  if (parts.count == 3 && [parts[0] isEqualToString:@"GET"] && [parts[1] hasPrefix:@"/"]) {
+    URL = [NSURL URLWithString:parts[1] relativeToURL:_redirectURL].absoluteURL;
+    OIDURLQueryComponent *query = URL ? [[OIDURLQueryComponent alloc] initWithURL:URL] : nil;
+    NSString *state = [query valuesForParameter:kStateParameter].firstObject;
+    session = state ? _sessionsByState[state] : nil;
+  }
+
+  if (!session) {
+    [self respondToConnection:connection status:@"404 Not Found" HTML:kNotFoundResponseHTML];
+    return;
+  }
+  [self respondToConnection:connection status:@"200 OK" HTML:_responseHTML];
+  dispatch_async(dispatch_get_main_queue(), ^{
+    // the browser may repeat the redirect, which must not reach a completed session
+    if (!session.finished) {
+      [session resumeAuthorizationFlowWithURL:URL];
+    }
+  });
+}
+
+/*! @fn respondToConnection:status:HTML:
+    @brief Sends a complete response and shuts down the sending side of the connection.
+ */
+- (void)respondToConnection:(OIDLoopbackRedirectConnection *)connection
+                     status:(NSString *)status
+                       HTML:(NSString *)HTML {
+  NSData *body = [HTML dataUsingEncoding:NSUTF8StringEncoding];
+  NSString *header =
+      [NSString stringWithFormat:@"HTTP/1.1 %@\r\n"
+                                  "Content-Type: text/html; charset=utf-8\r\n"
+                                  "Content-Length: %lu\r\n"
+                                  "Cache-Control: no-store\r\n"
+                                  "Connection: close\r\n\r\n",
+                                 status,
+                                 (unsigned long)body.length];
+  NSMutableData *response = [[header dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+  [response appendData:body];
+
+  // the response is far smaller than a socket send buffer, so it's written without waiting
+  const uint8_t *bytes = response.bytes;
+  size_t remaining = response.length;
+  while (remaining > 0) {
+    ssize_t written = send(connection.socket, bytes, remaining, kSendFlags);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    bytes += written;
+    remaining -= (size_t)written;
+  }
+  shutdown(connection.socket, SHUT_WR);
+  connection.responded = YES;
+  connection.buffer.length = 0;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,40 @@
+/*! @file OIDNetworkReachabilityMonitor.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "OIDConnectivityMonitor.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDNetworkReachabilityMonitor
+    @brief An @c OIDConnectivityMonitor which uses @c SCNetworkReachability to track whether the
+        internet is reachable.
+    @discussion Reachability is only monitored while there are blocks waiting for it. On platforms
+        without SystemConfiguration, such as GNUstep, the network is always considered reachable.
+ */
+@interface OIDNetworkReachabilityMonitor : NSObject <OIDConnectivityMonitor>
+
+/*! @fn sharedMonitor
+    @brief A monitor which can be shared by any number of @c OIDAuthState instances.
+ */
++ (OIDNetworkReachabilityMonitor *)sharedMonitor;
+
+@end
+
+NS_ASSUME_NONNULL_END
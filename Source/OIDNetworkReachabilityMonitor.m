@@ -0,0 +1,177 @@
+/*! @file OIDNetworkReachabilityMonitor.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDNetworkReachabilityMonitor.h"
+
+#if __has_include(<SystemConfiguration/SystemConfiguration.h>)
+#import <SystemConfiguration/SystemConfiguration.h>
+#import <netinet/in.h>
+#define OID_HAS_SYSTEM_CONFIGURATION 1
+#endif
+
+@interface OIDNetworkReachabilityMonitor ()
+
+/*! @fn reachabilityDidChange
+    @brief Performs the waiting blocks if the network has become reachable.
+    @discussion Called on the main thread.
+ */
+- (void)reachabilityDidChange;
+
+@end
+
+#if OID_HAS_SYSTEM_CONFIGURATION
+
+/*! @fn OIDIsReachableWithFlags
+    @brief Whether the flags indicate that a connection can be made without user intervention.
+ */
+static BOOL OIDIsReachableWithFlags(SCNetworkReachabilityFlags flags) {
+  if (!(flags & kSCNetworkReachabilityFlagsReachable)) {
+    return NO;
+  }
+  if (!(flags & kSCNetworkReachabilityFlagsConnectionRequired)) {
+    return YES;
+  }
+  // connections are established automatically, unless the user has to do something first
+  return (flags & (kSCNetworkReachabilityFlagsConnectionOnDemand
+                   | kSCNetworkReachabilityFlagsConnectionOnTraffic))
+      && !(flags & kSCNetworkReachabilityFlagsInterventionRequired);
+}
+
+/*! @fn OIDReachabilityCallback
+    @brief Called by SystemConfiguration on the main queue when reachability changes.
+ */
+static void OIDReachabilityCallback(SCNetworkReachabilityRef target,
+                                    SCNetworkReachabilityFlags flags,
+                                    void *info) {
+  [(__bridge OIDNetworkReachabilityMonitor *)info reachabilityDidChange];
+}
+
+#endif
+
+@implementation OIDNetworkReachabilityMonitor {
+#if OID_HAS_SYSTEM_CONFIGURATION
+  /*! @var _reachability
+      @brief Tracks reachability of the zero address, which stands for the internet in general.
+   */
+  SCNetworkReachabilityRef _reachability;
+#endif
+
+  /*! @var _waitingBlocks
+      @brief Blocks to perform when the network becomes reachable. Only accessed on the main
+          thread.
+   */
+  NSMutableArray<dispatch_block_t> *_waitingBlocks;
+}
+
++ (OIDNetworkReachabilityMonitor *)sharedMonitor {
+  static OIDNetworkReachabilityMonitor *sharedMonitor;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    sharedMonitor = [[OIDNetworkReachabilityMonitor alloc] init];
+  });
+  return sharedMonitor;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _waitingBlocks = [NSMutableArray array];
+#if OID_HAS_SYSTEM_CONFIGURATION
+    struct sockaddr_in zeroAddress;
+    memset(&zeroAddress, 0, sizeof(zeroAddress));
+    zeroAddress.sin_len = sizeof(zeroAddress);
+    zeroAddress.sin_family = AF_INET;
+    _reachability = SCNetworkReachabilityCreateWithAddress(kCFAllocatorDefault,
+                                                           (struct sockaddr *)&zeroAddress);
+#endif
+  }
+  return self;
+}
+
+- (void)dealloc {
+#if OID_HAS_SYSTEM_CONFIGURATION
+  if (_reachability) {
+    [self stopMonitoring];
+    CFRelease(_reachability);
+  }
+#endif
+}
+
+#pragma mark - OIDConnectivityMonitor
+
+- (BOOL)isReachable {
+#if OID_HAS_SYSTEM_CONFIGURATION
+  SCNetworkReachabilityFlags flags;
+  if (!_reachability || !SCNetworkReachabilityGetFlags(_reachability, &flags)) {
+    // if reachability can't be determined, requests are allowed to try
+    return YES;
+  }
+  return OIDIsReachableWithFlags(flags);
+#else
+  return YES;
+#endif
+}
+
+- (void)performWhenReachable:(dispatch_block_t)block {
+  dispatch_block_t blockCopy = [block copy];
+  dispatch_async(dispatch_get_main_queue(), ^() {
+    if (self.reachable) {
+      blockCopy();
+      return;
+    }
+    [self->_waitingBlocks addObject:blockCopy];
+    [self startMonitoring];
+  });
+}
+
+#pragma mark - Monitoring
+
+/*! @fn startMonitoring
+    @brief Starts receiving reachability callbacks on the main queue.
+ */
+- (void)startMonitoring {
+#if OID_HAS_SYSTEM_CONFIGURATION
+  SCNetworkReachabilityContext context = { 0, (__bridge void *)self, NULL, NULL, NULL };
+  SCNetworkReachabilitySetCallback(_reachability, OIDReachabilityCallback, &context);
+  SCNetworkReachabilitySetDispatchQueue(_reachability, dispatch_get_main_queue());
+#endif
+}
+
+/*! @fn stopMonitoring
+    @brief Stops receiving reachability callbacks.
+ */
+- (void)stopMonitoring {
+#if OID_HAS_SYSTEM_CONFIGURATION
+  SCNetworkReachabilitySetDispatchQueue(_reachability, NULL);
+  SCNetworkReachabilitySetCallback(_reachability, NULL, NULL);
+#endif
+}
+
+- (void)reachabilityDidChange {
+  if (!self.reachable || !_waitingBlocks.count) {
+    return;
+  }
+  NSArray<dispatch_block_t> *blocks = [_waitingBlocks copy];
+  [_waitingBlocks removeAllObjects];
+  [self stopMonitoring];
+  for (dispatch_block_t block in blocks) {
+    block();
+  }
+}
+
+@end
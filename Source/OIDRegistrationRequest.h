@@ -0,0 +1,112 @@
+/*! @file OIDRegistrationRequest.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OIDServiceConfiguration;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDRegistrationRequest
+    @brief Represents a dynamic client registration request.
+    @see https://tools.ietf.org/html/rfc7591#section-3.1
+ */
+@interface OIDRegistrationRequest : NSObject <NSCopying, NSSecureCoding>
+
+/*! @property configuration
+    @brief The service's configuration.
+    @remarks This configuration specifies how to connect to a particular OAuth provider. Its
+        @c registrationEndpoint must be set.
+ */
+@property(nonatomic, readonly) OIDServiceConfiguration *configuration;
+
+/*! @property redirectURIs
+    @brief The client's redirect URIs.
+    @remarks redirect_uris
+    @see https://tools.ietf.org/html/rfc7591#section-2
+ */
+@property(nonatomic, readonly) NSArray<NSURL *> *redirectURIs;
+
+/*! @property responseTypes
+    @brief The response types the client will use.
+    @remarks response_types
+    @see https://tools.ietf.org/html/rfc7591#section-2
+ */
+@property(nonatomic, readonly, nullable) NSArray<NSString *> *responseTypes;
+
+/*! @property grantTypes
+    @brief The grant types the client will use.
+    @remarks grant_types
+    @see https://tools.ietf.org/html/rfc7591#section-2
+ */
+@property(nonatomic, readonly, nullable) NSArray<NSString *> *grantTypes;
+
+/*! @property subjectType
+    @brief The subject type requested for responses to this client.
+    @remarks subject_type
+    @see https://openid.net/specs/openid-connect-registration-1_0.html#ClientMetadata
+ */
+@property(nonatomic, readonly, nullable) NSString *subjectType;
+
+/*! @property tokenEndpointAuthenticationMethod
+    @brief The client authentication method to use at the token endpoint.
+    @remarks token_endpoint_auth_method
+    @see https://tools.ietf.org/html/rfc7591#section-2
+ */
+@property(nonatomic, readonly, nullable) NSString *tokenEndpointAuthenticationMethod;
+
+/*! @property additionalParameters
+    @brief The client's additional registration request parameters.
+ */
+@property(nonatomic, readonly, nullable) NSDictionary<NSString *, NSString *> *additionalParameters;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use the designated initializer.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn initWithConfiguration:redirectURIs:responseTypes:grantTypes:subjectType:tokenEndpointAuthMethod:additionalParameters:
+    @brief Designated initializer.
+    @param configuration The service's configuration.
+    @param redirectURIs The client's redirect URIs.
+    @param responseTypes The response types the client will use.
+    @param grantTypes The grant types the client will use.
+    @param subjectType The subject type requested for responses to this client.
+    @param tokenEndpointAuthMethod The client authentication method to use at the token endpoint.
+    @param additionalParameters The client's additional registration request parameters.
+ */
+- (nullable instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
+               redirectURIs:(NSArray<NSURL *> *)redirectURIs
+              responseTypes:(nullable NSArray<NSString *> *)responseTypes
+                 grantTypes:(nullable NSArray<NSString *> *)grantTypes
+                subjectType:(nullable NSString *)subjectType
+    tokenEndpointAuthMethod:(nullable NSString *)tokenEndpointAuthMethod
+       additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters
+    NS_DESIGNATED_INITIALIZER;
+
+/*! @fn URLRequest
+    @brief Constructs an @c NSURLRequest representing the registration request.
+    @return An @c NSURLRequest representing the registration request, which POSTs the client
+        metadata as JSON.
+ */
+- (NSURLRequest *)URLRequest;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,220 @@
+/*! @file OIDRegistrationRequest.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDRegistrationRequest.h"
+
+#import "OIDDefines.h"
+#import "OIDLogging.h"
+#import "OIDServiceConfiguration.h"
+
+/*! @var kConfigurationKey
+    @brief The key for the @c configuration property for @c NSSecureCoding
+ */
+static NSString *const kConfigurationKey = @"configuration";
+
+/*! @var kRedirectURIsKey
+    @brief The key for the @c redirectURIs property for @c NSSecureCoding and the request body.
+ */
+static NSString *const kRedirectURIsKey = @"redirect_uris";
+
+/*! @var kResponseTypesKey
+    @brief The key for the @c responseTypes property for @c NSSecureCoding and the request body.
+ */
+static NSString *const kResponseTypesKey = @"response_types";
+
+/*! @var kGrantTypesKey
+    @brief The key for the @c grantTypes property for @c NSSecureCoding and the request body.
+ */
+static NSString *const kGrantTypesKey = @"grant_types";
+
+/*! @var kSubjectTypeKey
+    @brief The key for the @c subjectType property for @c NSSecureCoding and the request body.
+ */
+static NSString *const kSubjectTypeKey = @"subject_type";
+
+/*! @var kTokenEndpointAuthenticationMethodKey
+    @brief The key for the @c tokenEndpointAuthenticationMethod property for @c NSSecureCoding and
+        the request body.
+ */
+static NSString *const kTokenEndpointAuthenticationMethodKey = @"token_endpoint_auth_method";
+
+/*! @var kAdditionalParametersKey
+    @brief Key used to encode the @c additionalParameters property for @c NSSecureCoding
+ */
+static NSString *const kAdditionalParametersKey = @"additionalParameters";
+
+@implementation OIDRegistrationRequest
+
+- (instancetype)init
+    OID_UNAVAILABLE_USE_INITIALIZER(
+        @selector(initWithConfiguration:
+                           redirectURIs:
+                          responseTypes:
+                             grantTypes:
+                            subjectType:
+                tokenEndpointAuthMethod:
+                   additionalParameters:)
+    );
+
+- (nullable instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
+               redirectURIs:(NSArray<NSURL *> *)redirectURIs
+              responseTypes:(nullable NSArray<NSString *> *)responseTypes
+                 grantTypes:(nullable NSArray<NSString *> *)grantTypes
+                subjectType:(nullable NSString *)subjectType
+    tokenEndpointAuthMethod:(nullable NSString *)tokenEndpointAuthMethod
+       additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters {
+  self = [super init];
+  if (self) {
+    _configuration = [configuration copy];
+    _redirectURIs = [redirectURIs copy];
+    _responseTypes = [responseTypes copy];
+    _grantTypes = [grantTypes copy];
+    _subjectType = [subjectType copy];
+    _tokenEndpointAuthenticationMethod = [tokenEndpointAuthMethod copy];
+    _additionalParameters =
+        [[NSDictionary alloc] initWithDictionary:additionalParameters copyItems:YES];
+  }
+  return self;
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(nullable NSZone *)zone {
+  // The documentation for NSCopying specifically advises us to return a reference to the original
+  // instance in the case where instances are immutable (as ours is):
+  // "Implement NSCopying by retaining the original instead of creating a new copy when the class
+  // and its contents are immutable."
+  return self;
+}
+
+#pragma mark - NSSecureCoding
+
++ (BOOL)supportsSecureCoding {
+  return YES;
+}
+
+- (instancetype)initWithCoder:(NSCoder *)aDecoder {
+  OIDServiceConfiguration *configuration =
+      [aDecoder decodeObjectOfClass:[OIDServiceConfiguration class]
+                             forKey:kConfigurationKey];
+  NSSet *URLArrayCodingClasses = [NSSet setWithArray:@[ [NSArray class], [NSURL class] ]];
+  NSArray *redirectURIs = [aDecoder decodeObjectOfClasses:URLArrayCodingClasses
+                                                   forKey:kRedirectURIsKey];
+  NSSet *stringArrayCodingClasses = [NSSet setWithArray:@[ [NSArray class], [NSString class] ]];
+  NSArray *responseTypes = [aDecoder decodeObjectOfClasses:stringArrayCodingClasses
+                                                    forKey:kResponseTypesKey];
+  NSArray *grantTypes = [aDecoder decodeObjectOfClasses:stringArrayCodingClasses
+                                                 forKey:kGrantTypesKey];
+  NSString *subjectType = [aDecoder decodeObjectOfClass:[NSString class] forKey:kSubjectTypeKey];
+  NSString *tokenEndpointAuthenticationMethod =
+      [aDecoder decodeObjectOfClass:[NSString class] forKey:kTokenEndpointAuthenticationMethodKey];
+  NSSet *additionalParameterCodingClasses = [NSSet setWithArray:@[
+    [NSDictionary class],
+    [NSString class]
+  ]];
+  NSDictionary *additionalParameters =
+      [aDecoder decodeObjectOfClasses:additionalParameterCodingClasses
+                               forKey:kAdditionalParametersKey];
+  self = [self initWithConfiguration:configuration
+                        redirectURIs:redirectURIs
+                       responseTypes:responseTypes
+                          grantTypes:grantTypes
+                         subjectType:subjectType
+             tokenEndpointAuthMethod:tokenEndpointAuthenticationMethod
+                additionalParameters:additionalParameters];
+  return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)aCoder {
+  [aCoder encodeObject:_configuration forKey:kConfigurationKey];
+  [aCoder encodeObject:_redirectURIs forKey:kRedirectURIsKey];
+  [aCoder encodeObject:_responseTypes forKey:kResponseTypesKey];
+  [aCoder encodeObject:_grantTypes forKey:kGrantTypesKey];
+  [aCoder encodeObject:_subjectType forKey:kSubjectTypeKey];
+  [aCoder encodeObject:_tokenEndpointAuthenticationMethod
+                forKey:kTokenEndpointAuthenticationMethodKey];
+  [aCoder encodeObject:_additionalParameters forKey:kAdditionalParametersKey];
+}
+
+#pragma mark - NSObject overrides
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, URL: %@, redirectURIs: %@, responseTypes: %@, "
+                                     "grantTypes: %@, subjectType: %@, "
+                                     "tokenEndpointAuthenticationMethod: %@, "
+                                     "additionalParameters: %@>",
+                                    NSStringFromClass([self class]),
+                                    self,
+                                    _configuration.registrationEndpoint,
+                                    _redirectURIs,
+                                    _responseTypes,
+                                    _grantTypes,
+                                    _subjectType,
+                                    _tokenEndpointAuthenticationMethod,
+                                    OIDLogRedactParameters(_additionalParameters)];
+}
+
+#pragma mark -
+
+/*! @fn registrationRequestBody
+    @brief Constructs the request body data by serializing the client metadata as a JSON object.
+    @return The data to POST to the registration endpoint.
+    @see https://tools.ietf.org/html/rfc7591#section-3.1
+ */
+- (NSData *)registrationRequestBody {
+  NSMutableDictionary<NSString *, id> *metadata =
+      [NSMutableDictionary dictionaryWithDictionary:_additionalParameters ?: @{ }];
+
+  NSMutableArray<NSString *> *redirectURIStrings =
+      [NSMutableArray arrayWithCapacity:_redirectURIs.count];
+  for (NSURL *redirectURI in _redirectURIs) {
+    [redirectURIStrings addObject:redirectURI.absoluteString];
+  }
+  metadata[kRedirectURIsKey] = redirectURIStrings;
+  if (_responseTypes) {
+    metadata[kResponseTypesKey] = _responseTypes;
+  }
+  if (_grantTypes) {
+    metadata[kGrantTypesKey] = _grantTypes;
+  }
+  if (_subjectType) {
+    metadata[kSubjectTypeKey] = _subjectType;
+  }
+  if (_tokenEndpointAuthenticationMethod) {
+    metadata[kTokenEndpointAuthenticationMethodKey] = _tokenEndpointAuthenticationMethod;
+  }
+
+  return [NSJSONSerialization dataWithJSONObject:metadata options:0 error:NULL];
+}
+
+- (NSURLRequest *)URLRequest {
+  static NSString *const kHTTPPost = @"POST";
+  static NSString *const kHTTPContentTypeHeaderKey = @"Content-Type";
+  static NSString *const kHTTPAcceptHeaderKey = @"Accept";
+  static NSString *const kJSONContentType = @"application/json";
+
+  NSMutableURLRequest *URLRequest =
+      [[NSURLRequest requestWithURL:_configuration.registrationEndpoint] mutableCopy];
+  URLRequest.HTTPMethod = kHTTPPost;
+  [URLRequest setValue:kJSONContentType forHTTPHeaderField:kHTTPContentTypeHeaderKey];
+  [URLRequest setValue:kJSONContentType forHTTPHeaderField:kHTTPAcceptHeaderKey];
+  URLRequest.HTTPBody = [self registrationRequestBody];
+  return URLRequest;
+}
+
+@end
@@ -0,0 +1,120 @@
+/*! @file OIDRegistrationResponse.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OIDRegistrationRequest;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDRegistrationResponse
+    @brief Represents a successful response to a dynamic client registration request.
+    @see https://tools.ietf.org/html/rfc7591#section-3.2.1
+ */
+@interface OIDRegistrationResponse : NSObject <NSCopying, NSSecureCoding>
+
+/*! @property request
+    @brief The request which was serviced.
+ */
+@property(nonatomic, readonly) OIDRegistrationRequest *request;
+
+/*! @property clientID
+    @brief The client identifier issued by the authorization server.
+    @remarks client_id
+    @see https://tools.ietf.org/html/rfc7591#section-3.2.1
+ */
+@property(nonatomic, readonly) NSString *clientID;
+
+/*! @property clientIDIssuedAt
+    @brief When the client identifier was issued, if the server provided it.
+    @remarks client_id_issued_at
+    @see https://tools.ietf.org/html/rfc7591#section-3.2.1
+ */
+@property(nonatomic, readonly, nullable) NSDate *clientIDIssuedAt;
+
+/*! @property clientSecret
+    @brief The client secret, if one was issued.
+    @remarks client_secret
+    @see https://tools.ietf.org/html/rfc7591#section-3.2.1
+ */
+@property(nonatomic, readonly, nullable) NSString *clientSecret;
+
+/*! @property clientSecretExpiresAt
+    @brief When the client secret expires, or nil if no secret was issued or it doesn't expire.
+    @remarks client_secret_expires_at
+    @see https://tools.ietf.org/html/rfc7591#section-3.2.1
+ */
+@property(nonatomic, readonly, nullable) NSDate *clientSecretExpiresAt;
+
+/*! @property registrationAccessToken
+    @brief The access token for reading and updating the registration, if one was issued.
+    @remarks registration_access_token
+    @see https://tools.ietf.org/html/rfc7592#section-3
+ */
+@property(nonatomic, readonly, nullable) NSString *registrationAccessToken;
+
+/*! @property registrationClientURI
+    @brief The client configuration endpoint for the registration, if one was issued.
+    @remarks registration_client_uri
+    @see https://tools.ietf.org/html/rfc7592#section-3
+ */
+@property(nonatomic, readonly, nullable) NSURL *registrationClientURI;
+
+/*! @property tokenEndpointAuthenticationMethod
+    @brief The client authentication method the server registered for the token endpoint.
+    @remarks token_endpoint_auth_method
+    @see https://tools.ietf.org/html/rfc7591#section-2
+ */
+@property(nonatomic, readonly, nullable) NSString *tokenEndpointAuthenticationMethod;
+
+/*! @property additionalParameters
+    @brief Additional parameters returned from the registration endpoint, such as the registered
+        client metadata.
+ */
+@property(nonatomic, readonly, nullable)
+    NSDictionary<NSString *, NSObject<NSCopying> *> *additionalParameters;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use initWithRequest:parameters:.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn initWithRequest:parameters:
+    @brief Designated initializer.
+    @param request The serviced request.
+    @param parameters The decoded parameters returned from the registration endpoint.
+    @return The response, or nil if the parameters don't include a client identifier.
+    @remarks Known parameters are extracted from the @c parameters parameter and the normative
+        properties are populated. Non-normative parameters are placed in the @c additionalParameters
+        dictionary.
+ */
+- (nullable instancetype)initWithRequest:(OIDRegistrationRequest *)request
+    parameters:(NSDictionary<NSString *, NSObject<NSCopying> *> *)parameters
+    NS_DESIGNATED_INITIALIZER;
+
+/*! @fn isClientSecretExpiredWithTolerance:
+    @brief Returns whether the client secret has expired, or will within @c tolerance seconds.
+    @param tolerance The number of seconds before the expiry date to consider the secret expired.
+    @return NO if no secret was issued, or if it doesn't expire.
+ */
+- (BOOL)isClientSecretExpiredWithTolerance:(NSTimeInterval)tolerance;
+
+@end
+
+NS_ASSUME_NONNULL_END
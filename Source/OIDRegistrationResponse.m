@@ -0,0 +1,226 @@
+/*! @file OIDRegistrationResponse.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDRegistrationResponse.h"
+
+#import "OIDDefines.h"
+#import "OIDFieldMapping.h"
+#import "OIDLogging.h"
+#import "OIDRegistrationRequest.h"
+
+/*! @var kRequestKey
+    @brief Key used to encode the @c request property for @c NSSecureCoding
+ */
+static NSString *const kRequestKey = @"request";
+
+/*! @var kClientIDKey
+    @brief The key for the @c clientID property in the incoming parameters and for
+        @c NSSecureCoding.
+ */
+static NSString *const kClientIDKey = @"client_id";
+
+/*! @var kClientIDIssuedAtKey
+    @brief The key for the @c clientIDIssuedAt property in the incoming parameters and for
+        @c NSSecureCoding.
+ */
+static NSString *const kClientIDIssuedAtKey = @"client_id_issued_at";
+
+/*! @var kClientSecretKey
+    @brief The key for the @c clientSecret property in the incoming parameters and for
+        @c NSSecureCoding.
+ */
+static NSString *const kClientSecretKey = @"client_secret";
+
+/*! @var kClientSecretExpiresAtKey
+    @brief The key for the @c clientSecretExpiresAt property in the incoming parameters and for
+        @c NSSecureCoding.
+ */
+static NSString *const kClientSecretExpiresAtKey = @"client_secret_expires_at";
+
+/*! @var kRegistrationAccessTokenKey
+    @brief The key for the @c registrationAccessToken property in the incoming parameters and for
+        @c NSSecureCoding.
+ */
+static NSString *const kRegistrationAccessTokenKey = @"registration_access_token";
+
+/*! @var kRegistrationClientURIKey
+    @brief The key for the @c registrationClientURI property in the incoming parameters and for
+        @c NSSecureCoding.
+ */
+static NSString *const kRegistrationClientURIKey = @"registration_client_uri";
+
+/*! @var kTokenEndpointAuthenticationMethodKey
+    @brief The key for the @c tokenEndpointAuthenticationMethod property in the incoming parameters
+        and for @c NSSecureCoding.
+ */
+static NSString *const kTokenEndpointAuthenticationMethodKey = @"token_endpoint_auth_method";
+
+/*! @var kAdditionalParametersKey
+    @brief Key used to encode the @c additionalParameters property for @c NSSecureCoding
+ */
+static NSString *const kAdditionalParametersKey = @"additionalParameters";
+
+@implementation OIDRegistrationResponse {
+  /*! @var _clientSecretExpiresAtTimestamp
+      @brief The client_secret_expires_at parameter, in seconds since 1970. 0 means the secret
+          doesn't expire, which has no natural @c NSDate representation.
+   */
+  NSNumber *_clientSecretExpiresAtTimestamp;
+}
+
+/*! @fn fieldMap
+    @brief Returns a mapping of incoming parameters to instance variables.
+    @return A mapping of incoming parameters to instance variables.
+ */
++ (NSDictionary<NSString *, OIDFieldMapping *> *)fieldMap {
+  static NSMutableDictionary<NSString *, OIDFieldMapping *> *fieldMap;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    fieldMap = [NSMutableDictionary dictionary];
+    fieldMap[kClientIDKey] =
+        [[OIDFieldMapping alloc] initWithName:@"_clientID" type:[NSString class]];
+    fieldMap[kClientIDIssuedAtKey] =
+        [[OIDFieldMapping alloc] initWithName:@"_clientIDIssuedAt"
+                                         type:[NSDate class]
+                                   conversion:^id _Nullable(NSObject *_Nullable value) {
+          if (![value isKindOfClass:[NSNumber class]]) {
+            return value;
+          }
+          NSNumber *valueAsNumber = (NSNumber *)value;
+          return [NSDate dateWithTimeIntervalSince1970:[valueAsNumber longLongValue]];
+        }];
+    fieldMap[kClientSecretKey] =
+        [[OIDFieldMapping alloc] initWithName:@"_clientSecret" type:[NSString class]];
+    fieldMap[kClientSecretExpiresAtKey] =
+        [[OIDFieldMapping alloc] initWithName:@"_clientSecretExpiresAtTimestamp"
+                                         type:[NSNumber class]];
+    fieldMap[kRegistrationAccessTokenKey] =
+        [[OIDFieldMapping alloc] initWithName:@"_registrationAccessToken" type:[NSString class]];
+    fieldMap[kRegistrationClientURIKey] =
+        [[OIDFieldMapping alloc] initWithName:@"_registrationClientURI"
+                                         type:[NSURL class]
+                                   conversion:[OIDFieldMapping URLConversion]];
+    fieldMap[kTokenEndpointAuthenticationMethodKey] =
+        [[OIDFieldMapping alloc] initWithName:@"_tokenEndpointAuthenticationMethod"
+                                         type:[NSString class]];
+  });
+  return fieldMap;
+}
+
+#pragma mark - Initializers
+
+- (nullable instancetype)init
+    OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithRequest:parameters:));
+
+- (nullable instancetype)initWithRequest:(OIDRegistrationRequest *)request
+    parameters:(NSDictionary<NSString *, NSObject<NSCopying> *> *)parameters {
+  self = [super init];
+  if (self) {
+    _request = [request copy];
+    NSDictionary<NSString *, NSObject<NSCopying> *> *additionalParameters =
+        [OIDFieldMapping remainingParametersWithMap:[[self class] fieldMap]
+                                         parameters:parameters
+                                           instance:self];
+    _additionalParameters = additionalParameters;
+
+    // a registration without a client identifier can't be used
+    if (!_clientID) {
+      return nil;
+    }
+  }
+  return self;
+}
+
+#pragma mark - Client secret expiry
+
+- (nullable NSDate *)clientSecretExpiresAt {
+  long long timestamp = _clientSecretExpiresAtTimestamp.longLongValue;
+  if (!_clientSecret || timestamp == 0) {
+    return nil;
+  }
+  return [NSDate dateWithTimeIntervalSince1970:timestamp];
+}
+
+- (BOOL)isClientSecretExpiredWithTolerance:(NSTimeInterval)tolerance {
+  NSDate *expiresAt = self.clientSecretExpiresAt;
+  return expiresAt && [expiresAt timeIntervalSinceNow] <= tolerance;
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(nullable NSZone *)zone {
+  // The documentation for NSCopying specifically advises us to return a reference to the original
+  // instance in the case where instances are immutable (as ours is):
+  // "Implement NSCopying by retaining the original instead of creating a new copy when the class
+  // and its contents are immutable."
+  return self;
+}
+
+#pragma mark - NSSecureCoding
+
++ (BOOL)supportsSecureCoding {
+  return YES;
+}
+
+- (nullable instancetype)initWithCoder:(NSCoder *)aDecoder {
+  OIDRegistrationRequest *request =
+      [aDecoder decodeObjectOfClass:[OIDRegistrationRequest class] forKey:kRequestKey];
+  NSString *clientID = [aDecoder decodeObjectOfClass:[NSString class] forKey:kClientIDKey];
+  if (!clientID) {
+    return nil;
+  }
+  self = [self initWithRequest:request parameters:@{ kClientIDKey : clientID }];
+  if (self) {
+    [OIDFieldMapping decodeWithCoder:aDecoder map:[[self class] fieldMap] instance:self];
+    _additionalParameters = [aDecoder decodeObjectOfClasses:[OIDFieldMapping JSONTypes]
+                                                     forKey:kAdditionalParametersKey];
+  }
+  return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)aCoder {
+  [OIDFieldMapping encodeWithCoder:aCoder map:[[self class] fieldMap] instance:self];
+  [aCoder encodeObject:_request forKey:kRequestKey];
+  [aCoder encodeObject:_additionalParameters forKey:kAdditionalParametersKey];
+}
+
+#pragma mark - NSObject overrides
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, clientID: \"%@\", clientIDIssuedAt: %@, "
+                                     "clientSecret: \"%@\", clientSecretExpiresAt: %@, "
+                                     "registrationAccessToken: \"%@\", "
+                                     "registrationClientURI: %@, "
+                                     "tokenEndpointAuthenticationMethod: %@, "
+                                     "additionalParameters: %@, request: %@>",
+                                    NSStringFromClass([self class]),
+                                    self,
+                                    _clientID,
+                                    _clientIDIssuedAt,
+                                    OIDLogRedact(_clientSecret),
+                                    self.clientSecretExpiresAt,
+                                    OIDLogRedact(_registrationAccessToken),
+                                    _registrationClientURI,
+                                    _tokenEndpointAuthenticationMethod,
+                                    OIDLogRedactParameters(_additionalParameters),
+                                    _request];
+}
+
+#pragma mark -
+
+@end
@@ -0,0 +1,101 @@
+/*! @file OIDRegistrationStore.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "OIDAuthorizationService.h"
+
+@class OIDRegistrationRequest;
+@class OIDRegistrationResponse;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDRegistrationStore
+    @brief A file-backed cache of a dynamic client registration, so an app registers once per
+        install rather than on every launch.
+    @discussion @c registrationResponseForRequest:completion: returns the stored registration if
+        it was made at the same registration endpoint with the same redirect URIs, and its client
+        secret hasn't expired. Otherwise it registers, and stores the result.
+
+        Registrations are collapsed: calls made while a registration for an equivalent request
+        is in progress wait for it and share its result, rather than each registering. Calls for
+        other requests wait for it to complete, then check its result before registering.
+
+        Across processes using a store for the same file, such as an app and its extensions,
+        registration is serialized by an advisory @c flock(2) on a sibling ".lock" file, and a
+        process which waited for the lock re-reads the store before registering.
+ */
+@interface OIDRegistrationStore : NSObject
+
+/*! @property fileURL
+    @brief The location of the archived @c OIDRegistrationResponse.
+ */
+@property(nonatomic, readonly) NSURL *fileURL;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use @c initWithFileURL:.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn initWithFileURL:
+    @brief Designated initializer.
+    @param fileURL The file URL of the archived @c OIDRegistrationResponse. The registration lock
+        is created next to it, with a ".lock" suffix.
+ */
+- (nullable instancetype)initWithFileURL:(NSURL *)fileURL NS_DESIGNATED_INITIALIZER;
+
+/*! @fn registrationResponseForRequest:completion:
+    @brief Calls @c completion with the stored registration if it can be used for @c request,
+        otherwise performs the request and stores the response.
+    @param request The registration request to perform if there is no usable stored registration.
+    @param completion Called on the main queue with the registration, or the registration error.
+    @discussion Calls made while another with the same registration endpoint and redirect URIs
+        is in progress share its result.
+ */
+- (void)registrationResponseForRequest:(OIDRegistrationRequest *)request
+                            completion:(OIDRegistrationCallback)completion;
+
+/*! @fn readRegistrationResponse
+    @brief Reads the stored registration.
+    @return The stored registration, or nil if nothing was stored or the archive could not be
+        read.
+ */
+- (nullable OIDRegistrationResponse *)readRegistrationResponse;
+
+/*! @fn removeRegistrationWithError:
+    @brief Deletes the stored registration, so the next call to
+        @c registrationResponseForRequest:completion: registers again.
+    @param error If the registration could not be removed, the underlying file system error.
+    @return YES if the registration was removed, or nothing was stored.
+ */
+- (BOOL)removeRegistrationWithError:(NSError **_Nullable)error;
+
+/*! @fn performRegistrationRequest:completion:
+    @brief Performs a registration request when no usable registration is stored.
+    @param request The registration request.
+    @param completion Called when the request has completed or failed.
+    @discussion Calls @c OIDAuthorizationService.performRegistrationRequest:completion:.
+        Subclasses may override this to customize how the request is sent.
+ */
+- (void)performRegistrationRequest:(OIDRegistrationRequest *)request
+                        completion:(OIDRegistrationCallback)completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,271 @@
+/*! @file OIDRegistrationStore.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDRegistrationStore.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#import "OIDDefines.h"
+#import "OIDLogging.h"
+#import "OIDRegistrationRequest.h"
+#import "OIDRegistrationResponse.h"
+#import "OIDServiceConfiguration.h"
+
+/*! @var kLockFileSuffix
+    @brief Suffix appended to the store's file path to create the registration lock file.
+ */
+static NSString *const kLockFileSuffix = @".lock";
+
+/*! @var kClientSecretExpirationTolerance
+    @brief Number of seconds before its client secret expires that a stored registration is no
+        longer used.
+ */
+static NSTimeInterval const kClientSecretExpirationTolerance = 60;
+
+@implementation OIDRegistrationStore {
+  /*! @var _registrationResponse
+      @brief The most recently read or registered response. Synchronized on @c self.
+   */
+  OIDRegistrationResponse *_registrationResponse;
+
+  /*! @var _pendingCompletions
+      @brief The completion blocks waiting for the registration in progress, or nil if there isn't
+          one. Synchronized on @c self.
+   */
+  NSMutableArray<OIDRegistrationCallback> *_pendingCompletions;
+
+  /*! @var _pendingRequest
+      @brief The request of the registration in progress. Synchronized on @c self.
+   */
+  OIDRegistrationRequest *_pendingRequest;
+
+  /*! @var _deferredCalls
+      @brief Calls for requests which can't share the registration in progress, made again once
+          it completes. Synchronized on @c self.
+   */
+  NSMutableArray<dispatch_block_t> *_deferredCalls;
+}
+
+- (nullable instancetype)init OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithFileURL:));
+
+- (nullable instancetype)initWithFileURL:(NSURL *)fileURL {
+  self = [super init];
+  if (self) {
+    _fileURL = [fileURL copy];
+  }
+  return self;
+}
+
+#pragma mark - Reading and writing
+
+- (nullable OIDRegistrationResponse *)readRegistrationResponse {
+  NSData *data = [NSData dataWithContentsOfURL:_fileURL];
+  if (!data) {
+    return nil;
+  }
+  id registrationResponse = nil;
+  @try {
+    registrationResponse = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  } @catch (NSException *exception) {
+    // a corrupt archive is treated the same as a missing one
+    return nil;
+  }
+  if (![registrationResponse isKindOfClass:[OIDRegistrationResponse class]]) {
+    return nil;
+  }
+  return registrationResponse;
+}
+
+- (BOOL)removeRegistrationWithError:(NSError **_Nullable)error {
+  @synchronized(self) {
+    _registrationResponse = nil;
+  }
+  NSError *removeError;
+  if (![[NSFileManager defaultManager] removeItemAtURL:_fileURL error:&removeError]
+      && !([removeError.domain isEqual:NSCocoaErrorDomain]
+           && removeError.code == NSFileNoSuchFileError)) {
+    if (error) {
+      *error = removeError;
+    }
+    return NO;
+  }
+  return YES;
+}
+
+/*! @fn isRequest:equivalentToRequest:
+    @brief Returns whether a registration made for one request can be used for the other: they
+        have the same registration endpoint and redirect URIs.
+ */
++ (BOOL)isRequest:(OIDRegistrationRequest *)request
+    equivalentToRequest:(OIDRegistrationRequest *)otherRequest {
+  NSURL *registrationEndpoint = request.configuration.registrationEndpoint;
+  return [otherRequest.configuration.registrationEndpoint isEqual:registrationEndpoint]
+      && [otherRequest.redirectURIs isEqualToArray:request.redirectURIs];
+}
+
+/*! @fn isRegistrationResponse:usableForRequest:
+    @brief Returns whether a stored registration was made for an equivalent request, and its
+        client secret is still valid.
+ */
++ (BOOL)isRegistrationResponse:(nullable OIDRegistrationResponse *)response
+              usableForRequest:(OIDRegistrationRequest *)request {
+  if (!response) {
+    return NO;
+  }
+  return [self isRequest:response.request equivalentToRequest:request]
+      && ![response isClientSecretExpiredWithTolerance:kClientSecretExpirationTolerance];
+}
+
+#pragma mark - Registration
+
+- (void)registrationResponseForRequest:(OIDRegistrationRequest *)request
+                            completion:(OIDRegistrationCallback)completion {
+  @synchronized(self) {
+    if (_pendingCompletions) {
+      if ([[self class] isRequest:_pendingRequest equivalentToRequest:request]) {
+        OIDLogDebug(@"Waiting for the registration in progress at %@.",
+                    request.configuration.registrationEndpoint);
+        [_pendingCompletions addObject:[completion copy]];
+        return;
+      }
+      // the store holds one registration, so this request is checked against the result of the
+      // one in progress before registering
+      OIDLogDebug(@"Deferring a registration at %@ until the one in progress completes.",
+                  request.configuration.registrationEndpoint);
+      if (!_deferredCalls) {
+        _deferredCalls = [NSMutableArray array];
+      }
+      [_deferredCalls addObject:^{
+        [self registrationResponseForRequest:request completion:completion];
+      }];
+      return;
+    }
+    OIDRegistrationResponse *registrationResponse = _registrationResponse;
+    if ([[self class] isRegistrationResponse:registrationResponse usableForRequest:request]) {
+      dispatch_async(dispatch_get_main_queue(), ^{
+        completion(registrationResponse, nil);
+      });
+      return;
+    }
+    _pendingCompletions = [NSMutableArray arrayWithObject:[completion copy]];
+    _pendingRequest = request;
+  }
+
+  // the lock may be held by another process which is registering, so wait for it off the main
+  // thread
+  dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    int lockFileDescriptor = [self lockForRegistration];
+    OIDRegistrationResponse *storedResponse = [self readRegistrationResponse];
+    if ([[self class] isRegistrationResponse:storedResponse usableForRequest:request]) {
+      [self unlockForRegistration:lockFileDescriptor];
+      [self completeRegistrationWithResponse:storedResponse error:nil];
+      return;
+    }
+
+    [self performRegistrationRequest:request
+                          completion:^(OIDRegistrationResponse *_Nullable registrationResponse,
+                                       NSError *_Nullable error) {
+      dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        if (registrationResponse) {
+          NSData *data = [NSKeyedArchiver archivedDataWithRootObject:registrationResponse];
+          NSError *writeError;
+          if (![data writeToURL:self.fileURL options:NSDataWritingAtomic error:&writeError]) {
+            // the registration can still be used by this process
+            OIDLogWarning(@"Failed to store the registration: %@", writeError);
+          }
+        }
+        [self unlockForRegistration:lockFileDescriptor];
+        [self completeRegistrationWithResponse:registrationResponse error:error];
+      });
+    }];
+  });
+}
+
+- (void)performRegistrationRequest:(OIDRegistrationRequest *)request
+                        completion:(OIDRegistrationCallback)completion {
+  [OIDAuthorizationService performRegistrationRequest:request completion:completion];
+}
+
+/*! @fn completeRegistrationWithResponse:error:
+    @brief Calls every completion waiting for the registration in progress on the main queue.
+ */
+- (void)completeRegistrationWithResponse:(nullable OIDRegistrationResponse *)registrationResponse
+                                   error:(nullable NSError *)error {
+  NSArray<OIDRegistrationCallback> *completions;
+  NSArray<dispatch_block_t> *deferredCalls;
+  @synchronized(self) {
+    completions = _pendingCompletions;
+    _pendingCompletions = nil;
+    _pendingRequest = nil;
+    deferredCalls = _deferredCalls;
+    _deferredCalls = nil;
+    if (registrationResponse) {
+      _registrationResponse = registrationResponse;
+    }
+  }
+  dispatch_async(dispatch_get_main_queue(), ^{
+    for (OIDRegistrationCallback completion in completions) {
+      completion(registrationResponse, error);
+    }
+  });
+  for (dispatch_block_t deferredCall in deferredCalls) {
+    deferredCall();
+  }
+}
+
+#pragma mark - Registration lock
+
+/*! @fn lockForRegistration
+    @brief Opens the lock file and acquires an exclusive lock on it, blocking until it's available.
+    @return The open lock file, or -1 if it couldn't be opened or locked, in which case
+        registration proceeds without cross-process coordination.
+    @discussion Each registration opens its own file description, so separate stores for the same
+        file within one process also exclude each other.
+ */
+- (int)lockForRegistration {
+  NSString *lockPath = [_fileURL.path stringByAppendingString:kLockFileSuffix];
+  int lockFileDescriptor = open(lockPath.fileSystemRepresentation, O_RDWR | O_CREAT, 0600);
+  if (lockFileDescriptor < 0) {
+    return -1;
+  }
+  int result;
+  do {
+    result = flock(lockFileDescriptor, LOCK_EX);
+  } while (result != 0 && errno == EINTR);
+  if (result != 0) {
+    close(lockFileDescriptor);
+    return -1;
+  }
+  return lockFileDescriptor;
+}
+
+/*! @fn unlockForRegistration:
+    @brief Releases a lock acquired by @c lockForRegistration, and closes the lock file.
+ */
+- (void)unlockForRegistration:(int)lockFileDescriptor {
+  if (lockFileDescriptor < 0) {
+    return;
+  }
+  flock(lockFileDescriptor, LOCK_UN);
+  close(lockFileDescriptor);
+}
+
+@end
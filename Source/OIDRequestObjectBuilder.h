@@ -0,0 +1,116 @@
+/*! @file OIDRequestObjectBuilder.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OIDAuthorizationRequest;
+@class OIDServiceConfiguration;
+@protocol OIDJWSSigner;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDRequestObjectBuilder
+    @brief Signs authorization request parameters as a request object, which is sent in the
+        @c request parameter of the authorization URL.
+    @discussion The JOSE header depends only on the signing key, so it is encoded once, when the
+        builder is created, and each request object only encodes its claims and signs them.
+
+        To combine request objects with precompiled authorization URLs, pass a builder to
+        @c OIDAuthorizationRequestTemplate, which also prepares the constant claims once.
+
+        A builder may be used from any thread.
+    @see https://www.rfc-editor.org/rfc/rfc9101
+    @see http://openid.net/specs/openid-connect-core-1_0.html#RequestObject
+ */
+@interface OIDRequestObjectBuilder : NSObject
+
+/*! @property signer
+    @brief The key request objects are signed with.
+ */
+@property(nonatomic, readonly) id<OIDJWSSigner> signer;
+
+/*! @property clientID
+    @brief The client identifier, which is the request object's issuer.
+ */
+@property(nonatomic, readonly) NSString *clientID;
+
+/*! @property audience
+    @brief The authorization server's issuer identifier, which is the request object's audience.
+ */
+@property(nonatomic, readonly) NSString *audience;
+
+/*! @property lifetime
+    @brief How long request objects are valid for, which sets their @c exp claim. Defaults to
+        five minutes.
+ */
+@property(atomic, assign) NSTimeInterval lifetime;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use @c initWithSigner:clientID:audience:.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn initWithSigner:clientID:audience:
+    @brief Designated initializer.
+    @param signer The key to sign request objects with.
+    @param clientID The client identifier.
+    @param audience The authorization server's issuer identifier.
+    @return The builder, or nil if the JOSE header couldn't be encoded.
+ */
+- (nullable instancetype)initWithSigner:(id<OIDJWSSigner>)signer
+                               clientID:(NSString *)clientID
+                               audience:(NSString *)audience NS_DESIGNATED_INITIALIZER;
+
+/*! @fn builderWithConfiguration:clientID:signer:
+    @brief Creates a builder for an authorization server which accepts request objects signed by
+        the given key.
+    @param configuration The authorization server's configuration.
+    @return The builder, or nil if the configuration has no discovery document or issuer, the
+        server doesn't support the @c request parameter, or it doesn't list the signer's
+        algorithm in @c request_object_signing_alg_values_supported.
+ */
++ (nullable instancetype)builderWithConfiguration:(OIDServiceConfiguration *)configuration
+                                         clientID:(NSString *)clientID
+                                           signer:(id<OIDJWSSigner>)signer;
+
+/*! @fn requestObjectWithClaims:error:
+    @brief Signs a request object.
+    @param claims The authorization request parameters, which are signed along with the claims
+        @c iss, @c aud, @c iat, @c nbf, @c exp and a unique @c jti. The times are the
+        audience's, from @c OIDClockSkewEstimator.serverDateForIssuer:.
+    @param error If the request object could not be signed, the reason.
+    @return The compact serialization of the request object.
+ */
+- (nullable NSString *)requestObjectWithClaims:(NSDictionary<NSString *, NSString *> *)claims
+                                         error:(NSError **_Nullable)error;
+
+/*! @fn authorizationRequestURLForRequest:error:
+    @brief Builds the authorization URL of a request with all its parameters in a request object.
+    @param request The authorization request.
+    @param error If the request object could not be signed, the reason.
+    @return The authorization endpoint URL with the @c request parameter, and the
+        @c response_type, @c client_id and @c scope parameters OpenID Connect requires outside the
+        request object.
+ */
+- (nullable NSURL *)authorizationRequestURLForRequest:(OIDAuthorizationRequest *)request
+                                                error:(NSError **_Nullable)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,200 @@
+/*! @file OIDRequestObjectBuilder.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDRequestObjectBuilder.h"
+
+#import "OIDAuthorizationRequest.h"
+#import "OIDClock.h"
+#import "OIDClockSkewEstimator.h"
+#import "OIDDefines.h"
+#import "OIDErrorUtilities.h"
+#import "OIDJWSSigner.h"
+#import "OIDServiceConfiguration.h"
+#import "OIDServiceDiscovery.h"
+#import "OIDTokenUtilities.h"
+#import "OIDURLQueryComponent.h"
+
+/*! @var kRequestObjectType
+    @brief The @c typ header parameter of request objects.
+    @see https://www.rfc-editor.org/rfc/rfc9101#section-10.8
+ */
+static NSString *const kRequestObjectType = @"oauth-authz-req+jwt";
+
+/*! @var kRequestParameter
+    @brief The authorization request parameter the request object is sent in.
+ */
+static NSString *const kRequestParameter = @"request";
+
+/*! @var kResponseTypeParameter
+    @brief The response type request parameter.
+ */
+static NSString *const kResponseTypeParameter = @"response_type";
+
+/*! @var kClientIDParameter
+    @brief The client ID request parameter.
+ */
+static NSString *const kClientIDParameter = @"client_id";
+
+/*! @var kRedirectURLParameter
+    @brief The redirect URI request parameter.
+ */
+static NSString *const kRedirectURLParameter = @"redirect_uri";
+
+/*! @var kScopeParameter
+    @brief The scope request parameter.
+ */
+static NSString *const kScopeParameter = @"scope";
+
+/*! @var kStateParameter
+    @brief The state request parameter.
+ */
+static NSString *const kStateParameter = @"state";
+
+/*! @var kCodeChallengeParameter
+    @brief The PKCE code challenge request parameter.
+ */
+static NSString *const kCodeChallengeParameter = @"code_challenge";
+
+/*! @var kCodeChallengeMethodParameter
+    @brief The PKCE code challenge method request parameter.
+ */
+static NSString *const kCodeChallengeMethodParameter = @"code_challenge_method";
+
+/*! @var kJTISize
+    @brief The number of random bytes in the @c jti claim of each request object.
+ */
+static NSUInteger const kJTISize = 16;
+
+/*! @var kDefaultLifetime
+    @brief The default value of @c lifetime.
+ */
+static NSTimeInterval const kDefaultLifetime = 300;
+
+@implementation OIDRequestObjectBuilder {
+  /*! @var _headerPrefix
+      @brief The base64url-encoded JOSE header followed by a period, which starts every request
+          object.
+   */
+  NSString *_headerPrefix;
+}
+
+- (nullable instancetype)init
+    OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithSigner:clientID:audience:));
+
+- (nullable instancetype)initWithSigner:(id<OIDJWSSigner>)signer
+                               clientID:(NSString *)clientID
+                               audience:(NSString *)audience {
+  self = [super init];
+  if (self) {
+    _signer = signer;
+    _clientID = [clientID copy];
+    _audience = [audience copy];
+    _lifetime = kDefaultLifetime;
+    NSMutableDictionary<NSString *, id> *header =
+        [@{ @"alg" : signer.algorithm, @"typ" : kRequestObjectType } mutableCopy];
+    if ([signer respondsToSelector:@selector(keyID)]) {
+      header[@"kid"] = signer.keyID;
+    }
+    _headerPrefix = [OIDTokenUtilities JWSHeaderPrefixWithHeader:header];
+    if (!_headerPrefix) {
+      return nil;
+    }
+  }
+  return self;
+}
+
++ (nullable instancetype)builderWithConfiguration:(OIDServiceConfiguration *)configuration
+                                         clientID:(NSString *)clientID
+                                           signer:(id<OIDJWSSigner>)signer {
+  OIDServiceDiscovery *discovery = configuration.discoveryDocument;
+  NSArray<NSString *> *algorithms = discovery.requestObjectSigningAlgorithmValuesSupported;
+  // without an issuer the request object would have no audience, which servers must reject
+  if (!discovery.issuer || !discovery.requestParameterSupported
+      || (algorithms && ![algorithms containsObject:signer.algorithm])) {
+    return nil;
+  }
+  return [[self alloc] initWithSigner:signer
+                             clientID:clientID
+                             audience:discovery.issuer.absoluteString];
+}
+
+- (nullable NSString *)requestObjectWithClaims:(NSDictionary<NSString *, NSString *> *)claims
+                                         error:(NSError **_Nullable)error {
+  NSString *jti = [OIDTokenUtilities randomURLSafeStringWithSize:kJTISize];
+  // the server validates these claims against its own clock
+  NSURL *issuer = [NSURL URLWithString:_audience];
+  NSDate *now = issuer ? [[OIDClockSkewEstimator sharedEstimator] serverDateForIssuer:issuer]
+                       : [OIDClock sharedClock].now;
+  long long issuedAt = (long long)now.timeIntervalSince1970;
+  NSMutableDictionary<NSString *, id> *requestClaims = [claims mutableCopy];
+  requestClaims[@"iss"] = _clientID;
+  requestClaims[@"aud"] = _audience;
+  requestClaims[@"iat"] = @(issuedAt);
+  requestClaims[@"nbf"] = @(issuedAt);
+  requestClaims[@"exp"] = @(issuedAt + (long long)self.lifetime);
+  requestClaims[@"jti"] = jti;
+
+  NSError *signingError;
+  NSString *requestObject;
+  if (jti) {
+    requestObject = [OIDTokenUtilities JWSWithHeaderPrefix:_headerPrefix
+                                                    claims:requestClaims
+                                                    signer:_signer
+                                                     error:&signingError];
+  }
+  if (!requestObject) {
+    if (error) {
+      *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeRequestObjectError
+                                underlyingError:signingError
+                                    description:@"Failed to sign a request object."];
+    }
+    return nil;
+  }
+  return requestObject;
+}
+
+- (nullable NSURL *)authorizationRequestURLForRequest:(OIDAuthorizationRequest *)request
+                                                error:(NSError **_Nullable)error {
+  // the same parameters as -[OIDAuthorizationRequest authorizationRequestURL]
+  NSMutableDictionary<NSString *, NSString *> *parameters =
+      [NSMutableDictionary dictionaryWithDictionary:request.additionalParameters ?: @{}];
+  parameters[kResponseTypeParameter] = request.responseType;
+  parameters[kClientIDParameter] = request.clientID;
+  parameters[kRedirectURLParameter] = request.redirectURL.absoluteString;
+  parameters[kScopeParameter] = request.scope;
+  parameters[kStateParameter] = request.state;
+  if (request.codeVerifier) {
+    parameters[kCodeChallengeParameter] = request.codeChallenge;
+    parameters[kCodeChallengeMethodParameter] = request.codeChallengeMethod;
+  }
+  NSString *requestObject = [self requestObjectWithClaims:parameters error:error];
+  if (!requestObject) {
+    return nil;
+  }
+
+  OIDURLQueryComponent *query = [[OIDURLQueryComponent alloc] init];
+  [query addParameter:kResponseTypeParameter value:request.responseType];
+  [query addParameter:kClientIDParameter value:request.clientID];
+  if (request.scope) {
+    [query addParameter:kScopeParameter value:request.scope];
+  }
+  [query addParameter:kRequestParameter value:requestObject];
+  return [query URLByReplacingQueryInURL:request.configuration.authorizationEndpoint];
+}
+
+@end
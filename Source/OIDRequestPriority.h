@@ -0,0 +1,47 @@
+/*! @file OIDRequestPriority.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*! @enum OIDRequestPriority
+    @brief How urgently a network request is needed, which determines the order requests are
+        started in when @c OIDHTTPClient has more than it runs at once, the priority of their
+        @c NSURLSessionTask, and the queue their responses are parsed on.
+    @discussion The priority doesn't carry through to callbacks: @c OIDAuthorizationService and
+        @c OIDAuthState always call them on the main queue, as they always have. A callback for
+        background work should therefore return quickly, dispatching anything expensive to a
+        queue of its own.
+ */
+typedef NS_ENUM(NSInteger, OIDRequestPriority) {
+  /*! @var OIDRequestPriorityBackground
+      @brief Work nobody is waiting for, such as refreshing tokens ahead of time. Started only
+          when no more urgent request is waiting.
+   */
+  OIDRequestPriorityBackground = -1,
+
+  /*! @var OIDRequestPriorityDefault
+      @brief The priority of requests which don't specify one.
+   */
+  OIDRequestPriorityDefault = 0,
+
+  /*! @var OIDRequestPriorityUserInitiated
+      @brief Work the user is waiting for, such as exchanging an authorization code. Started
+          straight away, even when the client is already running its maximum number of requests.
+   */
+  OIDRequestPriorityUserInitiated = 1,
+};
@@ -0,0 +1,108 @@
+/*! @file OIDScopeSet.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDScopeSet
+    @brief An immutable set of OAuth 2 scopes, for cheaply comparing the scope granted to a client
+        with the scope an API call requires.
+    @discussion Every scope name seen by any scope set is interned in a process-wide table, which
+        assigns it a bit index. A scope set is a bitset over those indexes, so subset, union and
+        intersection operations take time proportional to the number of 64 bit words, rather than
+        the number of scopes or their lengths.
+
+        Scope sets parsed from a scope string are cached, as is the string representation of each
+        set, so converting the same granted scope repeatedly doesn't split or join strings.
+        Interned scope names are never released, which is appropriate for the small vocabulary of
+        scopes an app works with. So that scopes supplied by a server can't grow the table without
+        bound, it holds at most 1024 scopes; further scopes are kept by each set in an ordinary
+        string set, which only makes operations involving them slower.
+    @see https://tools.ietf.org/html/rfc6749#section-3.3
+ */
+@interface OIDScopeSet : NSObject <NSCopying, NSSecureCoding>
+
+/*! @property count
+    @brief The number of scopes in the set.
+ */
+@property(nonatomic, readonly) NSUInteger count;
+
+/*! @property scopes
+    @brief The scopes in the set, in no particular order.
+ */
+@property(nonatomic, readonly) NSArray<NSString *> *scopes;
+
+/*! @property scopeString
+    @brief The set as a space-delimited scope string per the OAuth 2 spec. For sets created from a
+        string, this is the original string.
+ */
+@property(nonatomic, readonly) NSString *scopeString;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use @c scopeSetWithString: or @c scopeSetWithArray:.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn scopeSetWithString:
+    @brief Returns the scope set for an OAuth 2 spec-compliant scope string.
+    @param scopeString A space-delimited scope string.
+    @discussion Results are cached, so repeated calls with the same string are cheap.
+ */
++ (instancetype)scopeSetWithString:(NSString *)scopeString;
+
+/*! @fn scopeSetWithArray:
+    @brief Returns the scope set containing the given scopes.
+    @param scopes An array of scope strings.
+ */
++ (instancetype)scopeSetWithArray:(NSArray<NSString *> *)scopes;
+
+/*! @fn containsScope:
+    @brief Returns whether the set contains the given scope.
+    @param scope A single scope name.
+ */
+- (BOOL)containsScope:(NSString *)scope;
+
+/*! @fn isSubsetOfScopeSet:
+    @brief Returns whether every scope in this set is also in @c other.
+    @param other The set to compare with, typically the granted scope.
+ */
+- (BOOL)isSubsetOfScopeSet:(OIDScopeSet *)other;
+
+/*! @fn intersectsScopeSet:
+    @brief Returns whether this set and @c other have at least one scope in common.
+    @param other The set to compare with.
+ */
+- (BOOL)intersectsScopeSet:(OIDScopeSet *)other;
+
+/*! @fn scopeSetByAddingScopeSet:
+    @brief Returns the union of this set and @c other.
+    @param other The set to add.
+ */
+- (OIDScopeSet *)scopeSetByAddingScopeSet:(OIDScopeSet *)other;
+
+/*! @fn scopeSetByIntersectingScopeSet:
+    @brief Returns the scopes which are in both this set and @c other.
+    @param other The set to intersect with.
+ */
+- (OIDScopeSet *)scopeSetByIntersectingScopeSet:(OIDScopeSet *)other;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,381 @@
+/*! @file OIDScopeSet.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDScopeSet.h"
+
+#import "OIDDefines.h"
+
+/*! @var kScopeStringKey
+    @brief Key used to encode the @c scopeString property for @c NSSecureCoding.
+ */
+static NSString *const kScopeStringKey = @"scope";
+
+/*! @var kBitsPerWord
+    @brief The number of scope bits stored in each word of a set.
+ */
+static NSUInteger const kBitsPerWord = 64;
+
+/*! @var kMaximumInternedScopes
+    @brief The capacity of the intern table. Scopes seen once it is full are never interned.
+ */
+static NSUInteger const kMaximumInternedScopes = 1024;
+
+/*! @var kStackIndexCount
+    @brief The number of scope indexes looked up in a stack buffer when creating a set from an
+        array. Longer arrays, such as a hostile server's scope string, use the heap.
+ */
+static NSUInteger const kStackIndexCount = 32;
+
+/*! @var gScopeIndexes
+    @brief Maps each interned scope to its bit index. Guarded by @c gScopeNames.
+ */
+static NSMutableDictionary<NSString *, NSNumber *> *gScopeIndexes;
+
+/*! @var gScopeNames
+    @brief Interned scopes, by bit index. Also used as the lock for the intern table.
+ */
+static NSMutableArray<NSString *> *gScopeNames;
+
+/*! @var gScopeSetCache
+    @brief Scope sets previously parsed from a scope string, keyed by that string.
+ */
+static NSCache<NSString *, OIDScopeSet *> *gScopeSetCache;
+
+@implementation OIDScopeSet {
+  /*! @var _words
+      @brief The bitset, with no trailing zero words. NULL for the empty set.
+   */
+  uint64_t *_words;
+
+  /*! @var _wordCount
+      @brief The number of words in @c _words.
+   */
+  NSUInteger _wordCount;
+
+  /*! @var _uninternedScopes
+      @brief The scopes in the set which couldn't be interned because the table was full, or nil
+          if there are none. A scope is either interned by every set or by none.
+   */
+  NSSet<NSString *> *_uninternedScopes;
+
+  /*! @var _cachedScopeString
+      @brief The cached value of @c scopeString. Synchronized on @c self.
+   */
+  NSString *_cachedScopeString;
+}
+
++ (void)initialize {
+  if (self == [OIDScopeSet class]) {
+    gScopeIndexes = [NSMutableDictionary dictionary];
+    gScopeNames = [NSMutableArray array];
+    gScopeSetCache = [[NSCache alloc] init];
+  }
+}
+
+#pragma mark - Interning
+
+/*! @fn indexForScope:intern:
+    @brief Looks up the bit index of a scope.
+    @param intern Whether to assign an index to a scope which doesn't have one yet.
+    @return The scope's index, or @c NSNotFound if it isn't interned and either @c intern is NO
+        or the table is full.
+ */
++ (NSUInteger)indexForScope:(NSString *)scope intern:(BOOL)intern {
+  @synchronized(gScopeNames) {
+    NSNumber *index = gScopeIndexes[scope];
+    if (index) {
+      return index.unsignedIntegerValue;
+    }
+    if (!intern || gScopeNames.count >= kMaximumInternedScopes) {
+      return NSNotFound;
+    }
+    NSUInteger newIndex = gScopeNames.count;
+    NSString *internedScope = [scope copy];
+    [gScopeNames addObject:internedScope];
+    gScopeIndexes[internedScope] = @(newIndex);
+    return newIndex;
+  }
+}
+
+#pragma mark - Initializers
+
+- (nullable instancetype)init
+    OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithWords:count:uninternedScopes:scopeString:));
+
+/*! @fn initWithWords:count:uninternedScopes:scopeString:
+    @brief Designated initializer.
+    @param words A buffer allocated with @c malloc, which the set takes ownership of.
+    @param count The number of words in the buffer.
+    @param uninternedScopes The scopes which aren't interned, if any.
+    @param scopeString The set's string representation, if already known.
+ */
+- (instancetype)initWithWords:(uint64_t *)words
+                        count:(NSUInteger)count
+             uninternedScopes:(nullable NSSet<NSString *> *)uninternedScopes
+                  scopeString:(nullable NSString *)scopeString {
+  self = [super init];
+  if (self) {
+    // trailing zero words are dropped so equal sets have identical representations
+    while (count > 0 && words[count - 1] == 0) {
+      count--;
+    }
+    if (count == 0) {
+      free(words);
+      words = NULL;
+    }
+    _words = words;
+    _wordCount = count;
+    _uninternedScopes = uninternedScopes.count ? [uninternedScopes copy] : nil;
+    _cachedScopeString = [scopeString copy];
+  }
+  return self;
+}
+
+- (void)dealloc {
+  free(_words);
+}
+
++ (instancetype)scopeSetWithString:(NSString *)scopeString {
+  OIDScopeSet *cached = [gScopeSetCache objectForKey:scopeString];
+  if (cached) {
+    return cached;
+  }
+  NSMutableArray<NSString *> *scopes = [NSMutableArray array];
+  for (NSString *scope in [scopeString componentsSeparatedByString:@" "]) {
+    if (scope.length) {
+      [scopes addObject:scope];
+    }
+  }
+  OIDScopeSet *scopeSet = [self scopeSetWithArray:scopes scopeString:scopeString];
+  [gScopeSetCache setObject:scopeSet forKey:[scopeString copy]];
+  return scopeSet;
+}
+
++ (instancetype)scopeSetWithArray:(NSArray<NSString *> *)scopes {
+  return [self scopeSetWithArray:scopes scopeString:nil];
+}
+
+/*! @fn scopeSetWithArray:scopeString:
+    @brief Interns the given scopes and creates the set containing them.
+ */
++ (instancetype)scopeSetWithArray:(NSArray<NSString *> *)scopes
+                      scopeString:(nullable NSString *)scopeString {
+  NSUInteger stackIndexes[kStackIndexCount];
+  NSUInteger *indexes = stackIndexes;
+  if (scopes.count > kStackIndexCount) {
+    indexes = malloc(scopes.count * sizeof(NSUInteger));
+  }
+  NSMutableSet<NSString *> *uninternedScopes;
+  NSUInteger wordCount = 0;
+  NSUInteger i = 0;
+  for (NSString *scope in scopes) {
+    indexes[i] = [self indexForScope:scope intern:YES];
+    if (indexes[i] == NSNotFound) {
+      if (!uninternedScopes) {
+        uninternedScopes = [NSMutableSet set];
+      }
+      [uninternedScopes addObject:scope];
+    } else {
+      wordCount = MAX(wordCount, indexes[i] / kBitsPerWord + 1);
+    }
+    i++;
+  }
+  uint64_t *words = calloc(MAX(wordCount, 1), sizeof(uint64_t));
+  for (i = 0; i < scopes.count; i++) {
+    if (indexes[i] != NSNotFound) {
+      words[indexes[i] / kBitsPerWord] |= (uint64_t)1 << (indexes[i] % kBitsPerWord);
+    }
+  }
+  if (indexes != stackIndexes) {
+    free(indexes);
+  }
+  return [[self alloc] initWithWords:words
+                               count:wordCount
+                    uninternedScopes:uninternedScopes
+                         scopeString:scopeString];
+}
+
+#pragma mark - Set operations
+
+- (BOOL)containsScope:(NSString *)scope {
+  NSUInteger index = [[self class] indexForScope:scope intern:NO];
+  if (index == NSNotFound) {
+    return [_uninternedScopes containsObject:scope];
+  }
+  if (index / kBitsPerWord >= _wordCount) {
+    return NO;
+  }
+  return (_words[index / kBitsPerWord] >> (index % kBitsPerWord)) & 1;
+}
+
+- (BOOL)isSubsetOfScopeSet:(OIDScopeSet *)other {
+  if (_wordCount > other->_wordCount) {
+    // our highest word is non-zero, and other has no bits there
+    return NO;
+  }
+  for (NSUInteger i = 0; i < _wordCount; i++) {
+    if (_words[i] & ~other->_words[i]) {
+      return NO;
+    }
+  }
+  return !_uninternedScopes
+      || (other->_uninternedScopes && [_uninternedScopes isSubsetOfSet:other->_uninternedScopes]);
+}
+
+- (BOOL)intersectsScopeSet:(OIDScopeSet *)other {
+  NSUInteger count = MIN(_wordCount, other->_wordCount);
+  for (NSUInteger i = 0; i < count; i++) {
+    if (_words[i] & other->_words[i]) {
+      return YES;
+    }
+  }
+  return other->_uninternedScopes && [_uninternedScopes intersectsSet:other->_uninternedScopes];
+}
+
+- (OIDScopeSet *)scopeSetByAddingScopeSet:(OIDScopeSet *)other {
+  if ([other isSubsetOfScopeSet:self]) {
+    return self;
+  }
+  NSUInteger count = MAX(_wordCount, other->_wordCount);
+  uint64_t *words = calloc(count, sizeof(uint64_t));
+  for (NSUInteger i = 0; i < count; i++) {
+    words[i] = (i < _wordCount ? _words[i] : 0) | (i < other->_wordCount ? other->_words[i] : 0);
+  }
+  NSSet<NSString *> *uninternedScopes = _uninternedScopes;
+  if (other->_uninternedScopes) {
+    uninternedScopes = uninternedScopes
+        ? [uninternedScopes setByAddingObjectsFromSet:other->_uninternedScopes]
+        : other->_uninternedScopes;
+  }
+  return [[OIDScopeSet alloc] initWithWords:words
+                                      count:count
+                           uninternedScopes:uninternedScopes
+                                scopeString:nil];
+}
+
+- (OIDScopeSet *)scopeSetByIntersectingScopeSet:(OIDScopeSet *)other {
+  if ([self isSubsetOfScopeSet:other]) {
+    return self;
+  }
+  NSUInteger count = MIN(_wordCount, other->_wordCount);
+  uint64_t *words = calloc(MAX(count, 1), sizeof(uint64_t));
+  for (NSUInteger i = 0; i < count; i++) {
+    words[i] = _words[i] & other->_words[i];
+  }
+  NSMutableSet<NSString *> *uninternedScopes;
+  if (_uninternedScopes && other->_uninternedScopes) {
+    uninternedScopes = [_uninternedScopes mutableCopy];
+    [uninternedScopes intersectSet:other->_uninternedScopes];
+  }
+  return [[OIDScopeSet alloc] initWithWords:words
+                                      count:count
+                           uninternedScopes:uninternedScopes
+                                scopeString:nil];
+}
+
+#pragma mark - Conversions
+
+- (NSUInteger)count {
+  NSUInteger count = 0;
+  for (NSUInteger i = 0; i < _wordCount; i++) {
+    count += (NSUInteger)__builtin_popcountll(_words[i]);
+  }
+  return count + _uninternedScopes.count;
+}
+
+- (NSArray<NSString *> *)scopes {
+  NSMutableArray<NSString *> *scopes = [NSMutableArray arrayWithCapacity:self.count];
+  @synchronized(gScopeNames) {
+    for (NSUInteger i = 0; i < _wordCount; i++) {
+      uint64_t word = _words[i];
+      while (word) {
+        NSUInteger bit = (NSUInteger)__builtin_ctzll(word);
+        [scopes addObject:gScopeNames[i * kBitsPerWord + bit]];
+        word &= word - 1;
+      }
+    }
+  }
+  if (_uninternedScopes) {
+    [scopes addObjectsFromArray:_uninternedScopes.allObjects];
+  }
+  return scopes;
+}
+
+- (NSString *)scopeString {
+  @synchronized(self) {
+    if (!_cachedScopeString) {
+      _cachedScopeString = [self.scopes componentsJoinedByString:@" "];
+    }
+    return _cachedScopeString;
+  }
+}
+
+#pragma mark - NSObject overrides
+
+- (BOOL)isEqual:(id)object {
+  if (object == self) {
+    return YES;
+  }
+  if (![object isKindOfClass:[OIDScopeSet class]]) {
+    return NO;
+  }
+  OIDScopeSet *other = object;
+  return _wordCount == other->_wordCount
+      && (_wordCount == 0 || memcmp(_words, other->_words, _wordCount * sizeof(uint64_t)) == 0)
+      && OIDIsEqualIncludingNil(_uninternedScopes, other->_uninternedScopes);
+}
+
+- (NSUInteger)hash {
+  NSUInteger hash = _wordCount ^ _uninternedScopes.count;
+  for (NSUInteger i = 0; i < _wordCount; i++) {
+    hash = hash * 31 + (NSUInteger)(_words[i] ^ (_words[i] >> 32));
+  }
+  return hash;
+}
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, scope: \"%@\">",
+                                    NSStringFromClass([self class]),
+                                    self,
+                                    self.scopeString];
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(nullable NSZone *)zone {
+  // immutable
+  return self;
+}
+
+#pragma mark - NSSecureCoding
+
++ (BOOL)supportsSecureCoding {
+  return YES;
+}
+
+- (nullable instancetype)initWithCoder:(NSCoder *)aDecoder {
+  NSString *scopeString = [aDecoder decodeObjectOfClass:[NSString class] forKey:kScopeStringKey];
+  // bit indexes are specific to this process, so sets are archived as scope strings
+  return [[self class] scopeSetWithString:scopeString ?: @""];
+}
+
+- (void)encodeWithCoder:(NSCoder *)aCoder {
+  [aCoder encodeObject:self.scopeString forKey:kScopeStringKey];
+}
+
+@end
@@ -34,10 +34,25 @@ NS_ASSUME_NONNULL_BEGIN
 /*! @fn scopesWithArray:
     @brief Converts an array of scope strings to a single scope string per the OAuth 2 spec.
     @param scopes An array of scope strings.
-    @return A space-delimited string of scopes.
+    @return A space-delimited string of the valid scopes, or nil if none are valid.
+    @discussion Invalid scopes fail an assertion in debug builds, and are logged and left out of
+        the result in release builds. Use @c scopesWithArray:error: to handle invalid scopes as
+        errors.
     @see https://tools.ietf.org/html/rfc6749#section-3.3
  */
-+ (NSString *)scopesWithArray:(NSArray<NSString *> *)scopes;
++ (nullable NSString *)scopesWithArray:(nullable NSArray<NSString *> *)scopes;
+
+/*! @fn scopesWithArray:error:
+    @brief Validates an array of scope strings and joins them into a single scope string per the
+        OAuth 2 spec.
+    @param scopes An array of scope strings.
+    @param error If a scope is empty or contains a character not allowed in scopes, an error with
+        the code @c OIDErrorCodeInvalidScope.
+    @return A space-delimited string of scopes, or nil if a scope is invalid.
+    @see https://tools.ietf.org/html/rfc6749#section-3.3
+ */
++ (nullable NSString *)scopesWithArray:(NSArray<NSString *> *)scopes
+                                 error:(NSError **_Nullable)error;
 
 /*! @fn scopesArrayWithString:
     @brief Converts an OAuth 2 spec-compliant scope string to an array of scopes.
@@ -18,36 +18,94 @@
 
 #import "OIDScopeUtilities.h"
 
-@implementation OIDScopeUtilities
+#import "OIDErrorUtilities.h"
+#import "OIDLogging.h"
 
-/*! @fn disallowedScopeCharacters
-    @brief A character set with the characters NOT allowed in a scope name.
+/*! @var kScopeCharacterAllowed
+    @brief Lookup table of the bytes allowed in a scope name: %x21 / %x23-5B / %x5D-7E.
     @see https://tools.ietf.org/html/rfc6749#section-3.3
  */
-+ (NSCharacterSet *)disallowedScopeCharacters {
-  static NSCharacterSet *disallowedCharacters;
-  static dispatch_once_t onceToken;
-  dispatch_once(&onceToken, ^{
-    NSMutableCharacterSet *allowedCharacters;
-    allowedCharacters =
-        [NSMutableCharacterSet characterSetWithRange:NSMakeRange(0x23, 0x5B - 0x23 + 1)];
-    [allowedCharacters addCharactersInRange:NSMakeRange(0x5D, 0x7E - 0x5D + 1)];
-    [allowedCharacters addCharactersInString:@"\x21"];
-    disallowedCharacters = [allowedCharacters invertedSet];
-  });
-  return disallowedCharacters;
+static const BOOL kScopeCharacterAllowed[256] = {
+  [0x21] = YES,
+  [0x23 ... 0x5B] = YES,
+  [0x5D ... 0x7E] = YES,
+};
+
+@implementation OIDScopeUtilities
+
++ (nullable NSString *)scopesWithArray:(nullable NSArray<NSString *> *)scopes {
+  if (!scopes) {
+    return nil;
+  }
+  NSError *error;
+  NSString *scopeString = [self scopesWithArray:scopes error:&error];
+  if (!scopeString) {
+    NSAssert(NO, @"%@", error.localizedFailureReason);
+    OIDLogWarning(@"Dropping invalid scopes: %@", error.localizedFailureReason);
+    // only the valid scopes are sent; invalid ones are never joined into the request
+    NSMutableArray<NSString *> *validScopes = [NSMutableArray arrayWithCapacity:scopes.count];
+    for (NSString *scope in scopes) {
+      if ([self scopesWithArray:@[ scope ] error:NULL]) {
+        [validScopes addObject:scope];
+      }
+    }
+    return validScopes.count ? [self scopesWithArray:validScopes error:NULL] : nil;
+  }
+  return scopeString;
 }
 
-+ (NSString *)scopesWithArray:(NSArray<NSString *> *)scopes {
-  NSCharacterSet *disallowedCharacters = [self disallowedScopeCharacters];
++ (nullable NSString *)scopesWithArray:(NSArray<NSString *> *)scopes
+                                 error:(NSError **_Nullable)error {
+  NSUInteger count = scopes.count;
+  NSUInteger length = count ? count - 1 : 0;
   for (NSString *scope in scopes) {
-    NSAssert(scope.length, @"Found illegal empty scope string.");
-    NSAssert([scope rangeOfCharacterFromSet:disallowedCharacters].location == NSNotFound,
-             @"Found illegal character in scope string.");
+    length += scope.length;
   }
 
-  NSString *scopeString = [scopes componentsJoinedByString:@" "];
-  return scopeString;
+  // scopes are copied straight into the joined string's buffer and checked there, so each
+  // character is visited once
+  char *buffer = malloc(MAX(length, 1));
+  NSUInteger offset = 0;
+  NSUInteger index = 0;
+  for (NSString *scope in scopes) {
+    NSUInteger scopeLength = scope.length;
+    NSUInteger usedLength = 0;
+    // conversion stops short at the first non-ASCII character, none of which are allowed
+    [scope getBytes:buffer + offset
+          maxLength:scopeLength
+         usedLength:&usedLength
+           encoding:NSASCIIStringEncoding
+            options:0
+              range:NSMakeRange(0, scopeLength)
+     remainingRange:NULL];
+    BOOL valid = scopeLength > 0 && usedLength == scopeLength;
+    for (NSUInteger i = 0; valid && i < scopeLength; i++) {
+      valid = kScopeCharacterAllowed[(uint8_t)buffer[offset + i]];
+    }
+    if (!valid) {
+      free(buffer);
+      if (error) {
+        NSString *description =
+            scopeLength ? [NSString stringWithFormat:@"Found illegal character in scope \"%@\" "
+                                                     "at index %lu.", scope, (unsigned long)index]
+                        : [NSString stringWithFormat:@"Found illegal empty scope at index %lu.",
+                                                     (unsigned long)index];
+        *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeInvalidScope
+                                  underlyingError:nil
+                                      description:description];
+      }
+      return nil;
+    }
+    offset += scopeLength;
+    if (++index < count) {
+      buffer[offset++] = ' ';
+    }
+  }
+
+  return [[NSString alloc] initWithBytesNoCopy:buffer
+                                        length:length
+                                      encoding:NSASCIIStringEncoding
+                                  freeWhenDone:YES];
 }
 
 + (NSArray<NSString *> *)scopesArrayWithString:(NSString *)scopes {
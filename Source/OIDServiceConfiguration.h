@@ -46,6 +46,11 @@ typedef void (^OIDServiceConfigurationCreated)
  */
 @property(nonatomic, readonly) NSURL *tokenEndpoint;
 
+/*! @property registrationEndpoint
+    @brief The dynamic client registration endpoint URI, if the server supports registration.
+ */
+@property(nonatomic, readonly, nullable) NSURL *registrationEndpoint;
+
 /*! @property discoveryDocument
     @brief The discovery document.
  */
@@ -65,12 +70,30 @@ typedef void (^OIDServiceConfigurationCreated)
 - (nullable instancetype)initWithAuthorizationEndpoint:(NSURL *)authorizationEndpoint
                                          tokenEndpoint:(NSURL *)tokenEndpoint;
 
+/*! @fn initWithAuthorizationEndpoint:tokenEndpoint:registrationEndpoint:
+    @param authorizationEndpoint The authorization endpoint URI.
+    @param tokenEndpoint The token exchange and refresh endpoint URI.
+    @param registrationEndpoint The dynamic client registration endpoint URI.
+ */
+- (nullable instancetype)initWithAuthorizationEndpoint:(NSURL *)authorizationEndpoint
+                                         tokenEndpoint:(NSURL *)tokenEndpoint
+                                  registrationEndpoint:(nullable NSURL *)registrationEndpoint;
+
 /*! @fn initWithDiscoveryDocument:
     @param discoveryDocument The discovery document from which to extract the required OAuth
         configuration.
  */
 - (nullable instancetype)initWithDiscoveryDocument:(OIDServiceDiscovery *)discoveryDocument;
 
+/*! @fn internedConfiguration:
+    @brief Returns the canonical instance of a configuration: the first live configuration which
+        is equal to it, or @c configuration itself if there is none.
+    @param configuration The configuration to intern.
+    @discussion Configurations decoded from an archive are interned, so restoring many states for
+        the same service shares a single configuration. Interned configurations are held weakly.
+ */
++ (OIDServiceConfiguration *)internedConfiguration:(OIDServiceConfiguration *)configuration;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -32,6 +32,11 @@ static NSString *const kAuthorizationEndpointKey = @"authorizationEndpoint";
  */
 static NSString *const kTokenEndpointKey = @"tokenEndpoint";
 
+/*! @var kRegistrationEndpointKey
+    @brief The key for the @c registrationEndpoint property.
+ */
+static NSString *const kRegistrationEndpointKey = @"registrationEndpoint";
+
 /*! @var kDiscoveryDocumentKey
     @brief The key for the @c discoveryDocument property.
  */
@@ -43,11 +48,18 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable instancetype)initWithAuthorizationEndpoint:(NSURL *)authorizationEndpoint
         tokenEndpoint:(NSURL *)tokenEndpoint
+ registrationEndpoint:(nullable NSURL *)registrationEndpoint
     discoveryDocument:(nullable OIDServiceDiscovery *)discoveryDocument
     NS_DESIGNATED_INITIALIZER;
 
 @end
 
+/*! @var gInternedConfigurations
+    @brief The canonical instance of each distinct configuration. Held weakly, and synchronized on
+        itself.
+ */
+static NSHashTable<OIDServiceConfiguration *> *gInternedConfigurations;
+
 @implementation OIDServiceConfiguration
 
 - (nullable instancetype)init
@@ -55,12 +67,14 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable instancetype)initWithAuthorizationEndpoint:(NSURL *)authorizationEndpoint
         tokenEndpoint:(NSURL *)tokenEndpoint
+ registrationEndpoint:(nullable NSURL *)registrationEndpoint
     discoveryDocument:(nullable OIDServiceDiscovery *)discoveryDocument {
 
   self = [super init];
   if (self) {
     _authorizationEndpoint = [authorizationEndpoint copy];
     _tokenEndpoint = [tokenEndpoint copy];
+    _registrationEndpoint = [registrationEndpoint copy];
     _discoveryDocument = [discoveryDocument copy];
   }
   return self;
@@ -70,15 +84,41 @@ NS_ASSUME_NONNULL_BEGIN
                                          tokenEndpoint:(NSURL *)tokenEndpoint {
   return [self initWithAuthorizationEndpoint:authorizationEndpoint
                                tokenEndpoint:tokenEndpoint
+                        registrationEndpoint:nil
+                           discoveryDocument:nil];
+}
+
+- (nullable instancetype)initWithAuthorizationEndpoint:(NSURL *)authorizationEndpoint
+                                         tokenEndpoint:(NSURL *)tokenEndpoint
+                                  registrationEndpoint:(nullable NSURL *)registrationEndpoint {
+  return [self initWithAuthorizationEndpoint:authorizationEndpoint
+                               tokenEndpoint:tokenEndpoint
+                        registrationEndpoint:registrationEndpoint
                            discoveryDocument:nil];
 }
 
 - (nullable instancetype)initWithDiscoveryDocument:(OIDServiceDiscovery *) discoveryDocument {
   return [self initWithAuthorizationEndpoint:discoveryDocument.authorizationEndpoint
                                tokenEndpoint:discoveryDocument.tokenEndpoint
+                        registrationEndpoint:discoveryDocument.registrationEndpoint
                            discoveryDocument:discoveryDocument];
 }
 
++ (OIDServiceConfiguration *)internedConfiguration:(OIDServiceConfiguration *)configuration {
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    gInternedConfigurations = [NSHashTable weakObjectsHashTable];
+  });
+  @synchronized(gInternedConfigurations) {
+    OIDServiceConfiguration *interned = [gInternedConfigurations member:configuration];
+    if (interned) {
+      return interned;
+    }
+    [gInternedConfigurations addObject:configuration];
+    return configuration;
+  }
+}
+
 #pragma mark - NSCopying
 
 - (instancetype)copyWithZone:(nullable NSZone *)zone {
@@ -107,26 +147,56 @@ NS_ASSUME_NONNULL_BEGIN
 
   OIDServiceDiscovery *discoveryDocument = [aDecoder decodeObjectOfClass:[OIDServiceDiscovery class]
                                                                   forKey:kDiscoveryDocumentKey];
+  NSURL *registrationEndpoint = [aDecoder decodeObjectOfClass:[NSURL class]
+                                                       forKey:kRegistrationEndpointKey];
 
   return [self initWithAuthorizationEndpoint:authorizationEndpoint
                                tokenEndpoint:tokenEndpoint
+                        registrationEndpoint:registrationEndpoint
                            discoveryDocument:discoveryDocument];
 }
 
+- (id)awakeAfterUsingCoder:(NSCoder *)aDecoder {
+  // restoring many states for the same issuer shares one configuration, rather than one per state
+  return [[self class] internedConfiguration:self];
+}
+
 - (void)encodeWithCoder:(NSCoder *)aCoder {
   [aCoder encodeObject:_authorizationEndpoint forKey:kAuthorizationEndpointKey];
   [aCoder encodeObject:_tokenEndpoint forKey:kTokenEndpointKey];
+  [aCoder encodeObject:_registrationEndpoint forKey:kRegistrationEndpointKey];
   [aCoder encodeObject:_discoveryDocument forKey:kDiscoveryDocumentKey];
 }
 
+#pragma mark - NSObject overrides
+
+- (BOOL)isEqual:(id)object {
+  if (object == self) {
+    return YES;
+  }
+  if (![object isKindOfClass:[OIDServiceConfiguration class]]) {
+    return NO;
+  }
+  OIDServiceConfiguration *other = object;
+  return [_tokenEndpoint isEqual:other->_tokenEndpoint]
+      && OIDIsEqualIncludingNil(_authorizationEndpoint, other->_authorizationEndpoint)
+      && OIDIsEqualIncludingNil(_registrationEndpoint, other->_registrationEndpoint)
+      && OIDIsEqualIncludingNil(_discoveryDocument, other->_discoveryDocument);
+}
+
+- (NSUInteger)hash {
+  return _tokenEndpoint.hash ^ _authorizationEndpoint.hash;
+}
+
 #pragma mark - description
 
 - (NSString *)description {
   return [NSString stringWithFormat:
       @"OIDServiceConfiguration authorizationEndpoint: %@, tokenEndpoint: %@, "
-          "discoveryDocument: [%@]",
+          "registrationEndpoint: %@, discoveryDocument: [%@]",
       _authorizationEndpoint,
       _tokenEndpoint,
+      _registrationEndpoint,
       _discoveryDocument];
 }
 
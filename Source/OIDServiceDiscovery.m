@@ -71,6 +71,12 @@ static NSString *const kRequireRequestURIRegistrationKey = @"require_request_uri
 static NSString *const kOPPolicyURIKey = @"op_policy_uri";
 static NSString *const kOPTosURIKey = @"op_tos_uri";
 
+/*! @var gInternedDiscoveryDocuments
+    @brief The canonical instance of each distinct discovery document decoded from an archive.
+        Held weakly, and synchronized on itself.
+ */
+static NSHashTable<OIDServiceDiscovery *> *gInternedDiscoveryDocuments;
+
 @implementation OIDServiceDiscovery {
   NSDictionary *_discoveryDictionary;
 }
@@ -188,10 +194,44 @@ static NSString *const kOPTosURIKey = @"op_tos_uri";
   return self;
 }
 
+- (id)awakeAfterUsingCoder:(NSCoder *)aDecoder {
+  // restoring many states for the same issuer shares one document, rather than one per state
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    gInternedDiscoveryDocuments = [NSHashTable weakObjectsHashTable];
+  });
+  @synchronized(gInternedDiscoveryDocuments) {
+    OIDServiceDiscovery *interned = [gInternedDiscoveryDocuments member:self];
+    if (interned) {
+      return interned;
+    }
+    [gInternedDiscoveryDocuments addObject:self];
+    return self;
+  }
+}
+
 - (void)encodeWithCoder:(NSCoder *)aCoder {
   [_discoveryDictionary encodeWithCoder:aCoder];
 }
 
+#pragma mark - NSObject overrides
+
+- (BOOL)isEqual:(id)object {
+  if (object == self) {
+    return YES;
+  }
+  if (![object isKindOfClass:[OIDServiceDiscovery class]]) {
+    return NO;
+  }
+  OIDServiceDiscovery *other = object;
+  return [_discoveryDictionary isEqualToDictionary:other->_discoveryDictionary];
+}
+
+- (NSUInteger)hash {
+  // documents which differ only in their other fields are rare, and the issuer is cheap to hash
+  return [_discoveryDictionary[kIssuerKey] hash];
+}
+
 #pragma mark - Properties
 
 - (NSDictionary<NSString *, NSString *> *)discoveryDictionary {
@@ -0,0 +1,69 @@
+/*! @file OIDTokenRefreshRequestTemplate.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OIDAuthorizationRequest;
+@class OIDServiceConfiguration;
+@class OIDTokenRequest;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDTokenRefreshRequestTemplate
+    @brief A precompiled refresh token request for a particular authorization.
+    @discussion The parameters which are the same for every refresh (the grant type, scope, client
+        ID and redirect URI) are encoded once, along with the token endpoint request and its
+        headers. Each refresh then only encodes its refresh token, and any additional parameters,
+        and appends them to the cached body prefix.
+
+        The @c OIDTokenRequest objects created from a template are otherwise ordinary requests,
+        and are archived as such.
+    @see https://tools.ietf.org/html/rfc6749#section-6
+ */
+@interface OIDTokenRefreshRequestTemplate : NSObject
+
+/*! @property authorizationRequest
+    @brief The authorization request whose configuration, redirect URL, client ID and scope the
+        template was compiled from.
+ */
+@property(nonatomic, readonly) OIDAuthorizationRequest *authorizationRequest;
+
+/*! @fn init
+    @internal
+    @brief Unavailable. Please use @c initWithAuthorizationRequest:.
+ */
+- (nullable instancetype)init NS_UNAVAILABLE;
+
+/*! @fn initWithAuthorizationRequest:
+    @brief Compiles the refresh token request template for an authorization.
+    @param authorizationRequest The authorization request the refresh token was granted for.
+ */
+- (instancetype)initWithAuthorizationRequest:(OIDAuthorizationRequest *)authorizationRequest
+    NS_DESIGNATED_INITIALIZER;
+
+/*! @fn tokenRequestWithRefreshToken:additionalParameters:
+    @brief Creates a refresh token request, whose @c URLRequest is built from the template.
+    @param refreshToken The refresh token.
+    @param additionalParameters Additional parameters for the token request.
+ */
+- (OIDTokenRequest *)tokenRequestWithRefreshToken:(NSString *)refreshToken
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,232 @@
+/*! @file OIDTokenRefreshRequestTemplate.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDTokenRefreshRequestTemplate.h"
+
+#import "OIDAuthorizationRequest.h"
+#import "OIDDefines.h"
+#import "OIDGrantTypes.h"
+#import "OIDServiceConfiguration.h"
+#import "OIDTokenRequest.h"
+#import "OIDURLQueryComponent.h"
+
+/*! @var kGrantTypeParameter
+    @brief The grant type request parameter.
+ */
+static NSString *const kGrantTypeParameter = @"grant_type";
+
+/*! @var kScopeParameter
+    @brief The scope request parameter.
+ */
+static NSString *const kScopeParameter = @"scope";
+
+/*! @var kClientIDParameter
+    @brief The client ID request parameter.
+ */
+static NSString *const kClientIDParameter = @"client_id";
+
+/*! @var kRedirectURLParameter
+    @brief The redirect URI request parameter.
+ */
+static NSString *const kRedirectURLParameter = @"redirect_uri";
+
+/*! @var kRefreshTokenParameter
+    @brief The refresh token request parameter.
+ */
+static NSString *const kRefreshTokenParameter = @"refresh_token";
+
+/*! @var kHTTPPost
+    @brief The HTTP method of token requests.
+ */
+static NSString *const kHTTPPost = @"POST";
+
+/*! @var kHTTPContentTypeHeaderKey
+    @brief The Content-Type HTTP header.
+ */
+static NSString *const kHTTPContentTypeHeaderKey = @"Content-Type";
+
+/*! @var kHTTPContentTypeHeaderValue
+    @brief The Content-Type of token request bodies.
+ */
+static NSString *const kHTTPContentTypeHeaderValue =
+    @"application/x-www-form-urlencoded; charset=UTF-8";
+
+/*! @var kParameterSeparator
+    @brief Separates encoded parameters in a request body.
+ */
+static const char kParameterSeparator = '&';
+
+/*! @class OIDTemplatedTokenRequest
+    @brief A token request whose @c URLRequest is built by appending to a template's body prefix.
+ */
+@interface OIDTemplatedTokenRequest : OIDTokenRequest
+
+/*! @fn initWithTemplate:refreshToken:additionalParameters:
+    @brief Creates a refresh token request from a template.
+ */
+- (instancetype)initWithTemplate:(OIDTokenRefreshRequestTemplate *)requestTemplate
+                    refreshToken:(NSString *)refreshToken
+            additionalParameters:
+                (nullable NSDictionary<NSString *, NSString *> *)additionalParameters
+    NS_DESIGNATED_INITIALIZER;
+
+@end
+
+@interface OIDTokenRefreshRequestTemplate ()
+
+/*! @fn URLRequestWithRefreshToken:additionalParameters:
+    @brief Builds the URL request for a refresh from the cached request and body prefix.
+ */
+- (NSURLRequest *)URLRequestWithRefreshToken:(NSString *)refreshToken
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters;
+
+@end
+
+@implementation OIDTokenRefreshRequestTemplate {
+  /*! @var _baseURLRequest
+      @brief The token endpoint request with its method and headers set, but no body.
+   */
+  NSURLRequest *_baseURLRequest;
+
+  /*! @var _bodyPrefix
+      @brief The encoded parameters which are the same for every refresh.
+   */
+  NSData *_bodyPrefix;
+}
+
+- (nullable instancetype)init
+    OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithAuthorizationRequest:));
+
+- (instancetype)initWithAuthorizationRequest:(OIDAuthorizationRequest *)authorizationRequest {
+  self = [super init];
+  if (self) {
+    _authorizationRequest = authorizationRequest;
+
+    NSMutableURLRequest *URLRequest = [NSMutableURLRequest
+        requestWithURL:authorizationRequest.configuration.tokenEndpoint];
+    URLRequest.HTTPMethod = kHTTPPost;
+    [URLRequest setValue:kHTTPContentTypeHeaderValue forHTTPHeaderField:kHTTPContentTypeHeaderKey];
+    _baseURLRequest = [URLRequest copy];
+
+    OIDURLQueryComponent *query = [[OIDURLQueryComponent alloc] init];
+    [query addParameter:kGrantTypeParameter value:OIDGrantTypeRefreshToken];
+    if (authorizationRequest.scope) {
+      [query addParameter:kScopeParameter value:authorizationRequest.scope];
+    }
+    if (authorizationRequest.clientID) {
+      [query addParameter:kClientIDParameter value:authorizationRequest.clientID];
+    }
+    if (authorizationRequest.redirectURL) {
+      [query addParameter:kRedirectURLParameter
+                    value:authorizationRequest.redirectURL.absoluteString];
+    }
+    _bodyPrefix = [[query URLEncodedParameters] dataUsingEncoding:NSUTF8StringEncoding];
+  }
+  return self;
+}
+
+- (OIDTokenRequest *)tokenRequestWithRefreshToken:(NSString *)refreshToken
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters {
+  return [[OIDTemplatedTokenRequest alloc] initWithTemplate:self
+                                               refreshToken:refreshToken
+                                       additionalParameters:additionalParameters];
+}
+
+- (NSURLRequest *)URLRequestWithRefreshToken:(NSString *)refreshToken
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters {
+  OIDURLQueryComponent *query = [[OIDURLQueryComponent alloc] init];
+  [query addParameter:kRefreshTokenParameter value:refreshToken];
+  [query addParameters:additionalParameters];
+  NSData *suffix = [[query URLEncodedParameters] dataUsingEncoding:NSUTF8StringEncoding];
+
+  NSMutableData *body = [NSMutableData dataWithCapacity:_bodyPrefix.length + 1 + suffix.length];
+  [body appendData:_bodyPrefix];
+  [body appendBytes:&kParameterSeparator length:1];
+  [body appendData:suffix];
+
+  NSMutableURLRequest *URLRequest = [_baseURLRequest mutableCopy];
+  URLRequest.HTTPBody = body;
+  return URLRequest;
+}
+
+#pragma mark - NSObject overrides
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, URL: %@, body prefix: \"%@\">",
+                                    NSStringFromClass([self class]),
+                                    self,
+                                    _baseURLRequest.URL,
+                                    [[NSString alloc] initWithData:_bodyPrefix
+                                                          encoding:NSUTF8StringEncoding]];
+}
+
+@end
+
+@implementation OIDTemplatedTokenRequest {
+  /*! @var _requestTemplate
+      @brief The template the request was created from.
+   */
+  OIDTokenRefreshRequestTemplate *_requestTemplate;
+}
+
+- (nullable instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
+               grantType:(NSString *)grantType
+       authorizationCode:(nullable NSString *)code
+             redirectURL:(NSURL *)redirectURL
+                clientID:(NSString *)clientID
+                   scope:(nullable NSString *)scope
+            refreshToken:(nullable NSString *)refreshToken
+            codeVerifier:(nullable NSString *)codeVerifier
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters
+    OID_UNAVAILABLE_USE_INITIALIZER(
+        @selector(initWithTemplate:refreshToken:additionalParameters:)
+    );
+
+- (instancetype)initWithTemplate:(OIDTokenRefreshRequestTemplate *)requestTemplate
+                    refreshToken:(NSString *)refreshToken
+            additionalParameters:
+                (nullable NSDictionary<NSString *, NSString *> *)additionalParameters {
+  OIDAuthorizationRequest *authorizationRequest = requestTemplate.authorizationRequest;
+  self = [super initWithConfiguration:authorizationRequest.configuration
+                            grantType:OIDGrantTypeRefreshToken
+                    authorizationCode:nil
+                          redirectURL:authorizationRequest.redirectURL
+                             clientID:authorizationRequest.clientID
+                                scope:authorizationRequest.scope
+                         refreshToken:refreshToken
+                         codeVerifier:nil
+                 additionalParameters:additionalParameters];
+  if (self) {
+    _requestTemplate = requestTemplate;
+  }
+  return self;
+}
+
+- (NSURLRequest *)URLRequest {
+  return [_requestTemplate URLRequestWithRefreshToken:self.refreshToken
+                                 additionalParameters:self.additionalParameters];
+}
+
+#pragma mark - NSSecureCoding
+
+- (Class)classForCoder {
+  // the template isn't archived, so the request is decoded as an ordinary one
+  return [OIDTokenRequest class];
+}
+
+@end
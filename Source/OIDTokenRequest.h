@@ -117,6 +117,9 @@ NS_ASSUME_NONNULL_BEGIN
     @param scopes An array of scopes to combine into a single scope string per the OAuth2 spec.
     @param refreshToken The refresh token.
     @param additionalParameters The client's additional token request parameters.
+    @return The request, or nil if a scope is invalid.
+    @discussion Scopes are validated as by the initializer taking an error. An invalid scope fails
+        an assertion in debug builds, and is logged in release builds.
  */
 - (nullable instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
                grantType:(NSString *)grantType
@@ -128,6 +131,31 @@ NS_ASSUME_NONNULL_BEGIN
             codeVerifier:(nullable NSString *)codeVerifier
     additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters;
 
+/*! @fn initWithConfiguration:grantType:authorizationCode:redirectURL:clientID:scopes:refreshToken:codeVerifier:additionalParameters:error:
+    @brief Creates a token request, validating the scopes.
+    @param configuration The service's configuration.
+    @param grantType the type of token being sent to the token endpoint.
+        @see OIDGrantTypes.h
+    @param code The authorization code received from the authorization server.
+    @param redirectURL The client's redirect URI.
+    @param clientID The client identifier.
+    @param scopes An array of scopes to combine into a single scope string per the OAuth2 spec.
+    @param refreshToken The refresh token.
+    @param additionalParameters The client's additional token request parameters.
+    @param error If a scope is invalid, an error with the code @c OIDErrorCodeInvalidScope.
+    @return The request, or nil if a scope is invalid.
+ */
+- (nullable instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
+               grantType:(NSString *)grantType
+       authorizationCode:(nullable NSString *)code
+             redirectURL:(NSURL *)redirectURL
+                clientID:(NSString *)clientID
+                  scopes:(nullable NSArray<NSString *> *)scopes
+            refreshToken:(nullable NSString *)refreshToken
+            codeVerifier:(nullable NSString *)codeVerifier
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters
+                   error:(NSError **_Nullable)error;
+
 /*! @fn initWithConfiguration:grantType:authorizationCode:redirectURL:clientID:scope:refreshToken:additionalParameters:
     @brief Designated initializer.
     @param configuration The service's configuration.
@@ -19,6 +19,7 @@
 #import "OIDTokenRequest.h"
 
 #import "OIDDefines.h"
+#import "OIDLogging.h"
 #import "OIDScopeUtilities.h"
 #import "OIDServiceConfiguration.h"
 #import "OIDURLQueryComponent.h"
@@ -94,14 +95,49 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
             refreshToken:(nullable NSString *)refreshToken
             codeVerifier:(nullable NSString *)codeVerifier
     additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters {
+  NSError *error;
+  self = [self initWithConfiguration:configuration
+                           grantType:grantType
+                   authorizationCode:code
+                         redirectURL:redirectURL
+                            clientID:clientID
+                              scopes:scopes
+                        refreshToken:refreshToken
+                        codeVerifier:codeVerifier
+                additionalParameters:additionalParameters
+                               error:&error];
+  if (error) {
+    NSAssert(NO, @"%@", error.localizedFailureReason);
+    OIDLogWarning(@"Not creating token request: %@", error.localizedFailureReason);
+  }
+  return self;
+}
+
+- (nullable instancetype)initWithConfiguration:(OIDServiceConfiguration *)configuration
+               grantType:(NSString *)grantType
+       authorizationCode:(nullable NSString *)code
+             redirectURL:(NSURL *)redirectURL
+                clientID:(NSString *)clientID
+                  scopes:(nullable NSArray<NSString *> *)scopes
+            refreshToken:(nullable NSString *)refreshToken
+            codeVerifier:(nullable NSString *)codeVerifier
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters
+                   error:(NSError **_Nullable)error {
+  NSString *scope;
+  if (scopes) {
+    scope = [OIDScopeUtilities scopesWithArray:scopes error:error];
+    if (!scope) {
+      return nil;
+    }
+  }
   return [self initWithConfiguration:configuration
                            grantType:grantType
                    authorizationCode:code
                          redirectURL:redirectURL
                             clientID:clientID
-                               scope:[OIDScopeUtilities scopesWithArray:scopes]
+                               scope:scope
                         refreshToken:refreshToken
-                        codeVerifier:(NSString *)codeVerifier
+                        codeVerifier:codeVerifier
                 additionalParameters:additionalParameters];
 }
 
@@ -191,14 +227,21 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
 #pragma mark - NSObject overrides
 
 - (NSString *)description {
-  NSURLRequest *request = self.URLRequest;
-  NSString *requestBody =
-      [[NSString alloc] initWithData:request.HTTPBody encoding:NSUTF8StringEncoding];
-  return [NSString stringWithFormat:@"<%@: %p, request: <URL: %@, HTTPBody: %@>>",
+  return [NSString stringWithFormat:@"<%@: %p, URL: %@, grantType: %@, clientID: %@, scope: "
+                                     "\"%@\", redirectURL: %@, authorizationCode: %@, "
+                                     "refreshToken: %@, codeVerifier: %@, "
+                                     "additionalParameters: %@>",
                                     NSStringFromClass([self class]),
                                     self,
-                                    request.URL,
-                                    requestBody];
+                                    _configuration.tokenEndpoint,
+                                    _grantType,
+                                    _clientID,
+                                    _scope,
+                                    _redirectURL,
+                                    OIDLogRedact(_authorizationCode),
+                                    OIDLogRedact(_refreshToken),
+                                    OIDLogRedact(_codeVerifier),
+                                    OIDLogRedactParameters(_additionalParameters)];
 }
 
 #pragma mark -
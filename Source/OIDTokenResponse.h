@@ -108,6 +108,27 @@ NS_ASSUME_NONNULL_BEGIN
     parameters:(NSDictionary<NSString *, NSObject<NSCopying> *> *)parameters
     NS_DESIGNATED_INITIALIZER;
 
+/*! @fn accessTokenTimeUntilExpiration
+    @brief The estimated number of seconds until the access token expires, which is negative if
+        it has expired, or 0 if the expiry is unknown.
+    @discussion For responses received by this process, the time is measured on a monotonic clock
+        as well as the wall clock, so that setting the device's clock back doesn't extend the
+        token's lifetime. For unarchived responses, @c accessTokenExpirationDate is corrected for
+        any change in the estimated offset between the device's clock and the authorization
+        server's since the response was received.
+    @see OIDClockSkewEstimator
+ */
+- (NSTimeInterval)accessTokenTimeUntilExpiration;
+
+/*! @fn responseByReplacingRequest:
+    @brief Returns a response with the same values as this one, including its expiry, but
+        serviced by an equivalent request.
+    @param request The request to substitute, typically one which shares its configuration with
+        other objects.
+    @see OIDAuthState.compact
+ */
+- (instancetype)responseByReplacingRequest:(OIDTokenRequest *)request;
+
 @end
 
 NS_ASSUME_NONNULL_END
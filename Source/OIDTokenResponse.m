@@ -18,8 +18,12 @@
 
 #import "OIDTokenResponse.h"
 
+#import "OIDClock.h"
+#import "OIDClockSkewEstimator.h"
 #import "OIDDefines.h"
 #import "OIDFieldMapping.h"
+#import "OIDLogging.h"
+#import "OIDServiceConfiguration.h"
 #import "OIDTokenRequest.h"
 
 /*! @var kRequestKey
@@ -66,7 +70,26 @@ static NSString *const kScopeKey = @"scope";
  */
 static NSString *const kAdditionalParametersKey = @"additionalParameters";
 
-@implementation OIDTokenResponse
+/*! @var kClockOffsetKey
+    @brief Key used to encode the clock offset at the time of the response for
+        @c NSSecureCoding.
+ */
+static NSString *const kClockOffsetKey = @"clockOffset";
+
+@implementation OIDTokenResponse {
+  /*! @var _accessTokenMonotonicExpiration
+      @brief When the access token expires, on the clock of
+          @c OIDClockSkewEstimator.monotonicTimeInterval, or 0 if unknown. Not archived, as the
+          clock is only meaningful within this boot of the device.
+   */
+  NSTimeInterval _accessTokenMonotonicExpiration;
+
+  /*! @var _clockOffset
+      @brief The estimated offset of the authorization server's clock when the response was
+          received, if known.
+   */
+  NSNumber *_clockOffset;
+}
 
 /*! @fn fieldMap
     @brief Returns a mapping of incoming parameters to instance variables.
@@ -87,7 +110,8 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
             return value;
           }
           NSNumber *valueAsNumber = (NSNumber *)value;
-          return [NSDate dateWithTimeIntervalSinceNow:[valueAsNumber longLongValue]];
+          return [[OIDClock sharedClock].now
+              dateByAddingTimeInterval:[valueAsNumber longLongValue]];
         }];
     fieldMap[kTokenTypeKey] =
         [[OIDFieldMapping alloc] initWithName:@"_tokenType" type:[NSString class]];
@@ -116,10 +140,56 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
                                          parameters:parameters
                                            instance:self];
     _additionalParameters = additionalParameters;
+
+    NSObject *expiresIn = parameters[kExpiresInKey];
+    if ([expiresIn isKindOfClass:[NSNumber class]]) {
+      _accessTokenMonotonicExpiration = [OIDClockSkewEstimator monotonicTimeInterval]
+          + [(NSNumber *)expiresIn longLongValue];
+    }
+    NSURL *issuer = [OIDClockSkewEstimator issuerForConfiguration:request.configuration];
+    OIDClockSkewEstimator *estimator = [OIDClockSkewEstimator sharedEstimator];
+    if (issuer && [estimator hasClockOffsetForIssuer:issuer]) {
+      _clockOffset = @([estimator clockOffsetForIssuer:issuer]);
+    }
   }
   return self;
 }
 
+#pragma mark - Expiry
+
+- (NSTimeInterval)accessTokenTimeUntilExpiration {
+  if (!_accessTokenExpirationDate) {
+    return 0;
+  }
+  NSTimeInterval timeUntilExpiration =
+      [_accessTokenExpirationDate timeIntervalSinceDate:[OIDClock sharedClock].now];
+  if (_accessTokenMonotonicExpiration > 0) {
+    // the monotonic clock stops while the device sleeps, when the wall clock is more accurate
+    NSTimeInterval monotonicTimeUntilExpiration =
+        _accessTokenMonotonicExpiration - [OIDClockSkewEstimator monotonicTimeInterval];
+    return MIN(timeUntilExpiration, monotonicTimeUntilExpiration);
+  }
+
+  // the offset changes when the device's clock is changed
+  NSURL *issuer = [OIDClockSkewEstimator issuerForConfiguration:_request.configuration];
+  OIDClockSkewEstimator *estimator = [OIDClockSkewEstimator sharedEstimator];
+  if (_clockOffset && issuer && [estimator hasClockOffsetForIssuer:issuer]) {
+    timeUntilExpiration += _clockOffset.doubleValue - [estimator clockOffsetForIssuer:issuer];
+  }
+  return timeUntilExpiration;
+}
+
+- (instancetype)responseByReplacingRequest:(OIDTokenRequest *)request {
+  OIDTokenResponse *response = [[[self class] alloc] initWithRequest:request parameters:@{ }];
+  [OIDFieldMapping copyFieldsWithMap:[[self class] fieldMap]
+                        fromInstance:self
+                          toInstance:response];
+  response->_additionalParameters = _additionalParameters;
+  response->_accessTokenMonotonicExpiration = _accessTokenMonotonicExpiration;
+  response->_clockOffset = _clockOffset;
+  return response;
+}
+
 #pragma mark - NSCopying
 
 - (instancetype)copyWithZone:(nullable NSZone *)zone {
@@ -144,6 +214,7 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
     [OIDFieldMapping decodeWithCoder:aDecoder map:[[self class] fieldMap] instance:self];
     _additionalParameters = [aDecoder decodeObjectOfClasses:[OIDFieldMapping JSONTypes]
                                                      forKey:kAdditionalParametersKey];
+    _clockOffset = [aDecoder decodeObjectOfClass:[NSNumber class] forKey:kClockOffsetKey];
   }
   return self;
 }
@@ -152,6 +223,7 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
   [OIDFieldMapping encodeWithCoder:aCoder map:[[self class] fieldMap] instance:self];
   [aCoder encodeObject:_request forKey:kRequestKey];
   [aCoder encodeObject:_additionalParameters forKey:kAdditionalParametersKey];
+  [aCoder encodeObject:_clockOffset forKey:kClockOffsetKey];
 }
 
 #pragma mark - NSObject overrides
@@ -162,13 +234,13 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
                                      "scope: \"%@\", additionalParameters: %@, request: %@>",
                                     NSStringFromClass([self class]),
                                     self,
-                                    _accessToken,
+                                    OIDLogRedact(_accessToken),
                                     _accessTokenExpirationDate,
                                     _tokenType,
-                                    _idToken,
-                                    _refreshToken,
+                                    OIDLogRedact(_idToken),
+                                    OIDLogRedact(_refreshToken),
                                     _scope,
-                                    _additionalParameters,
+                                    OIDLogRedactParameters(_additionalParameters),
                                     _request];
 }
 
@@ -18,6 +18,8 @@
 
 #import <Foundation/Foundation.h>
 
+@protocol OIDJWSSigner;
+
 NS_ASSUME_NONNULL_BEGIN
 
 /*! @class OIDTokenUtilities
@@ -40,6 +42,20 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (NSString *)encodeBase64urlNoPadding:(NSData *)data;
 
+/*! @fn decodeBase64urlNoPadding:
+    @brief Decodes base64url-nopadding encoded data, such as the segments of a JWT.
+    @param base64urlString The encoded string, which may also be padded.
+    @return The decoded data, or nil if the string isn't valid base64url.
+ */
++ (nullable NSData *)decodeBase64urlNoPadding:(NSString *)base64urlString;
+
+/*! @fn randomDataWithSize:
+    @brief Generates cryptographically secure random bytes, such as keys and nonces.
+    @param size The number of random bytes.
+    @return The random data, or nil if the system's random number generator failed.
+ */
++ (nullable NSData *)randomDataWithSize:(NSUInteger)size;
+
 /*! @fn randomURLSafeStringWithLength:
     @brief Generates a URL-safe string with random data.
     @param size The number of random bytes to encode. NB. the length of the output string will be
@@ -55,6 +71,39 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (NSData *)sha265:(NSString *)inputString;
 
+/*! @fn HMACSHA256WithKey:data:
+    @brief Computes the HMAC-SHA256 of data.
+    @param key The secret key.
+    @param data The data to authenticate.
+    @return The 32 byte HMAC.
+ */
++ (NSData *)HMACSHA256WithKey:(NSData *)key data:(NSData *)data;
+
+/*! @fn JWSHeaderPrefixWithHeader:
+    @brief Encodes a JOSE header for @c JWSWithHeaderPrefix:claims:signer:error:.
+    @param header The JOSE header parameters.
+    @return The base64url-encoded header followed by a period, or nil if the header couldn't be
+        serialized as JSON.
+    @discussion Headers often depend only on the signing key, so callers signing many tokens
+        with one key can encode the header once and reuse the prefix.
+ */
++ (nullable NSString *)JWSHeaderPrefixWithHeader:(NSDictionary<NSString *, id> *)header;
+
+/*! @fn JWSWithHeaderPrefix:claims:signer:error:
+    @brief Creates the compact serialization of a JWS.
+    @param headerPrefix The encoded header, from @c JWSHeaderPrefixWithHeader:.
+    @param claims The JWT claims, which must be serializable as JSON.
+    @param signer The key to sign with.
+    @param error If the claims couldn't be serialized or the signer failed, the signer's error if
+        any.
+    @return The signed JWT.
+    @see https://www.rfc-editor.org/rfc/rfc7515#section-7.1
+ */
++ (nullable NSString *)JWSWithHeaderPrefix:(NSString *)headerPrefix
+                                    claims:(NSDictionary<NSString *, id> *)claims
+                                    signer:(id<OIDJWSSigner>)signer
+                                     error:(NSError **_Nullable)error;
+
 @end
 
 NS_ASSUME_NONNULL_END
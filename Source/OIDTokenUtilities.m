@@ -18,7 +18,20 @@
 
 #import "OIDTokenUtilities.h"
 
+#import "OIDJWSSigner.h"
+
+#if __has_include(<CommonCrypto/CommonDigest.h>)
 #import <CommonCrypto/CommonDigest.h>
+#import <CommonCrypto/CommonHMAC.h>
+#import <Security/SecRandom.h>
+#define OID_HAS_COMMON_CRYPTO 1
+#else
+// GNUstep on Linux, for the AppAuthCore library; see GNUmakefile
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+#endif
 
 @implementation OIDTokenUtilities
 
@@ -32,20 +45,99 @@
   return base64string;
 }
 
-+ (nullable NSString *)randomURLSafeStringWithSize:(NSUInteger)size {
++ (nullable NSData *)decodeBase64urlNoPadding:(NSString *)base64urlString {
+  // converts base64url to base64
+  NSMutableString *base64string = [base64urlString mutableCopy];
+  [base64string replaceOccurrencesOfString:@"-"
+                                withString:@"+"
+                                   options:0
+                                     range:NSMakeRange(0, base64string.length)];
+  [base64string replaceOccurrencesOfString:@"_"
+                                withString:@"/"
+                                   options:0
+                                     range:NSMakeRange(0, base64string.length)];
+  // restores padding
+  while (base64string.length % 4) {
+    [base64string appendString:@"="];
+  }
+  return [[NSData alloc] initWithBase64EncodedString:base64string options:0];
+}
+
++ (nullable NSData *)randomDataWithSize:(NSUInteger)size {
   NSMutableData *randomData = [NSMutableData dataWithLength:size];
+#if OID_HAS_COMMON_CRYPTO
   int result = SecRandomCopyBytes(kSecRandomDefault, randomData.length, randomData.mutableBytes);
   if (result != 0) {
     return nil;
   }
+#else
+  if (RAND_bytes(randomData.mutableBytes, (int)randomData.length) != 1) {
+    return nil;
+  }
+#endif
+  return randomData;
+}
+
++ (nullable NSString *)randomURLSafeStringWithSize:(NSUInteger)size {
+  NSData *randomData = [self randomDataWithSize:size];
+  if (!randomData) {
+    return nil;
+  }
   return [[self class] encodeBase64urlNoPadding:randomData];
 }
 
 + (NSData *)sha265:(NSString *)inputString {
   NSData *verifierData = [inputString dataUsingEncoding:NSUTF8StringEncoding];
+#if OID_HAS_COMMON_CRYPTO
   NSMutableData *sha256Verifier = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
   CC_SHA256(verifierData.bytes, (CC_LONG)verifierData.length, sha256Verifier.mutableBytes);
+#else
+  NSMutableData *sha256Verifier = [NSMutableData dataWithLength:SHA256_DIGEST_LENGTH];
+  SHA256(verifierData.bytes, verifierData.length, sha256Verifier.mutableBytes);
+#endif
   return sha256Verifier;
 }
 
++ (NSData *)HMACSHA256WithKey:(NSData *)key data:(NSData *)data {
+#if OID_HAS_COMMON_CRYPTO
+  NSMutableData *result = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+  CCHmac(kCCHmacAlgSHA256, key.bytes, key.length, data.bytes, data.length, result.mutableBytes);
+#else
+  NSMutableData *result = [NSMutableData dataWithLength:SHA256_DIGEST_LENGTH];
+  unsigned int resultLength = (unsigned int)result.length;
+  HMAC(EVP_sha256(), key.bytes, (int)key.length, data.bytes, data.length, result.mutableBytes,
+       &resultLength);
+#endif
+  return result;
+}
+
++ (nullable NSString *)JWSHeaderPrefixWithHeader:(NSDictionary<NSString *, id> *)header {
+  NSData *headerData = [NSJSONSerialization dataWithJSONObject:header options:0 error:NULL];
+  if (!headerData) {
+    return nil;
+  }
+  return [[self encodeBase64urlNoPadding:headerData] stringByAppendingString:@"."];
+}
+
++ (nullable NSString *)JWSWithHeaderPrefix:(NSString *)headerPrefix
+                                    claims:(NSDictionary<NSString *, id> *)claims
+                                    signer:(id<OIDJWSSigner>)signer
+                                     error:(NSError **_Nullable)error {
+  NSData *claimsData = [NSJSONSerialization dataWithJSONObject:claims options:0 error:error];
+  if (!claimsData) {
+    return nil;
+  }
+  NSString *signingInput =
+      [headerPrefix stringByAppendingString:[self encodeBase64urlNoPadding:claimsData]];
+  NSData *signature =
+      [signer signatureForSigningInput:[signingInput dataUsingEncoding:NSASCIIStringEncoding]
+                                 error:error];
+  if (!signature) {
+    return nil;
+  }
+  return [NSString stringWithFormat:@"%@.%@",
+                                    signingInput,
+                                    [self encodeBase64urlNoPadding:signature]];
+}
+
 @end
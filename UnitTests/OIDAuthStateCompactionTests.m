@@ -0,0 +1,206 @@
+/*! @file OIDAuthStateCompactionTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import <malloc/malloc.h>
+
+#import "OIDServiceDiscoveryTests.h"
+#import "Source/OIDAuthState.h"
+#import "Source/OIDAuthorizationRequest.h"
+#import "Source/OIDAuthorizationResponse.h"
+#import "Source/OIDGrantTypes.h"
+#import "Source/OIDResponseTypes.h"
+#import "Source/OIDServiceConfiguration.h"
+#import "Source/OIDServiceDiscovery.h"
+#import "Source/OIDTokenRequest.h"
+#import "Source/OIDTokenResponse.h"
+
+/*! @var kCompactionBenchmarkStateCount
+    @brief The number of resident states measured by @c testCompactionMemory.
+ */
+static const NSUInteger kCompactionBenchmarkStateCount = 1000;
+
+/*! @class OIDAuthStateCompactionTests
+    @brief Unit tests for @c OIDAuthState.compact.
+ */
+@interface OIDAuthStateCompactionTests : XCTestCase
+@end
+
+@implementation OIDAuthStateCompactionTests
+
+/*! @fn discoveredInstance
+    @brief Creates an auth state whose configuration came from a complete discovery document.
+ */
++ (OIDAuthState *)discoveredInstance {
+  OIDServiceDiscovery *discovery = [[OIDServiceDiscovery alloc]
+      initWithDictionary:[OIDServiceDiscoveryTests completeServiceDiscoveryDictionary]
+                   error:NULL];
+  OIDServiceConfiguration *configuration =
+      [[OIDServiceConfiguration alloc] initWithDiscoveryDocument:discovery];
+  OIDAuthorizationRequest *authorizationRequest =
+      [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
+                                                    clientId:@"ClientID"
+                                                       scope:@"openid email"
+                                                 redirectURL:[NSURL URLWithString:@"app:/"]
+                                                responseType:OIDResponseTypeCode
+                                                       state:@"State"
+                                                codeVerifier:@"CodeVerifier"
+                                        additionalParameters:nil];
+  OIDAuthorizationResponse *authorizationResponse =
+      [[OIDAuthorizationResponse alloc] initWithRequest:authorizationRequest
+                                             parameters:@{ @"code" : @"Code",
+                                                           @"state" : @"State" }];
+  OIDTokenResponse *tokenResponse =
+      [[OIDTokenResponse alloc] initWithRequest:[authorizationResponse tokenExchangeRequest]
+                                     parameters:@{ @"access_token" : @"AccessToken",
+                                                   @"token_type" : @"Bearer",
+                                                   @"expires_in" : @3600,
+                                                   @"id_token" : @"IDToken",
+                                                   @"refresh_token" : @"RefreshToken",
+                                                   @"extra" : @"Extra" }];
+  return [[OIDAuthState alloc] initWithAuthorizationResponse:authorizationResponse
+                                               tokenResponse:tokenResponse];
+}
+
+/*! @fn unarchivedCopyOfState:
+    @brief Returns a copy of a state with its own object graph, as if read from disk.
+ */
++ (OIDAuthState *)unarchivedCopyOfState:(OIDAuthState *)authState {
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:authState];
+  return [NSKeyedUnarchiver unarchiveObjectWithData:data];
+}
+
+/*! @fn bytesInUse
+    @brief The number of bytes currently allocated by this process.
+ */
++ (size_t)bytesInUse {
+  malloc_statistics_t statistics;
+  malloc_zone_statistics(NULL, &statistics);
+  return statistics.size_in_use;
+}
+
+/*! @fn testCompactPreservesState
+    @brief Tests that compaction keeps every property and the refresh request unchanged.
+ */
+- (void)testCompactPreservesState {
+  OIDAuthState *authState = [[self class] discoveredInstance];
+  OIDAuthState *original = [[self class] unarchivedCopyOfState:authState];
+  OIDTokenRequest *originalRefreshRequest = [original tokenRefreshRequest];
+  [authState compact];
+
+  XCTAssertEqualObjects(authState.accessToken, original.accessToken);
+  XCTAssertEqualObjects(authState.accessTokenExpirationDate, original.accessTokenExpirationDate);
+  XCTAssertEqualObjects(authState.idToken, original.idToken);
+  XCTAssertEqualObjects(authState.refreshToken, original.refreshToken);
+  XCTAssertEqualObjects(authState.scope, original.scope);
+  XCTAssertEqual(authState.isAuthorized, original.isAuthorized);
+  XCTAssertEqualObjects(authState.lastTokenResponse.tokenType, @"Bearer");
+  XCTAssertEqualObjects(authState.lastTokenResponse.additionalParameters[@"extra"], @"Extra");
+  XCTAssertEqualObjects(authState.lastAuthorizationResponse.authorizationCode, @"Code");
+  XCTAssertEqualWithAccuracy(authState.lastTokenResponse.accessTokenTimeUntilExpiration,
+                             original.lastTokenResponse.accessTokenTimeUntilExpiration, 1);
+
+  OIDTokenRequest *refreshRequest = [authState tokenRefreshRequest];
+  XCTAssertEqualObjects(refreshRequest.URLRequest.URL, originalRefreshRequest.URLRequest.URL);
+  XCTAssertEqualObjects(refreshRequest.clientID, originalRefreshRequest.clientID);
+  XCTAssertEqualObjects(refreshRequest.scope, originalRefreshRequest.scope);
+  XCTAssertEqualObjects(refreshRequest.redirectURL, originalRefreshRequest.redirectURL);
+
+  // compacting twice changes nothing
+  OIDAuthorizationResponse *compactedResponse = authState.lastAuthorizationResponse;
+  [authState compact];
+  XCTAssertEqual(authState.lastAuthorizationResponse, compactedResponse);
+}
+
+/*! @fn testCompactDropsSpentSecrets
+    @brief Tests that compaction drops the secrets of requests which were already made.
+ */
+- (void)testCompactDropsSpentSecrets {
+  OIDAuthState *authState = [[self class] discoveredInstance];
+  OIDTokenRequest *tokenRequest = authState.lastTokenResponse.request;
+  XCTAssertEqualObjects(tokenRequest.authorizationCode, @"Code");
+  XCTAssertEqualObjects(tokenRequest.codeVerifier, @"CodeVerifier");
+  [authState compact];
+
+  tokenRequest = authState.lastTokenResponse.request;
+  XCTAssertNil(tokenRequest.authorizationCode);
+  XCTAssertNil(tokenRequest.codeVerifier);
+  XCTAssertNil(tokenRequest.refreshToken);
+  XCTAssertEqualObjects(tokenRequest.grantType, OIDGrantTypeAuthorizationCode);
+  XCTAssertEqualObjects(tokenRequest.clientID, @"ClientID");
+  XCTAssertNil(authState.lastAuthorizationResponse.request.codeVerifier);
+  XCTAssertEqualObjects(authState.lastAuthorizationResponse.request.state, @"State");
+}
+
+/*! @fn testCompactSharesConfiguration
+    @brief Tests that compacted states share one configuration without a discovery document.
+ */
+- (void)testCompactSharesConfiguration {
+  OIDAuthState *authState = [[self class] discoveredInstance];
+  OIDAuthState *otherState = [[self class] unarchivedCopyOfState:authState];
+  XCTAssertNotNil(authState.lastAuthorizationResponse.request.configuration.discoveryDocument);
+  [authState compact];
+  [otherState compact];
+
+  OIDServiceConfiguration *configuration =
+      authState.lastAuthorizationResponse.request.configuration;
+  XCTAssertNil(configuration.discoveryDocument);
+  XCTAssertEqual(authState.lastTokenResponse.request.configuration, configuration);
+  XCTAssertEqual(otherState.lastAuthorizationResponse.request.configuration, configuration);
+  XCTAssertEqual(otherState.lastTokenResponse.request.configuration, configuration);
+
+  // a compacted state is archived without the discovery document, and can be compacted again
+  OIDAuthState *unarchived = [[self class] unarchivedCopyOfState:authState];
+  XCTAssertNil(unarchived.lastAuthorizationResponse.request.configuration.discoveryDocument);
+  [unarchived compact];
+  XCTAssertEqual(unarchived.lastAuthorizationResponse.request.configuration, configuration);
+}
+
+/*! @fn testCompactionMemory
+    @brief Tests that compaction reduces the bytes held by each resident state.
+ */
+- (void)testCompactionMemory {
+  OIDAuthState *prototype = [[self class] discoveredInstance];
+  NSMutableArray<OIDAuthState *> *states =
+      [NSMutableArray arrayWithCapacity:kCompactionBenchmarkStateCount];
+
+  size_t baseline = [[self class] bytesInUse];
+  @autoreleasepool {
+    for (NSUInteger i = 0; i < kCompactionBenchmarkStateCount; i++) {
+      [states addObject:[[self class] unarchivedCopyOfState:prototype]];
+    }
+  }
+  size_t loaded = [[self class] bytesInUse];
+  @autoreleasepool {
+    for (OIDAuthState *authState in states) {
+      [authState compact];
+    }
+  }
+  size_t compacted = [[self class] bytesInUse];
+
+  double bytesPerState = (double)(loaded - baseline) / kCompactionBenchmarkStateCount;
+  double compactedBytesPerState =
+      ((double)compacted - (double)baseline) / kCompactionBenchmarkStateCount;
+  XCTAssertGreaterThan(bytesPerState, 0);
+  XCTAssertLessThan(compactedBytesPerState, bytesPerState,
+                    @"bytes per state: %.0f, compacted: %.0f",
+                    bytesPerState,
+                    compactedBytesPerState);
+}
+
+@end
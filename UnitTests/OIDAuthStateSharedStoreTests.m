@@ -0,0 +1,283 @@
+/*! @file OIDAuthStateSharedStoreTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/file.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#import "OIDAuthorizationResponseTests.h"
+#import "OIDAuthStateTests.h"
+#import "OIDTokenRequestTests.h"
+#import "Source/OIDAuthState.h"
+#import "Source/OIDAuthStateSharedStore.h"
+#import "Source/OIDTokenResponse.h"
+
+/*! @var kSharedAccessTokenTestValue
+    @brief Access token obtained by the simulated "other process".
+ */
+static NSString *const kSharedAccessTokenTestValue = @"shared_access_token";
+
+/*! @var kSharedRefreshTokenTestValue
+    @brief Rotated refresh token obtained by the simulated "other process".
+ */
+static NSString *const kSharedRefreshTokenTestValue = @"shared_refresh_token";
+
+/*! @var kStagingFileSuffix
+    @brief Suffix of the file a forked process moves into place as its refreshed state.
+ */
+static NSString *const kStagingFileSuffix = @".staging";
+
+/*! @class OIDAuthStateSharedStoreTests
+    @brief Unit tests for @c OIDAuthStateSharedStore.
+    @discussion Each store instance opens its own lock file description, so two stores for the same
+        file contend for the lock in the same way two processes do.
+        @c testRefreshIsSingleFlightAcrossProcesses checks this against a real forked process.
+ */
+@interface OIDAuthStateSharedStoreTests : XCTestCase
+@end
+
+@implementation OIDAuthStateSharedStoreTests {
+  /*! @var _fileURL
+      @brief A unique file location for the test's store.
+   */
+  NSURL *_fileURL;
+}
+
+- (void)setUp {
+  [super setUp];
+  NSString *path =
+      [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+  _fileURL = [NSURL fileURLWithPath:path];
+}
+
+- (void)tearDown {
+  NSFileManager *fileManager = [NSFileManager defaultManager];
+  [fileManager removeItemAtURL:_fileURL error:NULL];
+  [fileManager removeItemAtPath:[_fileURL.path stringByAppendingString:@".lock"] error:NULL];
+  [fileManager removeItemAtPath:[_fileURL.path stringByAppendingString:kStagingFileSuffix]
+                          error:NULL];
+  _fileURL = nil;
+  [super tearDown];
+}
+
+/*! @fn freshAuthState
+    @brief Creates an auth state as if another process had just refreshed it.
+ */
++ (OIDAuthState *)freshAuthState {
+  OIDTokenResponse *tokenResponse =
+      [[OIDTokenResponse alloc] initWithRequest:[OIDTokenRequestTests testInstance]
+                                     parameters:@{
+        @"access_token" : kSharedAccessTokenTestValue,
+        @"expires_in" : @3600,
+        @"token_type" : @"Bearer",
+        @"refresh_token" : kSharedRefreshTokenTestValue,
+      }];
+  return [[OIDAuthState alloc]
+      initWithAuthorizationResponse:[OIDAuthorizationResponseTests testInstanceCodeFlow]
+                      tokenResponse:tokenResponse];
+}
+
+/*! @fn testReadWrite
+    @brief Tests that a written state can be read back by another store.
+ */
+- (void)testReadWrite {
+  OIDAuthStateSharedStore *writer = [[OIDAuthStateSharedStore alloc] initWithFileURL:_fileURL];
+  OIDAuthStateSharedStore *reader = [[OIDAuthStateSharedStore alloc] initWithFileURL:_fileURL];
+  XCTAssertNil([reader readAuthState]);
+
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  NSError *error;
+  XCTAssert([writer writeAuthState:authState error:&error]);
+  XCTAssertNil(error);
+
+  OIDAuthState *readState = [reader readAuthState];
+  XCTAssertNotNil(readState);
+  XCTAssertEqualObjects(readState.refreshToken, authState.refreshToken);
+  XCTAssertEqualObjects(readState.scope, authState.scope);
+}
+
+/*! @fn testRefreshLockIsExclusive
+    @brief Tests that only one store at a time can hold the refresh lock for a file.
+ */
+- (void)testRefreshLockIsExclusive {
+  OIDAuthStateSharedStore *storeA = [[OIDAuthStateSharedStore alloc] initWithFileURL:_fileURL];
+  OIDAuthStateSharedStore *storeB = [[OIDAuthStateSharedStore alloc] initWithFileURL:_fileURL];
+
+  XCTAssert([storeA tryLockForRefresh]);
+  XCTAssertFalse([storeB tryLockForRefresh]);
+  // the same store is also exclusive within a process
+  XCTAssertFalse([storeA tryLockForRefresh]);
+
+  [storeA unlockForRefresh];
+  XCTAssert([storeB tryLockForRefresh]);
+  [storeB unlockForRefresh];
+}
+
+/*! @fn testBlockedRefreshLockIsAcquiredAfterRelease
+    @brief Tests that a blocking lock request waits for the holder and then succeeds.
+ */
+- (void)testBlockedRefreshLockIsAcquiredAfterRelease {
+  OIDAuthStateSharedStore *storeA = [[OIDAuthStateSharedStore alloc] initWithFileURL:_fileURL];
+  OIDAuthStateSharedStore *storeB = [[OIDAuthStateSharedStore alloc] initWithFileURL:_fileURL];
+  XCTAssert([storeA tryLockForRefresh]);
+
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Lock should be acquired."];
+  __block BOOL unlocked = NO;
+  dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    XCTAssert([storeB lockForRefresh]);
+    XCTAssert(unlocked);
+    [storeB unlockForRefresh];
+    [expectation fulfill];
+  });
+
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.2 * NSEC_PER_SEC)),
+                 dispatch_get_main_queue(), ^{
+    unlocked = YES;
+    [storeA unlockForRefresh];
+  });
+  [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+/*! @fn testAdoptsTokensRefreshedByAnotherProcess
+    @brief Tests that an auth state with an expiring token adopts the fresh tokens written to the
+        shared store, instead of making its own refresh request.
+ */
+- (void)testAdoptsTokensRefreshedByAnotherProcess {
+  OIDAuthStateSharedStore *otherProcessStore =
+      [[OIDAuthStateSharedStore alloc] initWithFileURL:_fileURL];
+  XCTAssert([otherProcessStore writeAuthState:[[self class] freshAuthState] error:NULL]);
+
+  // the test instance's access token expires within the refresh tolerance
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  authState.sharedStore = [[OIDAuthStateSharedStore alloc] initWithFileURL:_fileURL];
+
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Action should be called."];
+  [authState withFreshTokensPerformAction:^(NSString *_Nullable accessToken,
+                                            NSString *_Nullable idToken,
+                                            NSError *_Nullable error) {
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(accessToken, kSharedAccessTokenTestValue);
+    [expectation fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:2 handler:nil];
+
+  XCTAssertEqualObjects(authState.refreshToken, kSharedRefreshTokenTestValue);
+  // the lock is released once the tokens were adopted
+  XCTAssert([otherProcessStore tryLockForRefresh]);
+  [otherProcessStore unlockForRefresh];
+}
+
+/*! @fn testRefreshIsSingleFlightAcrossProcesses
+    @brief Tests that a refresh waits for a forked process holding the refresh lock, and adopts the
+        tokens it stored instead of making its own refresh request.
+    @discussion The child only makes async-signal-safe calls: it takes the @c flock(2) lock
+        directly, and publishes a state archived by the parent with @c rename(2), as the store's
+        atomic writes do. Exiting releases its lock.
+ */
+- (void)testRefreshIsSingleFlightAcrossProcesses {
+  NSString *stagingPath = [_fileURL.path stringByAppendingString:kStagingFileSuffix];
+  OIDAuthStateSharedStore *stagingStore =
+      [[OIDAuthStateSharedStore alloc] initWithFileURL:[NSURL fileURLWithPath:stagingPath]];
+  XCTAssert([stagingStore writeAuthState:[[self class] freshAuthState] error:NULL]);
+  const char *lockPath =
+      [_fileURL.path stringByAppendingString:@".lock"].fileSystemRepresentation;
+  const char *stagingFile = stagingPath.fileSystemRepresentation;
+  const char *storeFile = _fileURL.path.fileSystemRepresentation;
+
+  int lockedPipe[2];
+  int releasePipe[2];
+  if (pipe(lockedPipe) != 0) {
+    XCTFail(@"pipe failed: %d", errno);
+    return;
+  }
+  if (pipe(releasePipe) != 0) {
+    XCTFail(@"pipe failed: %d", errno);
+    close(lockedPipe[0]);
+    close(lockedPipe[1]);
+    return;
+  }
+  pid_t child = fork();
+  if (child == -1) {
+    // there is no process to hold the lock, so nothing below could be waited on or checked
+    XCTFail(@"fork failed: %d", errno);
+    close(lockedPipe[0]);
+    close(lockedPipe[1]);
+    close(releasePipe[0]);
+    close(releasePipe[1]);
+    return;
+  }
+  if (child == 0) {
+    char byte = 0;
+    int lockFile = open(lockPath, O_RDWR | O_CREAT, 0600);
+    if (lockFile < 0 || flock(lockFile, LOCK_EX) != 0
+        || write(lockedPipe[1], &byte, 1) != 1
+        || read(releasePipe[0], &byte, 1) != 1
+        || rename(stagingFile, storeFile) != 0) {
+      _exit(1);
+    }
+    _exit(0);
+  }
+  close(lockedPipe[1]);
+  close(releasePipe[0]);
+  char byte = 0;
+  XCTAssertEqual(read(lockedPipe[0], &byte, 1), 1);
+  close(lockedPipe[0]);
+
+  // the child's lock excludes this process
+  OIDAuthStateSharedStore *probeStore = [[OIDAuthStateSharedStore alloc] initWithFileURL:_fileURL];
+  XCTAssertFalse([probeStore tryLockForRefresh]);
+
+  // the test instance's access token expires within the refresh tolerance
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  authState.sharedStore = [[OIDAuthStateSharedStore alloc] initWithFileURL:_fileURL];
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Action should be called."];
+  __block BOOL released = NO;
+  [authState withFreshTokensPerformAction:^(NSString *_Nullable accessToken,
+                                            NSString *_Nullable idToken,
+                                            NSError *_Nullable error) {
+    XCTAssert(released);
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(accessToken, kSharedAccessTokenTestValue);
+    [expectation fulfill];
+  }];
+
+  // lets the child finish its "refresh" only once the refresh above is waiting for the lock
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.2 * NSEC_PER_SEC)),
+                 dispatch_get_main_queue(), ^{
+    released = YES;
+    char releaseByte = 0;
+    XCTAssertEqual(write(releasePipe[1], &releaseByte, 1), 1);
+    close(releasePipe[1]);
+  });
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+
+  int status = 0;
+  XCTAssertEqual(waitpid(child, &status, 0), child);
+  XCTAssert(WIFEXITED(status));
+  XCTAssertEqual(WEXITSTATUS(status), 0);
+  XCTAssertEqualObjects(authState.refreshToken, kSharedRefreshTokenTestValue);
+  XCTAssert([probeStore tryLockForRefresh]);
+  [probeStore unlockForRefresh];
+}
+
+@end
@@ -0,0 +1,192 @@
+/*! @file OIDAuthStateSimulation.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @class OIDAuthStateSimulationPolicy
+    @brief The refresh settings of the @c OIDAuthState under simulation. Defaults to the settings
+        of a new @c OIDAuthState.
+ */
+@interface OIDAuthStateSimulationPolicy : NSObject
+
+/*! @property name
+    @brief A name for the policy in reports.
+ */
+@property(nonatomic, copy) NSString *name;
+
+/*! @property tokenRefreshLeadTime
+    @brief The state's @c tokenRefreshLeadTime.
+ */
+@property(nonatomic, assign) NSTimeInterval tokenRefreshLeadTime;
+
+/*! @property staleTokenGracePeriod
+    @brief The state's @c staleTokenGracePeriod.
+ */
+@property(nonatomic, assign) NSTimeInterval staleTokenGracePeriod;
+
+/*! @property staleTokenRetryInitialInterval
+    @brief The state's @c staleTokenRetryInitialInterval.
+ */
+@property(nonatomic, assign) NSTimeInterval staleTokenRetryInitialInterval;
+
+/*! @property staleTokenRetryMaximumInterval
+    @brief The state's @c staleTokenRetryMaximumInterval.
+ */
+@property(nonatomic, assign) NSTimeInterval staleTokenRetryMaximumInterval;
+
+/*! @fn initWithName:
+    @brief Creates a policy with the default settings.
+ */
+- (instancetype)initWithName:(NSString *)name;
+
+@end
+
+/*! @class OIDAuthStateSimulationScenario
+    @brief The traffic and token endpoint behaviour a policy is simulated against.
+ */
+@interface OIDAuthStateSimulationScenario : NSObject
+
+/*! @property duration
+    @brief The simulated time, in seconds. Defaults to one day.
+ */
+@property(nonatomic, assign) NSTimeInterval duration;
+
+/*! @property meanActionInterval
+    @brief The mean number of seconds between calls to @c withFreshTokensPerformAction:, which
+        arrive as a Poisson process. Defaults to 60.
+ */
+@property(nonatomic, assign) NSTimeInterval meanActionInterval;
+
+/*! @property tokenEndpointLatency
+    @brief The minimum number of seconds between a token request and its response. Defaults to
+        0.2.
+ */
+@property(nonatomic, assign) NSTimeInterval tokenEndpointLatency;
+
+/*! @property tokenEndpointLatencyJitter
+    @brief The maximum number of seconds added to @c tokenEndpointLatency, uniformly
+        distributed. Defaults to 0.
+ */
+@property(nonatomic, assign) NSTimeInterval tokenEndpointLatencyJitter;
+
+/*! @property tokenEndpointErrorRate
+    @brief The probability that a token request fails with an HTTP 503. Defaults to 0.
+ */
+@property(nonatomic, assign) double tokenEndpointErrorRate;
+
+/*! @property accessTokenLifetime
+    @brief The @c expires_in of issued access tokens. Defaults to an hour.
+ */
+@property(nonatomic, assign) NSTimeInterval accessTokenLifetime;
+
+/*! @property seed
+    @brief Seeds the random traffic, latency and errors, so runs are reproducible. Defaults to 1.
+ */
+@property(nonatomic, assign) uint64_t seed;
+
+@end
+
+/*! @class OIDAuthStateSimulationReport
+    @brief What happened when a policy was simulated.
+ */
+@interface OIDAuthStateSimulationReport : NSObject
+
+/*! @property policy
+    @brief The simulated policy.
+ */
+@property(nonatomic, readonly) OIDAuthStateSimulationPolicy *policy;
+
+/*! @property actionCount
+    @brief The number of calls to @c withFreshTokensPerformAction: whose action was performed.
+ */
+@property(nonatomic, readonly) NSUInteger actionCount;
+
+/*! @property tokenRequestCount
+    @brief The number of token refresh requests made.
+ */
+@property(nonatomic, readonly) NSUInteger tokenRequestCount;
+
+/*! @property failedTokenRequestCount
+    @brief The number of token refresh requests which failed.
+ */
+@property(nonatomic, readonly) NSUInteger failedTokenRequestCount;
+
+/*! @property criticalPathRefreshCount
+    @brief The number of actions which had to wait for a token refresh.
+ */
+@property(nonatomic, readonly) NSUInteger criticalPathRefreshCount;
+
+/*! @property expiredTokenUseCount
+    @brief The number of actions performed with an access token the server considers expired.
+ */
+@property(nonatomic, readonly) NSUInteger expiredTokenUseCount;
+
+/*! @property failedActionCount
+    @brief The number of actions performed with an error instead of tokens.
+ */
+@property(nonatomic, readonly) NSUInteger failedActionCount;
+
+/*! @property criticalPathRefreshRate
+    @brief The fraction of actions which had to wait for a token refresh.
+ */
+@property(nonatomic, readonly) double criticalPathRefreshRate;
+
+/*! @property expiredTokenUseRate
+    @brief The fraction of actions performed with an expired access token.
+ */
+@property(nonatomic, readonly) double expiredTokenUseRate;
+
+@end
+
+/*! @class OIDAuthStateSimulation
+    @brief Runs an @c OIDAuthState against a virtual clock and a simulated token endpoint, to
+        compare refresh policies.
+    @discussion While a policy runs, the shared @c OIDClock and @c OIDHTTPClient are replaced.
+        Events (calls to @c withFreshTokensPerformAction:, token endpoint responses and the
+        state's timers) are processed in virtual time order, and the main queue is drained after
+        each one, so a day of traffic takes a fraction of a second. Must be run on the main
+        thread.
+ */
+@interface OIDAuthStateSimulation : NSObject
+
+/*! @property scenario
+    @brief The scenario policies are simulated against.
+ */
+@property(nonatomic, readonly) OIDAuthStateSimulationScenario *scenario;
+
+/*! @fn initWithScenario:
+    @brief Creates a simulation of the given scenario.
+ */
+- (instancetype)initWithScenario:(OIDAuthStateSimulationScenario *)scenario;
+
+/*! @fn runPolicy:
+    @brief Simulates the scenario with a new @c OIDAuthState using the given policy.
+ */
+- (OIDAuthStateSimulationReport *)runPolicy:(OIDAuthStateSimulationPolicy *)policy;
+
+/*! @fn runPolicies:
+    @brief Simulates the scenario with each policy, with the same traffic for each.
+ */
+- (NSArray<OIDAuthStateSimulationReport *> *)runPolicies:
+    (NSArray<OIDAuthStateSimulationPolicy *> *)policies;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,561 @@
+/*! @file OIDAuthStateSimulation.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDAuthStateSimulation.h"
+
+#import "Source/OIDAuthState.h"
+#import "Source/OIDAuthorizationRequest.h"
+#import "Source/OIDAuthorizationResponse.h"
+#import "Source/OIDCancellable.h"
+#import "Source/OIDClock.h"
+#import "Source/OIDDefines.h"
+#import "Source/OIDHTTPClient.h"
+#import "Source/OIDResponseTypes.h"
+#import "Source/OIDServiceConfiguration.h"
+#import "Source/OIDTokenRequest.h"
+#import "Source/OIDTokenResponse.h"
+
+/*! @var kSimulatedTokenEndpoint
+    @brief The token endpoint of simulated auth states, which is never actually contacted.
+ */
+static NSString *const kSimulatedTokenEndpoint = @"https://simulated.invalid/token";
+
+/*! @var kSimulationStartDate
+    @brief The wall clock time at which simulations start, in seconds since the reference date.
+ */
+static NSTimeInterval const kSimulationStartDate = 800000000;
+
+/*! @var kSimulationStartUptime
+    @brief The monotonic time at which simulations start.
+ */
+static NSTimeInterval const kSimulationStartUptime = 1000;
+
+/*! @var kMainQueueDrainRounds
+    @brief The number of times the main queue is drained after each event. Each round runs the
+        blocks the previous one dispatched, and a token response takes two hops to reach the
+        auth state and one more to reach the action.
+ */
+static NSUInteger const kMainQueueDrainRounds = 4;
+
+/*! @fn OIDSimulationRandom
+    @brief Returns a uniformly distributed number in [0, 1) from an xorshift64* generator.
+    @param state The generator's state, which must not be zero.
+ */
+static double OIDSimulationRandom(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+  return (double)((x * 0x2545F4914F6CDD1DULL) >> 11) / (double)(1ULL << 53);
+}
+
+/*! @fn OIDSimulationRandomState
+    @brief Returns a non-zero generator state for the given seed and stream.
+ */
+static uint64_t OIDSimulationRandomState(uint64_t seed, uint64_t stream) {
+  uint64_t state = (seed + 1) * 0x9E3779B97F4A7C15ULL ^ (stream + 1) * 0xBF58476D1CE4E5B9ULL;
+  return state ?: 1;
+}
+
+#pragma mark - Simulated Clock
+
+/*! @class OIDSimulatedEvent
+    @brief A block scheduled on the simulated clock.
+ */
+@interface OIDSimulatedEvent : NSObject
+
+/*! @property time
+    @brief The number of simulated seconds since the start at which the block runs.
+ */
+@property(nonatomic, assign) NSTimeInterval time;
+
+/*! @property sequence
+    @brief Orders events scheduled for the same time by when they were scheduled.
+ */
+@property(nonatomic, assign) NSUInteger sequence;
+
+/*! @property block
+    @brief The block to run.
+ */
+@property(nonatomic, copy) dispatch_block_t block;
+
+@end
+
+@implementation OIDSimulatedEvent
+@end
+
+/*! @class OIDSimulatedClock
+    @brief A clock which only advances when the simulation runs its next event.
+ */
+@interface OIDSimulatedClock : OIDClock
+
+/*! @property elapsed
+    @brief The number of simulated seconds since the start.
+ */
+@property(nonatomic, readonly) NSTimeInterval elapsed;
+
+/*! @property processedEventCount
+    @brief The number of events run so far.
+ */
+@property(nonatomic, readonly) NSUInteger processedEventCount;
+
+/*! @fn scheduleBlock:atTime:
+    @brief Schedules a block to run once the simulation reaches the given time.
+ */
+- (void)scheduleBlock:(dispatch_block_t)block atTime:(NSTimeInterval)time;
+
+/*! @fn runNextEventBefore:
+    @brief Advances to the next event and runs it, if it is due before the given time.
+    @return Whether an event was run.
+ */
+- (BOOL)runNextEventBefore:(NSTimeInterval)endTime;
+
+/*! @fn removeAllEvents
+    @brief Drops the events which haven't run.
+ */
+- (void)removeAllEvents;
+
+@end
+
+@implementation OIDSimulatedClock {
+  /*! @var _events
+      @brief The scheduled events, ordered by time then sequence.
+   */
+  NSMutableArray<OIDSimulatedEvent *> *_events;
+
+  /*! @var _nextSequence
+      @brief The sequence number of the next scheduled event.
+   */
+  NSUInteger _nextSequence;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _events = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (NSDate *)now {
+  return [NSDate dateWithTimeIntervalSinceReferenceDate:kSimulationStartDate + _elapsed];
+}
+
+- (NSTimeInterval)monotonicTimeInterval {
+  return kSimulationStartUptime + _elapsed;
+}
+
+- (void)performAfterDelay:(NSTimeInterval)delay block:(dispatch_block_t)block {
+  [self scheduleBlock:block atTime:_elapsed + MAX(delay, 0)];
+}
+
+- (void)scheduleBlock:(dispatch_block_t)block atTime:(NSTimeInterval)time {
+  OIDSimulatedEvent *event = [[OIDSimulatedEvent alloc] init];
+  event.time = MAX(time, _elapsed);
+  event.sequence = _nextSequence++;
+  event.block = block;
+  NSUInteger index = [_events indexOfObject:event
+                              inSortedRange:NSMakeRange(0, _events.count)
+                                    options:NSBinarySearchingInsertionIndex
+                            usingComparator:^NSComparisonResult(OIDSimulatedEvent *a,
+                                                                OIDSimulatedEvent *b) {
+    if (a.time != b.time) {
+      return a.time < b.time ? NSOrderedAscending : NSOrderedDescending;
+    }
+    return a.sequence < b.sequence ? NSOrderedAscending
+        : a.sequence > b.sequence ? NSOrderedDescending : NSOrderedSame;
+  }];
+  [_events insertObject:event atIndex:index];
+}
+
+- (BOOL)runNextEventBefore:(NSTimeInterval)endTime {
+  OIDSimulatedEvent *event = _events.firstObject;
+  if (!event || event.time >= endTime) {
+    return NO;
+  }
+  [_events removeObjectAtIndex:0];
+  _elapsed = event.time;
+  _processedEventCount++;
+  event.block();
+  return YES;
+}
+
+- (void)removeAllEvents {
+  [_events removeAllObjects];
+}
+
+@end
+
+#pragma mark - Simulated Token Endpoint
+
+/*! @class OIDSimulatedRequest
+    @brief The handle of a simulated token request.
+ */
+@interface OIDSimulatedRequest : NSObject <OIDCancellable>
+
+/*! @property cancelled
+    @brief Whether the request was cancelled, in which case its response is dropped.
+ */
+@property(nonatomic, readonly) BOOL cancelled;
+
+@end
+
+@implementation OIDSimulatedRequest
+
+- (void)cancel {
+  _cancelled = YES;
+}
+
+@end
+
+/*! @class OIDSimulatedTokenEndpoint
+    @brief An HTTP client which answers token requests on the simulated clock, issuing access
+        tokens with the scenario's lifetime or failing with the scenario's error rate.
+ */
+@interface OIDSimulatedTokenEndpoint : OIDHTTPClient
+
+/*! @property requestCount
+    @brief The number of requests made.
+ */
+@property(nonatomic, readonly) NSUInteger requestCount;
+
+/*! @property failedRequestCount
+    @brief The number of requests answered with an error.
+ */
+@property(nonatomic, readonly) NSUInteger failedRequestCount;
+
+/*! @fn initWithClock:scenario:
+    @brief Creates an endpoint answering on the given clock.
+ */
+- (instancetype)initWithClock:(OIDSimulatedClock *)clock
+                     scenario:(OIDAuthStateSimulationScenario *)scenario;
+
+/*! @fn issueTokenResponseParameters
+    @brief Issues an access token as of now, without a request.
+ */
+- (NSDictionary<NSString *, NSObject<NSCopying> *> *)issueTokenResponseParameters;
+
+/*! @fn isAccessTokenExpired:
+    @brief Whether the server considers the given access token expired as of now.
+ */
+- (BOOL)isAccessTokenExpired:(NSString *)accessToken;
+
+@end
+
+@implementation OIDSimulatedTokenEndpoint {
+  /*! @var _clock
+      @brief The clock requests are answered on.
+   */
+  OIDSimulatedClock *_clock;
+
+  /*! @var _scenario
+      @brief The latency, error rate and token lifetime of the endpoint.
+   */
+  OIDAuthStateSimulationScenario *_scenario;
+
+  /*! @var _randomState
+      @brief Draws latencies and failures.
+   */
+  uint64_t _randomState;
+
+  /*! @var _accessTokenExpiries
+      @brief The time at which each issued access token expires, by token.
+   */
+  NSMutableDictionary<NSString *, NSNumber *> *_accessTokenExpiries;
+}
+
+- (instancetype)initWithClock:(OIDSimulatedClock *)clock
+                     scenario:(OIDAuthStateSimulationScenario *)scenario {
+  self = [super init];
+  if (self) {
+    _clock = clock;
+    _scenario = scenario;
+    _randomState = OIDSimulationRandomState(scenario.seed, 1);
+    _accessTokenExpiries = [NSMutableDictionary dictionary];
+  }
+  return self;
+}
+
+- (NSDictionary<NSString *, NSObject<NSCopying> *> *)issueTokenResponseParameters {
+  return [self issueTokenResponseParametersAtTime:_clock.elapsed];
+}
+
+/*! @fn issueTokenResponseParametersAtTime:
+    @brief Issues an access token whose lifetime starts at the given time.
+ */
+- (NSDictionary<NSString *, NSObject<NSCopying> *> *)issueTokenResponseParametersAtTime:
+    (NSTimeInterval)time {
+  NSString *accessToken =
+      [NSString stringWithFormat:@"access-%lu", (unsigned long)_accessTokenExpiries.count];
+  _accessTokenExpiries[accessToken] = @(time + _scenario.accessTokenLifetime);
+  return @{ @"access_token" : accessToken,
+            @"token_type" : @"Bearer",
+            @"expires_in" : @(_scenario.accessTokenLifetime),
+            @"refresh_token" : @"RefreshToken" };
+}
+
+- (BOOL)isAccessTokenExpired:(NSString *)accessToken {
+  NSNumber *expiry = _accessTokenExpiries[accessToken];
+  return !expiry || expiry.doubleValue <= _clock.elapsed;
+}
+
+- (id<OIDCancellable>)performRequest:(NSURLRequest *)request
+                        endpointType:(OIDHTTPEndpointType)endpointType
+                            priority:(OIDRequestPriority)priority
+                            deadline:(nullable NSDate *)deadline
+                          completion:(OIDHTTPCompletion)completion {
+  _requestCount++;
+  NSTimeInterval latency = _scenario.tokenEndpointLatency
+      + _scenario.tokenEndpointLatencyJitter * OIDSimulationRandom(&_randomState);
+  BOOL fails = OIDSimulationRandom(&_randomState) < _scenario.tokenEndpointErrorRate;
+  NSInteger statusCode = 200;
+  NSData *body;
+  if (fails) {
+    _failedRequestCount++;
+    statusCode = 503;
+    body = [@"{}" dataUsingEncoding:NSUTF8StringEncoding];
+  } else {
+    // the server issues the token halfway through the round trip, so the client, which counts the
+    // lifetime from when the response arrives, thinks it expires later than it does
+    NSDictionary *parameters =
+        [self issueTokenResponseParametersAtTime:_clock.elapsed + latency / 2];
+    body = [NSJSONSerialization dataWithJSONObject:parameters options:0 error:NULL];
+  }
+  NSHTTPURLResponse *response =
+      [[NSHTTPURLResponse alloc] initWithURL:request.URL
+                                  statusCode:statusCode
+                                 HTTPVersion:@"HTTP/1.1"
+                                headerFields:@{ @"Content-Type" : @"application/json" }];
+  OIDSimulatedRequest *handle = [[OIDSimulatedRequest alloc] init];
+  [_clock scheduleBlock:^() {
+    if (!handle.cancelled) {
+      completion(body, response, nil);
+    }
+  } atTime:_clock.elapsed + latency];
+  return handle;
+}
+
+@end
+
+#pragma mark - Policy, Scenario and Report
+
+@implementation OIDAuthStateSimulationPolicy
+
+- (instancetype)init {
+  return [self initWithName:@"default"];
+}
+
+- (instancetype)initWithName:(NSString *)name {
+  self = [super init];
+  if (self) {
+    _name = [name copy];
+    // the documented defaults of OIDAuthState
+    _tokenRefreshLeadTime = 60;
+    _staleTokenRetryInitialInterval = 5;
+    _staleTokenRetryMaximumInterval = 60;
+  }
+  return self;
+}
+
+@end
+
+@implementation OIDAuthStateSimulationScenario
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _duration = 24 * 60 * 60;
+    _meanActionInterval = 60;
+    _tokenEndpointLatency = 0.2;
+    _accessTokenLifetime = 60 * 60;
+    _seed = 1;
+  }
+  return self;
+}
+
+@end
+
+@interface OIDAuthStateSimulationReport ()
+
+@property(nonatomic, readwrite) OIDAuthStateSimulationPolicy *policy;
+@property(nonatomic, readwrite) NSUInteger actionCount;
+@property(nonatomic, readwrite) NSUInteger tokenRequestCount;
+@property(nonatomic, readwrite) NSUInteger failedTokenRequestCount;
+@property(nonatomic, readwrite) NSUInteger criticalPathRefreshCount;
+@property(nonatomic, readwrite) NSUInteger expiredTokenUseCount;
+@property(nonatomic, readwrite) NSUInteger failedActionCount;
+
+@end
+
+@implementation OIDAuthStateSimulationReport
+
+- (double)criticalPathRefreshRate {
+  return _actionCount ? (double)_criticalPathRefreshCount / _actionCount : 0;
+}
+
+- (double)expiredTokenUseRate {
+  return _actionCount ? (double)_expiredTokenUseCount / _actionCount : 0;
+}
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, policy: %@, actions: %lu, token requests: %lu "
+                                     "(%lu failed), critical path refreshes: %.3f%%, expired "
+                                     "token uses: %.3f%%, failed actions: %lu>",
+                                    NSStringFromClass([self class]),
+                                    self,
+                                    _policy.name,
+                                    (unsigned long)_actionCount,
+                                    (unsigned long)_tokenRequestCount,
+                                    (unsigned long)_failedTokenRequestCount,
+                                    self.criticalPathRefreshRate * 100,
+                                    self.expiredTokenUseRate * 100,
+                                    (unsigned long)_failedActionCount];
+}
+
+@end
+
+#pragma mark - Simulation
+
+@implementation OIDAuthStateSimulation
+
+- (nullable instancetype)init
+    OID_UNAVAILABLE_USE_INITIALIZER(@selector(initWithScenario:));
+
+- (instancetype)initWithScenario:(OIDAuthStateSimulationScenario *)scenario {
+  self = [super init];
+  if (self) {
+    _scenario = scenario;
+  }
+  return self;
+}
+
+- (NSArray<OIDAuthStateSimulationReport *> *)runPolicies:
+    (NSArray<OIDAuthStateSimulationPolicy *> *)policies {
+  NSMutableArray<OIDAuthStateSimulationReport *> *reports = [NSMutableArray array];
+  for (OIDAuthStateSimulationPolicy *policy in policies) {
+    [reports addObject:[self runPolicy:policy]];
+  }
+  return reports;
+}
+
+- (OIDAuthStateSimulationReport *)runPolicy:(OIDAuthStateSimulationPolicy *)policy {
+  NSAssert([NSThread isMainThread], @"Simulations must run on the main thread.");
+  OIDSimulatedClock *clock = [[OIDSimulatedClock alloc] init];
+  OIDSimulatedTokenEndpoint *endpoint =
+      [[OIDSimulatedTokenEndpoint alloc] initWithClock:clock scenario:_scenario];
+  OIDClock *originalClock = [OIDClock sharedClock];
+  OIDHTTPClient *originalClient = [OIDHTTPClient sharedClient];
+  [OIDClock setSharedClock:clock];
+  [OIDHTTPClient setSharedClient:endpoint];
+
+  OIDAuthState *authState = [self authStateWithEndpoint:endpoint];
+  authState.tokenRefreshLeadTime = policy.tokenRefreshLeadTime;
+  authState.staleTokenGracePeriod = policy.staleTokenGracePeriod;
+  authState.staleTokenRetryInitialInterval = policy.staleTokenRetryInitialInterval;
+  authState.staleTokenRetryMaximumInterval = policy.staleTokenRetryMaximumInterval;
+
+  OIDAuthStateSimulationReport *report = [[OIDAuthStateSimulationReport alloc] init];
+  report.policy = policy;
+  __block uint64_t randomState = OIDSimulationRandomState(_scenario.seed, 0);
+  NSTimeInterval meanActionInterval = _scenario.meanActionInterval;
+  // each arrival schedules the next, so it refers to itself weakly
+  __block __weak dispatch_block_t weakArrival;
+  dispatch_block_t arrival = ^() {
+    NSUInteger arrivalEvent = clock.processedEventCount;
+    NSUInteger requestCount = endpoint.requestCount;
+    [authState withFreshTokensPerformAction:^(NSString *_Nullable accessToken,
+                                              NSString *_Nullable idToken,
+                                              NSError *_Nullable error) {
+      report.actionCount++;
+      // the action waited for a refresh if it was performed by a later event, or this one made a
+      // token request
+      if (clock.processedEventCount != arrivalEvent || endpoint.requestCount != requestCount) {
+        report.criticalPathRefreshCount++;
+      }
+      if (!accessToken || error) {
+        report.failedActionCount++;
+      } else if ([endpoint isAccessTokenExpired:accessToken]) {
+        report.expiredTokenUseCount++;
+      }
+    }];
+    // exponentially distributed intervals make the arrivals a Poisson process
+    NSTimeInterval interval = -log(1 - OIDSimulationRandom(&randomState)) * meanActionInterval;
+    [clock scheduleBlock:weakArrival atTime:clock.elapsed + interval];
+  };
+  weakArrival = arrival;
+  [clock scheduleBlock:arrival atTime:0];
+
+  while ([clock runNextEventBefore:_scenario.duration]) {
+    [self drainMainQueue];
+  }
+  // the events left over refer to the auth state and the clock
+  [clock removeAllEvents];
+
+  [OIDHTTPClient setSharedClient:originalClient];
+  [OIDClock setSharedClock:originalClock];
+  report.tokenRequestCount = endpoint.requestCount;
+  report.failedTokenRequestCount = endpoint.failedRequestCount;
+  return report;
+}
+
+/*! @fn authStateWithEndpoint:
+    @brief Creates an auth state whose tokens were just issued by the given endpoint.
+ */
+- (OIDAuthState *)authStateWithEndpoint:(OIDSimulatedTokenEndpoint *)endpoint {
+  NSURL *tokenEndpoint = [NSURL URLWithString:kSimulatedTokenEndpoint];
+  OIDServiceConfiguration *configuration =
+      [[OIDServiceConfiguration alloc] initWithAuthorizationEndpoint:tokenEndpoint
+                                                       tokenEndpoint:tokenEndpoint];
+  OIDAuthorizationRequest *authorizationRequest =
+      [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
+                                                    clientId:@"ClientID"
+                                                       scope:nil
+                                                 redirectURL:[NSURL URLWithString:@"app:/"]
+                                                responseType:OIDResponseTypeCode
+                                                       state:@"State"
+                                                codeVerifier:nil
+                                        additionalParameters:nil];
+  OIDAuthorizationResponse *authorizationResponse =
+      [[OIDAuthorizationResponse alloc] initWithRequest:authorizationRequest
+                                             parameters:@{ @"code" : @"Code",
+                                                           @"state" : @"State" }];
+  OIDTokenResponse *tokenResponse =
+      [[OIDTokenResponse alloc] initWithRequest:[authorizationResponse tokenExchangeRequest]
+                                     parameters:[endpoint issueTokenResponseParameters]];
+  return [[OIDAuthState alloc] initWithAuthorizationResponse:authorizationResponse
+                                               tokenResponse:tokenResponse];
+}
+
+/*! @fn drainMainQueue
+    @brief Runs the blocks the last event dispatched to the main queue, and the blocks those
+        dispatched, for @c kMainQueueDrainRounds rounds.
+ */
+- (void)drainMainQueue {
+  for (NSUInteger round = 0; round < kMainQueueDrainRounds; round++) {
+    __block BOOL drained = NO;
+    dispatch_async(dispatch_get_main_queue(), ^() {
+      drained = YES;
+    });
+    while (!drained) {
+      [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate distantPast]];
+    }
+  }
+}
+
+@end
@@ -0,0 +1,143 @@
+/*! @file OIDAuthStateSimulationTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDAuthStateSimulation.h"
+#import "Source/OIDClock.h"
+#import "Source/OIDHTTPClient.h"
+
+/*! @var kDay
+    @brief The number of seconds in a day.
+ */
+static NSTimeInterval const kDay = 24 * 60 * 60;
+
+/*! @class OIDAuthStateSimulationTests
+    @brief Compares @c OIDAuthState refresh policies with @c OIDAuthStateSimulation.
+ */
+@interface OIDAuthStateSimulationTests : XCTestCase
+@end
+
+@implementation OIDAuthStateSimulationTests
+
+/*! @fn testRefreshesOncePerTokenLifetime
+    @brief Tests that with a reliable endpoint, tokens are refreshed about once per lifetime, each
+        time on the critical path of an action, and expired tokens are never used.
+ */
+- (void)testRefreshesOncePerTokenLifetime {
+  OIDAuthStateSimulationScenario *scenario = [[OIDAuthStateSimulationScenario alloc] init];
+  scenario.duration = 2 * kDay;
+  OIDAuthStateSimulation *simulation =
+      [[OIDAuthStateSimulation alloc] initWithScenario:scenario];
+  OIDAuthStateSimulationReport *report =
+      [simulation runPolicy:[[OIDAuthStateSimulationPolicy alloc] initWithName:@"default"]];
+
+  NSUInteger expectedRequestCount = (NSUInteger)(scenario.duration / scenario.accessTokenLifetime);
+  XCTAssertGreaterThanOrEqual(report.tokenRequestCount, expectedRequestCount - 2, @"%@", report);
+  XCTAssertLessThanOrEqual(report.tokenRequestCount, expectedRequestCount + 2, @"%@", report);
+  XCTAssertEqual(report.failedTokenRequestCount, 0, @"%@", report);
+  XCTAssertGreaterThanOrEqual(report.criticalPathRefreshCount, report.tokenRequestCount,
+                              @"%@", report);
+  XCTAssertLessThan(report.criticalPathRefreshRate, 0.05, @"%@", report);
+  XCTAssertEqual(report.expiredTokenUseCount, 0, @"%@", report);
+  XCTAssertEqual(report.failedActionCount, 0, @"%@", report);
+  XCTAssertGreaterThan(report.actionCount, scenario.duration / scenario.meanActionInterval / 2,
+                       @"%@", report);
+}
+
+/*! @fn testLeadTimeCoversLatency
+    @brief Tests that a lead time shorter than the token endpoint latency leads to expired tokens
+        being used, and the default lead time doesn't.
+ */
+- (void)testLeadTimeCoversLatency {
+  OIDAuthStateSimulationScenario *scenario = [[OIDAuthStateSimulationScenario alloc] init];
+  scenario.meanActionInterval = 2;
+  scenario.tokenEndpointLatency = 4;
+  scenario.tokenEndpointLatencyJitter = 2;
+  OIDAuthStateSimulationPolicy *shortLeadTime =
+      [[OIDAuthStateSimulationPolicy alloc] initWithName:@"short lead time"];
+  shortLeadTime.tokenRefreshLeadTime = 1;
+  OIDAuthStateSimulationPolicy *defaultLeadTime =
+      [[OIDAuthStateSimulationPolicy alloc] initWithName:@"default lead time"];
+  NSArray<OIDAuthStateSimulationReport *> *reports =
+      [[[OIDAuthStateSimulation alloc] initWithScenario:scenario]
+          runPolicies:@[ shortLeadTime, defaultLeadTime ]];
+
+  NSUInteger expectedRequestCount = (NSUInteger)(scenario.duration / scenario.accessTokenLifetime);
+  for (OIDAuthStateSimulationReport *report in reports) {
+    XCTAssertLessThanOrEqual(report.tokenRequestCount, expectedRequestCount + 2, @"%@", report);
+    XCTAssertEqual(report.failedTokenRequestCount, 0, @"%@", report);
+    XCTAssertEqual(report.failedActionCount, 0, @"%@", report);
+  }
+  XCTAssertGreaterThan(reports[0].expiredTokenUseCount, 0, @"%@", reports[0]);
+  XCTAssertEqual(reports[1].expiredTokenUseCount, 0, @"%@", reports[1]);
+}
+
+/*! @fn testGracePeriodHidesTransientErrors
+    @brief Tests that with an unreliable endpoint, a stale token grace period saves actions from
+        failing, by refreshing in the background instead of on the critical path.
+ */
+- (void)testGracePeriodHidesTransientErrors {
+  OIDAuthStateSimulationScenario *scenario = [[OIDAuthStateSimulationScenario alloc] init];
+  scenario.duration = 3 * kDay;
+  scenario.tokenEndpointErrorRate = 0.5;
+  OIDAuthStateSimulationPolicy *noGracePeriod =
+      [[OIDAuthStateSimulationPolicy alloc] initWithName:@"no grace period"];
+  OIDAuthStateSimulationPolicy *gracePeriod =
+      [[OIDAuthStateSimulationPolicy alloc] initWithName:@"grace period"];
+  gracePeriod.staleTokenGracePeriod = 600;
+  NSArray<OIDAuthStateSimulationReport *> *reports =
+      [[[OIDAuthStateSimulation alloc] initWithScenario:scenario]
+          runPolicies:@[ noGracePeriod, gracePeriod ]];
+
+  XCTAssertGreaterThan(reports[0].failedTokenRequestCount, 0, @"%@", reports[0]);
+  XCTAssertGreaterThan(reports[1].failedTokenRequestCount, 0, @"%@", reports[1]);
+  XCTAssertGreaterThan(reports[0].failedActionCount, 0, @"%@", reports[0]);
+  XCTAssertLessThan(reports[1].failedActionCount, reports[0].failedActionCount, @"%@", reports);
+  XCTAssertLessThan(reports[1].criticalPathRefreshCount, reports[0].criticalPathRefreshCount,
+                    @"%@", reports);
+}
+
+/*! @fn testReproducible
+    @brief Tests that a seeded run is reproducible, and that the shared clock and HTTP client are
+        restored afterwards.
+ */
+- (void)testReproducible {
+  OIDClock *clock = [OIDClock sharedClock];
+  OIDHTTPClient *client = [OIDHTTPClient sharedClient];
+  OIDAuthStateSimulationScenario *scenario = [[OIDAuthStateSimulationScenario alloc] init];
+  scenario.tokenEndpointErrorRate = 0.2;
+  scenario.tokenEndpointLatencyJitter = 1;
+  scenario.seed = 42;
+  OIDAuthStateSimulationPolicy *policy =
+      [[OIDAuthStateSimulationPolicy alloc] initWithName:@"default"];
+  OIDAuthStateSimulation *simulation =
+      [[OIDAuthStateSimulation alloc] initWithScenario:scenario];
+  OIDAuthStateSimulationReport *first = [simulation runPolicy:policy];
+  OIDAuthStateSimulationReport *second = [simulation runPolicy:policy];
+
+  XCTAssertEqual(first.actionCount, second.actionCount);
+  XCTAssertEqual(first.tokenRequestCount, second.tokenRequestCount);
+  XCTAssertEqual(first.failedTokenRequestCount, second.failedTokenRequestCount);
+  XCTAssertEqual(first.criticalPathRefreshCount, second.criticalPathRefreshCount);
+  XCTAssertEqual(first.failedActionCount, second.failedActionCount);
+  XCTAssertEqual([OIDClock sharedClock], clock);
+  XCTAssertEqual([OIDHTTPClient sharedClient], client);
+}
+
+@end
@@ -0,0 +1,207 @@
+/*! @file OIDAuthStateSnapshotTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDAuthStateTests.h"
+#import "OIDTokenResponseTests.h"
+#import "Source/OIDAuthState.h"
+#import "Source/OIDAuthStateObserver.h"
+#import "Source/OIDAuthStateSnapshot.h"
+#import "Source/OIDError.h"
+#import "Source/OIDErrorUtilities.h"
+
+/*! @var kObserverQueueKey
+    @brief The key of the queue-specific value identifying the observer queue.
+ */
+static void *kObserverQueueKey = &kObserverQueueKey;
+
+/*! @class OIDTestAuthStateObserver
+    @brief Records the notifications it receives.
+ */
+@interface OIDTestAuthStateObserver : NSObject <OIDAuthStateObserver>
+
+/*! @property notificationCount
+    @brief The number of notifications received.
+ */
+@property(atomic, readonly) NSUInteger notificationCount;
+
+/*! @property lastSnapshot
+    @brief The snapshot of the last notification.
+ */
+@property(atomic, readonly, nullable) OIDAuthStateSnapshot *lastSnapshot;
+
+/*! @property expectation
+    @brief Fulfilled on the first notification.
+ */
+@property(atomic, nullable) XCTestExpectation *expectation;
+
+/*! @property onObserverQueue
+    @brief Whether every notification was received on the queue tagged with
+        @c kObserverQueueKey.
+ */
+@property(atomic, readonly) BOOL onObserverQueue;
+
+@end
+
+@implementation OIDTestAuthStateObserver
+
+@synthesize notificationCount = _notificationCount;
+@synthesize lastSnapshot = _lastSnapshot;
+@synthesize expectation = _expectation;
+@synthesize onObserverQueue = _onObserverQueue;
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _onObserverQueue = YES;
+  }
+  return self;
+}
+
+- (void)authState:(OIDAuthState *)authState didChangeToSnapshot:(OIDAuthStateSnapshot *)snapshot {
+  _onObserverQueue = _onObserverQueue && dispatch_get_specific(kObserverQueueKey) != NULL;
+  _notificationCount++;
+  _lastSnapshot = snapshot;
+  [_expectation fulfill];
+  _expectation = nil;
+}
+
+@end
+
+/*! @class OIDAuthStateSnapshotTests
+    @brief Unit tests for @c OIDAuthStateSnapshot and @c OIDAuthStateObserver notifications.
+ */
+@interface OIDAuthStateSnapshotTests : XCTestCase
+@end
+
+@implementation OIDAuthStateSnapshotTests
+
+/*! @fn observerQueue
+    @brief Returns a new serial queue, tagged with @c kObserverQueueKey.
+ */
+- (dispatch_queue_t)observerQueue {
+  dispatch_queue_t queue =
+      dispatch_queue_create("OIDAuthStateSnapshotTests.observer", DISPATCH_QUEUE_SERIAL);
+  dispatch_queue_set_specific(queue, kObserverQueueKey, kObserverQueueKey, NULL);
+  return queue;
+}
+
+/*! @fn invalidGrantError
+    @brief Returns an OAuth invalid_grant error from the token endpoint.
+ */
+- (NSError *)invalidGrantError {
+  return [OIDErrorUtilities OAuthErrorWithDomain:OIDOAuthTokenErrorDomain
+                                   OAuthResponse:@{ OIDOAuthErrorFieldError : @"invalid_grant" }
+                                 underlyingError:nil];
+}
+
+/*! @fn testSnapshot
+    @brief Tests that a snapshot copies the state's tokens and status.
+ */
+- (void)testSnapshot {
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  OIDTokenResponse *tokenResponse = [OIDTokenResponseTests testInstance];
+  [authState updateWithTokenResponse:tokenResponse error:nil];
+
+  OIDAuthStateSnapshot *snapshot = authState.snapshot;
+  XCTAssertEqualObjects(snapshot.accessToken, tokenResponse.accessToken);
+  XCTAssertEqualObjects(snapshot.tokenType, tokenResponse.tokenType);
+  XCTAssertEqualObjects(snapshot.accessTokenExpirationDate,
+                        tokenResponse.accessTokenExpirationDate);
+  XCTAssertEqualObjects(snapshot.idToken, tokenResponse.idToken);
+  XCTAssertEqualObjects(snapshot.refreshToken, authState.refreshToken);
+  XCTAssertEqualObjects(snapshot.scope, authState.scope);
+  XCTAssertEqual(snapshot.isAuthorized, authState.isAuthorized);
+
+  // later changes don't affect the snapshot
+  [authState updateWithAuthorizationError:[self invalidGrantError]];
+  XCTAssertNil(snapshot.authorizationError);
+  XCTAssertNotNil(authState.snapshot.authorizationError);
+  XCTAssertFalse(authState.snapshot.isAuthorized);
+  XCTAssertNil(authState.snapshot.accessToken);
+}
+
+/*! @fn testObserverNotifiedOnItsQueue
+    @brief Tests that an observer is notified asynchronously, on the queue it was added with.
+ */
+- (void)testObserverNotifiedOnItsQueue {
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  OIDTestAuthStateObserver *observer = [[OIDTestAuthStateObserver alloc] init];
+  observer.expectation = [self expectationWithDescription:@"Observer should be notified."];
+  [authState addObserver:observer queue:[self observerQueue]];
+
+  OIDTokenResponse *tokenResponse = [OIDTokenResponseTests testInstanceRefresh];
+  [authState updateWithTokenResponse:tokenResponse error:nil];
+  [self waitForExpectationsWithTimeout:2 handler:nil];
+
+  XCTAssertEqual(observer.notificationCount, 1);
+  XCTAssert(observer.onObserverQueue);
+  XCTAssertEqualObjects(observer.lastSnapshot.accessToken, tokenResponse.accessToken);
+}
+
+/*! @fn testBurstIsCoalesced
+    @brief Tests that changes made before the observer's queue runs are delivered as a single
+        notification with the latest snapshot.
+ */
+- (void)testBurstIsCoalesced {
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  OIDTestAuthStateObserver *observer = [[OIDTestAuthStateObserver alloc] init];
+  observer.expectation = [self expectationWithDescription:@"Observer should be notified."];
+  dispatch_queue_t queue = [self observerQueue];
+  [authState addObserver:observer queue:queue];
+
+  dispatch_suspend(queue);
+  [authState updateWithTokenResponse:[OIDTokenResponseTests testInstance] error:nil];
+  [authState updateWithTokenResponse:[OIDTokenResponseTests testInstanceRefresh] error:nil];
+  [authState updateWithAuthorizationError:[self invalidGrantError]];
+  dispatch_resume(queue);
+  [self waitForExpectationsWithTimeout:2 handler:nil];
+
+  // gives any extra notification the chance to arrive
+  dispatch_sync(queue, ^{});
+  XCTAssertEqual(observer.notificationCount, 1);
+  XCTAssertNotNil(observer.lastSnapshot.authorizationError);
+  XCTAssertFalse(observer.lastSnapshot.isAuthorized);
+}
+
+/*! @fn testMultipleObserversAndRemoval
+    @brief Tests that every observer is notified, and that a removed observer doesn't receive a
+        notification which was queued before its removal.
+ */
+- (void)testMultipleObserversAndRemoval {
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  OIDTestAuthStateObserver *kept = [[OIDTestAuthStateObserver alloc] init];
+  OIDTestAuthStateObserver *removed = [[OIDTestAuthStateObserver alloc] init];
+  kept.expectation = [self expectationWithDescription:@"Observer should be notified."];
+  dispatch_queue_t queue = [self observerQueue];
+  [authState addObserver:kept queue:queue];
+  [authState addObserver:removed queue:queue];
+
+  dispatch_suspend(queue);
+  [authState updateWithTokenResponse:[OIDTokenResponseTests testInstanceRefresh] error:nil];
+  [authState removeObserver:removed];
+  dispatch_resume(queue);
+  [self waitForExpectationsWithTimeout:2 handler:nil];
+
+  dispatch_sync(queue, ^{});
+  XCTAssertEqual(kept.notificationCount, 1);
+  XCTAssertEqual(removed.notificationCount, 0);
+}
+
+@end
@@ -21,10 +21,103 @@
 #import "OIDAuthorizationResponseTests.h"
 #import "OIDTokenResponseTests.h"
 #import "Source/OIDAuthState.h"
+#import "Source/OIDAuthorizationRequest.h"
 #import "Source/OIDAuthorizationResponse.h"
+#import "Source/OIDConnectivityMonitor.h"
 #import "Source/OIDErrorUtilities.h"
+#import "Source/OIDGrantTypes.h"
+#import "Source/OIDResponseTypes.h"
+#import "Source/OIDServiceConfiguration.h"
+#import "Source/OIDTokenRequest.h"
 #import "Source/OIDTokenResponse.h"
 
+/*! @var kUnreachableEndpoint
+    @brief An endpoint which refuses connections, for simulating an authorization server outage.
+ */
+static NSString *const kUnreachableEndpoint = @"http://127.0.0.1:1/token";
+
+/*! @var kColdStartStateCount
+    @brief The number of stored states restored by @c testColdStartPerformance.
+ */
+static const NSUInteger kColdStartStateCount = 1000;
+
+/*! @class OIDLegacyAuthStateArchive
+    @brief Encodes an auth state in the layout used before the two-tier archive.
+ */
+@interface OIDLegacyAuthStateArchive : NSObject <NSCoding>
+
+/*! @property authState
+    @brief The state to encode.
+ */
+@property(nonatomic) OIDAuthState *authState;
+
+@end
+
+@implementation OIDLegacyAuthStateArchive
+
+@synthesize authState = _authState;
+
+- (nullable instancetype)initWithCoder:(NSCoder *)aDecoder {
+  return nil;
+}
+
+- (void)encodeWithCoder:(NSCoder *)aCoder {
+  [aCoder encodeObject:_authState.lastAuthorizationResponse forKey:@"lastAuthorizationResponse"];
+  [aCoder encodeObject:_authState.lastTokenResponse forKey:@"lastTokenResponse"];
+  [aCoder encodeObject:_authState.scope forKey:@"scope"];
+  [aCoder encodeObject:_authState.refreshToken forKey:@"refreshToken"];
+}
+
+@end
+
+/*! @class OIDTestConnectivityMonitor
+    @brief An @c OIDConnectivityMonitor whose reachability is set by the test.
+ */
+@interface OIDTestConnectivityMonitor : NSObject <OIDConnectivityMonitor>
+
+/*! @property reachable
+    @brief Whether the network is reachable. Setting it to YES performs the waiting blocks.
+ */
+@property(nonatomic, assign, getter=isReachable) BOOL reachable;
+
+@end
+
+@implementation OIDTestConnectivityMonitor {
+  /*! @var _waitingBlocks
+      @brief Blocks waiting for the network to become reachable.
+   */
+  NSMutableArray<dispatch_block_t> *_waitingBlocks;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _waitingBlocks = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (void)setReachable:(BOOL)reachable {
+  _reachable = reachable;
+  if (reachable) {
+    NSArray<dispatch_block_t> *blocks = [_waitingBlocks copy];
+    [_waitingBlocks removeAllObjects];
+    for (dispatch_block_t block in blocks) {
+      dispatch_async(dispatch_get_main_queue(), block);
+    }
+  }
+}
+
+- (void)performWhenReachable:(dispatch_block_t)block {
+  if (_reachable) {
+    dispatch_async(dispatch_get_main_queue(), block);
+  } else {
+    [_waitingBlocks addObject:[block copy]];
+  }
+}
+
+@end
+
 @interface OIDAuthStateTests () <OIDAuthStateChangeDelegate, OIDAuthStateErrorDelegate>
 @end
 
@@ -45,6 +138,17 @@
           OIDAuthStateErrorDelegate.didEncounterTransientError:.
    */
   XCTestExpectation *_didEncounterTransientErrorExpectation;
+
+  /*! @var _didUseStaleTokensExpectation
+      @brief An expectation for tests waiting on
+          OIDAuthStateErrorDelegate.didUseStaleTokensAfterTransientError:.
+   */
+  XCTestExpectation *_didUseStaleTokensExpectation;
+
+  /*! @var _transientErrorCount
+      @brief The number of times OIDAuthStateErrorDelegate.didEncounterTransientError: was called.
+   */
+  NSUInteger _transientErrorCount;
 }
 
 + (OIDAuthState *)testInstance {
@@ -57,6 +161,38 @@
   return authstate;
 }
 
+/*! @fn unreachableInstanceWithExpiresIn:
+    @brief Creates an @c OIDAuthState whose token endpoint can't be reached.
+    @param expiresIn The lifetime of the access token, in seconds.
+ */
++ (OIDAuthState *)unreachableInstanceWithExpiresIn:(NSInteger)expiresIn {
+  NSURL *endpoint = [NSURL URLWithString:kUnreachableEndpoint];
+  OIDServiceConfiguration *configuration =
+      [[OIDServiceConfiguration alloc] initWithAuthorizationEndpoint:endpoint
+                                                       tokenEndpoint:endpoint];
+  OIDAuthorizationRequest *authorizationRequest =
+      [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
+                                                    clientId:@"ClientID"
+                                                       scope:nil
+                                                 redirectURL:[NSURL URLWithString:@"app:/"]
+                                                responseType:OIDResponseTypeCode
+                                                       state:@"State"
+                                                codeVerifier:nil
+                                        additionalParameters:nil];
+  OIDAuthorizationResponse *authorizationResponse =
+      [[OIDAuthorizationResponse alloc] initWithRequest:authorizationRequest
+                                             parameters:@{ @"code" : @"Code",
+                                                           @"state" : @"State" }];
+  OIDTokenRequest *tokenRequest = [authorizationResponse tokenExchangeRequest];
+  OIDTokenResponse *tokenResponse =
+      [[OIDTokenResponse alloc] initWithRequest:tokenRequest
+                                     parameters:@{ @"access_token" : @"AccessToken",
+                                                   @"expires_in" : @(expiresIn),
+                                                   @"refresh_token" : @"RefreshToken" }];
+  return [[OIDAuthState alloc] initWithAuthorizationResponse:authorizationResponse
+                                               tokenResponse:tokenResponse];
+}
+
 /*! @fn OAuthAuthorizationError
     @brief NSError for an invalid_request on the authorization endpoint.
  */
@@ -109,10 +245,24 @@
   [_didEncounterAuthorizationErrorExpectation fulfill];
 }
 
+- (void)authState:(OIDAuthState *)state didEncounterTransientError:(NSError *)error {
+  _transientErrorCount++;
+  [_didEncounterTransientErrorExpectation fulfill];
+}
+
+- (void)authState:(OIDAuthState *)state didUseStaleTokensAfterTransientError:(NSError *)error {
+  // in this test, this method should only be called when we expect it
+  XCTAssertNotNil(_didUseStaleTokensExpectation);
+
+  [_didUseStaleTokensExpectation fulfill];
+}
+
 - (void)tearDown {
   _didChangeStateExpectation = nil;
   _didEncounterAuthorizationErrorExpectation = nil;
   _didEncounterTransientErrorExpectation = nil;
+  _didUseStaleTokensExpectation = nil;
+  _transientErrorCount = 0;
 
   [super tearDown];
 }
@@ -340,6 +490,126 @@
   XCTAssertTrue(authState.isAuthorized, @"Should be in an authorized state now");
 }
 
+/*! @fn testStaleTokensUsedWithinGracePeriod
+    @brief Tests that when the token endpoint is unreachable, the last access token is used while
+        it is within the grace period, and that later actions don't wait for another refresh.
+ */
+- (void)testStaleTokensUsedWithinGracePeriod {
+  // the access token expires within the refresh tolerance, so a refresh is attempted
+  OIDAuthState *authState = [[self class] unreachableInstanceWithExpiresIn:30];
+  authState.staleTokenGracePeriod = 300;
+  authState.errorDelegate = self;
+
+  _didEncounterTransientErrorExpectation =
+      [self expectationWithDescription:@"Transient error should be reported."];
+  _didUseStaleTokensExpectation =
+      [self expectationWithDescription:@"Stale token use should be reported."];
+  XCTestExpectation *action = [self expectationWithDescription:@"Action should be called."];
+  [authState withFreshTokensPerformAction:^(NSString *_Nullable accessToken,
+                                            NSString *_Nullable idToken,
+                                            NSError *_Nullable error) {
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(accessToken, @"AccessToken");
+    [action fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+
+  // the next action is performed immediately, with no further errors reported
+  _didEncounterTransientErrorExpectation = nil;
+  _didUseStaleTokensExpectation = nil;
+  XCTestExpectation *nextAction =
+      [self expectationWithDescription:@"Next action should be called."];
+  [authState withFreshTokensPerformAction:^(NSString *_Nullable accessToken,
+                                            NSString *_Nullable idToken,
+                                            NSError *_Nullable error) {
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(accessToken, @"AccessToken");
+    [nextAction fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:1 handler:nil];
+}
+
+/*! @fn testStaleTokensNotUsedOutsideGracePeriod
+    @brief Tests that the refresh error is passed to the action when the access token expired
+        before the grace period.
+ */
+- (void)testStaleTokensNotUsedOutsideGracePeriod {
+  OIDAuthState *authState = [[self class] unreachableInstanceWithExpiresIn:-600];
+  authState.staleTokenGracePeriod = 300;
+  authState.errorDelegate = self;
+
+  _didEncounterTransientErrorExpectation =
+      [self expectationWithDescription:@"Transient error should be reported."];
+  XCTestExpectation *action = [self expectationWithDescription:@"Action should be called."];
+  [authState withFreshTokensPerformAction:^(NSString *_Nullable accessToken,
+                                            NSString *_Nullable idToken,
+                                            NSError *_Nullable error) {
+    XCTAssertNotNil(error);
+    [action fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+/*! @fn testRefreshDeferredWhileOffline
+    @brief Tests that actions wait while the network is unreachable, and that a single refresh is
+        made for all of them once it is reachable.
+ */
+- (void)testRefreshDeferredWhileOffline {
+  OIDAuthState *authState = [[self class] unreachableInstanceWithExpiresIn:30];
+  OIDTestConnectivityMonitor *monitor = [[OIDTestConnectivityMonitor alloc] init];
+  authState.connectivityMonitor = monitor;
+  authState.errorDelegate = self;
+
+  __block NSUInteger actionCount = 0;
+  XCTestExpectation *actions = [self expectationWithDescription:@"Actions should be called."];
+  for (NSUInteger i = 0; i < 2; i++) {
+    [authState withFreshTokensPerformAction:^(NSString *_Nullable accessToken,
+                                              NSString *_Nullable idToken,
+                                              NSError *_Nullable error) {
+      // the token endpoint refuses connections, so the refresh fails when it is made
+      XCTAssertNotNil(error);
+      if (++actionCount == 2) {
+        [actions fulfill];
+      }
+    }];
+  }
+
+  // nothing happens while offline
+  [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.5]];
+  XCTAssertEqual(actionCount, 0);
+  XCTAssertEqual(_transientErrorCount, 0);
+
+  monitor.reachable = YES;
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+  XCTAssertEqual(_transientErrorCount, 1);
+}
+
+/*! @fn testOfflineActionTimeout
+    @brief Tests that actions waiting for the network are performed with an error after the
+        timeout, and that no refresh is made for them later.
+ */
+- (void)testOfflineActionTimeout {
+  OIDAuthState *authState = [[self class] unreachableInstanceWithExpiresIn:30];
+  OIDTestConnectivityMonitor *monitor = [[OIDTestConnectivityMonitor alloc] init];
+  authState.connectivityMonitor = monitor;
+  authState.offlineActionTimeout = 0.1;
+  authState.errorDelegate = self;
+
+  XCTestExpectation *action = [self expectationWithDescription:@"Action should be called."];
+  [authState withFreshTokensPerformAction:^(NSString *_Nullable accessToken,
+                                            NSString *_Nullable idToken,
+                                            NSError *_Nullable error) {
+    XCTAssertEqualObjects(error.domain, OIDGeneralErrorDomain);
+    XCTAssertEqual(error.code, OIDErrorCodeNetworkError);
+    [action fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:2 handler:nil];
+
+  monitor.reachable = YES;
+  [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.5]];
+  XCTAssertEqual(_transientErrorCount, 0);
+}
+
 - (void)testSecureCoding {
   XCTAssert([OIDAuthState supportsSecureCoding]);
 
@@ -369,5 +639,75 @@
   XCTAssertEqual(authStateCopy.authorizationError.code, authState.authorizationError.code);
 }
 
+/*! @fn testColdPayloadIsDecodedLazily
+    @brief Tests that an unarchived state answers token queries from the hot header, and decodes
+        its responses only when they are first needed.
+ */
+- (void)testColdPayloadIsDecodedLazily {
+  OIDAuthState *authState = [[self class] testInstance];
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:authState];
+  OIDAuthState *authStateCopy = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+
+  XCTAssertNotNil([authStateCopy valueForKey:@"coldPayload"]);
+  XCTAssertEqual(authStateCopy.isAuthorized, authState.isAuthorized);
+  XCTAssertEqualObjects(authStateCopy.accessToken, authState.accessToken);
+  XCTAssertEqualObjects(authStateCopy.accessTokenExpirationDate,
+                        authState.accessTokenExpirationDate);
+  XCTAssertEqualObjects(authStateCopy.idToken, authState.idToken);
+  XCTAssertEqualObjects(authStateCopy.refreshToken, authState.refreshToken);
+  XCTAssertNotNil([authStateCopy valueForKey:@"coldPayload"]);
+
+  // re-archiving an undecoded state carries the cold payload over unchanged
+  NSData *reencoded = [NSKeyedArchiver archivedDataWithRootObject:authStateCopy];
+  XCTAssertNotNil([authStateCopy valueForKey:@"coldPayload"]);
+  OIDAuthState *secondCopy = [NSKeyedUnarchiver unarchiveObjectWithData:reencoded];
+  XCTAssertEqualObjects(secondCopy.lastTokenResponse.accessToken,
+                        authState.lastTokenResponse.accessToken);
+
+  XCTAssertEqualObjects(authStateCopy.lastAuthorizationResponse.authorizationCode,
+                        authState.lastAuthorizationResponse.authorizationCode);
+  XCTAssertNil([authStateCopy valueForKey:@"coldPayload"]);
+  XCTAssertEqualObjects(authStateCopy.accessToken, authState.accessToken);
+}
+
+/*! @fn testLegacyArchive
+    @brief Tests that states archived before the two-tier layout are still decoded.
+ */
+- (void)testLegacyArchive {
+  OIDAuthState *authState = [[self class] testInstance];
+  OIDLegacyAuthStateArchive *legacyArchive = [[OIDLegacyAuthStateArchive alloc] init];
+  legacyArchive.authState = authState;
+  NSMutableData *data = [NSMutableData data];
+  NSKeyedArchiver *archiver = [[NSKeyedArchiver alloc] initForWritingWithMutableData:data];
+  [archiver setClassName:NSStringFromClass([OIDAuthState class])
+                forClass:[OIDLegacyAuthStateArchive class]];
+  [archiver encodeObject:legacyArchive forKey:NSKeyedArchiveRootObjectKey];
+  [archiver finishEncoding];
+
+  OIDAuthState *authStateCopy = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssert([authStateCopy isKindOfClass:[OIDAuthState class]]);
+  XCTAssertNil([authStateCopy valueForKey:@"coldPayload"]);
+  XCTAssertEqualObjects(authStateCopy.accessToken, authState.accessToken);
+  XCTAssertEqualObjects(authStateCopy.refreshToken, authState.refreshToken);
+  XCTAssertEqualObjects(authStateCopy.lastTokenResponse.accessToken,
+                        authState.lastTokenResponse.accessToken);
+}
+
+/*! @fn testColdStartPerformance
+    @brief Measures restoring many stored states and checking whether each is authorized, as an
+        app does on launch.
+ */
+- (void)testColdStartPerformance {
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:[[self class] testInstance]];
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < kColdStartStateCount; i++) {
+      OIDAuthState *authState = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+      if (authState.isAuthorized) {
+        (void)authState.accessToken;
+      }
+    }
+  }];
+}
+
 @end
 
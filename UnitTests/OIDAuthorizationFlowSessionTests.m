@@ -0,0 +1,132 @@
+/*! @file OIDAuthorizationFlowSessionTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDAuthorizationRequestTests.h"
+#import "Source/OIDAuthorizationFlowSessionImplementation.h"
+#import "Source/OIDAuthorizationResponse.h"
+#import "Source/OIDError.h"
+
+/*! @var kTestRedirectURLWithCode
+    @brief A redirect for @c OIDAuthorizationRequestTests.testInstance carrying a code response.
+ */
+static NSString *const kTestRedirectURLWithCode = @"http://www.google.com/?code=Code&state=State";
+
+/*! @var kTestRedirectURLWithWrongState
+    @brief A redirect for @c OIDAuthorizationRequestTests.testInstance with a mismatched state.
+ */
+static NSString *const kTestRedirectURLWithWrongState =
+    @"http://www.google.com/?code=Code&state=Other";
+
+/*! @var kTestUnrelatedURL
+    @brief A URL which doesn't match the redirect URL of @c OIDAuthorizationRequestTests.
+ */
+static NSString *const kTestUnrelatedURL = @"http://www.example.com/?code=Code&state=State";
+
+/*! @class OIDAuthorizationFlowSessionTests
+    @brief Unit tests for the UI-independent @c OIDAuthorizationFlowSessionImplementation, as used
+        without a user agent by the AppAuthCore library.
+ */
+@interface OIDAuthorizationFlowSessionTests : XCTestCase
+@end
+
+@implementation OIDAuthorizationFlowSessionTests
+
+/*! @fn testResumeWithCodeResponse
+    @brief Tests that a matching redirect completes the flow with an authorization response.
+ */
+- (void)testResumeWithCodeResponse {
+  OIDAuthorizationFlowSessionImplementation *session =
+      [[OIDAuthorizationFlowSessionImplementation alloc]
+          initWithRequest:[OIDAuthorizationRequestTests testInstance]];
+  __block NSUInteger callbackCount = 0;
+  [session startWithCallback:^(OIDAuthorizationResponse *_Nullable authorizationResponse,
+                               NSError *_Nullable error) {
+    callbackCount++;
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(authorizationResponse.authorizationCode, @"Code");
+  }];
+
+  NSURL *URL = [NSURL URLWithString:kTestRedirectURLWithCode];
+  XCTAssert([session resumeAuthorizationFlowWithURL:URL]);
+  XCTAssertEqual(callbackCount, 1);
+
+  // the session is complete, so cancelling has no effect
+  [session cancel];
+  XCTAssertEqual(callbackCount, 1);
+}
+
+/*! @fn testResumeIgnoresUnrelatedURL
+    @brief Tests that a URL not matching the request's redirect URL isn't consumed.
+ */
+- (void)testResumeIgnoresUnrelatedURL {
+  OIDAuthorizationFlowSessionImplementation *session =
+      [[OIDAuthorizationFlowSessionImplementation alloc]
+          initWithRequest:[OIDAuthorizationRequestTests testInstance]];
+  [session startWithCallback:^(OIDAuthorizationResponse *_Nullable authorizationResponse,
+                               NSError *_Nullable error) {
+    XCTFail(@"The callback should not be invoked for an unrelated URL.");
+  }];
+
+  XCTAssertFalse([session resumeAuthorizationFlowWithURL:[NSURL URLWithString:kTestUnrelatedURL]]);
+}
+
+/*! @fn testResumeWithStateMismatch
+    @brief Tests that a response with a different state than the request results in an error.
+ */
+- (void)testResumeWithStateMismatch {
+  OIDAuthorizationFlowSessionImplementation *session =
+      [[OIDAuthorizationFlowSessionImplementation alloc]
+          initWithRequest:[OIDAuthorizationRequestTests testInstance]];
+  __block BOOL called = NO;
+  [session startWithCallback:^(OIDAuthorizationResponse *_Nullable authorizationResponse,
+                               NSError *_Nullable error) {
+    called = YES;
+    XCTAssertNil(authorizationResponse);
+    XCTAssertEqualObjects(error.domain, OIDOAuthAuthorizationErrorDomain);
+    XCTAssertEqual(error.code, OIDErrorCodeOAuthAuthorizationClientError);
+  }];
+
+  NSURL *URL = [NSURL URLWithString:kTestRedirectURLWithWrongState];
+  XCTAssert([session resumeAuthorizationFlowWithURL:URL]);
+  XCTAssert(called);
+}
+
+/*! @fn testCancel
+    @brief Tests that cancelling a session without a user agent reports a cancelled flow.
+ */
+- (void)testCancel {
+  OIDAuthorizationFlowSessionImplementation *session =
+      [[OIDAuthorizationFlowSessionImplementation alloc]
+          initWithRequest:[OIDAuthorizationRequestTests testInstance]];
+  __block NSUInteger callbackCount = 0;
+  [session startWithCallback:^(OIDAuthorizationResponse *_Nullable authorizationResponse,
+                               NSError *_Nullable error) {
+    callbackCount++;
+    XCTAssertNil(authorizationResponse);
+    XCTAssertEqualObjects(error.domain, OIDGeneralErrorDomain);
+    XCTAssertEqual(error.code, OIDErrorCodeUserCanceledAuthorizationFlow);
+  }];
+
+  [session cancel];
+  [session cancel];
+  XCTAssertEqual(callbackCount, 1);
+}
+
+@end
@@ -0,0 +1,132 @@
+/*! @file OIDAuthorizationRequestTemplateTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDAuthorizationRequestTests.h"
+#import "Source/OIDAuthorizationRequest.h"
+#import "Source/OIDAuthorizationRequestTemplate.h"
+#import "Source/OIDServiceConfiguration.h"
+
+/*! @class OIDAuthorizationRequestTemplateTests
+    @brief Unit tests for @c OIDAuthorizationRequestTemplate.
+ */
+@interface OIDAuthorizationRequestTemplateTests : XCTestCase
+@end
+
+@implementation OIDAuthorizationRequestTemplateTests
+
+/*! @fn templateForRequest:
+    @brief Returns a template with the constant parameters of an authorization request.
+ */
++ (OIDAuthorizationRequestTemplate *)templateForRequest:(OIDAuthorizationRequest *)request {
+  return [[OIDAuthorizationRequestTemplate alloc]
+      initWithConfiguration:request.configuration
+                   clientId:request.clientID
+                      scope:request.scope
+                redirectURL:request.redirectURL
+               responseType:request.responseType
+       additionalParameters:request.additionalParameters];
+}
+
+/*! @fn assertURL:isEquivalentToURL:
+    @brief Asserts that two URLs differ at most in the order of their query parameters.
+ */
+- (void)assertURL:(NSURL *)URL isEquivalentToURL:(NSURL *)expected {
+  NSURLComponents *components = [NSURLComponents componentsWithURL:URL
+                                           resolvingAgainstBaseURL:NO];
+  NSURLComponents *expectedComponents = [NSURLComponents componentsWithURL:expected
+                                                   resolvingAgainstBaseURL:NO];
+  XCTAssertEqualObjects(components.scheme, expectedComponents.scheme);
+  XCTAssertEqualObjects(components.host, expectedComponents.host);
+  XCTAssertEqualObjects(components.path, expectedComponents.path);
+  XCTAssertEqualObjects([NSSet setWithArray:components.queryItems],
+                        [NSSet setWithArray:expectedComponents.queryItems]);
+}
+
+/*! @fn testMatchesPlainRequest
+    @brief Tests that requests created from a template are equivalent to ones built directly.
+ */
+- (void)testMatchesPlainRequest {
+  OIDAuthorizationRequest *expected = [OIDAuthorizationRequestTests testInstance];
+  OIDAuthorizationRequestTemplate *requestTemplate = [[self class] templateForRequest:expected];
+  OIDAuthorizationRequest *request =
+      [requestTemplate authorizationRequestWithState:expected.state
+                                        codeVerifier:expected.codeVerifier];
+
+  XCTAssertEqualObjects(request.clientID, expected.clientID);
+  XCTAssertEqualObjects(request.scope, expected.scope);
+  XCTAssertEqualObjects(request.state, expected.state);
+  XCTAssertEqualObjects(request.codeChallenge, expected.codeChallenge);
+  XCTAssertEqualObjects(request.additionalParameters, expected.additionalParameters);
+  [self assertURL:request.authorizationRequestURL
+      isEquivalentToURL:expected.authorizationRequestURL];
+
+  // without the per-flow parameters
+  request = [requestTemplate authorizationRequestWithState:nil codeVerifier:nil];
+  XCTAssertNil(request.codeChallenge);
+  NSURLComponents *components = [NSURLComponents componentsWithURL:request.authorizationRequestURL
+                                           resolvingAgainstBaseURL:NO];
+  XCTAssertEqual(components.queryItems.count, 5);
+}
+
+/*! @fn testGeneratedParameters
+    @brief Tests that each request created from a template gets a new state and code verifier.
+ */
+- (void)testGeneratedParameters {
+  OIDAuthorizationRequestTemplate *requestTemplate =
+      [[self class] templateForRequest:[OIDAuthorizationRequestTests testInstance]];
+  OIDAuthorizationRequest *first = [requestTemplate authorizationRequest];
+  OIDAuthorizationRequest *second = [requestTemplate authorizationRequest];
+  XCTAssertNotNil(first.state);
+  XCTAssertNotNil(first.codeVerifier);
+  XCTAssertNotEqualObjects(first.state, second.state);
+  XCTAssertNotEqualObjects(first.codeVerifier, second.codeVerifier);
+  XCTAssertNotEqualObjects(first.authorizationRequestURL, second.authorizationRequestURL);
+}
+
+/*! @fn testSecureCoding
+    @brief Tests that a request created from a template is archived as an ordinary request.
+ */
+- (void)testSecureCoding {
+  OIDAuthorizationRequestTemplate *requestTemplate =
+      [[self class] templateForRequest:[OIDAuthorizationRequestTests testInstance]];
+  OIDAuthorizationRequest *request = [requestTemplate authorizationRequest];
+
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:request];
+  OIDAuthorizationRequest *unarchived = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssertEqual([unarchived class], [OIDAuthorizationRequest class]);
+  XCTAssertEqualObjects(unarchived.state, request.state);
+  [self assertURL:unarchived.authorizationRequestURL
+      isEquivalentToURL:request.authorizationRequestURL];
+}
+
+/*! @fn testBulkConstructionPerformance
+    @brief Measures creating requests from a template and building their URLs.
+ */
+- (void)testBulkConstructionPerformance {
+  OIDAuthorizationRequestTemplate *requestTemplate =
+      [[self class] templateForRequest:[OIDAuthorizationRequestTests testInstance]];
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < 1000; i++) {
+      [[requestTemplate authorizationRequest] authorizationRequestURL];
+    }
+  }];
+}
+
+@end
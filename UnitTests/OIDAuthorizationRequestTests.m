@@ -20,6 +20,7 @@
 
 #import "OIDServiceConfigurationTests.h"
 #import "Source/OIDAuthorizationRequest.h"
+#import "Source/OIDError.h"
 #import "Source/OIDScopeUtilities.h"
 #import "Source/OIDServiceConfiguration.h"
 
@@ -263,74 +264,63 @@ static int const kCodeVerifierRecommendedLength = 43;
 
 /*! @fn testDisallowedCharactersInScopes
     @brief Tests the scope string logic to make sure the disallowed characters are properly
-        enforced.
+        enforced, failing an assertion in debug builds and no request being created in release.
  */
 - (void)testDisallowedCharactersInScopes {
   NSURL *redirectURL = [NSURL URLWithString:kTestRedirectURL];
   OIDServiceConfiguration *configuration = [OIDServiceConfigurationTests testInstance];
-  XCTAssertThrows(
+  NSArray<NSString *> *invalidScopes =
+      @[ kTestInvalidScope1, kTestInvalidScope2, kTestInvalidScope3, kTestInvalidScope4 ];
+  for (NSString *invalidScope in invalidScopes) {
+#if !defined(NS_BLOCK_ASSERTIONS)
+    XCTAssertThrows(
+        [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
+                                                      clientId:kTestClientID
+                                                        scopes:@[ invalidScope ]
+                                                   redirectURL:redirectURL
+                                                  responseType:OIDResponseTypeCode
+                                          additionalParameters:nil]);
+#else
+    XCTAssertNil(
+        [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
+                                                      clientId:kTestClientID
+                                                        scopes:@[ invalidScope ]
+                                                   redirectURL:redirectURL
+                                                  responseType:OIDResponseTypeCode
+                                          additionalParameters:nil]);
+#endif
+  }
+}
+
+/*! @fn testInvalidScopesAsErrors
+    @brief Tests that the initializer taking an error reports invalid scopes instead of asserting.
+ */
+- (void)testInvalidScopesAsErrors {
+  NSURL *redirectURL = [NSURL URLWithString:kTestRedirectURL];
+  OIDServiceConfiguration *configuration = [OIDServiceConfigurationTests testInstance];
+  NSError *error;
+  OIDAuthorizationRequest *request =
       [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
                                                     clientId:kTestClientID
                                                       scopes:@[ kTestInvalidScope1 ]
                                                  redirectURL:redirectURL
                                                 responseType:OIDResponseTypeCode
-                                        additionalParameters:nil]);
-  XCTAssertThrows(
-      [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
-                                                    clientId:kTestClientID
-                                                      scopes:@[ kTestInvalidScope2 ]
-                                                 redirectURL:redirectURL
-                                                responseType:OIDResponseTypeCode
-                                        additionalParameters:nil]);
-  XCTAssertThrows(
-      [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
-                                                    clientId:kTestClientID
-                                                      scopes:@[ kTestInvalidScope3 ]
-                                                 redirectURL:redirectURL
-                                                responseType:OIDResponseTypeCode
-                                        additionalParameters:nil]);
-  XCTAssertThrows(
-      [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
-                                                    clientId:kTestClientID
-                                                      scopes:@[ kTestInvalidScope4 ]
-                                                 redirectURL:redirectURL
-                                                responseType:OIDResponseTypeCode
-                                        additionalParameters:nil]);
-  XCTAssertNoThrow(
-      [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
-                                                    clientId:kTestClientID
-                                                      scopes:@[ kTestValidScope1 ]
-                                                 redirectURL:redirectURL
-                                                responseType:OIDResponseTypeCode
-                                        additionalParameters:nil]);
-  XCTAssertNoThrow(
-      [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
-                                                    clientId:kTestClientID
-                                                      scopes:@[ kTestValidScope2 ]
-                                                 redirectURL:redirectURL
-                                                responseType:OIDResponseTypeCode
-                                        additionalParameters:nil]);
-  XCTAssertNoThrow(
-      [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
-                                                    clientId:kTestClientID
-                                                      scopes:@[ kTestValidScope3 ]
-                                                 redirectURL:redirectURL
-                                                responseType:OIDResponseTypeCode
-                                        additionalParameters:nil]);
-  XCTAssertNoThrow(
-      [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
-                                                    clientId:kTestClientID
-                                                      scopes:@[ kTestValidScope4 ]
-                                                 redirectURL:redirectURL
-                                                responseType:OIDResponseTypeCode
-                                        additionalParameters:nil]);
-  XCTAssertNoThrow(
-      [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
-                                                    clientId:kTestClientID
-                                                      scopes:@[ kTestValidScope5 ]
-                                                 redirectURL:redirectURL
-                                                responseType:OIDResponseTypeCode
-                                        additionalParameters:nil]);
+                                        additionalParameters:nil
+                                                       error:&error];
+  XCTAssertNil(request);
+  XCTAssertEqualObjects(error.domain, OIDGeneralErrorDomain);
+  XCTAssertEqual(error.code, OIDErrorCodeInvalidScope);
+
+  error = nil;
+  request = [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
+                                                          clientId:kTestClientID
+                                                            scopes:@[ kTestValidScope1 ]
+                                                       redirectURL:redirectURL
+                                                      responseType:OIDResponseTypeCode
+                                              additionalParameters:nil
+                                                             error:&error];
+  XCTAssertEqualObjects(request.scope, kTestValidScope1);
+  XCTAssertNil(error);
 }
 /*! @fn legalPKCECharacters
     @brief Returns a character set with all legal PKCE characters for the codeVerifier.
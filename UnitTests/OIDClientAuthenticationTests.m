@@ -0,0 +1,488 @@
+/*! @file OIDClientAuthenticationTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDServiceDiscoveryTests.h"
+#import "OIDTokenRequestTests.h"
+#import "Source/OIDAuthorizationService.h"
+#import "Source/OIDCancellable.h"
+#import "Source/OIDClientAuthentication.h"
+#import "Source/OIDClock.h"
+#import "Source/OIDClockSkewEstimator.h"
+#import "Source/OIDHTTPClient.h"
+#import "Source/OIDJWSSigner.h"
+#import "Source/OIDServiceConfiguration.h"
+#import "Source/OIDServiceDiscovery.h"
+#import "Source/OIDTokenRequest.h"
+#import "Source/OIDTokenUtilities.h"
+
+/*! @var kTestClientID
+    @brief A client ID with a character which must be encoded in Basic credentials.
+ */
+static NSString *const kTestClientID = @"s6BhdRkqt3:app";
+
+/*! @var kTestClientSecret
+    @brief A client secret with characters which must be form-encoded.
+ */
+static NSString *const kTestClientSecret = @"7Fjfp0ZBr1KtDRbnfVdmIw&a=b+c";
+
+/*! @class OIDClientAuthenticationTestSigner
+    @brief A private key whose "signature" is the SHA-256 hash of the signing input, which counts
+        its signatures.
+ */
+@interface OIDClientAuthenticationTestSigner : NSObject <OIDJWSSigner>
+
+/*! @property signatureCount
+    @brief The number of signatures made.
+ */
+@property(atomic, readonly) NSUInteger signatureCount;
+
+@end
+
+@implementation OIDClientAuthenticationTestSigner
+
+- (NSString *)algorithm {
+  return @"ES256";
+}
+
+- (NSString *)keyID {
+  return @"key-1";
+}
+
+- (nullable NSData *)signatureForSigningInput:(NSData *)signingInput
+                                        error:(NSError **_Nullable)error {
+  _signatureCount++;
+  NSString *input = [[NSString alloc] initWithData:signingInput encoding:NSASCIIStringEncoding];
+  return [OIDTokenUtilities sha265:input];
+}
+
+@end
+
+/*! @class OIDClientAuthenticationTestHTTPClient
+    @brief Responds to each request with the next of the given token endpoint responses, and
+        records the request bodies.
+ */
+@interface OIDClientAuthenticationTestHTTPClient : OIDHTTPClient <OIDCancellable>
+
+/*! @property responses
+    @brief The responses still to be served, each as a status code and a JSON body.
+ */
+@property(nonatomic, strong) NSMutableArray<NSArray *> *responses;
+
+/*! @property requestBodies
+    @brief The body of each request received.
+ */
+@property(nonatomic, readonly) NSMutableArray<NSData *> *requestBodies;
+
+@end
+
+@implementation OIDClientAuthenticationTestHTTPClient
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _responses = [NSMutableArray array];
+    _requestBodies = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (id<OIDCancellable>)performRequest:(NSURLRequest *)request
+                        endpointType:(OIDHTTPEndpointType)endpointType
+                            priority:(OIDRequestPriority)priority
+                            deadline:(nullable NSDate *)deadline
+                          completion:(OIDHTTPCompletion)completion {
+  NSArray *stubResponse;
+  @synchronized(self) {
+    [_requestBodies addObject:request.HTTPBody ?: [NSData data]];
+    stubResponse = _responses.firstObject;
+    [_responses removeObjectAtIndex:0];
+  }
+  NSHTTPURLResponse *response =
+      [[NSHTTPURLResponse alloc] initWithURL:request.URL
+                                  statusCode:[stubResponse[0] integerValue]
+                                 HTTPVersion:@"HTTP/1.1"
+                                headerFields:@{ @"Content-Type" : @"application/json" }];
+  NSData *body = [stubResponse[1] dataUsingEncoding:NSUTF8StringEncoding];
+  dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^() {
+    completion(body, response, nil);
+  });
+  return self;
+}
+
+- (void)cancel {
+}
+
+@end
+
+/*! @class OIDClientAuthenticationTestClock
+    @brief A clock which is stopped at a fixed time.
+ */
+@interface OIDClientAuthenticationTestClock : OIDClock
+
+/*! @property fixedNow
+    @brief The time the clock reports.
+ */
+@property(nonatomic, copy) NSDate *fixedNow;
+
+@end
+
+@implementation OIDClientAuthenticationTestClock
+
+- (NSDate *)now {
+  return _fixedNow;
+}
+
+@end
+
+/*! @class OIDClientAuthenticationTests
+    @brief Unit tests for @c OIDClientAuthentication.
+ */
+@interface OIDClientAuthenticationTests : XCTestCase
+@end
+
+@implementation OIDClientAuthenticationTests
+
+/*! @fn bodyParametersOfRequest:
+    @brief Decodes the form parameters of a request's body.
+ */
+- (NSDictionary<NSString *, NSString *> *)bodyParametersOfRequest:(NSURLRequest *)request {
+  NSString *body = [[NSString alloc] initWithData:request.HTTPBody encoding:NSUTF8StringEncoding];
+  NSMutableDictionary<NSString *, NSString *> *parameters = [NSMutableDictionary dictionary];
+  for (NSString *pair in [body componentsSeparatedByString:@"&"]) {
+    NSRange separator = [pair rangeOfString:@"="];
+    XCTAssertNotEqual(separator.location, NSNotFound);
+    NSString *value = [[pair substringFromIndex:NSMaxRange(separator)]
+        stringByReplacingOccurrencesOfString:@"+"
+                                  withString:@" "];
+    parameters[[pair substringToIndex:separator.location]] = value.stringByRemovingPercentEncoding;
+  }
+  return parameters;
+}
+
+/*! @fn decodeBase64URL:
+    @brief Decodes unpadded base64url.
+ */
+- (NSData *)decodeBase64URL:(NSString *)string {
+  NSMutableString *base64 = [[string stringByReplacingOccurrencesOfString:@"-" withString:@"+"]
+      mutableCopy];
+  [base64 replaceOccurrencesOfString:@"_"
+                          withString:@"/"
+                             options:0
+                               range:NSMakeRange(0, base64.length)];
+  while (base64.length % 4) {
+    [base64 appendString:@"="];
+  }
+  return [[NSData alloc] initWithBase64EncodedString:base64 options:0];
+}
+
+/*! @fn JSONOfJWTPart:
+    @brief Decodes the JSON of an encoded JWT header or claims set.
+ */
+- (NSDictionary *)JSONOfJWTPart:(NSString *)part {
+  return [NSJSONSerialization JSONObjectWithData:[self decodeBase64URL:part] options:0 error:NULL];
+}
+
+/*! @fn testClientSecretBasic
+    @brief Tests that the credentials are form-encoded before being base64-encoded, and the body
+        is unchanged.
+ */
+- (void)testClientSecretBasic {
+  OIDClientAuthentication *authentication =
+      [OIDClientAuthentication clientSecretBasicAuthenticationWithClientID:kTestClientID
+                                                              clientSecret:kTestClientSecret];
+  NSURLRequest *request = [[OIDTokenRequestTests testInstance] URLRequest];
+  NSURLRequest *authenticated = [authentication requestByAuthenticatingRequest:request error:NULL];
+
+  NSString *credentials = @"s6BhdRkqt3%3Aapp:7Fjfp0ZBr1KtDRbnfVdmIw%26a%3Db%2Bc";
+  NSString *expected = [@"Basic " stringByAppendingString:
+      [[credentials dataUsingEncoding:NSUTF8StringEncoding] base64EncodedStringWithOptions:0]];
+  XCTAssertEqualObjects([authenticated valueForHTTPHeaderField:@"Authorization"], expected);
+  XCTAssertEqualObjects(authenticated.HTTPBody, request.HTTPBody);
+}
+
+/*! @fn testClientSecretPost
+    @brief Tests that the secret is appended to the body.
+ */
+- (void)testClientSecretPost {
+  OIDClientAuthentication *authentication =
+      [OIDClientAuthentication clientSecretPostAuthenticationWithClientID:kTestClientID
+                                                             clientSecret:kTestClientSecret];
+  NSURLRequest *request = [[OIDTokenRequestTests testInstance] URLRequest];
+  NSURLRequest *authenticated = [authentication requestByAuthenticatingRequest:request error:NULL];
+
+  NSDictionary<NSString *, NSString *> *parameters = [self bodyParametersOfRequest:authenticated];
+  XCTAssertEqualObjects(parameters[@"client_secret"], kTestClientSecret);
+  XCTAssertEqualObjects(parameters[@"grant_type"],
+                        [self bodyParametersOfRequest:request][@"grant_type"]);
+  XCTAssertNil([authenticated valueForHTTPHeaderField:@"Authorization"]);
+}
+
+/*! @fn testPrivateKeyJWT
+    @brief Tests the header and claims of a client assertion, and that it's reused for the same
+        audience.
+ */
+- (void)testPrivateKeyJWT {
+  OIDClientAuthenticationTestSigner *signer = [[OIDClientAuthenticationTestSigner alloc] init];
+  OIDClientAuthentication *authentication =
+      [OIDClientAuthentication privateKeyJWTAuthenticationWithClientID:kTestClientID
+                                                                signer:signer];
+  authentication.assertionReuseInterval = 60;
+  NSURLRequest *request = [[OIDTokenRequestTests testInstance] URLRequest];
+  NSURLRequest *authenticated = [authentication requestByAuthenticatingRequest:request error:NULL];
+  NSDictionary<NSString *, NSString *> *parameters = [self bodyParametersOfRequest:authenticated];
+  XCTAssertEqualObjects(parameters[@"client_assertion_type"],
+                        @"urn:ietf:params:oauth:client-assertion-type:jwt-bearer");
+
+  NSString *assertion = parameters[@"client_assertion"];
+  NSArray<NSString *> *parts = [assertion componentsSeparatedByString:@"."];
+  XCTAssertEqual(parts.count, 3);
+  XCTAssertEqualObjects([self JSONOfJWTPart:parts[0]],
+                        (@{ @"alg" : @"ES256", @"typ" : @"JWT", @"kid" : @"key-1" }));
+  NSDictionary *claims = [self JSONOfJWTPart:parts[1]];
+  XCTAssertEqualObjects(claims[@"iss"], kTestClientID);
+  XCTAssertEqualObjects(claims[@"sub"], kTestClientID);
+  XCTAssertEqualObjects(claims[@"aud"], request.URL.absoluteString);
+  XCTAssertNotNil(claims[@"jti"]);
+  XCTAssertEqual([claims[@"exp"] longLongValue] - [claims[@"iat"] longLongValue], 120);
+  NSString *signingInput = [NSString stringWithFormat:@"%@.%@", parts[0], parts[1]];
+  XCTAssertEqualObjects([self decodeBase64URL:parts[2]], [OIDTokenUtilities sha265:signingInput]);
+
+  // a second request within the reuse interval isn't signed again
+  NSURLRequest *second = [authentication requestByAuthenticatingRequest:request error:NULL];
+  XCTAssertEqualObjects([self bodyParametersOfRequest:second][@"client_assertion"], assertion);
+  XCTAssertEqual(signer.signatureCount, 1);
+
+  // but a request to another endpoint is
+  NSMutableURLRequest *otherRequest = [request mutableCopy];
+  otherRequest.URL = [NSURL URLWithString:@"https://other.example.com/token"];
+  NSURLRequest *other = [authentication requestByAuthenticatingRequest:otherRequest error:NULL];
+  NSString *otherAssertion = [self bodyParametersOfRequest:other][@"client_assertion"];
+  NSDictionary *otherClaims =
+      [self JSONOfJWTPart:[otherAssertion componentsSeparatedByString:@"."][1]];
+  XCTAssertEqualObjects(otherClaims[@"aud"], @"https://other.example.com/token");
+  XCTAssertNotEqualObjects(otherClaims[@"jti"], claims[@"jti"]);
+  XCTAssertEqual(signer.signatureCount, 2);
+}
+
+/*! @fn testAssertionsAreNotReusedByDefault
+    @brief Tests that by default every request gets a new assertion with a unique @c jti.
+ */
+- (void)testAssertionsAreNotReusedByDefault {
+  OIDClientAuthenticationTestSigner *signer = [[OIDClientAuthenticationTestSigner alloc] init];
+  OIDClientAuthentication *authentication =
+      [OIDClientAuthentication privateKeyJWTAuthenticationWithClientID:kTestClientID
+                                                                signer:signer];
+  XCTAssertEqual(authentication.assertionReuseInterval, 0);
+  NSURLRequest *request = [[OIDTokenRequestTests testInstance] URLRequest];
+  NSMutableSet<NSString *> *JTIs = [NSMutableSet set];
+  for (int i = 0; i < 3; i++) {
+    NSURLRequest *authenticated =
+        [authentication requestByAuthenticatingRequest:request error:NULL];
+    NSString *assertion = [self bodyParametersOfRequest:authenticated][@"client_assertion"];
+    [JTIs addObject:[self JSONOfJWTPart:[assertion componentsSeparatedByString:@"."][1]][@"jti"]];
+  }
+  XCTAssertEqual(JTIs.count, 3);
+  XCTAssertEqual(signer.signatureCount, 3);
+}
+
+/*! @fn assertionOfRequestBody:
+    @brief Returns the client assertion in a form-encoded request body.
+ */
+- (NSString *)assertionOfRequestBody:(NSData *)body {
+  NSMutableURLRequest *request = [[NSMutableURLRequest alloc] init];
+  request.HTTPBody = body;
+  return [self bodyParametersOfRequest:request][@"client_assertion"];
+}
+
+/*! @fn testInvalidClientDiscardsCachedAssertion
+    @brief Tests that a reused assertion is discarded when the token endpoint responds with
+        @c invalid_client, but not for other errors.
+ */
+- (void)testInvalidClientDiscardsCachedAssertion {
+  OIDClientAuthenticationTestSigner *signer = [[OIDClientAuthenticationTestSigner alloc] init];
+  OIDClientAuthentication *authentication =
+      [OIDClientAuthentication privateKeyJWTAuthenticationWithClientID:kTestClientID
+                                                                signer:signer];
+  authentication.assertionReuseInterval = 60;
+  OIDClientAuthenticationTestHTTPClient *client =
+      [[OIDClientAuthenticationTestHTTPClient alloc] init];
+  [client.responses addObjectsFromArray:@[
+    @[ @400, @"{\"error\":\"invalid_grant\"}" ],
+    @[ @400, @"{\"error\":\"invalid_client\"}" ],
+    @[ @400, @"{\"error\":\"invalid_grant\"}" ],
+  ]];
+  OIDHTTPClient *originalClient = [OIDHTTPClient sharedClient];
+  [OIDHTTPClient setSharedClient:client];
+  for (NSUInteger i = 0; i < 3; i++) {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Token request failed."];
+    [OIDAuthorizationService performTokenRequest:[OIDTokenRequestTests testInstance]
+                            clientAuthentication:authentication
+                                  proofGenerator:nil
+                                        priority:OIDRequestPriorityDefault
+                                        deadline:nil
+                                        callback:^(OIDTokenResponse *_Nullable response,
+                                                   NSError *_Nullable error) {
+      XCTAssertNotNil(error);
+      [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+  }
+  [OIDHTTPClient setSharedClient:originalClient];
+
+  NSArray<NSData *> *bodies = client.requestBodies;
+  XCTAssertEqual(bodies.count, 3);
+  // reused after invalid_grant, discarded after invalid_client
+  XCTAssertEqualObjects([self assertionOfRequestBody:bodies[1]],
+                        [self assertionOfRequestBody:bodies[0]]);
+  XCTAssertNotEqualObjects([self assertionOfRequestBody:bodies[2]],
+                           [self assertionOfRequestBody:bodies[1]]);
+  XCTAssertEqual(signer.signatureCount, 2);
+}
+
+/*! @fn testClientSecretJWT
+    @brief Tests that @c client_secret_jwt assertions are HS256 signatures keyed by the secret.
+ */
+- (void)testClientSecretJWT {
+  OIDClientAuthentication *authentication =
+      [OIDClientAuthentication clientSecretJWTAuthenticationWithClientID:kTestClientID
+                                                            clientSecret:kTestClientSecret];
+  NSURLRequest *request = [[OIDTokenRequestTests testInstance] URLRequest];
+  NSURLRequest *authenticated = [authentication requestByAuthenticatingRequest:request error:NULL];
+  NSString *assertion = [self bodyParametersOfRequest:authenticated][@"client_assertion"];
+  NSArray<NSString *> *parts = [assertion componentsSeparatedByString:@"."];
+  XCTAssertEqualObjects([self JSONOfJWTPart:parts[0]], (@{ @"alg" : @"HS256", @"typ" : @"JWT" }));
+  NSString *signingInput = [NSString stringWithFormat:@"%@.%@", parts[0], parts[1]];
+  NSData *key = [kTestClientSecret dataUsingEncoding:NSUTF8StringEncoding];
+  NSData *expected =
+      [OIDTokenUtilities HMACSHA256WithKey:key
+                                      data:[signingInput dataUsingEncoding:NSASCIIStringEncoding]];
+  XCTAssertEqualObjects([self decodeBase64URL:parts[2]], expected);
+}
+
+/*! @fn testHMACSHA256
+    @brief Tests HMAC-SHA256 against RFC 4231's second test case.
+ */
+- (void)testHMACSHA256 {
+  NSData *MAC = [OIDTokenUtilities
+      HMACSHA256WithKey:[@"Jefe" dataUsingEncoding:NSUTF8StringEncoding]
+                   data:[@"what do ya want for nothing?" dataUsingEncoding:NSUTF8StringEncoding]];
+  NSMutableString *hex = [NSMutableString string];
+  for (NSUInteger i = 0; i < MAC.length; i++) {
+    [hex appendFormat:@"%02x", ((const uint8_t *)MAC.bytes)[i]];
+  }
+  XCTAssertEqualObjects(hex, @"5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+}
+
+/*! @fn configurationWithMethods:algorithms:
+    @brief Returns a configuration whose discovery document lists the given methods and signing
+        algorithms.
+ */
+- (OIDServiceConfiguration *)configurationWithMethods:(nullable NSArray<NSString *> *)methods
+                                           algorithms:(nullable NSArray<NSString *> *)algorithms {
+  NSMutableDictionary *dictionary =
+      [[OIDServiceDiscoveryTests minimumServiceDiscoveryDictionary] mutableCopy];
+  dictionary[@"token_endpoint_auth_methods_supported"] = methods;
+  dictionary[@"token_endpoint_auth_signing_alg_values_supported"] = algorithms;
+  OIDServiceDiscovery *discovery = [[OIDServiceDiscovery alloc] initWithDictionary:dictionary
+                                                                              error:NULL];
+  return [[OIDServiceConfiguration alloc] initWithDiscoveryDocument:discovery];
+}
+
+/*! @fn testAssertionsUseServerTime
+    @brief Tests that the time claims of client assertions follow the shared clock, corrected by
+        the estimated offset of the token endpoint's clock.
+ */
+- (void)testAssertionsUseServerTime {
+  NSMutableURLRequest *request = [[[OIDTokenRequestTests testInstance] URLRequest] mutableCopy];
+  request.URL = [NSURL URLWithString:
+      [NSString stringWithFormat:@"https://%@.example.com/token", [NSUUID UUID].UUIDString]];
+  OIDClientAuthenticationTestClock *clock = [[OIDClientAuthenticationTestClock alloc] init];
+  clock.fixedNow = [NSDate dateWithTimeIntervalSince1970:1500000000];
+  // the device's clock is 90 seconds ahead of the server's
+  [[OIDClockSkewEstimator sharedEstimator]
+      recordServerDate:[clock.fixedNow dateByAddingTimeInterval:-90]
+             localDate:clock.fixedNow
+             forIssuer:request.URL];
+  OIDClientAuthentication *authentication = [OIDClientAuthentication
+      privateKeyJWTAuthenticationWithClientID:kTestClientID
+                                       signer:[[OIDClientAuthenticationTestSigner alloc] init]];
+
+  OIDClock *originalClock = [OIDClock sharedClock];
+  [OIDClock setSharedClock:clock];
+  NSURLRequest *authenticated = [authentication requestByAuthenticatingRequest:request error:NULL];
+  [OIDClock setSharedClock:originalClock];
+
+  NSString *assertion = [self bodyParametersOfRequest:authenticated][@"client_assertion"];
+  NSDictionary *claims = [self JSONOfJWTPart:[assertion componentsSeparatedByString:@"."][1]];
+  XCTAssertEqualObjects(claims[@"iat"], @1499999910);
+  XCTAssertEqualObjects(claims[@"exp"], @1500000030);
+}
+
+/*! @fn testMethodSelection
+    @brief Tests choosing the method from the discovery document.
+ */
+- (void)testMethodSelection {
+  OIDClientAuthenticationTestSigner *signer = [[OIDClientAuthenticationTestSigner alloc] init];
+  NSArray<NSString *> *allMethods = @[
+    @"client_secret_post", @"client_secret_basic", @"client_secret_jwt", @"private_key_jwt"
+  ];
+
+  OIDServiceConfiguration *configuration = [self configurationWithMethods:allMethods
+                                                               algorithms:nil];
+  XCTAssertEqualObjects([OIDClientAuthentication authenticationWithConfiguration:configuration
+                                                                        clientID:kTestClientID
+                                                                    clientSecret:kTestClientSecret
+                                                                          signer:signer].method,
+                        OIDClientAuthenticationMethodPrivateKeyJWT);
+  XCTAssertEqualObjects([OIDClientAuthentication authenticationWithConfiguration:configuration
+                                                                        clientID:kTestClientID
+                                                                    clientSecret:kTestClientSecret
+                                                                          signer:nil].method,
+                        OIDClientAuthenticationMethodClientSecretJWT);
+
+  // the server doesn't accept the signer's algorithm or HS256
+  configuration = [self configurationWithMethods:allMethods algorithms:@[ @"RS256" ]];
+  XCTAssertEqualObjects([OIDClientAuthentication authenticationWithConfiguration:configuration
+                                                                        clientID:kTestClientID
+                                                                    clientSecret:kTestClientSecret
+                                                                          signer:signer].method,
+                        OIDClientAuthenticationMethodClientSecretBasic);
+
+  configuration = [self configurationWithMethods:@[ @"client_secret_post" ] algorithms:nil];
+  XCTAssertEqualObjects([OIDClientAuthentication authenticationWithConfiguration:configuration
+                                                                        clientID:kTestClientID
+                                                                    clientSecret:kTestClientSecret
+                                                                          signer:nil].method,
+                        OIDClientAuthenticationMethodClientSecretPost);
+  XCTAssertNil([OIDClientAuthentication authenticationWithConfiguration:configuration
+                                                               clientID:kTestClientID
+                                                           clientSecret:nil
+                                                                 signer:signer]);
+
+  // without a list, client_secret_basic is the default
+  configuration = [self configurationWithMethods:nil algorithms:nil];
+  XCTAssertEqualObjects([OIDClientAuthentication authenticationWithConfiguration:configuration
+                                                                        clientID:kTestClientID
+                                                                    clientSecret:kTestClientSecret
+                                                                          signer:signer].method,
+                        OIDClientAuthenticationMethodClientSecretBasic);
+}
+
+@end
@@ -0,0 +1,361 @@
+/*! @file OIDClockSkewEstimatorTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDServiceDiscoveryTests.h"
+#import "Source/OIDAuthState.h"
+#import "Source/OIDAuthorizationRequest.h"
+#import "Source/OIDAuthorizationResponse.h"
+#import "Source/OIDCancellable.h"
+#import "Source/OIDClockSkewEstimator.h"
+#import "Source/OIDGrantTypes.h"
+#import "Source/OIDHTTPClient.h"
+#import "Source/OIDResponseTypes.h"
+#import "Source/OIDServiceConfiguration.h"
+#import "Source/OIDServiceDiscovery.h"
+#import "Source/OIDTokenRequest.h"
+#import "Source/OIDTokenResponse.h"
+#import "Source/OIDTokenUtilities.h"
+
+/*! @var kTestIssuer
+    @brief The token endpoint of a test authorization server.
+ */
+static NSString *const kTestIssuer = @"https://skew.example.com/token";
+
+/*! @var kTestAccuracy
+    @brief Allowed error in estimates, as samples have one second resolution.
+ */
+static const NSTimeInterval kTestAccuracy = 1.5;
+
+/*! @var kTestRefreshIssuer
+    @brief The token endpoint of a test authorization server refreshed through the shared
+        estimator, which no other test samples.
+ */
+static NSString *const kTestRefreshIssuer = @"https://refresh.skew.example.com/token";
+
+/*! @class OIDClockSkewTestHTTPClient
+    @brief Answers every request with a successful token response with the given body, without
+        a @c Date header.
+ */
+@interface OIDClockSkewTestHTTPClient : OIDHTTPClient
+
+/*! @property responseBody
+    @brief The JSON body of the responses.
+ */
+@property(nonatomic, copy) NSDictionary *responseBody;
+
+@end
+
+/*! @class OIDClockSkewTestRequest
+    @brief A request handle which can't be cancelled.
+ */
+@interface OIDClockSkewTestRequest : NSObject <OIDCancellable>
+@end
+
+@implementation OIDClockSkewTestRequest
+
+- (void)cancel {
+}
+
+@end
+
+@implementation OIDClockSkewTestHTTPClient
+
+- (id<OIDCancellable>)performRequest:(NSURLRequest *)request
+                        endpointType:(OIDHTTPEndpointType)endpointType
+                            priority:(OIDRequestPriority)priority
+                            deadline:(nullable NSDate *)deadline
+                          completion:(OIDHTTPCompletion)completion {
+  NSData *body = [NSJSONSerialization dataWithJSONObject:_responseBody options:0 error:NULL];
+  NSHTTPURLResponse *response =
+      [[NSHTTPURLResponse alloc] initWithURL:request.URL
+                                  statusCode:200
+                                 HTTPVersion:@"HTTP/1.1"
+                                headerFields:@{ @"Content-Type" : @"application/json" }];
+  dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^() {
+    completion(body, response, nil);
+  });
+  return [[OIDClockSkewTestRequest alloc] init];
+}
+
+@end
+
+/*! @class OIDClockSkewEstimatorTests
+    @brief Unit tests for @c OIDClockSkewEstimator, and its use by @c OIDTokenResponse.
+ */
+@interface OIDClockSkewEstimatorTests : XCTestCase
+@end
+
+@implementation OIDClockSkewEstimatorTests
+
+/*! @fn testHTTPDateParsing
+    @brief Tests parsing the example IMF-fixdate from RFC7231, and rejecting other formats.
+ */
+- (void)testHTTPDateParsing {
+  NSDate *date = [OIDClockSkewEstimator dateWithHTTPDate:@"Sun, 06 Nov 1994 08:49:37 GMT"];
+  XCTAssertEqual(date.timeIntervalSince1970, 784111777);
+  XCTAssertNil([OIDClockSkewEstimator dateWithHTTPDate:@"Sunday, 06-Nov-94 08:49:37 GMT"]);
+  XCTAssertNil([OIDClockSkewEstimator dateWithHTTPDate:@""]);
+}
+
+/*! @fn testDateHeaderSample
+    @brief Tests that the offset is learned from a @c Date header, and applies to every URL with
+        the same origin.
+ */
+- (void)testDateHeaderSample {
+  OIDClockSkewEstimator *estimator = [[OIDClockSkewEstimator alloc] init];
+  NSURL *issuer = [NSURL URLWithString:kTestIssuer];
+  XCTAssertFalse([estimator hasClockOffsetForIssuer:issuer]);
+  XCTAssertEqual([estimator clockOffsetForIssuer:issuer], 0);
+
+  NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+  formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+  formatter.timeZone = [NSTimeZone timeZoneForSecondsFromGMT:0];
+  formatter.dateFormat = @"EEE',' dd MMM yyyy HH':'mm':'ss 'GMT'";
+  NSString *serverDate = [formatter stringFromDate:[NSDate dateWithTimeIntervalSinceNow:100]];
+  NSHTTPURLResponse *response =
+      [[NSHTTPURLResponse alloc] initWithURL:issuer
+                                  statusCode:200
+                                 HTTPVersion:@"HTTP/1.1"
+                                headerFields:@{ @"Date" : serverDate }];
+  [estimator recordDateHeaderOfResponse:response forIssuer:issuer];
+
+  NSURL *otherEndpoint = [NSURL URLWithString:@"https://skew.example.com:443/authorize"];
+  XCTAssert([estimator hasClockOffsetForIssuer:otherEndpoint]);
+  XCTAssertEqualWithAccuracy([estimator clockOffsetForIssuer:otherEndpoint], 100, kTestAccuracy);
+  XCTAssertFalse([estimator hasClockOffsetForIssuer:
+      [NSURL URLWithString:@"https://other.example.com/token"]]);
+}
+
+/*! @fn testIDTokenSample
+    @brief Tests that the offset is learned from the @c iat claim of an ID token.
+ */
+- (void)testIDTokenSample {
+  OIDClockSkewEstimator *estimator = [[OIDClockSkewEstimator alloc] init];
+  NSURL *issuer = [NSURL URLWithString:kTestIssuer];
+  NSDictionary *claims = @{ @"iat" : @((long long)[[NSDate date] timeIntervalSince1970] - 50) };
+  NSData *claimsData = [NSJSONSerialization dataWithJSONObject:claims options:0 error:NULL];
+  NSString *idToken =
+      [NSString stringWithFormat:@"eyJhbGciOiJub25lIn0.%@.",
+                                 [OIDTokenUtilities encodeBase64urlNoPadding:claimsData]];
+  [estimator recordIssuedAtOfIDToken:idToken forIssuer:issuer];
+  XCTAssertEqualWithAccuracy([estimator clockOffsetForIssuer:issuer], -50, kTestAccuracy);
+
+  // malformed tokens are ignored
+  [estimator recordIssuedAtOfIDToken:@"not a JWT" forIssuer:issuer];
+  XCTAssertEqualWithAccuracy([estimator clockOffsetForIssuer:issuer], -50, kTestAccuracy);
+}
+
+/*! @fn testSmoothing
+    @brief Tests that later samples move the estimate gradually.
+ */
+- (void)testSmoothing {
+  OIDClockSkewEstimator *estimator = [[OIDClockSkewEstimator alloc] init];
+  NSURL *issuer = [NSURL URLWithString:kTestIssuer];
+  NSDate *now = [NSDate date];
+  [estimator recordServerDate:[now dateByAddingTimeInterval:10] localDate:now forIssuer:issuer];
+  XCTAssertEqualWithAccuracy([estimator clockOffsetForIssuer:issuer], 10, 0.001);
+  [estimator recordServerDate:[now dateByAddingTimeInterval:20] localDate:now forIssuer:issuer];
+  XCTAssertEqualWithAccuracy([estimator clockOffsetForIssuer:issuer], 12.5, 0.001);
+}
+
+/*! @fn testArchivedResponseCorrectsForClockChange
+    @brief Tests that the expiry of an archived token response is corrected when the estimated
+        offset changes, as it would if the device's clock were changed.
+ */
+- (void)testArchivedResponseCorrectsForClockChange {
+  NSURL *issuer = [NSURL URLWithString:kTestIssuer];
+  OIDClockSkewEstimator *estimator = [OIDClockSkewEstimator sharedEstimator];
+  NSDate *now = [NSDate date];
+  for (NSUInteger i = 0; i < 100; i++) {
+    [estimator recordServerDate:now localDate:now forIssuer:issuer];
+  }
+
+  OIDServiceConfiguration *configuration =
+      [[OIDServiceConfiguration alloc]
+          initWithAuthorizationEndpoint:[NSURL URLWithString:@"https://skew.example.com/auth"]
+                          tokenEndpoint:issuer];
+  OIDTokenRequest *request =
+      [[OIDTokenRequest alloc] initWithConfiguration:configuration
+                                           grantType:OIDGrantTypeRefreshToken
+                                   authorizationCode:nil
+                                         redirectURL:[NSURL URLWithString:@"app:/redirect"]
+                                            clientID:@"ClientID"
+                                              scopes:nil
+                                        refreshToken:@"RefreshToken"
+                                        codeVerifier:nil
+                                additionalParameters:nil];
+  OIDTokenResponse *response =
+      [[OIDTokenResponse alloc] initWithRequest:request
+                                     parameters:@{ @"access_token" : @"AccessToken",
+                                                   @"expires_in" : @3600 }];
+  XCTAssertEqualWithAccuracy([response accessTokenTimeUntilExpiration], 3600, kTestAccuracy);
+
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:response];
+  OIDTokenResponse *unarchived = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssertEqualWithAccuracy([unarchived accessTokenTimeUntilExpiration], 3600, kTestAccuracy);
+
+  // the server now appears 1000s behind, as if the device's clock had been set 1000s ahead; the
+  // expiration date is 1000s closer on the device's clock than it really is
+  for (NSUInteger i = 0; i < 100; i++) {
+    [estimator recordServerDate:now
+                      localDate:[now dateByAddingTimeInterval:1000]
+                      forIssuer:issuer];
+  }
+  XCTAssertEqualWithAccuracy([unarchived accessTokenTimeUntilExpiration],
+                             [unarchived.accessTokenExpirationDate timeIntervalSinceNow] + 1000,
+                             kTestAccuracy);
+  // the response received by this process relies on the monotonic clock instead
+  XCTAssertEqualWithAccuracy([response accessTokenTimeUntilExpiration], 3600, kTestAccuracy);
+}
+
+/*! @fn testOutliersAreDiscarded
+    @brief Tests that a sample far from the estimate is discarded, and that the estimate restarts
+        once outliers persist.
+ */
+- (void)testOutliersAreDiscarded {
+  OIDClockSkewEstimator *estimator = [[OIDClockSkewEstimator alloc] init];
+  NSURL *issuer = [NSURL URLWithString:kTestIssuer];
+  NSDate *now = [NSDate date];
+  [estimator recordServerDate:now localDate:now forIssuer:issuer];
+  NSDate *twoDaysAgo = [now dateByAddingTimeInterval:-2 * 24 * 60 * 60];
+  for (NSUInteger i = 0; i < 3; i++) {
+    [estimator recordServerDate:twoDaysAgo localDate:now forIssuer:issuer];
+    XCTAssertEqualWithAccuracy([estimator clockOffsetForIssuer:issuer], 0, 0.001);
+  }
+  // an inlier resets the count
+  [estimator recordServerDate:now localDate:now forIssuer:issuer];
+  [estimator recordServerDate:twoDaysAgo localDate:now forIssuer:issuer];
+  XCTAssertEqualWithAccuracy([estimator clockOffsetForIssuer:issuer], 0, 0.001);
+
+  NSDate *later = [now dateByAddingTimeInterval:1000];
+  for (NSUInteger i = 0; i < 4; i++) {
+    [estimator recordServerDate:later localDate:now forIssuer:issuer];
+  }
+  XCTAssertEqualWithAccuracy([estimator clockOffsetForIssuer:issuer], 1000, 0.001);
+}
+
+/*! @fn testDiscoveredIssuerIdentifiesServer
+    @brief Tests that offsets are keyed by the discovered issuer, falling back to the token
+        endpoint.
+ */
+- (void)testDiscoveredIssuerIdentifiesServer {
+  NSError *error;
+  OIDServiceDiscovery *discovery =
+      [[OIDServiceDiscovery alloc]
+          initWithDictionary:[OIDServiceDiscoveryTests minimumServiceDiscoveryDictionary]
+                       error:&error];
+  XCTAssertNil(error);
+  OIDServiceConfiguration *discovered =
+      [[OIDServiceConfiguration alloc] initWithDiscoveryDocument:discovery];
+  XCTAssertEqualObjects([OIDClockSkewEstimator issuerForConfiguration:discovered],
+                        discovery.issuer);
+
+  NSURL *tokenEndpoint = [NSURL URLWithString:kTestIssuer];
+  OIDServiceConfiguration *configured =
+      [[OIDServiceConfiguration alloc]
+          initWithAuthorizationEndpoint:[NSURL URLWithString:@"https://skew.example.com/auth"]
+                          tokenEndpoint:tokenEndpoint];
+  XCTAssertEqualObjects([OIDClockSkewEstimator issuerForConfiguration:configured],
+                        tokenEndpoint);
+}
+
+/*! @fn IDTokenIssuedAt:
+    @brief Returns an unsigned ID token with the given @c iat.
+ */
++ (NSString *)IDTokenIssuedAt:(NSDate *)issuedAt {
+  NSDictionary *claims = @{ @"iat" : @((long long)issuedAt.timeIntervalSince1970) };
+  NSData *claimsData = [NSJSONSerialization dataWithJSONObject:claims options:0 error:NULL];
+  return [NSString stringWithFormat:@"eyJhbGciOiJub25lIn0.%@.",
+                                    [OIDTokenUtilities encodeBase64urlNoPadding:claimsData]];
+}
+
+/*! @fn refreshAuthStateHoldingIDToken:responseIDToken:
+    @brief Refreshes an auth state holding one ID token, through a token endpoint which responds
+        with another, and waits for the refresh to complete.
+ */
+- (void)refreshAuthStateHoldingIDToken:(NSString *)heldIDToken
+                       responseIDToken:(NSString *)responseIDToken {
+  NSURL *tokenEndpoint = [NSURL URLWithString:kTestRefreshIssuer];
+  OIDServiceConfiguration *configuration =
+      [[OIDServiceConfiguration alloc] initWithAuthorizationEndpoint:tokenEndpoint
+                                                       tokenEndpoint:tokenEndpoint];
+  OIDAuthorizationRequest *authorizationRequest =
+      [[OIDAuthorizationRequest alloc] initWithConfiguration:configuration
+                                                    clientId:@"ClientID"
+                                                       scope:nil
+                                                 redirectURL:[NSURL URLWithString:@"app:/"]
+                                                responseType:OIDResponseTypeCode
+                                                       state:@"State"
+                                                codeVerifier:nil
+                                        additionalParameters:nil];
+  OIDAuthorizationResponse *authorizationResponse =
+      [[OIDAuthorizationResponse alloc] initWithRequest:authorizationRequest
+                                             parameters:@{ @"code" : @"Code",
+                                                           @"state" : @"State" }];
+  OIDTokenResponse *tokenResponse =
+      [[OIDTokenResponse alloc] initWithRequest:[authorizationResponse tokenExchangeRequest]
+                                     parameters:@{ @"access_token" : @"AccessToken",
+                                                   @"expires_in" : @0,
+                                                   @"id_token" : heldIDToken,
+                                                   @"refresh_token" : @"RefreshToken" }];
+  OIDAuthState *authState =
+      [[OIDAuthState alloc] initWithAuthorizationResponse:authorizationResponse
+                                            tokenResponse:tokenResponse];
+
+  OIDClockSkewTestHTTPClient *client = [[OIDClockSkewTestHTTPClient alloc] init];
+  client.responseBody = @{ @"access_token" : @"NewAccessToken",
+                           @"expires_in" : @3600,
+                           @"id_token" : responseIDToken };
+  OIDHTTPClient *originalClient = [OIDHTTPClient sharedClient];
+  [OIDHTTPClient setSharedClient:client];
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Tokens refreshed."];
+  [authState withFreshTokensPerformAction:^(NSString *_Nullable accessToken,
+                                            NSString *_Nullable idToken,
+                                            NSError *_Nullable error) {
+    XCTAssertEqualObjects(accessToken, @"NewAccessToken");
+    [expectation fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+  [OIDHTTPClient setSharedClient:originalClient];
+}
+
+/*! @fn testRefreshSamplesOnlyNewIDTokens
+    @brief Tests that a refresh response repeating the held ID token, whose @c iat is long past,
+        isn't sampled, while a newly issued one is.
+ */
+- (void)testRefreshSamplesOnlyNewIDTokens {
+  NSURL *issuer = [NSURL URLWithString:kTestRefreshIssuer];
+  OIDClockSkewEstimator *estimator = [OIDClockSkewEstimator sharedEstimator];
+  NSDate *now = [NSDate date];
+  for (NSUInteger i = 0; i < 100; i++) {
+    [estimator recordServerDate:now localDate:now forIssuer:issuer];
+  }
+
+  NSString *staleIDToken =
+      [[self class] IDTokenIssuedAt:[now dateByAddingTimeInterval:-2 * 60 * 60]];
+  [self refreshAuthStateHoldingIDToken:staleIDToken responseIDToken:staleIDToken];
+  XCTAssertEqualWithAccuracy([estimator clockOffsetForIssuer:issuer], 0, kTestAccuracy);
+
+  NSString *newIDToken = [[self class] IDTokenIssuedAt:[now dateByAddingTimeInterval:-40]];
+  [self refreshAuthStateHoldingIDToken:staleIDToken responseIDToken:newIDToken];
+  XCTAssertEqualWithAccuracy([estimator clockOffsetForIssuer:issuer], -10, kTestAccuracy);
+}
+
+@end
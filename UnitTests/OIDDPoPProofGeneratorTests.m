@@ -0,0 +1,459 @@
+/*! @file OIDDPoPProofGeneratorTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDAuthorizationResponseTests.h"
+#import "OIDTokenRequestTests.h"
+#import "Source/OIDAuthState.h"
+#import "Source/OIDAuthorizationService.h"
+#import "Source/OIDClock.h"
+#import "Source/OIDClockSkewEstimator.h"
+#import "Source/OIDDPoPProofGenerator.h"
+#import "Source/OIDError.h"
+#import "Source/OIDHTTPClient.h"
+#import "Source/OIDTokenRequest.h"
+#import "Source/OIDTokenResponse.h"
+#import "Source/OIDTokenUtilities.h"
+
+/*! @var kTestResourceURL
+    @brief A resource server endpoint, whose query isn't part of proofs.
+ */
+static NSString *const kTestResourceURL = @"https://api.example.com/v1/resource?page=2#top";
+
+/*! @var kTestAccessToken
+    @brief An access token sent to the resource server.
+ */
+static NSString *const kTestAccessToken = @"Kz~8mXK1EalYznwH-LC-1fBAo.4Ljp~zsPE_NeO.gxU";
+
+/*! @var gStubResponses
+    @brief The responses the stub serves, in order, as status code, header fields and body.
+        Synchronized on the stub class.
+ */
+static NSMutableArray<NSArray *> *gStubResponses;
+
+/*! @var gStubProofs
+    @brief The DPoP header of each request the stub received. Synchronized on the stub class.
+ */
+static NSMutableArray<NSString *> *gStubProofs;
+
+/*! @class OIDDPoPTestKey
+    @brief A key with the public JWK from RFC 7638's example, whose "signature" is the SHA-256 hash
+        of the signing input, so tests can check what was signed.
+ */
+@interface OIDDPoPTestKey : NSObject <OIDDPoPKey>
+
+/*! @property publicJWKReadCount
+    @brief The number of times @c publicJWK was read.
+ */
+@property(nonatomic, readonly) NSUInteger publicJWKReadCount;
+
+@end
+
+@implementation OIDDPoPTestKey
+
+- (NSString *)algorithm {
+  return @"RS256";
+}
+
+- (NSDictionary<NSString *, NSString *> *)publicJWK {
+  _publicJWKReadCount++;
+  return @{
+    @"kty" : @"RSA",
+    @"n" : @"0vx7agoebGcQSuuPiLJXZptN9nndrQmbXEps2aiAFbWhM78LhWx4cbbfAAtVT86zwu1RK7aPFFxuhDR1L6tSo"
+            "c_BJECPebWKRXjBZCiFV4n3oknjhMstn64tZ_2W-5JsGY4Hc5n9yBXArwl93lqt7_RN5w6Cf0h4QyQ5v-65YGj"
+            "QR0_FDW2QvzqY368QQMicAtaSqzs8KJZgnYb9c7d0zgdAZHzu6qMQvRL5hajrn1n91CbOpbISD08qNLyrdkt-b"
+            "FTWhAI4vMQFh6WeZu0fM4lFd2NcRwr3XPksINHaQ-G_xBniIqbw0Ls1jF44-csFCur-kEgU8awapJzKnqDKgw",
+    @"e" : @"AQAB",
+    @"alg" : @"RS256",
+    @"kid" : @"2011-04-29",
+  };
+}
+
+- (nullable NSData *)signatureForSigningInput:(NSData *)signingInput
+                                        error:(NSError **_Nullable)error {
+  NSString *input = [[NSString alloc] initWithData:signingInput encoding:NSASCIIStringEncoding];
+  return [OIDTokenUtilities sha265:input];
+}
+
+@end
+
+/*! @class OIDDPoPTestsStubProtocol
+    @brief Serves the responses in @c gStubResponses, and records the proof of each request.
+ */
+@interface OIDDPoPTestsStubProtocol : NSURLProtocol
+@end
+
+@implementation OIDDPoPTestsStubProtocol
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+  return YES;
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+  return request;
+}
+
+- (void)startLoading {
+  NSArray *stubResponse;
+  @synchronized([OIDDPoPTestsStubProtocol class]) {
+    [gStubProofs addObject:[self.request valueForHTTPHeaderField:OIDDPoPHeaderField] ?: @""];
+    stubResponse = gStubResponses.firstObject;
+    [gStubResponses removeObjectAtIndex:0];
+  }
+  NSHTTPURLResponse *response =
+      [[NSHTTPURLResponse alloc] initWithURL:self.request.URL
+                                  statusCode:[stubResponse[0] integerValue]
+                                 HTTPVersion:@"HTTP/1.1"
+                                headerFields:stubResponse[1]];
+  [self.client URLProtocol:self
+        didReceiveResponse:response
+        cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+  NSData *body = [stubResponse[2] dataUsingEncoding:NSUTF8StringEncoding];
+  [self.client URLProtocol:self didLoadData:body];
+  [self.client URLProtocolDidFinishLoading:self];
+}
+
+- (void)stopLoading {
+}
+
+@end
+
+/*! @class OIDDPoPTestClock
+    @brief A clock which is stopped at a fixed time.
+ */
+@interface OIDDPoPTestClock : OIDClock
+
+/*! @property fixedNow
+    @brief The time the clock reports.
+ */
+@property(nonatomic, copy) NSDate *fixedNow;
+
+@end
+
+@implementation OIDDPoPTestClock
+
+- (NSDate *)now {
+  return _fixedNow;
+}
+
+@end
+
+/*! @class OIDDPoPProofGeneratorTests
+    @brief Unit tests for @c OIDDPoPProofGenerator, and DPoP in @c OIDAuthorizationService and
+        @c OIDAuthState.
+ */
+@interface OIDDPoPProofGeneratorTests : XCTestCase
+@end
+
+@implementation OIDDPoPProofGeneratorTests {
+  /*! @var _client
+      @brief The shared HTTP client during the test, which is served by the stub.
+   */
+  OIDHTTPClient *_client;
+
+  /*! @var _originalClient
+      @brief The shared HTTP client before the test.
+   */
+  OIDHTTPClient *_originalClient;
+}
+
+- (void)setUp {
+  [super setUp];
+  @synchronized([OIDDPoPTestsStubProtocol class]) {
+    gStubResponses = [NSMutableArray array];
+    gStubProofs = [NSMutableArray array];
+  }
+  NSURLSessionConfiguration *configuration =
+      [NSURLSessionConfiguration ephemeralSessionConfiguration];
+  configuration.protocolClasses = @[ [OIDDPoPTestsStubProtocol class] ];
+  _client = [[OIDHTTPClient alloc] initWithSessionConfiguration:configuration];
+  _originalClient = [OIDHTTPClient sharedClient];
+  [OIDHTTPClient setSharedClient:_client];
+}
+
+- (void)tearDown {
+  [OIDHTTPClient setSharedClient:_originalClient];
+  [_client invalidateAndCancel];
+  _client = nil;
+  [super tearDown];
+}
+
+/*! @fn stubResponseWithStatusCode:headers:body:
+    @brief Adds a response for the stub to serve.
+ */
+- (void)stubResponseWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> *)headers
+                              body:(NSString *)body {
+  NSMutableDictionary *allHeaders = [headers mutableCopy];
+  allHeaders[@"Content-Type"] = @"application/json";
+  @synchronized([OIDDPoPTestsStubProtocol class]) {
+    [gStubResponses addObject:@[ @(statusCode), allHeaders, body ]];
+  }
+}
+
+/*! @fn partsOfProof:
+    @brief Decodes the header and claims of a proof.
+ */
++ (NSArray<NSDictionary *> *)partsOfProof:(NSString *)proof {
+  NSArray<NSString *> *segments = [proof componentsSeparatedByString:@"."];
+  NSMutableArray<NSDictionary *> *parts = [NSMutableArray array];
+  for (NSUInteger i = 0; i < 2 && i < segments.count; i++) {
+    NSData *data = [OIDTokenUtilities decodeBase64urlNoPadding:segments[i]];
+    [parts addObject:[NSJSONSerialization JSONObjectWithData:data options:0 error:NULL] ?: @{}];
+  }
+  return parts;
+}
+
+/*! @fn testThumbprint
+    @brief Tests the thumbprint against the example in RFC 7638 Section 3.1.
+ */
+- (void)testThumbprint {
+  OIDDPoPProofGenerator *generator =
+      [[OIDDPoPProofGenerator alloc] initWithKey:[[OIDDPoPTestKey alloc] init]];
+  XCTAssertEqualObjects(generator.thumbprint, @"NzbLsXh8uDCcd-6MNwXF4W_7noWXFZAfHkxZsRGC9Xs");
+}
+
+/*! @fn testProof
+    @brief Tests the header, claims and signature of a proof.
+ */
+- (void)testProof {
+  OIDDPoPTestKey *key = [[OIDDPoPTestKey alloc] init];
+  OIDDPoPProofGenerator *generator = [[OIDDPoPProofGenerator alloc] initWithKey:key];
+  NSError *error;
+  NSString *proof = [generator proofForHTTPMethod:@"GET"
+                                              URL:[NSURL URLWithString:kTestResourceURL]
+                                      accessToken:nil
+                                            error:&error];
+  XCTAssertNil(error);
+  NSArray<NSDictionary *> *parts = [[self class] partsOfProof:proof];
+  XCTAssertEqualObjects(parts[0][@"typ"], @"dpop+jwt");
+  XCTAssertEqualObjects(parts[0][@"alg"], @"RS256");
+  XCTAssertEqualObjects(parts[0][@"jwk"], key.publicJWK);
+  XCTAssertEqualObjects(parts[1][@"htm"], @"GET");
+  XCTAssertEqualObjects(parts[1][@"htu"], @"https://api.example.com/v1/resource");
+  XCTAssertEqualWithAccuracy([parts[1][@"iat"] doubleValue],
+                             [NSDate date].timeIntervalSince1970,
+                             5);
+  XCTAssertNotNil(parts[1][@"jti"]);
+  XCTAssertNil(parts[1][@"nonce"]);
+  XCTAssertNil(parts[1][@"ath"]);
+
+  NSRange lastPeriod = [proof rangeOfString:@"." options:NSBackwardsSearch];
+  NSString *signingInput = [proof substringToIndex:lastPeriod.location];
+  NSString *encodedSignature = [proof substringFromIndex:NSMaxRange(lastPeriod)];
+  NSData *signature = [OIDTokenUtilities decodeBase64urlNoPadding:encodedSignature];
+  XCTAssertEqualObjects(signature, [OIDTokenUtilities sha265:signingInput]);
+
+  NSString *otherProof = [generator proofForHTTPMethod:@"GET"
+                                                   URL:[NSURL URLWithString:kTestResourceURL]
+                                           accessToken:nil
+                                                 error:NULL];
+  XCTAssertNotEqualObjects([[self class] partsOfProof:otherProof][1][@"jti"], parts[1][@"jti"]);
+  XCTAssertEqual(key.publicJWKReadCount, 2, @"once by the generator, once by this test");
+}
+
+/*! @fn testProofUsesServerTime
+    @brief Tests that the @c iat claim follows the shared clock, corrected by the estimated offset
+        of the server's clock.
+ */
+- (void)testProofUsesServerTime {
+  NSURL *URL = [NSURL URLWithString:
+      [NSString stringWithFormat:@"https://%@.example.com/token", [NSUUID UUID].UUIDString]];
+  OIDDPoPTestClock *clock = [[OIDDPoPTestClock alloc] init];
+  clock.fixedNow = [NSDate dateWithTimeIntervalSince1970:1500000000];
+  // the server's clock is ten minutes ahead
+  [[OIDClockSkewEstimator sharedEstimator]
+      recordServerDate:[clock.fixedNow dateByAddingTimeInterval:600]
+             localDate:clock.fixedNow
+             forIssuer:URL];
+  OIDDPoPProofGenerator *generator =
+      [[OIDDPoPProofGenerator alloc] initWithKey:[[OIDDPoPTestKey alloc] init]];
+
+  OIDClock *originalClock = [OIDClock sharedClock];
+  [OIDClock setSharedClock:clock];
+  NSString *proof = [generator proofForHTTPMethod:@"POST" URL:URL accessToken:nil error:NULL];
+  [OIDClock setSharedClock:originalClock];
+
+  XCTAssertEqualObjects([[self class] partsOfProof:proof][1][@"iat"], @1500000600);
+}
+
+/*! @fn testAccessTokenBinding
+    @brief Tests that a signed resource request carries the token with the DPoP scheme, and a
+        proof with the token's hash.
+ */
+- (void)testAccessTokenBinding {
+  OIDDPoPProofGenerator *generator =
+      [[OIDDPoPProofGenerator alloc] initWithKey:[[OIDDPoPTestKey alloc] init]];
+  NSMutableURLRequest *request =
+      [NSMutableURLRequest requestWithURL:[NSURL URLWithString:kTestResourceURL]];
+  request.HTTPMethod = @"POST";
+  NSURLRequest *signedRequest = [generator requestBySigningRequest:request
+                                                       accessToken:kTestAccessToken
+                                                             error:NULL];
+  XCTAssertEqualObjects([signedRequest valueForHTTPHeaderField:@"Authorization"],
+                        [@"DPoP " stringByAppendingString:kTestAccessToken]);
+  NSDictionary *claims =
+      [[self class] partsOfProof:[signedRequest valueForHTTPHeaderField:@"DPoP"]][1];
+  XCTAssertEqualObjects(claims[@"htm"], @"POST");
+  // the example in RFC 9449 Section 7.1
+  XCTAssertEqualObjects(claims[@"ath"], @"fUHyO2r2Z3DZ53EsNrWBb0xWXoaNy59IiKCAqksmQEo");
+}
+
+/*! @fn testNoncesArePerEndpoint
+    @brief Tests that a recorded nonce is only included in proofs for its endpoint.
+ */
+- (void)testNoncesArePerEndpoint {
+  OIDDPoPProofGenerator *generator =
+      [[OIDDPoPProofGenerator alloc] initWithKey:[[OIDDPoPTestKey alloc] init]];
+  NSURL *resourceURL = [NSURL URLWithString:kTestResourceURL];
+  NSHTTPURLResponse *response =
+      [[NSHTTPURLResponse alloc] initWithURL:resourceURL
+                                  statusCode:401
+                                 HTTPVersion:@"HTTP/1.1"
+                                headerFields:@{ OIDDPoPNonceHeaderField : @"eyJ7S_zG.eyJH0-Z" }];
+  XCTAssert([generator recordNonceFromResponse:response]);
+  XCTAssertFalse([generator recordNonceFromResponse:response], @"the nonce hasn't changed");
+
+  NSString *proof = [generator proofForHTTPMethod:@"GET"
+                                              URL:resourceURL
+                                      accessToken:nil
+                                            error:NULL];
+  XCTAssertEqualObjects([[self class] partsOfProof:proof][1][@"nonce"], @"eyJ7S_zG.eyJH0-Z");
+  NSString *otherProof = [generator proofForHTTPMethod:@"GET"
+                                                   URL:[NSURL URLWithString:@"https://other.com/"]
+                                           accessToken:nil
+                                                 error:NULL];
+  XCTAssertNil([[self class] partsOfProof:otherProof][1][@"nonce"]);
+}
+
+/*! @fn testTokenRequestIsRetriedWithNonce
+    @brief Tests that a token request rejected for lacking a nonce is retried with the nonce.
+ */
+- (void)testTokenRequestIsRetriedWithNonce {
+  [self stubResponseWithStatusCode:400
+                           headers:@{ OIDDPoPNonceHeaderField : @"nonce-1" }
+                              body:@"{\"error\":\"use_dpop_nonce\"}"];
+  [self stubResponseWithStatusCode:200
+                           headers:@{}
+                              body:@"{\"access_token\":\"a\",\"token_type\":\"DPoP\","
+                                    "\"expires_in\":3600}"];
+  OIDDPoPProofGenerator *generator =
+      [[OIDDPoPProofGenerator alloc] initWithKey:[[OIDDPoPTestKey alloc] init]];
+  XCTestExpectation *expectation = [self expectationWithDescription:@"token response"];
+  [OIDAuthorizationService performTokenRequest:[OIDTokenRequestTests testInstance]
+                                proofGenerator:generator
+                                      priority:OIDRequestPriorityDefault
+                                      deadline:nil
+                                      callback:^(OIDTokenResponse *_Nullable response,
+                                                 NSError *_Nullable error) {
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(response.tokenType, @"DPoP");
+    [expectation fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+
+  @synchronized([OIDDPoPTestsStubProtocol class]) {
+    XCTAssertEqual(gStubProofs.count, 2);
+    XCTAssertNil([[self class] partsOfProof:gStubProofs[0]][1][@"nonce"]);
+    XCTAssertEqualObjects([[self class] partsOfProof:gStubProofs[1]][1][@"nonce"], @"nonce-1");
+  }
+}
+
+/*! @fn testTokenRequestIsRetriedOnce
+    @brief Tests that a token request is only retried once, even if the nonce changes again.
+ */
+- (void)testTokenRequestIsRetriedOnce {
+  [self stubResponseWithStatusCode:400
+                           headers:@{ OIDDPoPNonceHeaderField : @"nonce-1" }
+                              body:@"{\"error\":\"use_dpop_nonce\"}"];
+  [self stubResponseWithStatusCode:400
+                           headers:@{ OIDDPoPNonceHeaderField : @"nonce-2" }
+                              body:@"{\"error\":\"use_dpop_nonce\"}"];
+  OIDDPoPProofGenerator *generator =
+      [[OIDDPoPProofGenerator alloc] initWithKey:[[OIDDPoPTestKey alloc] init]];
+  XCTestExpectation *expectation = [self expectationWithDescription:@"token error"];
+  [OIDAuthorizationService performTokenRequest:[OIDTokenRequestTests testInstance]
+                                proofGenerator:generator
+                                      priority:OIDRequestPriorityDefault
+                                      deadline:nil
+                                      callback:^(OIDTokenResponse *_Nullable response,
+                                                 NSError *_Nullable error) {
+    XCTAssertNil(response);
+    XCTAssertEqualObjects(error.domain, OIDOAuthTokenErrorDomain);
+    [expectation fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+  @synchronized([OIDDPoPTestsStubProtocol class]) {
+    XCTAssertEqual(gStubProofs.count, 2);
+  }
+}
+
+/*! @fn authStateWithTokenType:
+    @brief Creates an auth state with a fresh access token of the given type.
+ */
++ (OIDAuthState *)authStateWithTokenType:(NSString *)tokenType {
+  OIDTokenResponse *tokenResponse =
+      [[OIDTokenResponse alloc] initWithRequest:[OIDTokenRequestTests testInstance]
+                                     parameters:@{
+        @"access_token" : kTestAccessToken,
+        @"expires_in" : @3600,
+        @"token_type" : tokenType,
+        @"refresh_token" : @"refresh_token",
+      }];
+  return [[OIDAuthState alloc]
+      initWithAuthorizationResponse:[OIDAuthorizationResponseTests testInstanceCodeFlow]
+                      tokenResponse:tokenResponse];
+}
+
+/*! @fn testAuthStateAuthorizesRequests
+    @brief Tests that auth states send DPoP-bound tokens with proofs, and bearer tokens without.
+ */
+- (void)testAuthStateAuthorizesRequests {
+  OIDDPoPProofGenerator *generator =
+      [[OIDDPoPProofGenerator alloc] initWithKey:[[OIDDPoPTestKey alloc] init]];
+  NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:kTestResourceURL]];
+
+  OIDAuthState *boundState = [[self class] authStateWithTokenType:@"DPoP"];
+  boundState.proofGenerator = generator;
+  XCTestExpectation *boundExpectation = [self expectationWithDescription:@"DPoP request"];
+  [boundState withFreshTokensAuthorizeRequest:request
+                                       action:^(NSURLRequest *_Nullable authorizedRequest,
+                                                NSError *_Nullable error) {
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([authorizedRequest valueForHTTPHeaderField:@"Authorization"],
+                          [@"DPoP " stringByAppendingString:kTestAccessToken]);
+    XCTAssertNotNil([authorizedRequest valueForHTTPHeaderField:OIDDPoPHeaderField]);
+    [boundExpectation fulfill];
+  }];
+
+  OIDAuthState *bearerState = [[self class] authStateWithTokenType:@"Bearer"];
+  bearerState.proofGenerator = generator;
+  XCTestExpectation *bearerExpectation = [self expectationWithDescription:@"bearer request"];
+  [bearerState withFreshTokensAuthorizeRequest:request
+                                        action:^(NSURLRequest *_Nullable authorizedRequest,
+                                                 NSError *_Nullable error) {
+    XCTAssertEqualObjects([authorizedRequest valueForHTTPHeaderField:@"Authorization"],
+                          [@"Bearer " stringByAppendingString:kTestAccessToken]);
+    XCTAssertNil([authorizedRequest valueForHTTPHeaderField:OIDDPoPHeaderField]);
+    [bearerExpectation fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+@end
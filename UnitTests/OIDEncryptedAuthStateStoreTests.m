@@ -0,0 +1,291 @@
+/*! @file OIDEncryptedAuthStateStoreTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#include <sys/stat.h>
+
+#import "OIDAuthStateTests.h"
+#import "Source/OIDAuthState.h"
+#import "Source/OIDEncryptedAuthStateStore.h"
+#import "Source/OIDError.h"
+#import "Source/OIDFileKeySource.h"
+#import "Source/OIDTokenResponse.h"
+
+/*! @var kTestIdentifier
+    @brief The identifier auth states are saved under.
+ */
+static NSString *const kTestIdentifier = @"user@example.com";
+
+/*! @var kOtherTestIdentifier
+    @brief A second identifier, for tests with several records.
+ */
+static NSString *const kOtherTestIdentifier = @"other@example.com";
+
+/*! @var kBenchmarkRecordCount
+    @brief The number of records saved or loaded in each iteration of the throughput benchmarks.
+ */
+static NSUInteger const kBenchmarkRecordCount = 100;
+
+/*! @class OIDEncryptedAuthStateStoreTests
+    @brief Unit tests for @c OIDEncryptedAuthStateStore and @c OIDFileKeySource.
+ */
+@interface OIDEncryptedAuthStateStoreTests : XCTestCase
+@end
+
+@implementation OIDEncryptedAuthStateStoreTests {
+  /*! @var _temporaryURL
+      @brief A unique directory containing the test's key file and records.
+   */
+  NSURL *_temporaryURL;
+}
+
+- (void)setUp {
+  [super setUp];
+  NSString *path =
+      [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+  _temporaryURL = [NSURL fileURLWithPath:path isDirectory:YES];
+  [[NSFileManager defaultManager] createDirectoryAtURL:_temporaryURL
+                           withIntermediateDirectories:YES
+                                            attributes:nil
+                                                 error:NULL];
+}
+
+- (void)tearDown {
+  [[NSFileManager defaultManager] removeItemAtURL:_temporaryURL error:NULL];
+  _temporaryURL = nil;
+  [super tearDown];
+}
+
+/*! @fn keySourceNamed:
+    @brief Returns a key source for a key file in the test's directory.
+ */
+- (OIDFileKeySource *)keySourceNamed:(NSString *)name {
+  NSURL *fileURL = [_temporaryURL URLByAppendingPathComponent:name];
+  return [[OIDFileKeySource alloc] initWithFileURL:fileURL];
+}
+
+/*! @fn storeWithKeySource:
+    @brief Returns a store for the test's records directory.
+ */
+- (OIDEncryptedAuthStateStore *)storeWithKeySource:(id<OIDKeySource>)keySource {
+  NSURL *directoryURL = [_temporaryURL URLByAppendingPathComponent:@"records"];
+  return [[OIDEncryptedAuthStateStore alloc] initWithDirectoryURL:directoryURL
+                                                        keySource:keySource];
+}
+
+/*! @fn recordURLs:
+    @brief Returns the record files in the test's records directory.
+ */
+- (NSArray<NSURL *> *)recordURLs {
+  NSURL *directoryURL = [_temporaryURL URLByAppendingPathComponent:@"records"];
+  return [[NSFileManager defaultManager] contentsOfDirectoryAtURL:directoryURL
+                                       includingPropertiesForKeys:nil
+                                                          options:0
+                                                            error:NULL];
+}
+
+/*! @fn testFileKeySource
+    @brief Tests that the key file is created once with owner-only permissions, and that a key of
+        the wrong length is an error.
+ */
+- (void)testFileKeySource {
+  OIDFileKeySource *keySource = [self keySourceNamed:@"key"];
+  NSError *error;
+  NSData *key = [keySource dataKeyWithLength:64 error:&error];
+  XCTAssertEqual(key.length, 64);
+  XCTAssertNil(error);
+  XCTAssertEqualObjects([[self keySourceNamed:@"key"] dataKeyWithLength:64 error:NULL], key);
+
+  struct stat fileStatus;
+  XCTAssertEqual(stat(keySource.fileURL.path.fileSystemRepresentation, &fileStatus), 0);
+  XCTAssertEqual(fileStatus.st_mode & 0777, 0600);
+
+  XCTAssertNil([keySource dataKeyWithLength:32 error:&error]);
+  XCTAssertEqualObjects(error.domain, OIDGeneralErrorDomain);
+  XCTAssertEqual(error.code, OIDErrorCodeKeyUnavailable);
+}
+
+/*! @fn testRoundTrip
+    @brief Tests that a saved state can be loaded by another store with the same key.
+ */
+- (void)testRoundTrip {
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  NSError *error;
+  XCTAssert([[self storeWithKeySource:[self keySourceNamed:@"key"]] saveAuthState:authState
+                                                                     forIdentifier:kTestIdentifier
+                                                                             error:&error]);
+  XCTAssertNil(error);
+
+  OIDEncryptedAuthStateStore *store = [self storeWithKeySource:[self keySourceNamed:@"key"]];
+  OIDAuthState *loaded = [store authStateForIdentifier:kTestIdentifier error:&error];
+  XCTAssertNil(error);
+  XCTAssertEqualObjects(loaded.refreshToken, authState.refreshToken);
+  XCTAssertEqualObjects(loaded.lastTokenResponse.accessToken,
+                        authState.lastTokenResponse.accessToken);
+
+  XCTAssertNil([store authStateForIdentifier:kOtherTestIdentifier error:&error]);
+  XCTAssertNil(error, @"a missing record isn't an error");
+
+  XCTAssert([store removeAuthStateForIdentifier:kTestIdentifier error:&error]);
+  XCTAssertNil([store authStateForIdentifier:kTestIdentifier error:&error]);
+  XCTAssertNil(error);
+  XCTAssert([store removeAuthStateForIdentifier:kTestIdentifier error:&error]);
+}
+
+/*! @fn testPlaintextIsNotStored
+    @brief Tests that the refresh token doesn't appear in the record.
+ */
+- (void)testPlaintextIsNotStored {
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  OIDEncryptedAuthStateStore *store = [self storeWithKeySource:[self keySourceNamed:@"key"]];
+  XCTAssert([store saveAuthState:authState forIdentifier:kTestIdentifier error:NULL]);
+
+  NSData *record = [NSData dataWithContentsOfURL:[self recordURLs].firstObject];
+  NSData *refreshToken = [authState.refreshToken dataUsingEncoding:NSUTF8StringEncoding];
+  XCTAssertNotNil(record);
+  XCTAssertEqual([record rangeOfData:refreshToken options:0 range:NSMakeRange(0, record.length)]
+                     .location,
+                 NSNotFound);
+}
+
+/*! @fn testUnchangedStateIsNotRewritten
+    @brief Tests that saving an unchanged state leaves its record alone, and that saving a changed
+        one encrypts it under a new nonce.
+ */
+- (void)testUnchangedStateIsNotRewritten {
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  OIDEncryptedAuthStateStore *store = [self storeWithKeySource:[self keySourceNamed:@"key"]];
+  XCTAssert([store saveAuthState:authState forIdentifier:kTestIdentifier error:NULL]);
+  NSURL *recordURL = [self recordURLs].firstObject;
+  NSData *record = [NSData dataWithContentsOfURL:recordURL];
+
+  XCTAssert([store saveAuthState:authState forIdentifier:kTestIdentifier error:NULL]);
+  XCTAssertEqualObjects([NSData dataWithContentsOfURL:recordURL], record);
+
+  [authState updateWithAuthorizationError:[NSError errorWithDomain:OIDOAuthTokenErrorDomain
+                                                              code:OIDErrorCodeOAuthInvalidGrant
+                                                          userInfo:nil]];
+  XCTAssert([store saveAuthState:authState forIdentifier:kTestIdentifier error:NULL]);
+  NSData *changedRecord = [NSData dataWithContentsOfURL:recordURL];
+  XCTAssertNotEqualObjects(changedRecord, record);
+  XCTAssertNotEqualObjects([changedRecord subdataWithRange:NSMakeRange(1, 16)],
+                           [record subdataWithRange:NSMakeRange(1, 16)]);
+}
+
+/*! @fn testTamperedRecordIsRejected
+    @brief Tests that flipping any bit of a record makes it fail authentication.
+ */
+- (void)testTamperedRecordIsRejected {
+  OIDEncryptedAuthStateStore *store = [self storeWithKeySource:[self keySourceNamed:@"key"]];
+  XCTAssert([store saveAuthState:[OIDAuthStateTests testInstance]
+                   forIdentifier:kTestIdentifier
+                           error:NULL]);
+  NSURL *recordURL = [self recordURLs].firstObject;
+  NSData *record = [NSData dataWithContentsOfURL:recordURL];
+
+  for (NSUInteger offset = 0; offset < record.length; offset += record.length / 7) {
+    NSMutableData *tampered = [record mutableCopy];
+    ((uint8_t *)tampered.mutableBytes)[offset] ^= 0x01;
+    [tampered writeToURL:recordURL atomically:YES];
+
+    NSError *error;
+    XCTAssertNil([store authStateForIdentifier:kTestIdentifier error:&error]);
+    XCTAssertEqualObjects(error.domain, OIDGeneralErrorDomain);
+    XCTAssertEqual(error.code, OIDErrorCodeStoredRecordInvalid, @"offset %lu",
+                   (unsigned long)offset);
+  }
+}
+
+/*! @fn testRecordIsBoundToIdentifier
+    @brief Tests that a record moved to another identifier fails authentication.
+ */
+- (void)testRecordIsBoundToIdentifier {
+  OIDEncryptedAuthStateStore *store = [self storeWithKeySource:[self keySourceNamed:@"key"]];
+  XCTAssert([store saveAuthState:[OIDAuthStateTests testInstance]
+                   forIdentifier:kOtherTestIdentifier
+                           error:NULL]);
+  NSURL *otherRecordURL = [self recordURLs].firstObject;
+  XCTAssert([store saveAuthState:[OIDAuthStateTests testInstance]
+                   forIdentifier:kTestIdentifier
+                           error:NULL]);
+  NSURL *recordURL = nil;
+  for (NSURL *URL in [self recordURLs]) {
+    if (![URL.lastPathComponent isEqual:otherRecordURL.lastPathComponent]) {
+      recordURL = URL;
+    }
+  }
+  XCTAssertNotNil(recordURL);
+  [[NSData dataWithContentsOfURL:otherRecordURL] writeToURL:recordURL atomically:YES];
+
+  NSError *error;
+  XCTAssertNil([store authStateForIdentifier:kTestIdentifier error:&error]);
+  XCTAssertEqual(error.code, OIDErrorCodeStoredRecordInvalid);
+  XCTAssertNotNil([store authStateForIdentifier:kOtherTestIdentifier error:NULL]);
+}
+
+/*! @fn testOtherKeyIsRejected
+    @brief Tests that a record can't be loaded with a different key.
+ */
+- (void)testOtherKeyIsRejected {
+  XCTAssert([[self storeWithKeySource:[self keySourceNamed:@"key"]]
+      saveAuthState:[OIDAuthStateTests testInstance]
+      forIdentifier:kTestIdentifier
+              error:NULL]);
+  OIDEncryptedAuthStateStore *store = [self storeWithKeySource:[self keySourceNamed:@"otherKey"]];
+  NSError *error;
+  XCTAssertNil([store authStateForIdentifier:kTestIdentifier error:&error]);
+  XCTAssertEqual(error.code, OIDErrorCodeStoredRecordInvalid);
+}
+
+/*! @fn testSaveThroughput
+    @brief Measures saving distinct records, each of which is archived, encrypted and written.
+ */
+- (void)testSaveThroughput {
+  OIDEncryptedAuthStateStore *store = [self storeWithKeySource:[self keySourceNamed:@"key"]];
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  __block NSUInteger iteration = 0;
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < kBenchmarkRecordCount; i++) {
+      NSString *identifier =
+          [NSString stringWithFormat:@"%lu-%lu", (unsigned long)iteration, (unsigned long)i];
+      XCTAssert([store saveAuthState:authState forIdentifier:identifier error:NULL]);
+    }
+    iteration++;
+  }];
+}
+
+/*! @fn testLoadThroughput
+    @brief Measures loading records, each of which is read, authenticated, decrypted and decoded.
+ */
+- (void)testLoadThroughput {
+  OIDEncryptedAuthStateStore *store = [self storeWithKeySource:[self keySourceNamed:@"key"]];
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  for (NSUInteger i = 0; i < kBenchmarkRecordCount; i++) {
+    NSString *identifier = [NSString stringWithFormat:@"%lu", (unsigned long)i];
+    XCTAssert([store saveAuthState:authState forIdentifier:identifier error:NULL]);
+  }
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < kBenchmarkRecordCount; i++) {
+      NSString *identifier = [NSString stringWithFormat:@"%lu", (unsigned long)i];
+      XCTAssertNotNil([store authStateForIdentifier:identifier error:NULL]);
+    }
+  }];
+}
+
+@end
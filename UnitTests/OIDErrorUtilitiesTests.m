@@ -0,0 +1,167 @@
+/*! @file OIDErrorUtilitiesTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "Source/OIDError.h"
+#import "Source/OIDErrorUtilities.h"
+
+/*! @var kTestURL
+    @brief The URL of the simulated HTTP responses.
+ */
+static NSString *const kTestURL = @"https://www.example.com/token";
+
+/*! @class OIDErrorUtilitiesTests
+    @brief Unit tests for @c OIDErrorUtilities.
+ */
+@interface OIDErrorUtilitiesTests : XCTestCase
+@end
+
+@implementation OIDErrorUtilitiesTests
+
+/*! @fn HTTPResponseWithStatusCode:headers:
+    @brief Creates an HTTP response for testing.
+ */
++ (NSHTTPURLResponse *)HTTPResponseWithStatusCode:(NSInteger)statusCode
+                                          headers:(nullable NSDictionary *)headers {
+  return [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:kTestURL]
+                                     statusCode:statusCode
+                                    HTTPVersion:@"HTTP/1.1"
+                                   headerFields:headers];
+}
+
+/*! @fn testOAuthErrorCodeFromString
+    @brief Tests the OAuth error code table, including for unknown and non-string codes.
+ */
+- (void)testOAuthErrorCodeFromString {
+  XCTAssertEqual([OIDErrorUtilities OAuthErrorCodeFromString:@"invalid_grant"],
+                 OIDErrorCodeOAuthInvalidGrant);
+  XCTAssertEqual([OIDErrorUtilities OAuthErrorCodeFromString:@"invalid_client_metadata"],
+                 OIDErrorCodeOAuthInvalidClientMetadata);
+  XCTAssertEqual([OIDErrorUtilities OAuthErrorCodeFromString:@"custom_error"],
+                 OIDErrorCodeOAuthOther);
+  XCTAssertEqual([OIDErrorUtilities OAuthErrorCodeFromString:(NSString *)@42],
+                 OIDErrorCodeOAuthOther);
+}
+
+/*! @fn testHTTPErrorBodyIsBounded
+    @brief Tests that only the start of a large error page is kept, and that the description is
+        decoded from it.
+ */
+- (void)testHTTPErrorBodyIsBounded {
+  NSMutableData *body = [NSMutableData dataWithLength:1024 * 1024];
+  memset(body.mutableBytes, 'x', body.length);
+  NSError *error =
+      [OIDErrorUtilities HTTPErrorWithHTTPResponse:[[self class] HTTPResponseWithStatusCode:502
+                                                                                  headers:nil]
+                                              data:body];
+  NSData *captured = error.userInfo[OIDHTTPErrorResponseBodyKey];
+  XCTAssertEqual(captured.length, OIDHTTPErrorResponseBodyCaptureLimit);
+  XCTAssertEqual(error.localizedDescription.length, OIDHTTPErrorResponseBodyCaptureLimit);
+  XCTAssertEqual(error.code, 502);
+}
+
+/*! @fn testHTTPErrorDescriptionWithTruncatedCharacter
+    @brief Tests that a body truncated partway through a multi-byte character is still decoded.
+ */
+- (void)testHTTPErrorDescriptionWithTruncatedCharacter {
+  NSMutableData *body = [NSMutableData dataWithLength:OIDHTTPErrorResponseBodyCaptureLimit - 1];
+  memset(body.mutableBytes, 'x', body.length);
+  [body appendData:[@"é" dataUsingEncoding:NSUTF8StringEncoding]];
+  NSError *error =
+      [OIDErrorUtilities HTTPErrorWithHTTPResponse:[[self class] HTTPResponseWithStatusCode:500
+                                                                                  headers:nil]
+                                              data:body];
+  XCTAssertEqual(error.localizedDescription.length, OIDHTTPErrorResponseBodyCaptureLimit - 1);
+}
+
+/*! @fn testHTTPErrorRetryability
+    @brief Tests the classification of HTTP status codes, and that Retry-After is captured.
+ */
+- (void)testHTTPErrorRetryability {
+  NSHTTPURLResponse *throttledResponse =
+      [[self class] HTTPResponseWithStatusCode:429 headers:@{ @"Retry-After" : @"30" }];
+  NSError *throttled = [OIDErrorUtilities HTTPErrorWithHTTPResponse:throttledResponse data:nil];
+  XCTAssertEqual([OIDErrorUtilities retryabilityOfError:throttled], OIDErrorRetryabilityTransient);
+  XCTAssertEqualObjects(throttled.userInfo[OIDHTTPErrorRetryAfterKey], @30);
+
+  NSError *notFound = [OIDErrorUtilities
+      HTTPErrorWithHTTPResponse:[[self class] HTTPResponseWithStatusCode:404 headers:nil]
+                           data:nil];
+  XCTAssertEqual([OIDErrorUtilities retryabilityOfError:notFound], OIDErrorRetryabilityNone);
+  XCTAssertNil(notFound.userInfo[OIDHTTPErrorRetryAfterKey]);
+
+  // a server error wrapping a transient HTTP error is transient
+  NSError *serverError = [OIDErrorUtilities errorWithCode:OIDErrorCodeServerError
+                                          underlyingError:throttled
+                                              description:nil];
+  XCTAssertEqualObjects(serverError.userInfo[OIDErrorRetryabilityKey],
+                        @(OIDErrorRetryabilityTransient));
+}
+
+/*! @fn testOAuthErrorRetryability
+    @brief Tests that only the OAuth errors which indicate a server problem are transient.
+ */
+- (void)testOAuthErrorRetryability {
+  NSDictionary *unavailableResponse = @{ OIDOAuthErrorFieldError : @"temporarily_unavailable" };
+  NSError *unavailable = [OIDErrorUtilities OAuthErrorWithDomain:OIDOAuthTokenErrorDomain
+                                                   OAuthResponse:unavailableResponse
+                                                 underlyingError:nil];
+  XCTAssertEqual([OIDErrorUtilities retryabilityOfError:unavailable],
+                 OIDErrorRetryabilityTransient);
+
+  NSError *invalidGrant =
+      [OIDErrorUtilities OAuthErrorWithDomain:OIDOAuthTokenErrorDomain
+                                OAuthResponse:@{ OIDOAuthErrorFieldError : @"invalid_grant" }
+                              underlyingError:nil];
+  XCTAssertEqual([OIDErrorUtilities retryabilityOfError:invalidGrant], OIDErrorRetryabilityNone);
+}
+
+/*! @fn testNetworkErrorRetryability
+    @brief Tests that network errors take the retryability of the underlying error.
+ */
+- (void)testNetworkErrorRetryability {
+  NSError *offline = [NSError errorWithDomain:NSURLErrorDomain
+                                         code:NSURLErrorNotConnectedToInternet
+                                     userInfo:nil];
+  NSError *cancelled = [NSError errorWithDomain:NSURLErrorDomain
+                                           code:NSURLErrorCancelled
+                                       userInfo:nil];
+  XCTAssertEqual([OIDErrorUtilities retryabilityOfError:offline], OIDErrorRetryabilityTransient);
+  XCTAssertEqual([OIDErrorUtilities retryabilityOfError:cancelled], OIDErrorRetryabilityNone);
+
+  NSError *networkError = [OIDErrorUtilities errorWithCode:OIDErrorCodeNetworkError
+                                           underlyingError:offline
+                                               description:nil];
+  XCTAssertEqual([OIDErrorUtilities retryabilityOfError:networkError],
+                 OIDErrorRetryabilityTransient);
+  NSError *cancelledError = [OIDErrorUtilities errorWithCode:OIDErrorCodeNetworkError
+                                             underlyingError:cancelled
+                                                 description:nil];
+  XCTAssertEqual([OIDErrorUtilities retryabilityOfError:cancelledError],
+                 OIDErrorRetryabilityNone);
+
+  NSError *userCanceled =
+      [OIDErrorUtilities errorWithCode:OIDErrorCodeUserCanceledAuthorizationFlow
+                       underlyingError:nil
+                           description:nil];
+  XCTAssertEqualObjects(userCanceled.userInfo[OIDErrorRetryabilityKey],
+                        @(OIDErrorRetryabilityNone));
+}
+
+@end
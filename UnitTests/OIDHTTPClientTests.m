@@ -0,0 +1,511 @@
+/*! @file OIDHTTPClientTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "Source/OIDError.h"
+#import "Source/OIDHTTPClient.h"
+
+/*! @var kTestURL
+    @brief The URL requested in tests, which is served by @c OIDHTTPClientTestsStubProtocol.
+ */
+static NSString *const kTestURL = @"https://stub.example.com/token";
+
+/*! @var kStubChunkSize
+    @brief The number of bytes the stub sends at a time.
+ */
+static NSUInteger const kStubChunkSize = 64 * 1024;
+
+/*! @var kOversizedBodyLength
+    @brief The length of the oversized bodies sent by the stub.
+ */
+static NSUInteger const kOversizedBodyLength = 16 * 1024 * 1024;
+
+/*! @var gStubStatusCode
+    @brief The status code of the stub's response.
+ */
+static NSInteger gStubStatusCode;
+
+/*! @var gStubHeaders
+    @brief The header fields of the stub's response.
+ */
+static NSDictionary<NSString *, NSString *> *gStubHeaders;
+
+/*! @var gStubBodyPrefix
+    @brief The start of the stub's response body.
+ */
+static NSData *gStubBodyPrefix;
+
+/*! @var gStubBodyLength
+    @brief The length of the stub's response body. Bytes beyond the prefix are generated as they
+        are sent, so the stub itself doesn't hold the body in memory.
+ */
+static NSUInteger gStubBodyLength;
+
+/*! @var gStubBytesSent
+    @brief The number of body bytes the stub has sent. Synchronized on the stub class.
+ */
+static NSUInteger gStubBytesSent;
+
+/*! @var gStubStartedRequests
+    @brief The query strings of the requests the stub has started loading, in order. Synchronized
+        on the stub class.
+ */
+static NSMutableArray<NSString *> *gStubStartedRequests;
+
+/*! @class OIDHTTPClientTestsStubProtocol
+    @brief Serves every request with the configured response, sending the body a chunk at a time
+        from a timer until the body is complete or loading is stopped.
+ */
+@interface OIDHTTPClientTestsStubProtocol : NSURLProtocol
+@end
+
+@implementation OIDHTTPClientTestsStubProtocol {
+  NSTimer *_timer;
+  NSUInteger _offset;
+}
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+  return YES;
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+  return request;
+}
+
+- (void)startLoading {
+  @synchronized([OIDHTTPClientTestsStubProtocol class]) {
+    [gStubStartedRequests addObject:self.request.URL.query ?: @""];
+  }
+  NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL
+                                                            statusCode:gStubStatusCode
+                                                           HTTPVersion:@"HTTP/1.1"
+                                                          headerFields:gStubHeaders];
+  [self.client URLProtocol:self
+        didReceiveResponse:response
+        cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+  // the timer runs on the loading thread, which is where the client must be messaged
+  _timer = [NSTimer scheduledTimerWithTimeInterval:0.001
+                                            target:self
+                                          selector:@selector(sendChunk)
+                                          userInfo:nil
+                                           repeats:YES];
+}
+
+- (void)stopLoading {
+  [_timer invalidate];
+  _timer = nil;
+}
+
+/*! @fn sendChunk
+    @brief Sends the next chunk of the body, or finishes loading if it has all been sent.
+ */
+- (void)sendChunk {
+  if (_offset >= gStubBodyLength) {
+    [self stopLoading];
+    [self.client URLProtocolDidFinishLoading:self];
+    return;
+  }
+  NSUInteger length = MIN(kStubChunkSize, gStubBodyLength - _offset);
+  NSMutableData *chunk = [NSMutableData dataWithLength:length];
+  memset(chunk.mutableBytes, 'a', length);
+  if (_offset < gStubBodyPrefix.length) {
+    NSUInteger prefixLength = MIN(length, gStubBodyPrefix.length - _offset);
+    [chunk replaceBytesInRange:NSMakeRange(0, prefixLength)
+                     withBytes:(const char *)gStubBodyPrefix.bytes + _offset];
+  }
+  _offset += length;
+  @synchronized([OIDHTTPClientTestsStubProtocol class]) {
+    gStubBytesSent += length;
+  }
+  [self.client URLProtocol:self didLoadData:chunk];
+}
+
+@end
+
+/*! @class OIDHTTPClientTests
+    @brief Unit tests for @c OIDHTTPClient, against a local stub that sends oversized bodies.
+ */
+@interface OIDHTTPClientTests : XCTestCase
+@end
+
+@implementation OIDHTTPClientTests {
+  OIDHTTPClient *_client;
+}
+
+- (void)setUp {
+  [super setUp];
+  gStubStatusCode = 200;
+  gStubHeaders = @{ @"Content-Type" : @"application/json" };
+  gStubBodyPrefix = [NSData data];
+  gStubBodyLength = 0;
+  @synchronized([OIDHTTPClientTestsStubProtocol class]) {
+    gStubBytesSent = 0;
+    gStubStartedRequests = [NSMutableArray array];
+  }
+
+  NSURLSessionConfiguration *configuration =
+      [NSURLSessionConfiguration ephemeralSessionConfiguration];
+  configuration.protocolClasses = @[ [OIDHTTPClientTestsStubProtocol class] ];
+  _client = [[OIDHTTPClient alloc] initWithSessionConfiguration:configuration];
+}
+
+- (void)tearDown {
+  [_client invalidateAndCancel];
+  _client = nil;
+  [super tearDown];
+}
+
+/*! @fn stubBody:
+    @brief Configures the stub to send the given body.
+ */
+- (void)stubBody:(NSString *)body {
+  gStubBodyPrefix = [body dataUsingEncoding:NSUTF8StringEncoding];
+  gStubBodyLength = gStubBodyPrefix.length;
+}
+
+/*! @fn stubOversizedJSONBody
+    @brief Configures the stub to send a JSON object of @c kOversizedBodyLength bytes, without
+        declaring its length.
+ */
+- (void)stubOversizedJSONBody {
+  gStubBodyPrefix = [@"{\"padding\":\"" dataUsingEncoding:NSUTF8StringEncoding];
+  gStubBodyLength = kOversizedBodyLength;
+}
+
+/*! @fn bytesSent
+    @brief The number of body bytes the stub has sent.
+ */
+- (NSUInteger)bytesSent {
+  @synchronized([OIDHTTPClientTestsStubProtocol class]) {
+    return gStubBytesSent;
+  }
+}
+
+/*! @fn performTokenRequest:
+    @brief Performs a request to the stub and waits for it to complete.
+    @param completion Called with the results of the request.
+ */
+- (void)performTokenRequest:(OIDHTTPCompletion)completion {
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Request completes."];
+  NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:kTestURL]];
+  [_client performRequest:request
+             endpointType:OIDHTTPEndpointTypeToken
+               completion:^(NSData *_Nullable data,
+                            NSHTTPURLResponse *_Nullable response,
+                            NSError *_Nullable error) {
+    completion(data, response, error);
+    [expectation fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+}
+
+/*! @fn testDefaultLimits
+    @brief Tests the default maximum body sizes, and that they can be changed per endpoint type.
+ */
+- (void)testDefaultLimits {
+  XCTAssertEqual([_client maximumBodySizeForEndpointType:OIDHTTPEndpointTypeDiscovery],
+                 1024 * 1024);
+  XCTAssertEqual([_client maximumBodySizeForEndpointType:OIDHTTPEndpointTypeToken], 256 * 1024);
+  [_client setMaximumBodySize:1024 forEndpointType:OIDHTTPEndpointTypeToken];
+  XCTAssertEqual([_client maximumBodySizeForEndpointType:OIDHTTPEndpointTypeToken], 1024);
+  XCTAssertEqual([_client maximumBodySizeForEndpointType:OIDHTTPEndpointTypeRegistration],
+                 256 * 1024);
+}
+
+/*! @fn testJSONResponse
+    @brief Tests that a small JSON response is delivered in full.
+ */
+- (void)testJSONResponse {
+  [self stubBody:@"{\"access_token\":\"abc\"}"];
+  [self performTokenRequest:^(NSData *data, NSHTTPURLResponse *response, NSError *error) {
+    XCTAssertNil(error);
+    XCTAssertEqual(response.statusCode, 200);
+    XCTAssertEqualObjects(data, gStubBodyPrefix);
+  }];
+}
+
+/*! @fn testOversizedStreamedBody
+    @brief Tests that a body without a Content-Length is aborted once it exceeds the limit, long
+        before the stub has sent all of it.
+ */
+- (void)testOversizedStreamedBody {
+  [self stubOversizedJSONBody];
+  [self performTokenRequest:^(NSData *data, NSHTTPURLResponse *response, NSError *error) {
+    XCTAssertNil(data);
+    XCTAssertEqualObjects(error.domain, OIDGeneralErrorDomain);
+    XCTAssertEqual(error.code, OIDErrorCodeResponseTooLarge);
+  }];
+  // the bytes the client could have buffered are bounded by what the stub sent
+  XCTAssertLessThan([self bytesSent], kOversizedBodyLength / 4);
+}
+
+/*! @fn testOversizedContentLength
+    @brief Tests that a response declaring an oversized Content-Length is aborted before its body
+        is read.
+ */
+- (void)testOversizedContentLength {
+  [self stubOversizedJSONBody];
+  gStubHeaders = @{
+    @"Content-Type" : @"application/json",
+    @"Content-Length" : [NSString stringWithFormat:@"%lu", (unsigned long)kOversizedBodyLength],
+  };
+  [self performTokenRequest:^(NSData *data, NSHTTPURLResponse *response, NSError *error) {
+    XCTAssertNil(data);
+    XCTAssertEqual(error.code, OIDErrorCodeResponseTooLarge);
+  }];
+  XCTAssertLessThan([self bytesSent], kOversizedBodyLength / 4);
+}
+
+/*! @fn testTruncatedErrorBody
+    @brief Tests that an oversized error page is truncated to the capture limit rather than
+        failing the request, so the status code is still reported.
+ */
+- (void)testTruncatedErrorBody {
+  gStubStatusCode = 502;
+  gStubHeaders = @{ @"Content-Type" : @"text/html" };
+  gStubBodyPrefix = [@"<html>" dataUsingEncoding:NSUTF8StringEncoding];
+  gStubBodyLength = kOversizedBodyLength;
+  [self performTokenRequest:^(NSData *data, NSHTTPURLResponse *response, NSError *error) {
+    XCTAssertNil(error);
+    XCTAssertEqual(response.statusCode, 502);
+    XCTAssertEqual(data.length, OIDHTTPErrorResponseBodyCaptureLimit);
+  }];
+  XCTAssertLessThan([self bytesSent], kOversizedBodyLength / 4);
+}
+
+/*! @fn testTruncatedJSONErrorBody
+    @brief Tests that an oversized error response is truncated to the capture limit even when
+        it's labelled as JSON.
+ */
+- (void)testTruncatedJSONErrorBody {
+  gStubStatusCode = 400;
+  [self stubOversizedJSONBody];
+  [self performTokenRequest:^(NSData *data, NSHTTPURLResponse *response, NSError *error) {
+    XCTAssertNil(error);
+    XCTAssertEqual(response.statusCode, 400);
+    XCTAssertEqual(data.length, OIDHTTPErrorResponseBodyCaptureLimit);
+  }];
+  XCTAssertLessThan([self bytesSent], kOversizedBodyLength / 4);
+}
+
+/*! @fn testUnexpectedContentType
+    @brief Tests that successful responses with HTML, plain text or other non-JSON content types
+        are aborted, and JSON-suffixed types are not.
+ */
+- (void)testUnexpectedContentType {
+  [self stubBody:@"<html><body>Sign in</body></html>"];
+  for (NSString *type in @[ @"text/html; charset=utf-8", @"text/plain", @"text/javascript",
+                            @"application/octet-stream" ]) {
+    gStubHeaders = @{ @"Content-Type" : type };
+    [self performTokenRequest:^(NSData *data, NSHTTPURLResponse *response, NSError *error) {
+      XCTAssertNil(data, @"%@", type);
+      XCTAssertEqual(error.code, OIDErrorCodeUnexpectedContentType, @"%@", type);
+    }];
+  }
+
+  gStubHeaders = @{ @"Content-Type" : @"application/jwk-set+json" };
+  [self stubBody:@"{\"keys\":[]}"];
+  [self performTokenRequest:^(NSData *data, NSHTTPURLResponse *response, NSError *error) {
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(data, gStubBodyPrefix);
+  }];
+}
+
+/*! @fn testBodyNotJSONObject
+    @brief Tests that a successful response labelled as JSON is aborted as soon as its body turns
+        out not to be a JSON object.
+ */
+- (void)testBodyNotJSONObject {
+  gStubBodyPrefix = [@"  <html>" dataUsingEncoding:NSUTF8StringEncoding];
+  gStubBodyLength = kOversizedBodyLength;
+  [self performTokenRequest:^(NSData *data, NSHTTPURLResponse *response, NSError *error) {
+    XCTAssertNil(data);
+    XCTAssertEqual(error.code, OIDErrorCodeJSONDeserializationError);
+  }];
+  XCTAssertLessThan([self bytesSent], kOversizedBodyLength / 4);
+}
+
+/*! @fn testCancel
+    @brief Tests that cancelling a request stops the transfer straight away and reports the
+        cancellation.
+ */
+- (void)testCancel {
+  [_client setMaximumBodySize:NSUIntegerMax forEndpointType:OIDHTTPEndpointTypeToken];
+  [self stubOversizedJSONBody];
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Request completes."];
+  NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:kTestURL]];
+  id<OIDCancellable> handle =
+      [_client performRequest:request
+                 endpointType:OIDHTTPEndpointTypeToken
+                   completion:^(NSData *_Nullable data,
+                                NSHTTPURLResponse *_Nullable response,
+                                NSError *_Nullable error) {
+    XCTAssertNil(data);
+    XCTAssertEqual(error.code, OIDErrorCodeRequestCanceled);
+    [expectation fulfill];
+  }];
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.02 * NSEC_PER_SEC)),
+                 dispatch_get_main_queue(),
+                 ^{
+    [handle cancel];
+  });
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  XCTAssertLessThan([self bytesSent], kOversizedBodyLength / 4);
+  // cancelling again after completion has no effect
+  [handle cancel];
+}
+
+/*! @fn testDeadlineExceeded
+    @brief Tests that a request still in progress at its deadline is cancelled, even though data
+        keeps arriving within the request's timeout.
+ */
+- (void)testDeadlineExceeded {
+  [_client setMaximumBodySize:NSUIntegerMax forEndpointType:OIDHTTPEndpointTypeToken];
+  [self stubOversizedJSONBody];
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Request completes."];
+  NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:kTestURL]];
+  [_client performRequest:request
+             endpointType:OIDHTTPEndpointTypeToken
+                 deadline:[NSDate dateWithTimeIntervalSinceNow:0.02]
+               completion:^(NSData *_Nullable data,
+                            NSHTTPURLResponse *_Nullable response,
+                            NSError *_Nullable error) {
+    XCTAssertNil(data);
+    XCTAssertEqualObjects(error.domain, OIDGeneralErrorDomain);
+    XCTAssertEqual(error.code, OIDErrorCodeDeadlineExceeded);
+    [expectation fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  XCTAssertLessThan([self bytesSent], kOversizedBodyLength / 4);
+}
+
+/*! @fn testDeadlinePassed
+    @brief Tests that a request whose deadline has already passed, such as a later stage of a
+        chain whose earlier stages used up the time, isn't started.
+ */
+- (void)testDeadlinePassed {
+  [self stubBody:@"{}"];
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Request completes."];
+  NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:kTestURL]];
+  [_client performRequest:request
+             endpointType:OIDHTTPEndpointTypeToken
+                 deadline:[NSDate dateWithTimeIntervalSinceNow:-1]
+               completion:^(NSData *_Nullable data,
+                            NSHTTPURLResponse *_Nullable response,
+                            NSError *_Nullable error) {
+    XCTAssertNil(response);
+    XCTAssertEqual(error.code, OIDErrorCodeDeadlineExceeded);
+    [expectation fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+  XCTAssertEqual([self bytesSent], 0);
+}
+
+/*! @fn performRequestNamed:priority:completion:
+    @brief Starts a request to the stub, identified by its query string.
+    @param name The query string.
+    @param priority The priority of the request.
+    @param completion Called with the error the request completed with.
+ */
+- (id<OIDCancellable>)performRequestNamed:(NSString *)name
+                                 priority:(OIDRequestPriority)priority
+                               completion:(void (^)(NSError *_Nullable error))completion {
+  NSString *URLString = [NSString stringWithFormat:@"%@?%@", kTestURL, name];
+  NSURLRequest *request = [NSURLRequest requestWithURL:[NSURL URLWithString:URLString]];
+  return [_client performRequest:request
+                    endpointType:OIDHTTPEndpointTypeToken
+                        priority:priority
+                        deadline:nil
+                      completion:^(NSData *_Nullable data,
+                                   NSHTTPURLResponse *_Nullable response,
+                                   NSError *_Nullable error) {
+    completion(error);
+  }];
+}
+
+/*! @fn testPriorityOrdering
+    @brief Tests that once the client is running its maximum number of requests, waiting requests
+        are started most urgent first, and user-initiated requests don't wait at all.
+ */
+- (void)testPriorityOrdering {
+  _client.maximumConcurrentRequests = 1;
+  gStubBodyPrefix = [@"{\"padding\":\"" dataUsingEncoding:NSUTF8StringEncoding];
+  gStubBodyLength = 4 * kStubChunkSize;
+
+  NSMutableArray<NSString *> *completed = [NSMutableArray array];
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Requests complete."];
+  for (NSArray *request in @[ @[ @"running", @(OIDRequestPriorityBackground) ],
+                              @[ @"background", @(OIDRequestPriorityBackground) ],
+                              @[ @"default", @(OIDRequestPriorityDefault) ],
+                              @[ @"interactive", @(OIDRequestPriorityUserInitiated) ] ]) {
+    NSString *name = request[0];
+    [self performRequestNamed:name
+                     priority:[request[1] integerValue]
+                   completion:^(NSError *_Nullable error) {
+      XCTAssertNil(error);
+      @synchronized(completed) {
+        [completed addObject:name];
+        if (completed.count == 4) {
+          [expectation fulfill];
+        }
+      }
+    }];
+  }
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+
+  NSArray<NSString *> *started;
+  @synchronized([OIDHTTPClientTestsStubProtocol class]) {
+    started = [gStubStartedRequests copy];
+  }
+  XCTAssertEqualObjects(started, (@[ @"running", @"interactive", @"default", @"background" ]));
+  XCTAssertEqualObjects(completed.lastObject, @"background");
+}
+
+/*! @fn testCancelWaitingRequest
+    @brief Tests that a request cancelled while waiting for a slot completes straight away and is
+        never started.
+ */
+- (void)testCancelWaitingRequest {
+  _client.maximumConcurrentRequests = 1;
+  [self stubBody:@"{}"];
+
+  XCTestExpectation *running = [self expectationWithDescription:@"Running request completes."];
+  XCTestExpectation *waiting = [self expectationWithDescription:@"Waiting request completes."];
+  [self performRequestNamed:@"running"
+                   priority:OIDRequestPriorityDefault
+                 completion:^(NSError *_Nullable error) {
+    XCTAssertNil(error);
+    [running fulfill];
+  }];
+  id<OIDCancellable> handle =
+      [self performRequestNamed:@"waiting"
+                       priority:OIDRequestPriorityBackground
+                     completion:^(NSError *_Nullable error) {
+    XCTAssertEqual(error.code, OIDErrorCodeRequestCanceled);
+    [waiting fulfill];
+  }];
+  [handle cancel];
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+
+  @synchronized([OIDHTTPClientTestsStubProtocol class]) {
+    XCTAssertEqualObjects(gStubStartedRequests, @[ @"running" ]);
+  }
+}
+
+@end
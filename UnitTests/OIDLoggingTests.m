@@ -0,0 +1,116 @@
+/*! @file OIDLoggingTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDTokenRequestTests.h"
+#import "OIDTokenResponseTests.h"
+#import "Source/OIDLogging.h"
+#import "Source/OIDTokenRequest.h"
+#import "Source/OIDTokenResponse.h"
+
+/*! @class OIDLoggingTests
+    @brief Unit tests for @c OIDLogging.
+ */
+@interface OIDLoggingTests : XCTestCase
+@end
+
+@implementation OIDLoggingTests {
+  /*! @var _messages
+      @brief Messages received by the test sink.
+   */
+  NSMutableArray<NSString *> *_messages;
+
+  /*! @var _argumentEvaluationCount
+      @brief The number of times @c countedArgument was evaluated.
+   */
+  NSUInteger _argumentEvaluationCount;
+}
+
+- (void)setUp {
+  [super setUp];
+  _messages = [NSMutableArray array];
+  NSMutableArray<NSString *> *messages = _messages;
+  [OIDLogging setSink:^(OIDLogLevel level, NSString *message) {
+    @synchronized(messages) {
+      [messages addObject:message];
+    }
+  }];
+}
+
+- (void)tearDown {
+  [OIDLogging setSink:nil];
+  [OIDLogging setLevel:OIDLogLevelWarning];
+  [OIDLogging setRedactsSecrets:YES];
+  [super tearDown];
+}
+
+/*! @fn countedArgument
+    @brief A log argument which records that it was evaluated.
+ */
+- (NSString *)countedArgument {
+  _argumentEvaluationCount++;
+  return @"argument";
+}
+
+/*! @fn testLevels
+    @brief Tests that only messages at or above the configured level reach the sink, and that the
+        arguments of other messages are not evaluated.
+ */
+- (void)testLevels {
+  [OIDLogging setLevel:OIDLogLevelWarning];
+  OIDLogError(@"error %@", [self countedArgument]);
+  OIDLogWarning(@"warning %@", [self countedArgument]);
+  OIDLogInfo(@"info %@", [self countedArgument]);
+  OIDLogDebug(@"debug %@", [self countedArgument]);
+  XCTAssertEqualObjects(_messages, (@[ @"error argument", @"warning argument" ]));
+  XCTAssertEqual(_argumentEvaluationCount, 2);
+
+  [OIDLogging setLevel:OIDLogLevelOff];
+  OIDLogError(@"error %@", [self countedArgument]);
+  XCTAssertEqual(_messages.count, 2);
+  XCTAssertEqual(_argumentEvaluationCount, 2);
+}
+
+/*! @fn testDescriptionsRedactSecrets
+    @brief Tests that tokens are redacted from descriptions unless redaction is disabled.
+ */
+- (void)testDescriptionsRedactSecrets {
+  OIDTokenResponse *response = [OIDTokenResponseTests testInstance];
+  XCTAssertNotNil(response.accessToken);
+  XCTAssertFalse([response.description containsString:response.accessToken]);
+  XCTAssertFalse([response.description containsString:response.refreshToken]);
+  OIDTokenRequest *request = [OIDTokenRequestTests testInstance];
+  XCTAssertFalse([request.description containsString:request.refreshToken]);
+
+  [OIDLogging setRedactsSecrets:NO];
+  XCTAssert([response.description containsString:response.accessToken]);
+  XCTAssert([request.description containsString:request.refreshToken]);
+}
+
+/*! @fn testRedactParameters
+    @brief Tests that parameter values are redacted but their names are kept.
+ */
+- (void)testRedactParameters {
+  NSDictionary *redacted = OIDLogRedactParameters(@{ @"client_secret" : @"secret" });
+  XCTAssertEqualObjects(redacted.allKeys, @[ @"client_secret" ]);
+  XCTAssertNotEqualObjects(redacted[@"client_secret"], @"secret");
+  XCTAssertNil(OIDLogRedact(nil));
+}
+
+@end
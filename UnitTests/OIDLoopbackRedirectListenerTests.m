@@ -0,0 +1,183 @@
+/*! @file OIDLoopbackRedirectListenerTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDServiceConfigurationTests.h"
+#import "Source/OIDAuthorizationRequest.h"
+#import "Source/OIDAuthorizationResponse.h"
+#import "Source/OIDLoopbackRedirectListener.h"
+
+/*! @var kTestClientID
+    @brief Client ID used in the test authorization requests.
+ */
+static NSString *const kTestClientID = @"ClientID";
+
+/*! @class OIDLoopbackRedirectListenerTests
+    @brief Unit tests for @c OIDLoopbackRedirectListener. The browser is simulated by
+        @c NSURLSession requests to the listener's redirect URL.
+ */
+@interface OIDLoopbackRedirectListenerTests : XCTestCase
+@end
+
+@implementation OIDLoopbackRedirectListenerTests
+
+/*! @fn requestWithRedirectURL:state:
+    @brief Creates a code flow request with the given redirect URL and state.
+ */
++ (OIDAuthorizationRequest *)requestWithRedirectURL:(NSURL *)redirectURL state:(NSString *)state {
+  return [[OIDAuthorizationRequest alloc]
+      initWithConfiguration:[OIDServiceConfigurationTests testInstance]
+                   clientId:kTestClientID
+                      scope:nil
+                redirectURL:redirectURL
+               responseType:OIDResponseTypeCode
+                      state:state
+               codeVerifier:nil
+       additionalParameters:nil];
+}
+
+/*! @fn redirectToListener:query:expectingStatus:
+    @brief Sends a GET request to the listener, as the browser would after authorization, and
+        checks the response status.
+ */
+- (void)redirectToListener:(OIDLoopbackRedirectListener *)listener
+                     query:(NSString *)query
+           expectingStatus:(NSInteger)expectedStatus {
+  NSURL *URL = [NSURL URLWithString:[@"?" stringByAppendingString:query]
+                      relativeToURL:listener.redirectURL];
+  XCTestExpectation *expectation =
+      [self expectationWithDescription:[NSString stringWithFormat:@"Response to %@", query]];
+  [[[NSURLSession sharedSession] dataTaskWithURL:URL
+                               completionHandler:^(NSData *_Nullable data,
+                                                   NSURLResponse *_Nullable response,
+                                                   NSError *_Nullable error) {
+    XCTAssertNil(error);
+    XCTAssertEqual(((NSHTTPURLResponse *)response).statusCode, expectedStatus);
+    XCTAssert(data.length > 0);
+    [expectation fulfill];
+  }] resume];
+}
+
+/*! @fn testStartAssignsLoopbackRedirectURL
+    @brief Tests that the listener binds to an ephemeral port on 127.0.0.1.
+ */
+- (void)testStartAssignsLoopbackRedirectURL {
+  OIDLoopbackRedirectListener *listener = [[OIDLoopbackRedirectListener alloc] init];
+  XCTAssertNil(listener.redirectURL);
+  XCTAssertFalse(listener.listening);
+
+  NSError *error;
+  XCTAssert([listener startWithError:&error]);
+  XCTAssertNil(error);
+  XCTAssert(listener.listening);
+  XCTAssertEqualObjects(listener.redirectURL.scheme, @"http");
+  XCTAssertEqualObjects(listener.redirectURL.host, @"127.0.0.1");
+  XCTAssertGreaterThan(listener.redirectURL.port.integerValue, 0);
+
+  [listener stop];
+  XCTAssertFalse(listener.listening);
+}
+
+/*! @fn testConcurrentFlowsAreRoutedByState
+    @brief Tests that responses for two flows in progress on one listener each resume their own
+        session, and that the listener stops once both have completed.
+ */
+- (void)testConcurrentFlowsAreRoutedByState {
+  OIDLoopbackRedirectListener *listener = [[OIDLoopbackRedirectListener alloc] init];
+  XCTAssert([listener startWithError:NULL]);
+
+  NSArray<NSString *> *states = @[ @"StateA", @"StateB" ];
+  for (NSString *state in states) {
+    OIDAuthorizationRequest *request =
+        [[self class] requestWithRedirectURL:listener.redirectURL state:state];
+    XCTestExpectation *expectation =
+        [self expectationWithDescription:[NSString stringWithFormat:@"Callback for %@", state]];
+    [listener authorizationFlowSessionWithRequest:request
+                                         callback:^(OIDAuthorizationResponse *_Nullable response,
+                                                    NSError *_Nullable error) {
+      XCTAssert([NSThread isMainThread]);
+      XCTAssertNil(error);
+      XCTAssertEqualObjects(response.state, state);
+      XCTAssertEqualObjects(response.authorizationCode, [@"CodeFor" stringByAppendingString:state]);
+      [expectation fulfill];
+    }];
+  }
+
+  // responses arrive in the opposite order to which the flows were started
+  [self redirectToListener:listener query:@"code=CodeForStateB&state=StateB" expectingStatus:200];
+  [self redirectToListener:listener query:@"code=CodeForStateA&state=StateA" expectingStatus:200];
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+
+  XCTAssertFalse(listener.listening);
+}
+
+/*! @fn testFlowAfterIdleStopReopensSocket
+    @brief Tests that a session started after the listener stopped for being idle reopens the
+        socket on the same port, and receives its response.
+ */
+- (void)testFlowAfterIdleStopReopensSocket {
+  OIDLoopbackRedirectListener *listener = [[OIDLoopbackRedirectListener alloc] init];
+  XCTAssert([listener startWithError:NULL]);
+  NSURL *redirectURL = listener.redirectURL;
+
+  for (NSString *state in @[ @"First", @"Second" ]) {
+    OIDAuthorizationRequest *request = [[self class] requestWithRedirectURL:redirectURL
+                                                                      state:state];
+    XCTestExpectation *expectation =
+        [self expectationWithDescription:[NSString stringWithFormat:@"Callback for %@", state]];
+    [listener authorizationFlowSessionWithRequest:request
+                                         callback:^(OIDAuthorizationResponse *_Nullable response,
+                                                    NSError *_Nullable error) {
+      XCTAssertNil(error);
+      XCTAssertEqualObjects(response.state, state);
+      [expectation fulfill];
+    }];
+    XCTAssert(listener.listening);
+    XCTAssertEqualObjects(listener.redirectURL, redirectURL);
+
+    NSString *query = [NSString stringWithFormat:@"code=Code&state=%@", state];
+    [self redirectToListener:listener query:query expectingStatus:200];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertFalse(listener.listening);
+  }
+}
+
+/*! @fn testUnknownStateIsNotRouted
+    @brief Tests that requests not belonging to a flow in progress, such as a browser's favicon
+        request, are answered without completing any session.
+ */
+- (void)testUnknownStateIsNotRouted {
+  OIDLoopbackRedirectListener *listener = [[OIDLoopbackRedirectListener alloc] init];
+  XCTAssert([listener startWithError:NULL]);
+  OIDAuthorizationRequest *request =
+      [[self class] requestWithRedirectURL:listener.redirectURL state:@"State"];
+  [listener authorizationFlowSessionWithRequest:request
+                                       callback:^(OIDAuthorizationResponse *_Nullable response,
+                                                  NSError *_Nullable error) {
+    XCTFail(@"The session should not be resumed by a response with a different state.");
+  }];
+
+  [self redirectToListener:listener query:@"code=Code&state=OtherState" expectingStatus:404];
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+
+  XCTAssert(listener.listening);
+  [listener stop];
+}
+
+@end
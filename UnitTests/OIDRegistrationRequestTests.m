@@ -0,0 +1,99 @@
+/*! @file OIDRegistrationRequestTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import "OIDRegistrationRequestTests.h"
+
+#import "Source/OIDRegistrationRequest.h"
+#import "Source/OIDServiceConfiguration.h"
+
+/*! @var kTestRegistrationEndpoint
+    @brief Test value for the configuration's @c registrationEndpoint.
+ */
+static NSString *const kTestRegistrationEndpoint = @"https://www.example.com/register";
+
+/*! @var kTestRedirectURI
+    @brief Test value for the @c redirectURIs property.
+ */
+static NSString *const kTestRedirectURI = @"com.example.app:/oauth2redirect";
+
+/*! @var kTestAdditionalParameterKey
+    @brief Test key for the @c additionalParameters property.
+ */
+static NSString *const kTestAdditionalParameterKey = @"client_name";
+
+/*! @var kTestAdditionalParameterValue
+    @brief Test value for the @c additionalParameters property.
+ */
+static NSString *const kTestAdditionalParameterValue = @"Example App";
+
+@implementation OIDRegistrationRequestTests
+
++ (OIDRegistrationRequest *)testInstance {
+  OIDServiceConfiguration *configuration = [[OIDServiceConfiguration alloc]
+      initWithAuthorizationEndpoint:[NSURL URLWithString:@"https://www.example.com/auth"]
+                      tokenEndpoint:[NSURL URLWithString:@"https://www.example.com/token"]
+               registrationEndpoint:[NSURL URLWithString:kTestRegistrationEndpoint]];
+  return [[OIDRegistrationRequest alloc]
+      initWithConfiguration:configuration
+               redirectURIs:@[ [NSURL URLWithString:kTestRedirectURI] ]
+              responseTypes:@[ @"code" ]
+                 grantTypes:@[ @"authorization_code", @"refresh_token" ]
+                subjectType:nil
+    tokenEndpointAuthMethod:@"client_secret_post"
+       additionalParameters:@{ kTestAdditionalParameterKey : kTestAdditionalParameterValue }];
+}
+
+/*! @fn testURLRequest
+    @brief Tests that the client metadata is POSTed to the registration endpoint as JSON.
+ */
+- (void)testURLRequest {
+  NSURLRequest *URLRequest = [[[self class] testInstance] URLRequest];
+  XCTAssertEqualObjects(URLRequest.URL.absoluteString, kTestRegistrationEndpoint);
+  XCTAssertEqualObjects(URLRequest.HTTPMethod, @"POST");
+  XCTAssertEqualObjects([URLRequest valueForHTTPHeaderField:@"Content-Type"],
+                        @"application/json");
+
+  NSDictionary *body = [NSJSONSerialization JSONObjectWithData:URLRequest.HTTPBody
+                                                       options:0
+                                                         error:NULL];
+  XCTAssertEqualObjects(body[@"redirect_uris"], @[ kTestRedirectURI ]);
+  XCTAssertEqualObjects(body[@"response_types"], @[ @"code" ]);
+  XCTAssertEqualObjects(body[@"grant_types"], (@[ @"authorization_code", @"refresh_token" ]));
+  XCTAssertEqualObjects(body[@"token_endpoint_auth_method"], @"client_secret_post");
+  XCTAssertEqualObjects(body[kTestAdditionalParameterKey], kTestAdditionalParameterValue);
+  XCTAssertNil(body[@"subject_type"]);
+}
+
+/*! @fn testSecureCoding
+    @brief Tests that the request round-trips through an archive.
+ */
+- (void)testSecureCoding {
+  OIDRegistrationRequest *request = [[self class] testInstance];
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:request];
+  OIDRegistrationRequest *unarchived = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssertEqualObjects(unarchived.configuration.registrationEndpoint,
+                        request.configuration.registrationEndpoint);
+  XCTAssertEqualObjects(unarchived.redirectURIs, request.redirectURIs);
+  XCTAssertEqualObjects(unarchived.responseTypes, request.responseTypes);
+  XCTAssertEqualObjects(unarchived.grantTypes, request.grantTypes);
+  XCTAssertEqualObjects(unarchived.tokenEndpointAuthenticationMethod,
+                        request.tokenEndpointAuthenticationMethod);
+  XCTAssertEqualObjects(unarchived.additionalParameters, request.additionalParameters);
+}
+
+@end
@@ -0,0 +1,141 @@
+/*! @file OIDRegistrationResponseTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDRegistrationRequestTests.h"
+#import "Source/OIDRegistrationRequest.h"
+#import "Source/OIDRegistrationResponse.h"
+
+/*! @var kClientIDTestValue
+    @brief The test value for the @c clientID property.
+ */
+static NSString *const kClientIDTestValue = @"s6BhdRkqt3";
+
+/*! @var kClientSecretTestValue
+    @brief The test value for the @c clientSecret property.
+ */
+static NSString *const kClientSecretTestValue = @"cf136dc3c1fc93f31185e5885805d";
+
+/*! @var kRegistrationAccessTokenTestValue
+    @brief The test value for the @c registrationAccessToken property.
+ */
+static NSString *const kRegistrationAccessTokenTestValue = @"this.is.an.access.token.value.ffx83";
+
+/*! @var kRegistrationClientURITestValue
+    @brief The test value for the @c registrationClientURI property.
+ */
+static NSString *const kRegistrationClientURITestValue =
+    @"https://www.example.com/register/s6BhdRkqt3";
+
+/*! @class OIDRegistrationResponseTests
+    @brief Unit tests for @c OIDRegistrationResponse.
+ */
+@interface OIDRegistrationResponseTests : XCTestCase
+@end
+
+@implementation OIDRegistrationResponseTests
+
+/*! @fn responseWithSecretExpiresAt:
+    @brief Creates a response with the given client_secret_expires_at value.
+ */
++ (OIDRegistrationResponse *)responseWithSecretExpiresAt:(long long)secretExpiresAt {
+  return [[OIDRegistrationResponse alloc]
+      initWithRequest:[OIDRegistrationRequestTests testInstance]
+           parameters:@{
+        @"client_id" : kClientIDTestValue,
+        @"client_id_issued_at" : @2893256800,
+        @"client_secret" : kClientSecretTestValue,
+        @"client_secret_expires_at" : @(secretExpiresAt),
+        @"registration_access_token" : kRegistrationAccessTokenTestValue,
+        @"registration_client_uri" : kRegistrationClientURITestValue,
+        @"token_endpoint_auth_method" : @"client_secret_post",
+        @"client_name" : @"Example App",
+      }];
+}
+
+/*! @fn testParameters
+    @brief Tests that known parameters are mapped to properties, and others kept as additional
+        parameters.
+ */
+- (void)testParameters {
+  OIDRegistrationResponse *response = [[self class] responseWithSecretExpiresAt:0];
+  XCTAssertEqualObjects(response.clientID, kClientIDTestValue);
+  XCTAssertEqualObjects(response.clientIDIssuedAt,
+                        [NSDate dateWithTimeIntervalSince1970:2893256800]);
+  XCTAssertEqualObjects(response.clientSecret, kClientSecretTestValue);
+  XCTAssertEqualObjects(response.registrationAccessToken, kRegistrationAccessTokenTestValue);
+  XCTAssertEqualObjects(response.registrationClientURI.absoluteString,
+                        kRegistrationClientURITestValue);
+  XCTAssertEqualObjects(response.tokenEndpointAuthenticationMethod, @"client_secret_post");
+  XCTAssertEqualObjects(response.additionalParameters, @{ @"client_name" : @"Example App" });
+}
+
+/*! @fn testMissingClientID
+    @brief Tests that a response without a client identifier is rejected.
+ */
+- (void)testMissingClientID {
+  OIDRegistrationResponse *response = [[OIDRegistrationResponse alloc]
+      initWithRequest:[OIDRegistrationRequestTests testInstance]
+           parameters:@{ @"client_secret" : kClientSecretTestValue }];
+  XCTAssertNil(response);
+}
+
+/*! @fn testClientSecretExpiry
+    @brief Tests that a client_secret_expires_at of 0 means the secret doesn't expire.
+ */
+- (void)testClientSecretExpiry {
+  OIDRegistrationResponse *neverExpires = [[self class] responseWithSecretExpiresAt:0];
+  XCTAssertNil(neverExpires.clientSecretExpiresAt);
+  XCTAssertFalse([neverExpires isClientSecretExpiredWithTolerance:60]);
+
+  long long inAnHour = (long long)[[NSDate date] timeIntervalSince1970] + 3600;
+  OIDRegistrationResponse *expiresSoon = [[self class] responseWithSecretExpiresAt:inAnHour];
+  XCTAssertEqualObjects(expiresSoon.clientSecretExpiresAt,
+                        [NSDate dateWithTimeIntervalSince1970:inAnHour]);
+  XCTAssertFalse([expiresSoon isClientSecretExpiredWithTolerance:60]);
+  XCTAssert([expiresSoon isClientSecretExpiredWithTolerance:7200]);
+}
+
+/*! @fn testSecureCoding
+    @brief Tests that the response round-trips through an archive.
+ */
+- (void)testSecureCoding {
+  long long inAnHour = (long long)[[NSDate date] timeIntervalSince1970] + 3600;
+  OIDRegistrationResponse *response = [[self class] responseWithSecretExpiresAt:inAnHour];
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:response];
+  OIDRegistrationResponse *unarchived = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssertEqualObjects(unarchived.clientID, response.clientID);
+  XCTAssertEqualObjects(unarchived.clientSecret, response.clientSecret);
+  XCTAssertEqualObjects(unarchived.clientSecretExpiresAt, response.clientSecretExpiresAt);
+  XCTAssertEqualObjects(unarchived.registrationClientURI, response.registrationClientURI);
+  XCTAssertEqualObjects(unarchived.additionalParameters, response.additionalParameters);
+  XCTAssertEqualObjects(unarchived.request.redirectURIs, response.request.redirectURIs);
+}
+
+/*! @fn testDescriptionRedactsSecrets
+    @brief Tests that the client secret and registration access token aren't logged.
+ */
+- (void)testDescriptionRedactsSecrets {
+  NSString *description = [[[self class] responseWithSecretExpiresAt:0] description];
+  XCTAssertFalse([description containsString:kClientSecretTestValue]);
+  XCTAssertFalse([description containsString:kRegistrationAccessTokenTestValue]);
+  XCTAssert([description containsString:kClientIDTestValue]);
+}
+
+@end
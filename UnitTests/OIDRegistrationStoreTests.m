@@ -0,0 +1,240 @@
+/*! @file OIDRegistrationStoreTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDRegistrationRequestTests.h"
+#import "Source/OIDError.h"
+#import "Source/OIDErrorUtilities.h"
+#import "Source/OIDRegistrationRequest.h"
+#import "Source/OIDRegistrationResponse.h"
+#import "Source/OIDRegistrationStore.h"
+#import "Source/OIDServiceConfiguration.h"
+
+/*! @var kClientIDTestValue
+    @brief The client identifier returned by the simulated registration endpoint.
+ */
+static NSString *const kClientIDTestValue = @"registered_client";
+
+/*! @class OIDTestRegistrationStore
+    @brief A registration store which simulates the registration endpoint, and counts the
+        registration requests it receives.
+ */
+@interface OIDTestRegistrationStore : OIDRegistrationStore
+
+/*! @property registrationCount
+    @brief The number of registration requests performed.
+ */
+@property(nonatomic, readonly) NSUInteger registrationCount;
+
+/*! @property failsRegistration
+    @brief Whether the simulated registration endpoint responds with a server error.
+ */
+@property(nonatomic) BOOL failsRegistration;
+
+@end
+
+@implementation OIDTestRegistrationStore
+
+- (void)performRegistrationRequest:(OIDRegistrationRequest *)request
+                        completion:(OIDRegistrationCallback)completion {
+  @synchronized(self) {
+    _registrationCount++;
+  }
+  OIDRegistrationResponse *response = nil;
+  NSError *error = nil;
+  if (_failsRegistration) {
+    error = [OIDErrorUtilities errorWithCode:OIDErrorCodeServerError
+                             underlyingError:nil
+                                 description:nil];
+  } else {
+    NSDictionary *parameters = @{ @"client_id" : kClientIDTestValue };
+    response = [[OIDRegistrationResponse alloc] initWithRequest:request parameters:parameters];
+  }
+  // respond after a delay, so concurrent calls arrive while the registration is in progress
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)),
+                 dispatch_get_main_queue(), ^{
+    completion(response, error);
+  });
+}
+
+@end
+
+/*! @class OIDRegistrationStoreTests
+    @brief Unit tests for @c OIDRegistrationStore.
+ */
+@interface OIDRegistrationStoreTests : XCTestCase
+@end
+
+@implementation OIDRegistrationStoreTests {
+  /*! @var _fileURL
+      @brief A unique file location for the test's store.
+   */
+  NSURL *_fileURL;
+}
+
+- (void)setUp {
+  [super setUp];
+  NSString *path =
+      [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+  _fileURL = [NSURL fileURLWithPath:path];
+}
+
+- (void)tearDown {
+  NSFileManager *fileManager = [NSFileManager defaultManager];
+  [fileManager removeItemAtURL:_fileURL error:NULL];
+  [fileManager removeItemAtPath:[_fileURL.path stringByAppendingString:@".lock"] error:NULL];
+  _fileURL = nil;
+  [super tearDown];
+}
+
+/*! @fn registerWithStore:request:
+    @brief Requests a registration from the store, and waits for it.
+ */
+- (nullable OIDRegistrationResponse *)registerWithStore:(OIDRegistrationStore *)store
+                                                request:(OIDRegistrationRequest *)request {
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Registration completed."];
+  __block OIDRegistrationResponse *registration;
+  [store registrationResponseForRequest:request
+                             completion:^(OIDRegistrationResponse *_Nullable response,
+                                          NSError *_Nullable error) {
+    XCTAssert([NSThread isMainThread]);
+    registration = response;
+    [expectation fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+  return registration;
+}
+
+/*! @fn testConcurrentRegistrationsAreCollapsed
+    @brief Tests that calls made while a registration is in progress share its result.
+ */
+- (void)testConcurrentRegistrationsAreCollapsed {
+  OIDTestRegistrationStore *store = [[OIDTestRegistrationStore alloc] initWithFileURL:_fileURL];
+  OIDRegistrationRequest *request = [OIDRegistrationRequestTests testInstance];
+  for (NSUInteger i = 0; i < 3; i++) {
+    XCTestExpectation *expectation =
+        [self expectationWithDescription:[NSString stringWithFormat:@"Registration %lu",
+                                                                    (unsigned long)i]];
+    [store registrationResponseForRequest:request
+                               completion:^(OIDRegistrationResponse *_Nullable response,
+                                            NSError *_Nullable error) {
+      XCTAssertEqualObjects(response.clientID, kClientIDTestValue);
+      [expectation fulfill];
+    }];
+  }
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+  XCTAssertEqual(store.registrationCount, 1);
+}
+
+/*! @fn testConcurrentDifferentRequestsAreNotCollapsed
+    @brief Tests that a call made while a registration for different redirect URIs is in progress
+        gets a registration for its own request.
+ */
+- (void)testConcurrentDifferentRequestsAreNotCollapsed {
+  OIDTestRegistrationStore *store = [[OIDTestRegistrationStore alloc] initWithFileURL:_fileURL];
+  OIDRegistrationRequest *request = [OIDRegistrationRequestTests testInstance];
+  OIDRegistrationRequest *otherRequest = [[OIDRegistrationRequest alloc]
+      initWithConfiguration:request.configuration
+               redirectURIs:@[ [NSURL URLWithString:@"com.example.other:/oauth2redirect"] ]
+              responseTypes:request.responseTypes
+                 grantTypes:request.grantTypes
+                subjectType:nil
+    tokenEndpointAuthMethod:nil
+       additionalParameters:nil];
+  NSArray<OIDRegistrationRequest *> *requests = @[ request, otherRequest, request ];
+  for (OIDRegistrationRequest *concurrentRequest in requests) {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Registration completed."];
+    [store registrationResponseForRequest:concurrentRequest
+                               completion:^(OIDRegistrationResponse *_Nullable response,
+                                            NSError *_Nullable error) {
+      XCTAssertEqualObjects(response.request.redirectURIs, concurrentRequest.redirectURIs);
+      [expectation fulfill];
+    }];
+  }
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+  XCTAssertEqual(store.registrationCount, 2);
+}
+
+/*! @fn testRegistrationIsReusedAcrossLaunches
+    @brief Tests that a new store for the same file, as on the next launch, reuses the stored
+        registration.
+ */
+- (void)testRegistrationIsReusedAcrossLaunches {
+  OIDRegistrationRequest *request = [OIDRegistrationRequestTests testInstance];
+  OIDTestRegistrationStore *firstLaunch =
+      [[OIDTestRegistrationStore alloc] initWithFileURL:_fileURL];
+  XCTAssertNotNil([self registerWithStore:firstLaunch request:request]);
+  XCTAssertEqualObjects([firstLaunch readRegistrationResponse].clientID, kClientIDTestValue);
+
+  OIDTestRegistrationStore *secondLaunch =
+      [[OIDTestRegistrationStore alloc] initWithFileURL:_fileURL];
+  OIDRegistrationResponse *registration = [self registerWithStore:secondLaunch request:request];
+  XCTAssertEqualObjects(registration.clientID, kClientIDTestValue);
+  XCTAssertEqual(secondLaunch.registrationCount, 0);
+}
+
+/*! @fn testChangedRedirectURIsRegisterAgain
+    @brief Tests that a stored registration isn't used for a request with different redirect URIs.
+ */
+- (void)testChangedRedirectURIsRegisterAgain {
+  OIDTestRegistrationStore *store = [[OIDTestRegistrationStore alloc] initWithFileURL:_fileURL];
+  OIDRegistrationRequest *request = [OIDRegistrationRequestTests testInstance];
+  [self registerWithStore:store request:request];
+
+  OIDRegistrationRequest *otherRequest = [[OIDRegistrationRequest alloc]
+      initWithConfiguration:request.configuration
+               redirectURIs:@[ [NSURL URLWithString:@"com.example.other:/oauth2redirect"] ]
+              responseTypes:request.responseTypes
+                 grantTypes:request.grantTypes
+                subjectType:nil
+    tokenEndpointAuthMethod:nil
+       additionalParameters:nil];
+  [self registerWithStore:store request:otherRequest];
+  XCTAssertEqual(store.registrationCount, 2);
+}
+
+/*! @fn testFailedRegistrationIsNotStored
+    @brief Tests that errors are reported to every waiting caller, and nothing is stored.
+ */
+- (void)testFailedRegistrationIsNotStored {
+  OIDTestRegistrationStore *store = [[OIDTestRegistrationStore alloc] initWithFileURL:_fileURL];
+  store.failsRegistration = YES;
+  XCTAssertNil([self registerWithStore:store request:[OIDRegistrationRequestTests testInstance]]);
+  XCTAssertNil([store readRegistrationResponse]);
+}
+
+/*! @fn testRemoveRegistration
+    @brief Tests that removing the registration causes the next call to register again.
+ */
+- (void)testRemoveRegistration {
+  OIDTestRegistrationStore *store = [[OIDTestRegistrationStore alloc] initWithFileURL:_fileURL];
+  OIDRegistrationRequest *request = [OIDRegistrationRequestTests testInstance];
+  [self registerWithStore:store request:request];
+
+  NSError *error;
+  XCTAssert([store removeRegistrationWithError:&error]);
+  XCTAssertNil(error);
+  XCTAssertNil([store readRegistrationResponse]);
+  XCTAssert([store removeRegistrationWithError:NULL]);
+
+  [self registerWithStore:store request:request];
+  XCTAssertEqual(store.registrationCount, 2);
+}
+
+@end
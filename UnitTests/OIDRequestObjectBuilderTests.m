@@ -0,0 +1,346 @@
+/*! @file OIDRequestObjectBuilderTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDAuthorizationRequestTests.h"
+#import "OIDServiceDiscoveryTests.h"
+#import "Source/OIDAuthorizationRequest.h"
+#import "Source/OIDAuthorizationRequestTemplate.h"
+#import "Source/OIDClock.h"
+#import "Source/OIDClockSkewEstimator.h"
+#import "Source/OIDError.h"
+#import "Source/OIDErrorUtilities.h"
+#import "Source/OIDJWSSigner.h"
+#import "Source/OIDRequestObjectBuilder.h"
+#import "Source/OIDServiceConfiguration.h"
+#import "Source/OIDServiceDiscovery.h"
+#import "Source/OIDTokenUtilities.h"
+
+/*! @var kTestAudience
+    @brief The authorization server's issuer identifier.
+ */
+static NSString *const kTestAudience = @"https://server.example.com";
+
+/*! @class OIDRequestObjectTestSigner
+    @brief A key whose "signature" is the SHA-256 hash of the signing input, which counts its
+        signatures.
+ */
+@interface OIDRequestObjectTestSigner : NSObject <OIDJWSSigner>
+
+/*! @property signatureCount
+    @brief The number of signatures made.
+ */
+@property(atomic, readonly) NSUInteger signatureCount;
+
+/*! @property failing
+    @brief Whether signing fails, as it would if the key were unavailable.
+ */
+@property(atomic, assign) BOOL failing;
+
+@end
+
+@implementation OIDRequestObjectTestSigner
+
+- (NSString *)algorithm {
+  return @"PS256";
+}
+
+- (nullable NSData *)signatureForSigningInput:(NSData *)signingInput
+                                        error:(NSError **_Nullable)error {
+  if (_failing) {
+    if (error) {
+      *error = [OIDErrorUtilities errorWithCode:OIDErrorCodeRequestObjectError
+                                underlyingError:nil
+                                    description:@"The key is unavailable."];
+    }
+    return nil;
+  }
+  _signatureCount++;
+  NSString *input = [[NSString alloc] initWithData:signingInput encoding:NSASCIIStringEncoding];
+  return [OIDTokenUtilities sha265:input];
+}
+
+@end
+
+/*! @class OIDRequestObjectTestClock
+    @brief A clock which is stopped at a fixed time.
+ */
+@interface OIDRequestObjectTestClock : OIDClock
+
+/*! @property fixedNow
+    @brief The time the clock reports.
+ */
+@property(nonatomic, copy) NSDate *fixedNow;
+
+@end
+
+@implementation OIDRequestObjectTestClock
+
+- (NSDate *)now {
+  return _fixedNow;
+}
+
+@end
+
+/*! @class OIDRequestObjectBuilderTests
+    @brief Unit tests for @c OIDRequestObjectBuilder.
+ */
+@interface OIDRequestObjectBuilderTests : XCTestCase
+@end
+
+@implementation OIDRequestObjectBuilderTests
+
+/*! @fn JSONOfJWTPart:
+    @brief Decodes the JSON of an encoded JWT header or claims set.
+ */
+- (NSDictionary *)JSONOfJWTPart:(NSString *)part {
+  NSMutableString *base64 = [[part stringByReplacingOccurrencesOfString:@"-" withString:@"+"]
+      mutableCopy];
+  [base64 replaceOccurrencesOfString:@"_"
+                          withString:@"/"
+                             options:0
+                               range:NSMakeRange(0, base64.length)];
+  while (base64.length % 4) {
+    [base64 appendString:@"="];
+  }
+  NSData *data = [[NSData alloc] initWithBase64EncodedString:base64 options:0];
+  return [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL];
+}
+
+/*! @fn queryOfURL:
+    @brief Returns the query parameters of a URL.
+ */
+- (NSDictionary<NSString *, NSString *> *)queryOfURL:(NSURL *)URL {
+  NSURLComponents *components = [NSURLComponents componentsWithURL:URL
+                                           resolvingAgainstBaseURL:NO];
+  NSMutableDictionary<NSString *, NSString *> *query = [NSMutableDictionary dictionary];
+  for (NSURLQueryItem *item in components.queryItems) {
+    query[item.name] = item.value;
+  }
+  return query;
+}
+
+/*! @fn claimsOfURL:
+    @brief Returns the claims of the request object in an authorization URL.
+ */
+- (NSDictionary *)claimsOfURL:(NSURL *)URL {
+  NSString *requestObject = [self queryOfURL:URL][@"request"];
+  NSArray<NSString *> *parts = [requestObject componentsSeparatedByString:@"."];
+  XCTAssertEqual(parts.count, 3);
+  return [self JSONOfJWTPart:parts[1]];
+}
+
+/*! @fn assertClaims:matchRequest:
+    @brief Asserts that request object claims carry all of a request's parameters.
+ */
+- (void)assertClaims:(NSDictionary *)claims matchRequest:(OIDAuthorizationRequest *)request {
+  NSURL *URL = request.authorizationRequestURL;
+  NSDictionary<NSString *, NSString *> *expected = [self queryOfURL:URL];
+  for (NSString *parameter in expected) {
+    if (![parameter isEqualToString:@"request"]) {
+      XCTAssertEqualObjects(claims[parameter], expected[parameter], @"%@", parameter);
+    }
+  }
+}
+
+/*! @fn testRequestObject
+    @brief Tests the header and registered claims of a request object.
+ */
+- (void)testRequestObject {
+  OIDRequestObjectBuilder *builder =
+      [[OIDRequestObjectBuilder alloc] initWithSigner:[[OIDRequestObjectTestSigner alloc] init]
+                                             clientID:@"client"
+                                             audience:kTestAudience];
+  NSString *requestObject = [builder requestObjectWithClaims:@{ @"state" : @"af0ifjsldkj" }
+                                                       error:NULL];
+  NSArray<NSString *> *parts = [requestObject componentsSeparatedByString:@"."];
+  XCTAssertEqual(parts.count, 3);
+  XCTAssertEqualObjects([self JSONOfJWTPart:parts[0]],
+                        (@{ @"alg" : @"PS256", @"typ" : @"oauth-authz-req+jwt" }));
+  NSDictionary *claims = [self JSONOfJWTPart:parts[1]];
+  XCTAssertEqualObjects(claims[@"state"], @"af0ifjsldkj");
+  XCTAssertEqualObjects(claims[@"iss"], @"client");
+  XCTAssertEqualObjects(claims[@"aud"], kTestAudience);
+  XCTAssertEqualObjects(claims[@"nbf"], claims[@"iat"]);
+  XCTAssertEqual([claims[@"exp"] longLongValue] - [claims[@"iat"] longLongValue], 300);
+
+  NSString *second = [builder requestObjectWithClaims:@{} error:NULL];
+  NSDictionary *secondClaims = [self JSONOfJWTPart:[second componentsSeparatedByString:@"."][1]];
+  XCTAssertNotEqualObjects(secondClaims[@"jti"], claims[@"jti"]);
+}
+
+/*! @fn testClaimsUseServerTime
+    @brief Tests that the time claims follow the shared clock, corrected by the estimated offset
+        of the authorization server's clock.
+ */
+- (void)testClaimsUseServerTime {
+  NSString *audience =
+      [NSString stringWithFormat:@"https://%@.example.com", [NSUUID UUID].UUIDString];
+  OIDRequestObjectTestClock *clock = [[OIDRequestObjectTestClock alloc] init];
+  clock.fixedNow = [NSDate dateWithTimeIntervalSince1970:1500000000];
+  // the server's clock is two minutes ahead
+  [[OIDClockSkewEstimator sharedEstimator]
+      recordServerDate:[clock.fixedNow dateByAddingTimeInterval:120]
+             localDate:clock.fixedNow
+             forIssuer:[NSURL URLWithString:audience]];
+  OIDRequestObjectBuilder *builder =
+      [[OIDRequestObjectBuilder alloc] initWithSigner:[[OIDRequestObjectTestSigner alloc] init]
+                                             clientID:@"client"
+                                             audience:audience];
+
+  OIDClock *originalClock = [OIDClock sharedClock];
+  [OIDClock setSharedClock:clock];
+  NSString *requestObject = [builder requestObjectWithClaims:@{} error:NULL];
+  [OIDClock setSharedClock:originalClock];
+
+  NSDictionary *claims = [self JSONOfJWTPart:[requestObject componentsSeparatedByString:@"."][1]];
+  XCTAssertEqualObjects(claims[@"iat"], @1500000120);
+  XCTAssertEqualObjects(claims[@"nbf"], @1500000120);
+  XCTAssertEqualObjects(claims[@"exp"], @1500000420);
+}
+
+/*! @fn testAuthorizationRequestURL
+    @brief Tests that only the parameters OpenID Connect requires are left outside the request
+        object.
+ */
+- (void)testAuthorizationRequestURL {
+  OIDAuthorizationRequest *request = [OIDAuthorizationRequestTests testInstance];
+  OIDRequestObjectBuilder *builder =
+      [[OIDRequestObjectBuilder alloc] initWithSigner:[[OIDRequestObjectTestSigner alloc] init]
+                                             clientID:request.clientID
+                                             audience:kTestAudience];
+  NSURL *URL = [builder authorizationRequestURLForRequest:request error:NULL];
+  NSDictionary<NSString *, NSString *> *query = [self queryOfURL:URL];
+  XCTAssertEqualObjects([NSSet setWithArray:query.allKeys],
+                        ([NSSet setWithArray:@[ @"response_type", @"client_id", @"scope",
+                                                @"request" ]]));
+  XCTAssertEqualObjects(query[@"client_id"], request.clientID);
+  [self assertClaims:[self claimsOfURL:URL] matchRequest:request];
+}
+
+/*! @fn testTemplate
+    @brief Tests that a template with a builder signs each request once, with the per-flow
+        parameters.
+ */
+- (void)testTemplate {
+  OIDAuthorizationRequest *expected = [OIDAuthorizationRequestTests testInstance];
+  OIDRequestObjectTestSigner *signer = [[OIDRequestObjectTestSigner alloc] init];
+  OIDRequestObjectBuilder *builder =
+      [[OIDRequestObjectBuilder alloc] initWithSigner:signer
+                                             clientID:expected.clientID
+                                             audience:kTestAudience];
+  OIDAuthorizationRequestTemplate *requestTemplate = [[OIDAuthorizationRequestTemplate alloc]
+      initWithConfiguration:expected.configuration
+                   clientId:expected.clientID
+                      scope:expected.scope
+                redirectURL:expected.redirectURL
+               responseType:expected.responseType
+       additionalParameters:expected.additionalParameters
+       requestObjectBuilder:builder];
+  OIDAuthorizationRequest *request =
+      [requestTemplate authorizationRequestWithState:expected.state
+                                        codeVerifier:expected.codeVerifier];
+  XCTAssertEqual(signer.signatureCount, 1);
+
+  NSURL *URL = request.authorizationRequestURL;
+  XCTAssertEqualObjects(request.authorizationRequestURL, URL);
+  XCTAssertEqual(signer.signatureCount, 1);
+  NSDictionary<NSString *, NSString *> *query = [self queryOfURL:URL];
+  XCTAssertEqual(query.count, 4);
+  XCTAssertEqualObjects(query[@"scope"], expected.scope);
+  [self assertClaims:[self claimsOfURL:URL] matchRequest:expected];
+}
+
+/*! @fn testTemplateSigningFailure
+    @brief Tests that a template doesn't create a request whose request object couldn't be
+        signed, rather than sending its parameters unsigned.
+ */
+- (void)testTemplateSigningFailure {
+  OIDAuthorizationRequest *expected = [OIDAuthorizationRequestTests testInstance];
+  OIDRequestObjectTestSigner *signer = [[OIDRequestObjectTestSigner alloc] init];
+  signer.failing = YES;
+  OIDRequestObjectBuilder *builder =
+      [[OIDRequestObjectBuilder alloc] initWithSigner:signer
+                                             clientID:expected.clientID
+                                             audience:kTestAudience];
+  OIDAuthorizationRequestTemplate *requestTemplate = [[OIDAuthorizationRequestTemplate alloc]
+      initWithConfiguration:expected.configuration
+                   clientId:expected.clientID
+                      scope:expected.scope
+                redirectURL:expected.redirectURL
+               responseType:expected.responseType
+       additionalParameters:expected.additionalParameters
+       requestObjectBuilder:builder];
+
+  NSError *error;
+  XCTAssertNil([requestTemplate authorizationRequestWithError:&error]);
+  XCTAssertEqualObjects(error.domain, OIDGeneralErrorDomain);
+  XCTAssertEqual(error.code, OIDErrorCodeRequestObjectError);
+  XCTAssertNil([requestTemplate authorizationRequest]);
+
+  signer.failing = NO;
+  OIDAuthorizationRequest *request = [requestTemplate authorizationRequestWithError:&error];
+  XCTAssertNotNil(request);
+  XCTAssertNotNil([self queryOfURL:request.authorizationRequestURL][@"request"]);
+}
+
+/*! @fn testBuilderWithConfiguration
+    @brief Tests that a builder is only created for servers which accept the signer's request
+        objects.
+ */
+- (void)testBuilderWithConfiguration {
+  OIDRequestObjectTestSigner *signer = [[OIDRequestObjectTestSigner alloc] init];
+  // without discovery there is no issuer to use as the audience
+  OIDServiceConfiguration *undiscovered =
+      [[OIDServiceConfiguration alloc]
+          initWithAuthorizationEndpoint:[NSURL URLWithString:@"https://server.example.com/auth"]
+                          tokenEndpoint:[NSURL URLWithString:@"https://server.example.com/token"]];
+  XCTAssertNil([OIDRequestObjectBuilder builderWithConfiguration:undiscovered
+                                                        clientID:@"client"
+                                                          signer:signer]);
+
+  NSMutableDictionary *dictionary =
+      [[OIDServiceDiscoveryTests minimumServiceDiscoveryDictionary] mutableCopy];
+  OIDServiceDiscovery *discovery = [[OIDServiceDiscovery alloc] initWithDictionary:dictionary
+                                                                              error:NULL];
+  OIDServiceConfiguration *configuration =
+      [[OIDServiceConfiguration alloc] initWithDiscoveryDocument:discovery];
+  XCTAssertNil([OIDRequestObjectBuilder builderWithConfiguration:configuration
+                                                        clientID:@"client"
+                                                          signer:signer]);
+
+  dictionary[@"request_parameter_supported"] = @YES;
+  dictionary[@"request_object_signing_alg_values_supported"] = @[ @"ES256" ];
+  discovery = [[OIDServiceDiscovery alloc] initWithDictionary:dictionary error:NULL];
+  configuration = [[OIDServiceConfiguration alloc] initWithDiscoveryDocument:discovery];
+  XCTAssertNil([OIDRequestObjectBuilder builderWithConfiguration:configuration
+                                                        clientID:@"client"
+                                                          signer:signer]);
+
+  dictionary[@"request_object_signing_alg_values_supported"] = @[ @"ES256", @"PS256" ];
+  discovery = [[OIDServiceDiscovery alloc] initWithDictionary:dictionary error:NULL];
+  configuration = [[OIDServiceConfiguration alloc] initWithDiscoveryDocument:discovery];
+  OIDRequestObjectBuilder *builder =
+      [OIDRequestObjectBuilder builderWithConfiguration:configuration
+                                               clientID:@"client"
+                                                 signer:signer];
+  XCTAssertEqualObjects(builder.audience, dictionary[@"issuer"]);
+}
+
+@end
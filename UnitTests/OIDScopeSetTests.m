@@ -0,0 +1,171 @@
+/*! @file OIDScopeSetTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDAuthStateTests.h"
+#import "Source/OIDAuthState.h"
+#import "Source/OIDScopeSet.h"
+
+/*! @var kTestGrantedScope
+    @brief A granted scope string for testing.
+ */
+static NSString *const kTestGrantedScope = @"openid profile email";
+
+/*! @class OIDScopeSetTests
+    @brief Unit tests for @c OIDScopeSet.
+ */
+@interface OIDScopeSetTests : XCTestCase
+@end
+
+@implementation OIDScopeSetTests
+
+/*! @fn testStringConversion
+    @brief Tests parsing and formatting scope strings, and that parsed sets are cached.
+ */
+- (void)testStringConversion {
+  OIDScopeSet *scopeSet = [OIDScopeSet scopeSetWithString:kTestGrantedScope];
+  XCTAssertEqual(scopeSet.count, 3);
+  XCTAssertEqualObjects(scopeSet.scopeString, kTestGrantedScope);
+  XCTAssertEqualObjects([NSSet setWithArray:scopeSet.scopes],
+                        ([NSSet setWithArray:@[ @"openid", @"profile", @"email" ]]));
+  XCTAssertEqual([OIDScopeSet scopeSetWithString:kTestGrantedScope], scopeSet);
+
+  OIDScopeSet *fromArray = [OIDScopeSet scopeSetWithArray:@[ @"email", @"openid", @"profile" ]];
+  XCTAssertEqualObjects(fromArray, scopeSet);
+  XCTAssertEqual(fromArray.hash, scopeSet.hash);
+  XCTAssertEqualObjects([OIDScopeSet scopeSetWithString:fromArray.scopeString], scopeSet);
+}
+
+/*! @fn testEmptyAndRepeatedSeparators
+    @brief Tests that empty components of a scope string are ignored.
+ */
+- (void)testEmptyAndRepeatedSeparators {
+  XCTAssertEqual([OIDScopeSet scopeSetWithString:@""].count, 0);
+  OIDScopeSet *scopeSet = [OIDScopeSet scopeSetWithString:@" openid  email "];
+  XCTAssertEqualObjects(scopeSet, ([OIDScopeSet scopeSetWithArray:@[ @"openid", @"email" ]]));
+  XCTAssertEqualObjects([OIDScopeSet scopeSetWithString:@""],
+                        [OIDScopeSet scopeSetWithArray:@[]]);
+}
+
+/*! @fn testContainsScope
+    @brief Tests membership, including for a scope that was never interned.
+ */
+- (void)testContainsScope {
+  OIDScopeSet *scopeSet = [OIDScopeSet scopeSetWithString:kTestGrantedScope];
+  XCTAssert([scopeSet containsScope:@"profile"]);
+  XCTAssertFalse([scopeSet containsScope:@"OIDScopeSetTests.neverInterned"]);
+}
+
+/*! @fn testSetOperations
+    @brief Tests subset, intersection and union.
+ */
+- (void)testSetOperations {
+  OIDScopeSet *granted = [OIDScopeSet scopeSetWithString:kTestGrantedScope];
+  OIDScopeSet *required = [OIDScopeSet scopeSetWithString:@"email openid"];
+  OIDScopeSet *other = [OIDScopeSet scopeSetWithString:@"email calendar"];
+
+  XCTAssert([required isSubsetOfScopeSet:granted]);
+  XCTAssertFalse([granted isSubsetOfScopeSet:required]);
+  XCTAssertFalse([other isSubsetOfScopeSet:granted]);
+  XCTAssert([other intersectsScopeSet:granted]);
+  XCTAssertFalse([[OIDScopeSet scopeSetWithString:@"calendar"] intersectsScopeSet:granted]);
+
+  OIDScopeSet *intersection = [granted scopeSetByIntersectingScopeSet:other];
+  XCTAssertEqualObjects(intersection, [OIDScopeSet scopeSetWithString:@"email"]);
+
+  OIDScopeSet *combined = [granted scopeSetByAddingScopeSet:other];
+  XCTAssertEqual(combined.count, 4);
+  XCTAssert([granted isSubsetOfScopeSet:combined]);
+  XCTAssert([other isSubsetOfScopeSet:combined]);
+}
+
+/*! @fn testSetsSpanningSeveralWords
+    @brief Tests operations on sets whose scopes don't fit in a single word, and that trailing
+        empty words don't affect equality.
+ */
+- (void)testSetsSpanningSeveralWords {
+  NSMutableArray<NSString *> *manyScopes = [NSMutableArray array];
+  for (NSUInteger i = 0; i < 200; i++) {
+    [manyScopes addObject:[NSString stringWithFormat:@"OIDScopeSetTests.scope%lu",
+                                                     (unsigned long)i]];
+  }
+  OIDScopeSet *large = [OIDScopeSet scopeSetWithArray:manyScopes];
+  OIDScopeSet *small = [OIDScopeSet scopeSetWithArray:@[ manyScopes.firstObject ]];
+  XCTAssertEqual(large.count, 200);
+  XCTAssert([small isSubsetOfScopeSet:large]);
+  XCTAssertFalse([large isSubsetOfScopeSet:small]);
+
+  // the intersection has no bits in the words beyond the small set's
+  OIDScopeSet *intersection = [large scopeSetByIntersectingScopeSet:small];
+  XCTAssertEqualObjects(intersection, small);
+  XCTAssertEqual(intersection.hash, small.hash);
+}
+
+/*! @fn testLongScopeListsBeyondInternTable
+    @brief Tests a scope string with more scopes than the intern table holds, as a hostile server
+        might send: the scopes beyond its capacity aren't interned, but behave the same.
+ */
+- (void)testLongScopeListsBeyondInternTable {
+  NSMutableArray<NSString *> *manyScopes = [NSMutableArray array];
+  for (NSUInteger i = 0; i < 5000; i++) {
+    [manyScopes addObject:[NSString stringWithFormat:@"OIDScopeSetTests.hostile%lu",
+                                                     (unsigned long)i]];
+  }
+  NSString *scopeString = [manyScopes componentsJoinedByString:@" "];
+  OIDScopeSet *large = [OIDScopeSet scopeSetWithString:scopeString];
+  XCTAssertEqual(large.count, 5000);
+  XCTAssert([large containsScope:manyScopes.firstObject]);
+  XCTAssert([large containsScope:manyScopes.lastObject]);
+  XCTAssertFalse([large containsScope:@"OIDScopeSetTests.hostileMissing"]);
+  NSArray<NSString *> *reversed = manyScopes.reverseObjectEnumerator.allObjects;
+  XCTAssertEqualObjects([OIDScopeSet scopeSetWithArray:reversed], large);
+
+  OIDScopeSet *last = [OIDScopeSet scopeSetWithArray:@[ manyScopes.lastObject ]];
+  OIDScopeSet *withGranted =
+      [last scopeSetByAddingScopeSet:[OIDScopeSet scopeSetWithString:kTestGrantedScope]];
+  XCTAssertEqual(withGranted.count, 4);
+  XCTAssert([last isSubsetOfScopeSet:large]);
+  XCTAssertFalse([withGranted isSubsetOfScopeSet:large]);
+  XCTAssert([withGranted intersectsScopeSet:large]);
+  XCTAssertEqualObjects([withGranted scopeSetByIntersectingScopeSet:large], last);
+  XCTAssertEqualObjects([OIDScopeSet scopeSetWithString:withGranted.scopeString], withGranted);
+}
+
+/*! @fn testSecureCoding
+    @brief Tests that scope sets are archived as scope strings.
+ */
+- (void)testSecureCoding {
+  OIDScopeSet *scopeSet = [OIDScopeSet scopeSetWithString:kTestGrantedScope];
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:scopeSet];
+  OIDScopeSet *unarchived = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssertEqualObjects(unarchived, scopeSet);
+}
+
+/*! @fn testAuthStateScopeSet
+    @brief Tests that @c OIDAuthState exposes its granted scope as a cached scope set.
+ */
+- (void)testAuthStateScopeSet {
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  XCTAssertNotNil(authState.scope);
+  OIDScopeSet *scopeSet = authState.scopeSet;
+  XCTAssertEqualObjects(scopeSet, [OIDScopeSet scopeSetWithString:authState.scope]);
+  XCTAssertEqual(authState.scopeSet, scopeSet);
+}
+
+@end
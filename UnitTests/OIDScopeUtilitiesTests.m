@@ -0,0 +1,98 @@
+/*! @file OIDScopeUtilitiesTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "Source/OIDError.h"
+#import "Source/OIDScopeUtilities.h"
+
+/*! @class OIDScopeUtilitiesTests
+    @brief Unit tests for @c OIDScopeUtilities.
+ */
+@interface OIDScopeUtilitiesTests : XCTestCase
+@end
+
+@implementation OIDScopeUtilitiesTests
+
+/*! @fn testJoining
+    @brief Tests that scopes are joined with single spaces.
+ */
+- (void)testJoining {
+  XCTAssertEqualObjects([OIDScopeUtilities scopesWithArray:@[]], @"");
+  XCTAssertEqualObjects([OIDScopeUtilities scopesWithArray:@[ @"openid" ]], @"openid");
+  XCTAssertEqualObjects(([OIDScopeUtilities scopesWithArray:@[ @"openid", @"email", @"a" ]]),
+                        @"openid email a");
+}
+
+/*! @fn testEveryAllowedCharacter
+    @brief Tests that a scope containing every allowed character is accepted.
+ */
+- (void)testEveryAllowedCharacter {
+  NSMutableString *scope = [NSMutableString string];
+  for (unichar c = 0x21; c <= 0x7E; c++) {
+    if (c != 0x22 && c != 0x5C) {
+      [scope appendFormat:@"%C", c];
+    }
+  }
+  NSError *error;
+  XCTAssertEqualObjects([OIDScopeUtilities scopesWithArray:@[ scope ] error:&error], scope);
+  XCTAssertNil(error);
+}
+
+/*! @fn testInvalidScopes
+    @brief Tests that empty scopes and those with disallowed characters, including non-ASCII
+        ones, are rejected with an error by @c scopesWithArray:error: and fail an assertion in
+        @c scopesWithArray:, which leaves them out of the result when assertions are disabled.
+ */
+- (void)testInvalidScopes {
+  NSArray<NSString *> *invalidScopes =
+      @[ @"", @"a b", @"a\"b", @"a\\b", @"a\x7F", @"\x1F", @"café", @"\U0001F511" ];
+  for (NSString *invalidScope in invalidScopes) {
+    NSError *error;
+    NSArray<NSString *> *scopes = @[ @"openid", invalidScope ];
+    XCTAssertNil([OIDScopeUtilities scopesWithArray:scopes error:&error], @"%@", invalidScope);
+    XCTAssertEqualObjects(error.domain, OIDGeneralErrorDomain);
+    XCTAssertEqual(error.code, OIDErrorCodeInvalidScope);
+#if !defined(NS_BLOCK_ASSERTIONS)
+    XCTAssertThrows([OIDScopeUtilities scopesWithArray:scopes], @"%@", invalidScope);
+#else
+    XCTAssertEqualObjects([OIDScopeUtilities scopesWithArray:scopes], @"openid");
+    XCTAssertNil([OIDScopeUtilities scopesWithArray:@[ invalidScope ]]);
+#endif
+  }
+}
+
+/*! @fn testJoiningPerformance
+    @brief Measures validating and joining a typical set of scopes.
+ */
+- (void)testJoiningPerformance {
+  NSArray<NSString *> *scopes = @[
+    @"openid",
+    @"profile",
+    @"email",
+    @"https://www.googleapis.com/auth/calendar.readonly",
+    @"https://www.googleapis.com/auth/drive.file",
+  ];
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < 10000; i++) {
+      [OIDScopeUtilities scopesWithArray:scopes error:NULL];
+    }
+  }];
+}
+
+@end
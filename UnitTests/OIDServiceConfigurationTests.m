@@ -23,25 +23,20 @@
 #import "OIDServiceDiscoveryTests.h"
 #import "Source/OIDAuthorizationService.h"
 #import "Source/OIDError.h"
+#import "Source/OIDHTTPClient.h"
 #import "Source/OIDServiceConfiguration.h"
 #import "Source/OIDServiceDiscovery.h"
 
-/*! @typedef DataTaskWithURLCompletionHandler
-    @brief The callback signature for @c NSURLSession 's @c dataTaskWithURL:completionHandler:
-        method, which we swizzle in @c testFetcher to fake the network response with an OpenID
-        Connect Discovery document.
+/*! @typedef PerformRequestImplementation
+    @brief The function signature for an implementation of @c OIDHTTPClient 's
+        @c performRequest:endpointType:deadline:completion: method, which we swizzle in
+        @c testFetcher to fake the network response with an OpenID Connect Discovery document.
  */
-typedef void(^DataTaskWithURLCompletionHandler)(NSData *_Nullable data,
-                                                NSURLResponse *_Nullable response,
-                                                NSError *_Nullable error);
-
-/*! @typedef DataTaskWithURLCompletionImplementation
-    @brief The function signature for a @c dataTaskWithURL:completionHandler: implementation. Used
-        in @c testFetcher for implementing a swizzled version of @c NSURLSession 's
-        @c dataTaskWithURL:completionHandler:
- */
-typedef NSURLSessionDataTask *(^DataTaskWithURLCompletionImplementation)
-    (id _self, NSURL *url, DataTaskWithURLCompletionHandler completionHandler);
+typedef id<OIDCancellable> (^PerformRequestImplementation)(id _self,
+                                                           NSURLRequest *request,
+                                                           OIDHTTPEndpointType endpointType,
+                                                           NSDate *_Nullable deadline,
+                                                           OIDHTTPCompletion completion);
 
 /*! @typedef TeardownTask
     @brief A block to be called during teardown.
@@ -157,6 +152,22 @@ static NSString *const kIssuerTestExpectedFullDiscoveryURL =
                         kInitializerTestAuthEndpoint);
   XCTAssertEqualObjects(configuration.tokenEndpoint.absoluteString,
                         kInitializerTestTokenEndpoint);
+  XCTAssertNil(configuration.registrationEndpoint);
+}
+
+/*! @fn testRegistrationEndpointSecureCoding
+    @brief Tests that the registration endpoint is archived with the configuration.
+ */
+- (void)testRegistrationEndpointSecureCoding {
+  NSURL *registrationEndpoint = [NSURL URLWithString:@"https://www.example.com/register"];
+  OIDServiceConfiguration *configuration = [[OIDServiceConfiguration alloc]
+      initWithAuthorizationEndpoint:[NSURL URLWithString:kInitializerTestAuthEndpoint]
+                      tokenEndpoint:[NSURL URLWithString:kInitializerTestTokenEndpoint]
+               registrationEndpoint:registrationEndpoint];
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:configuration];
+  OIDServiceConfiguration *unarchived = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssertEqualObjects(unarchived.registrationEndpoint, registrationEndpoint);
+  XCTAssertEqualObjects(unarchived.tokenEndpoint, configuration.tokenEndpoint);
 }
 
 - (void)testIssuer {
@@ -171,21 +182,25 @@ static NSString *const kIssuerTestExpectedFullDiscoveryURL =
       [self expectationWithDescription:@"Discovery URL should be correct."];
 
   id successfulResponse =
-      ^(id _self, NSURL *discoveryURL, OIDDiscoveryCallback completion) {
+      ^id<OIDCancellable>(id _self,
+                          NSURL *discoveryURL,
+                          NSDate *_Nullable deadline,
+                          OIDDiscoveryCallback completion) {
         NSURL *fullDiscoveryURL = [NSURL URLWithString:kIssuerTestExpectedFullDiscoveryURL];
         if ([discoveryURL isEqual:fullDiscoveryURL]) {
           [expectation fulfill];
-          return;
+          return nil;
         }
 
         XCTAssert(NO,
                   @"Not equal %@ != %@",
                   [fullDiscoveryURL absoluteString],
                   [discoveryURL absoluteString]);
+        return nil;
       };
 
   [self replaceClassMethodForClass:[OIDAuthorizationService class]
-       selector:@selector(discoverServiceConfigurationForDiscoveryURL:completion:)
+       selector:@selector(discoverServiceConfigurationForDiscoveryURL:deadline:completion:)
       withBlock:successfulResponse];
 
   NSURL *issuerURL = [NSURL URLWithString:issuer];
@@ -199,9 +214,12 @@ static NSString *const kIssuerTestExpectedFullDiscoveryURL =
     @brief Tests the OpenID Connect Discovery Document fetching and initialization.
  */
 - (void)testFetcher {
-  DataTaskWithURLCompletionImplementation successfulResponse =
-      ^NSURLSessionDataTask *(
-          id _self, NSURL *url, DataTaskWithURLCompletionHandler completionHandler) {
+  PerformRequestImplementation successfulResponse =
+      ^id<OIDCancellable>(id _self,
+                          NSURLRequest *request,
+                          OIDHTTPEndpointType endpointType,
+                          NSDate *_Nullable deadline,
+                          OIDHTTPCompletion completionHandler) {
         NSError *error;
         NSDictionary *jsonObject =
             [OIDServiceDiscoveryTests completeServiceDiscoveryDictionary];
@@ -209,7 +227,7 @@ static NSString *const kIssuerTestExpectedFullDiscoveryURL =
                                                            options:NSJSONWritingPrettyPrinted
                                                              error:&error];
         NSHTTPURLResponse *jsonResponse =
-            [[NSHTTPURLResponse alloc] initWithURL:url
+            [[NSHTTPURLResponse alloc] initWithURL:request.URL
                                         statusCode:200
                                        HTTPVersion:@"1.1"
                                       headerFields:nil];
@@ -217,8 +235,8 @@ static NSString *const kIssuerTestExpectedFullDiscoveryURL =
         return nil;
       };
 
-  [self replaceInstanceMethodForClass:[NSURLSession class]
-                             selector:@selector(dataTaskWithURL:completionHandler:)
+  [self replaceInstanceMethodForClass:[OIDHTTPClient class]
+                             selector:@selector(performRequest:endpointType:deadline:completion:)
                             withBlock:successfulResponse];
 
 
@@ -251,16 +269,19 @@ static NSString *const kIssuerTestExpectedFullDiscoveryURL =
         a network error.
  */
 - (void)testFetcherWithNetworkError {
-  DataTaskWithURLCompletionImplementation successfulResponse =
-      ^NSURLSessionDataTask *(
-          id _self, NSURL *url, DataTaskWithURLCompletionHandler completionHandler) {
+  PerformRequestImplementation successfulResponse =
+      ^id<OIDCancellable>(id _self,
+                          NSURLRequest *request,
+                          OIDHTTPEndpointType endpointType,
+                          NSDate *_Nullable deadline,
+                          OIDHTTPCompletion completionHandler) {
         NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:500 userInfo:nil];
         completionHandler(nil, nil, error);
         return nil;
       };
 
-  [self replaceInstanceMethodForClass:[NSURLSession class]
-                             selector:@selector(dataTaskWithURL:completionHandler:)
+  [self replaceInstanceMethodForClass:[OIDHTTPClient class]
+                             selector:@selector(performRequest:endpointType:deadline:completion:)
                             withBlock:successfulResponse];
 
   NSURL *url = [NSURL URLWithString:kInitializerTestDiscoveryEndpoint];
@@ -283,16 +304,19 @@ static NSString *const kIssuerTestExpectedFullDiscoveryURL =
         a non-2xx HTTP status code. Should return an error.
  */
 - (void)testFetcherWithErrorCode {
-  DataTaskWithURLCompletionImplementation successfulResponse =
-      ^NSURLSessionDataTask *(
-          id _self, NSURL *url, DataTaskWithURLCompletionHandler completionHandler) {
+  PerformRequestImplementation successfulResponse =
+      ^id<OIDCancellable>(id _self,
+                          NSURLRequest *request,
+                          OIDHTTPEndpointType endpointType,
+                          NSDate *_Nullable deadline,
+                          OIDHTTPCompletion completionHandler) {
         NSError *error;
         NSDictionary *jsonObject = [OIDServiceDiscoveryTests completeServiceDiscoveryDictionary];
         NSData *jsonData = [NSJSONSerialization dataWithJSONObject:jsonObject
                                                            options:NSJSONWritingPrettyPrinted
                                                              error:&error];
         NSHTTPURLResponse *jsonResponse =
-            [[NSHTTPURLResponse alloc] initWithURL:url
+            [[NSHTTPURLResponse alloc] initWithURL:request.URL
                                         statusCode:500
                                        HTTPVersion:@"1.1"
                                       headerFields:nil];
@@ -300,8 +324,8 @@ static NSString *const kIssuerTestExpectedFullDiscoveryURL =
         return nil;
       };
 
-  [self replaceInstanceMethodForClass:[NSURLSession class]
-                             selector:@selector(dataTaskWithURL:completionHandler:)
+  [self replaceInstanceMethodForClass:[OIDHTTPClient class]
+                             selector:@selector(performRequest:endpointType:deadline:completion:)
                             withBlock:successfulResponse];
 
 
@@ -320,17 +344,49 @@ static NSString *const kIssuerTestExpectedFullDiscoveryURL =
   [self waitForExpectationsWithTimeout:2 handler:nil];
 }
 
+/*! @fn testFetcherWithDeadline
+    @brief Tests that discovery passes its deadline on to the request.
+ */
+- (void)testFetcherWithDeadline {
+  NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:30];
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Request should be made."];
+  PerformRequestImplementation checkDeadline =
+      ^id<OIDCancellable>(id _self,
+                          NSURLRequest *request,
+                          OIDHTTPEndpointType endpointType,
+                          NSDate *_Nullable requestDeadline,
+                          OIDHTTPCompletion completionHandler) {
+        XCTAssertEqual(endpointType, OIDHTTPEndpointTypeDiscovery);
+        XCTAssertEqualObjects(requestDeadline, deadline);
+        [expectation fulfill];
+        return nil;
+      };
+
+  [self replaceInstanceMethodForClass:[OIDHTTPClient class]
+                             selector:@selector(performRequest:endpointType:deadline:completion:)
+                            withBlock:checkDeadline];
+
+  NSURL *url = [NSURL URLWithString:kInitializerTestDiscoveryEndpoint];
+  [OIDAuthorizationService discoverServiceConfigurationForDiscoveryURL:url
+      deadline:deadline
+      completion:^(OIDServiceConfiguration *_Nullable configuration, NSError *_Nullable error) {}];
+  [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
 /*! @fn testFetcherWithBadJSON
     @brief Tests the OpenID Connect Discovery Document fetching and initialization in the face of
         bad JSON input.
  */
 - (void)testFetcherWithBadJSON {
-  DataTaskWithURLCompletionImplementation successfulResponse =
-      ^NSURLSessionDataTask *(
-          id _self, NSURL *url, DataTaskWithURLCompletionHandler completionHandler) {
+  PerformRequestImplementation successfulResponse =
+      ^id<OIDCancellable>(id _self,
+                          NSURLRequest *request,
+                          OIDHTTPEndpointType endpointType,
+                          NSDate *_Nullable deadline,
+                          OIDHTTPCompletion completionHandler) {
         NSData *jsonData = [@"JUNK" dataUsingEncoding:NSUTF8StringEncoding];
         NSHTTPURLResponse *jsonResponse =
-            [[NSHTTPURLResponse alloc] initWithURL:url
+            [[NSHTTPURLResponse alloc] initWithURL:request.URL
                                         statusCode:200
                                        HTTPVersion:@"1.1"
                                       headerFields:nil];
@@ -338,8 +394,8 @@ static NSString *const kIssuerTestExpectedFullDiscoveryURL =
         return nil;
       };
 
-  [self replaceInstanceMethodForClass:[NSURLSession class]
-                             selector:@selector(dataTaskWithURL:completionHandler:)
+  [self replaceInstanceMethodForClass:[OIDHTTPClient class]
+                             selector:@selector(performRequest:endpointType:deadline:completion:)
                             withBlock:successfulResponse];
 
   NSURL *url = [NSURL URLWithString:kInitializerTestDiscoveryEndpoint];
@@ -383,4 +439,55 @@ static NSString *const kIssuerTestExpectedFullDiscoveryURL =
   XCTAssertEqualObjects(configuration.tokenEndpoint, unarchived.tokenEndpoint);
 }
 
+/*! @fn testEquality
+    @brief Tests that configurations are equal when their endpoints and discovery documents are.
+ */
+- (void)testEquality {
+  OIDServiceConfiguration *configuration = [[self class] testInstance];
+  NSURL *authorizationEndpoint = configuration.authorizationEndpoint;
+  NSURL *tokenEndpoint = configuration.tokenEndpoint;
+  OIDServiceConfiguration *same =
+      [[OIDServiceConfiguration alloc] initWithAuthorizationEndpoint:authorizationEndpoint
+                                                       tokenEndpoint:tokenEndpoint];
+  XCTAssertEqualObjects(configuration, same);
+  XCTAssertEqual(configuration.hash, same.hash);
+
+  OIDServiceConfiguration *withRegistration =
+      [[OIDServiceConfiguration alloc] initWithAuthorizationEndpoint:authorizationEndpoint
+                                                       tokenEndpoint:tokenEndpoint
+                                                registrationEndpoint:tokenEndpoint];
+  XCTAssertNotEqualObjects(configuration, withRegistration);
+
+  NSDictionary *dictionary = [OIDServiceDiscoveryTests completeServiceDiscoveryDictionary];
+  OIDServiceDiscovery *discovery =
+      [[OIDServiceDiscovery alloc] initWithDictionary:dictionary error:NULL];
+  OIDServiceConfiguration *discovered =
+      [[OIDServiceConfiguration alloc] initWithDiscoveryDocument:discovery];
+  OIDServiceConfiguration *endpointsOnly = [[OIDServiceConfiguration alloc]
+      initWithAuthorizationEndpoint:discovery.authorizationEndpoint
+                      tokenEndpoint:discovery.tokenEndpoint
+               registrationEndpoint:discovery.registrationEndpoint];
+  XCTAssertNotEqualObjects(discovered, endpointsOnly);
+  XCTAssertEqualObjects(discovered,
+                        [[OIDServiceConfiguration alloc] initWithDiscoveryDocument:discovery]);
+}
+
+/*! @fn testInterningOnDecode
+    @brief Tests that decoding the same configuration repeatedly yields a single shared instance.
+ */
+- (void)testInterningOnDecode {
+  NSDictionary *dictionary = [OIDServiceDiscoveryTests completeServiceDiscoveryDictionary];
+  OIDServiceDiscovery *discovery =
+      [[OIDServiceDiscovery alloc] initWithDictionary:dictionary error:NULL];
+  OIDServiceConfiguration *configuration =
+      [[OIDServiceConfiguration alloc] initWithDiscoveryDocument:discovery];
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:configuration];
+  OIDServiceConfiguration *first = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  OIDServiceConfiguration *second = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssertEqualObjects(first, configuration);
+  XCTAssertEqual(first, second);
+  XCTAssertEqual(first.discoveryDocument, second.discoveryDocument);
+  XCTAssertEqual([OIDServiceConfiguration internedConfiguration:configuration], first);
+}
+
 @end
@@ -406,6 +406,37 @@ static NSString *const kDiscoveryDocumentNullField =
   XCTAssertEqualObjects(discovery.discoveryDictionary, unarchived.discoveryDictionary);
 }
 
+/*! @fn testEquality
+    @brief Tests that discovery documents are equal when their dictionaries are.
+ */
+- (void)testEquality {
+  NSDictionary *dictionary = [[self class] completeServiceDiscoveryDictionary];
+  OIDServiceDiscovery *discovery =
+      [[OIDServiceDiscovery alloc] initWithDictionary:dictionary error:NULL];
+  OIDServiceDiscovery *same =
+      [[OIDServiceDiscovery alloc] initWithDictionary:[dictionary mutableCopy] error:NULL];
+  NSDictionary *minimumDictionary = [[self class] minimumServiceDiscoveryDictionary];
+  OIDServiceDiscovery *minimum =
+      [[OIDServiceDiscovery alloc] initWithDictionary:minimumDictionary error:NULL];
+  XCTAssertEqualObjects(discovery, same);
+  XCTAssertEqual(discovery.hash, same.hash);
+  XCTAssertNotEqualObjects(discovery, minimum);
+}
+
+/*! @fn testInterningOnDecode
+    @brief Tests that decoding the same document twice yields a single shared instance.
+ */
+- (void)testInterningOnDecode {
+  NSDictionary *dictionary = [[self class] completeServiceDiscoveryDictionary];
+  OIDServiceDiscovery *discovery =
+      [[OIDServiceDiscovery alloc] initWithDictionary:dictionary error:NULL];
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:discovery];
+  OIDServiceDiscovery *first = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  OIDServiceDiscovery *second = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssertEqualObjects(first, discovery);
+  XCTAssertEqual(first, second);
+}
+
 #pragma mark - Field Mappings
 
 /*! @define TestFieldBackedBy
@@ -0,0 +1,165 @@
+/*! @file OIDTokenRefreshRequestTemplateTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2016 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OIDAuthStateTests.h"
+#import "OIDAuthorizationRequestTests.h"
+#import "Source/OIDAuthState.h"
+#import "Source/OIDAuthorizationRequest.h"
+#import "Source/OIDAuthorizationResponse.h"
+#import "Source/OIDResponseTypes.h"
+#import "Source/OIDTokenRefreshRequestTemplate.h"
+#import "Source/OIDTokenRequest.h"
+#import "Source/OIDTokenResponse.h"
+
+/*! @var kTestRefreshToken
+    @brief A refresh token which needs percent-encoding.
+ */
+static NSString *const kTestRefreshToken = @"tGzv3JOkF0XG5Qx2TlKWIA+/=&";
+
+/*! @class OIDTokenRefreshRequestTemplateTests
+    @brief Unit tests for @c OIDTokenRefreshRequestTemplate.
+ */
+@interface OIDTokenRefreshRequestTemplateTests : XCTestCase
+@end
+
+@implementation OIDTokenRefreshRequestTemplateTests
+
+/*! @fn bodyParameters:
+    @brief Returns the encoded parameters of a request body, which are in no particular order.
+ */
+- (NSSet<NSString *> *)bodyParameters:(NSURLRequest *)URLRequest {
+  NSString *body = [[NSString alloc] initWithData:URLRequest.HTTPBody
+                                         encoding:NSUTF8StringEncoding];
+  return [NSSet setWithArray:[body componentsSeparatedByString:@"&"]];
+}
+
+/*! @fn assertRequest:isEquivalentToRequest:
+    @brief Asserts that two token requests have the same properties and URL requests.
+ */
+- (void)assertRequest:(OIDTokenRequest *)request isEquivalentToRequest:(OIDTokenRequest *)expected {
+  XCTAssertEqualObjects(request.grantType, expected.grantType);
+  XCTAssertEqualObjects(request.clientID, expected.clientID);
+  XCTAssertEqualObjects(request.scope, expected.scope);
+  XCTAssertEqualObjects(request.redirectURL, expected.redirectURL);
+  XCTAssertEqualObjects(request.refreshToken, expected.refreshToken);
+
+  NSURLRequest *URLRequest = [request URLRequest];
+  NSURLRequest *expectedURLRequest = [expected URLRequest];
+  XCTAssertEqualObjects(URLRequest.URL, expectedURLRequest.URL);
+  XCTAssertEqualObjects(URLRequest.HTTPMethod, expectedURLRequest.HTTPMethod);
+  XCTAssertEqualObjects(URLRequest.allHTTPHeaderFields, expectedURLRequest.allHTTPHeaderFields);
+  XCTAssertEqualObjects([self bodyParameters:URLRequest], [self bodyParameters:expectedURLRequest]);
+}
+
+/*! @fn plainRefreshRequestForAuthorizationRequest:additionalParameters:
+    @brief Returns the refresh request built without a template.
+ */
+- (OIDTokenRequest *)plainRefreshRequestForAuthorizationRequest:(OIDAuthorizationRequest *)request
+    additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters {
+  return [[OIDTokenRequest alloc] initWithConfiguration:request.configuration
+                                              grantType:OIDGrantTypeRefreshToken
+                                      authorizationCode:nil
+                                            redirectURL:request.redirectURL
+                                               clientID:request.clientID
+                                                  scope:request.scope
+                                           refreshToken:kTestRefreshToken
+                                           codeVerifier:nil
+                                   additionalParameters:additionalParameters];
+}
+
+/*! @fn testMatchesPlainRequest
+    @brief Tests that requests created from a template are equivalent to ones built directly.
+ */
+- (void)testMatchesPlainRequest {
+  OIDAuthorizationRequest *authorizationRequest = [OIDAuthorizationRequestTests testInstance];
+  OIDTokenRefreshRequestTemplate *requestTemplate =
+      [[OIDTokenRefreshRequestTemplate alloc] initWithAuthorizationRequest:authorizationRequest];
+
+  OIDTokenRequest *request = [requestTemplate tokenRequestWithRefreshToken:kTestRefreshToken
+                                                      additionalParameters:nil];
+  [self assertRequest:request
+      isEquivalentToRequest:[self plainRefreshRequestForAuthorizationRequest:authorizationRequest
+                                                        additionalParameters:nil]];
+
+  NSDictionary<NSString *, NSString *> *additionalParameters = @{ @"A" : @"1 2", @"B" : @"3" };
+  request = [requestTemplate tokenRequestWithRefreshToken:kTestRefreshToken
+                                     additionalParameters:additionalParameters];
+  OIDTokenRequest *expected =
+      [self plainRefreshRequestForAuthorizationRequest:authorizationRequest
+                                  additionalParameters:additionalParameters];
+  [self assertRequest:request isEquivalentToRequest:expected];
+  XCTAssertEqualObjects(request.additionalParameters, additionalParameters);
+}
+
+/*! @fn testSecureCoding
+    @brief Tests that a request created from a template is archived as an ordinary token request.
+ */
+- (void)testSecureCoding {
+  OIDAuthorizationRequest *authorizationRequest = [OIDAuthorizationRequestTests testInstance];
+  OIDTokenRefreshRequestTemplate *requestTemplate =
+      [[OIDTokenRefreshRequestTemplate alloc] initWithAuthorizationRequest:authorizationRequest];
+  OIDTokenRequest *request = [requestTemplate tokenRequestWithRefreshToken:kTestRefreshToken
+                                                      additionalParameters:nil];
+
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:request];
+  OIDTokenRequest *unarchived = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssertEqual([unarchived class], [OIDTokenRequest class]);
+  [self assertRequest:unarchived isEquivalentToRequest:request];
+}
+
+/*! @fn testAuthStateRecompilesAfterReauthorization
+    @brief Tests that an auth state's refresh requests follow a change of authorization.
+ */
+- (void)testAuthStateRecompilesAfterReauthorization {
+  OIDAuthState *authState = [OIDAuthStateTests testInstance];
+  OIDTokenRequest *first = [authState tokenRefreshRequest];
+  [self assertRequest:[authState tokenRefreshRequest] isEquivalentToRequest:first];
+
+  OIDAuthorizationRequest *previousRequest = authState.lastAuthorizationResponse.request;
+  OIDAuthorizationRequest *authorizationRequest =
+      [[OIDAuthorizationRequest alloc] initWithConfiguration:previousRequest.configuration
+                                                    clientId:@"OtherClientID"
+                                                       scope:@"openid other"
+                                                 redirectURL:previousRequest.redirectURL
+                                                responseType:OIDResponseTypeCode
+                                                       state:@"State"
+                                                codeVerifier:nil
+                                        additionalParameters:nil];
+  OIDAuthorizationResponse *authorizationResponse =
+      [[OIDAuthorizationResponse alloc] initWithRequest:authorizationRequest
+                                             parameters:@{ @"code" : @"Code",
+                                                           @"state" : @"State" }];
+  OIDTokenResponse *tokenResponse =
+      [[OIDTokenResponse alloc] initWithRequest:[authorizationResponse tokenExchangeRequest]
+                                     parameters:@{ @"access_token" : @"AccessToken",
+                                                   @"expires_in" : @3600,
+                                                   @"refresh_token" : kTestRefreshToken }];
+  [authState updateWithAuthorizationResponse:authorizationResponse error:nil];
+  [authState updateWithTokenResponse:tokenResponse error:nil];
+
+  OIDTokenRequest *request = [authState tokenRefreshRequest];
+  XCTAssertEqualObjects(request.clientID, @"OtherClientID");
+  XCTAssertEqualObjects(request.scope, @"openid other");
+  [self assertRequest:request
+      isEquivalentToRequest:[self plainRefreshRequestForAuthorizationRequest:authorizationRequest
+                                                        additionalParameters:nil]];
+}
+
+@end
@@ -22,6 +22,7 @@
 #import "OIDServiceConfigurationTests.h"
 #import "Source/OIDAuthorizationRequest.h"
 #import "Source/OIDAuthorizationResponse.h"
+#import "Source/OIDError.h"
 #import "Source/OIDScopeUtilities.h"
 #import "Source/OIDServiceConfiguration.h"
 #import "Source/OIDTokenRequest.h"
@@ -100,6 +101,53 @@ static NSString *const kTestAdditionalParameterValue = @"1";
   return request;
 }
 
+/*! @fn testInvalidScopesAsErrors
+    @brief Tests that the initializer taking an error reports invalid scopes, and that the one
+        not taking an error refuses them too.
+ */
+- (void)testInvalidScopesAsErrors {
+  OIDAuthorizationResponse *authResponse = [OIDAuthorizationResponseTests testInstance];
+  NSError *error;
+  OIDTokenRequest *request =
+      [[OIDTokenRequest alloc] initWithConfiguration:authResponse.request.configuration
+                                           grantType:OIDGrantTypeRefreshToken
+                                   authorizationCode:nil
+                                         redirectURL:authResponse.request.redirectURL
+                                            clientID:authResponse.request.clientID
+                                              scopes:@[ @"openid", @"in valid" ]
+                                        refreshToken:kRefreshTokenTestValue
+                                        codeVerifier:nil
+                                additionalParameters:nil
+                                               error:&error];
+  XCTAssertNil(request);
+  XCTAssertEqualObjects(error.domain, OIDGeneralErrorDomain);
+  XCTAssertEqual(error.code, OIDErrorCodeInvalidScope);
+
+#if !defined(NS_BLOCK_ASSERTIONS)
+  XCTAssertThrows(
+      [[OIDTokenRequest alloc] initWithConfiguration:authResponse.request.configuration
+                                           grantType:OIDGrantTypeRefreshToken
+                                   authorizationCode:nil
+                                         redirectURL:authResponse.request.redirectURL
+                                            clientID:authResponse.request.clientID
+                                              scopes:@[ @"openid", @"in valid" ]
+                                        refreshToken:kRefreshTokenTestValue
+                                        codeVerifier:nil
+                                additionalParameters:nil]);
+#else
+  XCTAssertNil(
+      [[OIDTokenRequest alloc] initWithConfiguration:authResponse.request.configuration
+                                           grantType:OIDGrantTypeRefreshToken
+                                   authorizationCode:nil
+                                         redirectURL:authResponse.request.redirectURL
+                                            clientID:authResponse.request.clientID
+                                              scopes:@[ @"openid", @"in valid" ]
+                                        refreshToken:kRefreshTokenTestValue
+                                        codeVerifier:nil
+                                additionalParameters:nil]);
+#endif
+}
+
 /*! @fn testCopying
     @brief Tests the @c NSCopying implementation by round-tripping an instance through the copying
         process and checking to make sure the source and destination instances are equivalent.